@@ -0,0 +1,232 @@
+/*
+ * bench_chess_system: measures the public ChessSystem API over parameterized sizes.
+ *
+ * Every size is given as TOURNAMENTSxPLAYERSxGAMES. For each size a fresh system is filled
+ * step by step, and every step is timed as one benchmark:
+ *   chessAddTournament             - adds all the tournaments
+ *   chessAddGame                   - adds the games, spread over the tournaments and players
+ *   chessCalculateAveragePlayTime  - queries every player
+ *   chessSavePlayersLevels         - exports the levels to /dev/null, repeated
+ *   chessEndTournament             - ends all the tournaments
+ *   chessSaveTournamentStatistics  - exports the statistics to /dev/null, repeated
+ *   chessRemovePlayer              - removes every player
+ *
+ * Each benchmark prints one JSON line with ns/op, ops/s and allocations per operation.
+ * Allocations are counted by wrapping malloc, calloc and realloc at link time
+ * (-Wl,--wrap=malloc ...), see benchmarks/Makefile.
+ *
+ * Usage: bench_chess_system [TxPxG ...]
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../chessSystem.h"
+
+#define NANOSECONDS 1000000000.0
+#define MAX_GAMES_PER_PLAYER 1000000
+#define MAX_PLAY_TIME 400
+#define EXPORT_REPEATS 5
+#define SINK_PATH "/dev/null"
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+
+static unsigned long long allocations = 0;
+
+void *__wrap_malloc(size_t size)
+{
+    allocations++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    allocations++;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size)
+{
+    allocations++;
+    return __real_realloc(pointer, size);
+}
+
+static unsigned long long random_state;
+
+static unsigned long long nextRandom()
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+
+static double secondsNow()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / NANOSECONDS;
+}
+
+typedef struct
+{
+    int tournaments;
+    int players;
+    int games;
+} BenchSize;
+
+typedef struct
+{
+    double start;
+    unsigned long long allocations;
+} BenchClock;
+
+static BenchClock benchStart()
+{
+    BenchClock clock = {secondsNow(), allocations};
+    return clock;
+}
+
+/**
+ * benchReport: Prints the JSON line of one benchmark.
+ *
+ * @param name - The benchmark name.
+ * @param size - The size the benchmark ran on.
+ * @param clock - The clock taken when the benchmark started.
+ * @param operations - The number of operations timed.
+ * @param failures - The number of operations that did not return CHESS_SUCCESS.
+ */
+static void benchReport(const char *name, BenchSize size, BenchClock clock, long operations, long failures)
+{
+    double seconds = secondsNow() - clock.start;
+    unsigned long long allocated = allocations - clock.allocations;
+    if (operations == 0)
+    {
+        operations = 1;
+    }
+    printf("{\"benchmark\":\"%s\",\"tournaments\":%d,\"players\":%d,\"games\":%d,"
+           "\"ops\":%ld,\"failures\":%ld,\"ns_per_op\":%.1f,\"ops_per_sec\":%.1f,\"allocs_per_op\":%.2f}\n",
+           name, size.tournaments, size.players, size.games, operations, failures,
+           seconds * NANOSECONDS / operations, seconds > 0 ? operations / seconds : 0,
+           (double)allocated / operations);
+    fflush(stdout);
+}
+
+/**
+ * benchSize: Runs all the benchmarks on one size.
+ *
+ * @param size - The size.
+ * @return
+ *     0 on success, 1 if the system could not be created.
+ */
+static int benchSize(BenchSize size)
+{
+    static const char *locations[] = {"London", "Tel aviv", "New york", "Paris city", "Berlin"};
+    const int number_of_locations = sizeof(locations) / sizeof(*locations);
+    random_state = 0x9E3779B97F4A7C15ULL;
+    ChessSystem chess = chessCreate();
+    if (chess == NULL)
+    {
+        return 1;
+    }
+
+    long failures = 0;
+    BenchClock clock = benchStart();
+    for (int i = 1; i <= size.tournaments; i++)
+    {
+        failures += chessAddTournament(chess, i, MAX_GAMES_PER_PLAYER, locations[i % number_of_locations]) != CHESS_SUCCESS;
+    }
+    benchReport("chessAddTournament", size, clock, size.tournaments, failures);
+
+    failures = 0;
+    clock = benchStart();
+    for (int i = 0; i < size.games; i++)
+    {
+        int first = 1 + (int)(nextRandom() % size.players);
+        int second = 1 + (int)((first + nextRandom() % (size.players - 1)) % size.players);
+        failures += chessAddGame(chess, 1 + i % size.tournaments, first, second, (Winner)(nextRandom() % 3),
+                                 (int)(nextRandom() % MAX_PLAY_TIME)) != CHESS_SUCCESS;
+    }
+    benchReport("chessAddGame", size, clock, size.games, failures);
+
+    failures = 0;
+    clock = benchStart();
+    for (int i = 1; i <= size.players; i++)
+    {
+        ChessResult result;
+        chessCalculateAveragePlayTime(chess, i, &result);
+        failures += result != CHESS_SUCCESS;
+    }
+    benchReport("chessCalculateAveragePlayTime", size, clock, size.players, failures);
+
+    FILE *sink = fopen(SINK_PATH, "w");
+    if (sink == NULL)
+    {
+        chessDestroy(chess);
+        return 1;
+    }
+    failures = 0;
+    clock = benchStart();
+    for (int i = 0; i < EXPORT_REPEATS; i++)
+    {
+        failures += chessSavePlayersLevels(chess, sink) != CHESS_SUCCESS;
+    }
+    fflush(sink);
+    benchReport("chessSavePlayersLevels", size, clock, EXPORT_REPEATS, failures);
+    fclose(sink);
+
+    failures = 0;
+    clock = benchStart();
+    for (int i = 1; i <= size.tournaments; i++)
+    {
+        failures += chessEndTournament(chess, i) != CHESS_SUCCESS;
+    }
+    benchReport("chessEndTournament", size, clock, size.tournaments, failures);
+
+    failures = 0;
+    clock = benchStart();
+    for (int i = 0; i < EXPORT_REPEATS; i++)
+    {
+        failures += chessSaveTournamentStatistics(chess, SINK_PATH) != CHESS_SUCCESS;
+    }
+    benchReport("chessSaveTournamentStatistics", size, clock, EXPORT_REPEATS, failures);
+
+    failures = 0;
+    clock = benchStart();
+    for (int i = 1; i <= size.players; i++)
+    {
+        failures += chessRemovePlayer(chess, i) != CHESS_SUCCESS;
+    }
+    benchReport("chessRemovePlayer", size, clock, size.players, failures);
+
+    chessDestroy(chess);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    static const BenchSize default_sizes[] = {{10, 100, 1000}, {50, 500, 10000}, {200, 2000, 50000}};
+    int number_of_sizes = argc > 1 ? argc - 1 : (int)(sizeof(default_sizes) / sizeof(*default_sizes));
+    for (int i = 0; i < number_of_sizes; i++)
+    {
+        BenchSize size;
+        if (argc == 1)
+        {
+            size = default_sizes[i];
+        }
+        else if (sscanf(argv[i + 1], "%dx%dx%d", &size.tournaments, &size.players, &size.games) != 3 ||
+                 size.tournaments < 1 || size.players < 2 || size.games < 0)
+        {
+            fprintf(stderr, "bench_chess_system: size %s is not TOURNAMENTSxPLAYERSxGAMES, "
+                            "with at least one tournament and two players\n", argv[i + 1]);
+            return 1;
+        }
+        if (benchSize(size) != 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
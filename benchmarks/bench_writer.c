@@ -0,0 +1,130 @@
+/*
+ * bench_writer: compares the fprintf path of the levels export with the fast writer.
+ *
+ * Every formatted line is first checked to be byte identical between the two paths, over
+ * random levels, exact rounding ties (k / 8) and values of the level formula. Then both
+ * paths write the same lines to /dev/null and the time per line is reported.
+ *
+ * Usage: bench_writer [number_of_lines]
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../fast_writer.h"
+
+#define DEFAULT_LINES 2000000
+#define NANOSECONDS 1000000000.0
+#define MAX_GAMES 200
+#define LEVEL_RANGE 10.0
+
+static unsigned long long random_state = 0x9E3779B97F4A7C15ULL;
+
+static unsigned long long nextRandom()
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+
+/**
+ * makeLevel: Returns a level as calulateLevel would, or an exact rounding tie every few values.
+ */
+static double makeLevel(int index)
+{
+    int wins = nextRandom() % MAX_GAMES, losses = nextRandom() % MAX_GAMES, draws = nextRandom() % MAX_GAMES;
+    switch (index % 4)
+    {
+    case 0:
+        return (double)((int)(nextRandom() % 1000) - 500) / 8.0;
+    case 1:
+        return ((double)(nextRandom() % 2000000) / 100000.0) - LEVEL_RANGE;
+    default:
+        return (double)((wins * 6) - (losses * 10) + (draws * 2)) / (wins + losses + draws + 1);
+    }
+}
+
+static double secondsNow()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / NANOSECONDS;
+}
+
+int main(int argc, char **argv)
+{
+    int lines = argc > 1 ? atoi(argv[1]) : DEFAULT_LINES;
+    int *ids = malloc(sizeof(*ids) * lines);
+    double *levels = malloc(sizeof(*levels) * lines);
+    if (ids == NULL || levels == NULL)
+    {
+        return 1;
+    }
+    for (int i = 0; i < lines; i++)
+    {
+        ids[i] = (int)(nextRandom() % 1000000) + 1;
+        levels[i] = makeLevel(i);
+    }
+
+    char *expected = NULL, *actual = NULL;
+    size_t expected_size = 0, actual_size = 0;
+    FILE *expected_file = open_memstream(&expected, &expected_size);
+    FILE *actual_file = open_memstream(&actual, &actual_size);
+    FastWriter writer = fastWriterCreate(actual_file);
+    for (int i = 0; i < lines; i++)
+    {
+        fprintf(expected_file, "%d %.2f\n", ids[i], levels[i]);
+        fastWriterPutInt(writer, ids[i]);
+        fastWriterPutChar(writer, ' ');
+        fastWriterPutFixed2(writer, levels[i]);
+        fastWriterPutChar(writer, '\n');
+    }
+    fastWriterDestroy(writer);
+    fclose(expected_file);
+    fclose(actual_file);
+    int identical = expected_size == actual_size && memcmp(expected, actual, expected_size) == 0;
+    free(expected);
+    free(actual);
+    if (!identical)
+    {
+        fprintf(stderr, "bench_writer: fast writer output differs from fprintf\n");
+        return 1;
+    }
+
+    FILE *sink = fopen("/dev/null", "w");
+    if (sink == NULL)
+    {
+        return 1;
+    }
+    double start = secondsNow();
+    for (int i = 0; i < lines; i++)
+    {
+        fprintf(sink, "%d %.2f\n", ids[i], levels[i]);
+    }
+    fflush(sink);
+    double fprintf_seconds = secondsNow() - start;
+
+    start = secondsNow();
+    writer = fastWriterCreate(sink);
+    for (int i = 0; i < lines; i++)
+    {
+        fastWriterPutInt(writer, ids[i]);
+        fastWriterPutChar(writer, ' ');
+        fastWriterPutFixed2(writer, levels[i]);
+        fastWriterPutChar(writer, '\n');
+    }
+    fastWriterDestroy(writer);
+    fflush(sink);
+    double writer_seconds = secondsNow() - start;
+    fclose(sink);
+
+    printf("lines %d identical yes\n", lines);
+    printf("fprintf ns/line %.1f\n", fprintf_seconds * NANOSECONDS / lines);
+    printf("fast_writer ns/line %.1f\n", writer_seconds * NANOSECONDS / lines);
+    printf("speedup %.2fx\n", fprintf_seconds / writer_seconds);
+    free(ids);
+    free(levels);
+    return 0;
+}
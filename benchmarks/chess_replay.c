@@ -0,0 +1,171 @@
+/*
+ * chess_replay: replays a trace recorded by chessTraceStart against a fresh ChessSystem.
+ *
+ * The whole trace is decoded first, then every call is repeated in order and timed, and its
+ * result (and returned average) is compared with the recorded one. Exports write to /dev/null.
+ * One JSON line is printed per operation with its count, mismatches, and the recorded and
+ * replayed total time, followed by a total line. The exit status is 1 if any result differs.
+ *
+ * Usage: chess_replay trace_file [runs]
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../chess_trace.h"
+
+#define NANOSECONDS 1000000000ULL
+#define INITIAL_CAPACITY 1024
+#define EXPAND 2
+#define SINK_PATH "/dev/null"
+
+typedef struct
+{
+    unsigned long long count;
+    unsigned long long mismatches;
+    unsigned long long recorded_ns;
+    unsigned long long replayed_ns;
+} ReplayTotals;
+
+static unsigned long long nanosecondsNow()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * NANOSECONDS + now.tv_nsec;
+}
+
+/**
+ * replayCall: Repeats one traced call.
+ *
+ * @param chess - The chess system.
+ * @param record - The traced call.
+ * @param sink - The stream the levels export writes to.
+ * @param average_play_time - Where to store the returned average of TRACE_AVERAGE_PLAY_TIME.
+ * @return
+ *     The result of the call.
+ */
+static ChessResult replayCall(ChessSystem chess, const TraceRecord *record, FILE *sink, double *average_play_time)
+{
+    const int *arguments = record->arguments;
+    ChessResult result = CHESS_NULL_ARGUMENT;
+    switch (record->operation)
+    {
+    case TRACE_ADD_TOURNAMENT:
+        return chessAddTournament(chess, arguments[0], arguments[1], record->location);
+    case TRACE_ADD_GAME:
+        return chessAddGame(chess, arguments[0], arguments[1], arguments[2], (Winner)arguments[3], arguments[4]);
+    case TRACE_REMOVE_TOURNAMENT:
+        return chessRemoveTournament(chess, arguments[0]);
+    case TRACE_REMOVE_PLAYER:
+        return chessRemovePlayer(chess, arguments[0]);
+    case TRACE_END_TOURNAMENT:
+        return chessEndTournament(chess, arguments[0]);
+    case TRACE_AVERAGE_PLAY_TIME:
+        *average_play_time = chessCalculateAveragePlayTime(chess, arguments[0], &result);
+        return result;
+    case TRACE_SAVE_LEVELS:
+        return chessSavePlayersLevels(chess, sink);
+    case TRACE_SAVE_STATISTICS:
+        return chessSaveTournamentStatistics(chess, SINK_PATH);
+    default:
+        return result;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: chess_replay trace_file [runs]\n");
+        return 1;
+    }
+    int runs = argc > 2 ? atoi(argv[2]) : 1;
+    TraceReader reader = traceReaderOpen(argv[1]);
+    FILE *sink = fopen(SINK_PATH, "w");
+    size_t capacity = INITIAL_CAPACITY, number_of_records = 0;
+    TraceRecord *records = malloc(sizeof(*records) * capacity);
+    if (reader == NULL || sink == NULL || records == NULL)
+    {
+        fprintf(stderr, "chess_replay: could not read %s\n", argv[1]);
+        return 1;
+    }
+    while (traceReadNext(reader, &records[number_of_records]))
+    {
+        if (++number_of_records == capacity)
+        {
+            capacity *= EXPAND;
+            TraceRecord *new_records = realloc(records, sizeof(*records) * capacity);
+            if (new_records == NULL)
+            {
+                fprintf(stderr, "chess_replay: out of memory\n");
+                return 1;
+            }
+            records = new_records;
+        }
+    }
+
+    ReplayTotals totals[TRACE_OPERATIONS] = {{0}};
+    unsigned long long first_mismatch = 0, mismatches = 0;
+    for (int run = 0; run < runs; run++)
+    {
+        ChessSystem chess = chessCreate();
+        if (chess == NULL)
+        {
+            fprintf(stderr, "chess_replay: out of memory\n");
+            return 1;
+        }
+        for (size_t i = 0; i < number_of_records; i++)
+        {
+            const TraceRecord *record = &records[i];
+            double average_play_time = 0;
+            unsigned long long start = nanosecondsNow();
+            ChessResult result = replayCall(chess, record, sink, &average_play_time);
+            unsigned long long duration = nanosecondsNow() - start;
+            ReplayTotals *operation_totals = &totals[record->operation];
+            operation_totals->count++;
+            operation_totals->recorded_ns += record->duration_ns;
+            operation_totals->replayed_ns += duration;
+            if (result != record->result ||
+                (record->operation == TRACE_AVERAGE_PLAY_TIME && average_play_time != record->average_play_time))
+            {
+                if (mismatches++ == 0)
+                {
+                    first_mismatch = i;
+                }
+                operation_totals->mismatches++;
+            }
+        }
+        chessDestroy(chess);
+    }
+
+    ReplayTotals total = {0, 0, 0, 0};
+    for (int operation = 1; operation < TRACE_OPERATIONS; operation++)
+    {
+        const ReplayTotals *operation_totals = &totals[operation];
+        if (operation_totals->count == 0)
+        {
+            continue;
+        }
+        total.count += operation_totals->count;
+        total.recorded_ns += operation_totals->recorded_ns;
+        total.replayed_ns += operation_totals->replayed_ns;
+        printf("{\"operation\":\"%s\",\"count\":%llu,\"mismatches\":%llu,\"recorded_ns_per_op\":%.1f,"
+               "\"replayed_ns_per_op\":%.1f}\n",
+               traceOperationName(operation), operation_totals->count, operation_totals->mismatches,
+               (double)operation_totals->recorded_ns / operation_totals->count,
+               (double)operation_totals->replayed_ns / operation_totals->count);
+    }
+    printf("{\"operation\":\"total\",\"records\":%zu,\"runs\":%d,\"mismatches\":%llu,\"recorded_seconds\":%.6f,"
+           "\"replayed_seconds\":%.6f}\n",
+           number_of_records, runs, mismatches, (double)total.recorded_ns / NANOSECONDS,
+           (double)total.replayed_ns / NANOSECONDS);
+    if (mismatches > 0)
+    {
+        fprintf(stderr, "chess_replay: %llu results differ, the first at record %llu\n", mismatches, first_mismatch);
+    }
+
+    free(records);
+    traceReaderDestroy(reader);
+    fclose(sink);
+    return mismatches > 0 ? 1 : 0;
+}
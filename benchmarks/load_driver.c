@@ -0,0 +1,170 @@
+/*
+ * load_driver: runs the generated workload against one ChessSystem for a fixed duration.
+ *
+ * Every operation is timed separately and recorded in a log-bucketed latency histogram of
+ * its type (8 buckets per power of two, so a reported latency is at most 12.5% above the
+ * real one). At the end one JSON line is printed per operation type with its count,
+ * throughput, non-success results and p50/p99/p999/max latency, followed by a total line.
+ * Exports write to /dev/null. Built with METRICS=1, the chess system metrics are printed to stderr.
+ *
+ * Usage: load_driver [seconds] [seed] [players]
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "workload.h"
+
+#define NANOSECONDS 1000000000.0
+#define DEFAULT_SECONDS 5.0
+#define SUB_BUCKET_BITS 3
+#define SUB_BUCKETS (1 << SUB_BUCKET_BITS)
+#define HISTOGRAM_BUCKETS (64 * SUB_BUCKETS)
+#define SINK_PATH "/dev/null"
+
+typedef struct
+{
+    unsigned long long buckets[HISTOGRAM_BUCKETS];
+    unsigned long long count;
+    unsigned long long failures;
+    unsigned long long max;
+} Histogram;
+
+static unsigned long long nanosecondsNow()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+ * bucketOf: Returns the histogram bucket of a latency. Latencies below SUB_BUCKETS get a bucket
+ * each, and every following power of two is split into SUB_BUCKETS buckets.
+ */
+static int bucketOf(unsigned long long value)
+{
+    if (value < SUB_BUCKETS)
+    {
+        return (int)value;
+    }
+    int highest_bit = 0;
+    while ((value >> highest_bit) > 1)
+    {
+        highest_bit++;
+    }
+    int shift = highest_bit - SUB_BUCKET_BITS;
+    return ((shift + 1) << SUB_BUCKET_BITS) + (int)((value >> shift) & (SUB_BUCKETS - 1));
+}
+
+/**
+ * bucketUpperBound: Returns the highest latency that falls in a bucket.
+ */
+static unsigned long long bucketUpperBound(int bucket)
+{
+    if (bucket < SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    int shift = (bucket >> SUB_BUCKET_BITS) - 1;
+    unsigned long long mantissa = SUB_BUCKETS + (bucket & (SUB_BUCKETS - 1));
+    return ((mantissa + 1) << shift) - 1;
+}
+
+static void histogramRecord(Histogram *histogram, unsigned long long value, ChessResult result)
+{
+    histogram->buckets[bucketOf(value)]++;
+    histogram->count++;
+    histogram->failures += result != CHESS_SUCCESS;
+    if (value > histogram->max)
+    {
+        histogram->max = value;
+    }
+}
+
+/**
+ * histogramPercentile: Returns the latency below which the given fraction of the recorded
+ * latencies are, rounded up to the bound of its bucket.
+ */
+static unsigned long long histogramPercentile(const Histogram *histogram, double fraction)
+{
+    unsigned long long rank = (unsigned long long)(fraction * histogram->count);
+    if (rank >= histogram->count)
+    {
+        rank = histogram->count - 1;
+    }
+    unsigned long long seen = 0;
+    for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++)
+    {
+        seen += histogram->buckets[bucket];
+        if (seen > rank)
+        {
+            unsigned long long bound = bucketUpperBound(bucket);
+            return bound < histogram->max ? bound : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+int main(int argc, char **argv)
+{
+    WorkloadConfig config;
+    workloadDefaultConfig(&config);
+    double seconds = argc > 1 ? atof(argv[1]) : DEFAULT_SECONDS;
+    if (argc > 2)
+    {
+        config.seed = strtoull(argv[2], NULL, 0);
+    }
+    if (argc > 3)
+    {
+        config.players = atoi(argv[3]);
+    }
+
+    static Histogram histograms[WORKLOAD_OPERATION_TYPES];
+    Workload workload = workloadCreate(&config);
+    ChessSystem chess = chessCreate();
+    FILE *sink = fopen(SINK_PATH, "w");
+    if (workload == NULL || chess == NULL || sink == NULL)
+    {
+        fprintf(stderr, "load_driver: could not set up the run\n");
+        return 1;
+    }
+
+    unsigned long long start = nanosecondsNow(), deadline = start + (unsigned long long)(seconds * NANOSECONDS);
+    unsigned long long now = start;
+    WorkloadOperation operation;
+    while (now < deadline)
+    {
+        workloadNext(workload, &operation);
+        unsigned long long before = nanosecondsNow();
+        ChessResult result = workloadRun(chess, &operation, sink, SINK_PATH);
+        now = nanosecondsNow();
+        histogramRecord(&histograms[operation.type], now - before, result);
+    }
+    double elapsed = (now - start) / NANOSECONDS;
+
+    unsigned long long total = 0;
+    for (int type = 0; type < WORKLOAD_OPERATION_TYPES; type++)
+    {
+        const Histogram *histogram = &histograms[type];
+        total += histogram->count;
+        if (histogram->count == 0)
+        {
+            continue;
+        }
+        printf("{\"operation\":\"%s\",\"count\":%llu,\"ops_per_sec\":%.1f,\"failures\":%llu,"
+               "\"p50_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu,\"max_ns\":%llu}\n",
+               workloadOperationName(type), histogram->count, histogram->count / elapsed, histogram->failures,
+               histogramPercentile(histogram, 0.5), histogramPercentile(histogram, 0.99),
+               histogramPercentile(histogram, 0.999), histogram->max);
+    }
+    printf("{\"operation\":\"total\",\"count\":%llu,\"ops_per_sec\":%.1f,\"seconds\":%.3f,\"seed\":%llu,\"players\":%d}\n",
+           total, total / elapsed, elapsed, config.seed, config.players);
+
+#ifdef CHESS_METRICS
+    chessDumpMetrics(stderr);
+#endif
+    fclose(sink);
+    chessDestroy(chess);
+    workloadDestroy(workload);
+    return 0;
+}
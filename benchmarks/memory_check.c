@@ -0,0 +1,216 @@
+/*
+ * memory_check: checks the memory accounting of the chess system on a fixed workload.
+ *
+ * Tournament t has the players 1 to t + 2, each playing every other player once. After the
+ * games are added, after tournaments end, after a tournament and a player are removed, the
+ * footprint of every tournament from chessMemoryUsage is compared with the sizes and counts
+ * its games, players and keys must have, and the total of the system with the live counters
+ * of chessLiveMemory, which are exact as the process runs one system. After the system is
+ * destroyed the live counters must be back to zero.
+ * One line is printed per failed check, and a summary line. The exit status is 1 if any failed.
+ *
+ * Usage: memory_check
+ */
+#include <stdio.h>
+#include <stdbool.h>
+#include "../chessSystem.h"
+#include "../game_data.h"
+#include "../player_data.h"
+
+#define TOURNAMENTS 6
+#define REMOVED_TOURNAMENT 3
+#define REMOVED_PLAYER 1
+#define LOCATION "London"
+#define PLAY_TIME 30
+
+static const char *category_names[CHESS_MEMORY_CATEGORIES] = {
+    "tournaments", "locations", "games", "players", "keys", "frozen", "ratings", "indexes", "sketches"};
+
+static int failures = 0;
+
+/** The state of a tournament of the workload */
+typedef struct
+{
+    bool removed;
+    bool ended;
+    int players;
+    int games;
+} ExpectedTournament;
+
+/**
+ * fail: Prints a failed check. Tournament 0 stands for the whole system.
+ */
+static void fail(const char *step, int tournament_id, const char *what, const char *unit, size_t found,
+                 size_t expected)
+{
+    printf("%s: tournament %d %s %s is %zu, expected %zu\n", step, tournament_id, what, unit, found, expected);
+    failures++;
+}
+
+/**
+ * checkCategory: Compares the bytes and allocations of a kind of structure in a footprint.
+ */
+static void checkCategory(const char *step, int tournament_id, const ChessMemoryFootprint *footprint,
+                          ChessMemoryCategory category, size_t allocations, size_t allocation_size)
+{
+    if (footprint->allocations[category] != allocations)
+    {
+        fail(step, tournament_id, category_names[category], "allocations", footprint->allocations[category],
+             allocations);
+    }
+    if (footprint->bytes[category] != allocations * allocation_size)
+    {
+        fail(step, tournament_id, category_names[category], "bytes", footprint->bytes[category],
+             allocations * allocation_size);
+    }
+}
+
+/**
+ * checkTournament: Compares the footprint of a tournament with the games, players and keys it must
+ * have. The tournament itself is one allocation, of the same size for every tournament.
+ */
+static void checkTournament(const char *step, const ChessTournamentMemory *memory, const ExpectedTournament *expected,
+                            size_t tournament_size)
+{
+    const ChessMemoryFootprint *footprint = &memory->footprint;
+    int id = memory->tournament_id;
+    checkCategory(step, id, footprint, CHESS_MEMORY_TOURNAMENTS, 1, tournament_size);
+    if (expected->ended)
+    {
+        // The games and players of an ended tournament are frozen, only its key is left in maps
+        checkCategory(step, id, footprint, CHESS_MEMORY_GAMES, 0, gameAllocationSize());
+        checkCategory(step, id, footprint, CHESS_MEMORY_PLAYERS, 0, playerDataAllocationSize());
+        checkCategory(step, id, footprint, CHESS_MEMORY_KEYS, 1, sizeof(int));
+        if (footprint->allocations[CHESS_MEMORY_FROZEN] == 0)
+        {
+            fail(step, id, "frozen", "allocations", 0, 1);
+        }
+        return;
+    }
+    checkCategory(step, id, footprint, CHESS_MEMORY_GAMES, expected->games, gameAllocationSize());
+    checkCategory(step, id, footprint, CHESS_MEMORY_PLAYERS, expected->players, playerDataAllocationSize());
+    checkCategory(step, id, footprint, CHESS_MEMORY_KEYS, 1 + expected->games + expected->players, sizeof(int));
+    checkCategory(step, id, footprint, CHESS_MEMORY_FROZEN, 0, 0);
+}
+
+/**
+ * checkSystem: Checks the footprint of every tournament and that the total of the system is the
+ * live memory.
+ */
+static void checkSystem(const char *step, ChessSystem chess, const ExpectedTournament *expected)
+{
+    ChessMemoryFootprint total, live;
+    ChessTournamentMemory tournaments[TOURNAMENTS];
+    int count;
+    if (chessMemoryUsage(chess, &total, tournaments, TOURNAMENTS, &count) != CHESS_SUCCESS ||
+        chessLiveMemory(&live) != CHESS_SUCCESS)
+    {
+        printf("%s: the memory could not be read\n", step);
+        failures++;
+        return;
+    }
+    int expected_count = 0;
+    for (int t = 1; t <= TOURNAMENTS; t++)
+    {
+        expected_count += expected[t - 1].removed == false;
+    }
+    if (count != expected_count)
+    {
+        fail(step, 0, "tournaments", "count", count, expected_count);
+        return;
+    }
+    size_t tournament_size = tournaments[0].footprint.bytes[CHESS_MEMORY_TOURNAMENTS];
+    for (int i = 0; i < count; i++)
+    {
+        checkTournament(step, &tournaments[i], &expected[tournaments[i].tournament_id - 1], tournament_size);
+    }
+    for (int category = 0; category < CHESS_MEMORY_CATEGORIES; category++)
+    {
+        if (total.bytes[category] != live.bytes[category])
+        {
+            fail(step, 0, category_names[category], "bytes", total.bytes[category], live.bytes[category]);
+        }
+        if (total.allocations[category] != live.allocations[category])
+        {
+            fail(step, 0, category_names[category], "allocations", total.allocations[category],
+                 live.allocations[category]);
+        }
+    }
+}
+
+/**
+ * addTournaments: Adds the tournaments of the workload, with all their games.
+ */
+static bool addTournaments(ChessSystem chess, ExpectedTournament *expected)
+{
+    for (int t = 1; t <= TOURNAMENTS; t++)
+    {
+        int players = t + 2;
+        if (chessAddTournament(chess, t, players, LOCATION) != CHESS_SUCCESS)
+        {
+            return false;
+        }
+        for (int first = 1; first <= players; first++)
+        {
+            for (int second = first + 1; second <= players; second++)
+            {
+                Winner winner = (Winner)((first + second + t) % 3);
+                if (chessAddGame(chess, t, first, second, winner, PLAY_TIME + first) != CHESS_SUCCESS)
+                {
+                    return false;
+                }
+            }
+        }
+        expected[t - 1].removed = false;
+        expected[t - 1].ended = false;
+        expected[t - 1].players = players;
+        expected[t - 1].games = players * (players - 1) / 2;
+    }
+    return true;
+}
+
+int main()
+{
+    ExpectedTournament expected[TOURNAMENTS];
+    ChessSystem chess = chessCreate();
+    if (chess == NULL || addTournaments(chess, expected) == false)
+    {
+        printf("memory_check: the workload could not be added\n");
+        chessDestroy(chess);
+        return 1;
+    }
+    checkSystem("added", chess, expected);
+
+    for (int t = 1; t < REMOVED_TOURNAMENT; t++)
+    {
+        chessEndTournament(chess, t);
+        expected[t - 1].ended = true;
+    }
+    checkSystem("ended", chess, expected);
+
+    chessRemoveTournament(chess, REMOVED_TOURNAMENT);
+    expected[REMOVED_TOURNAMENT - 1].removed = true;
+    checkSystem("removed tournament", chess, expected);
+
+    // The games of the removed player stay in the tournaments that did not end, without him
+    chessRemovePlayer(chess, REMOVED_PLAYER);
+    for (int t = REMOVED_TOURNAMENT + 1; t <= TOURNAMENTS; t++)
+    {
+        expected[t - 1].players--;
+    }
+    checkSystem("removed player", chess, expected);
+
+    chessDestroy(chess);
+    ChessMemoryFootprint live;
+    chessLiveMemory(&live);
+    for (int category = 0; category < CHESS_MEMORY_CATEGORIES; category++)
+    {
+        if (live.bytes[category] != 0 || live.allocations[category] != 0)
+        {
+            fail("destroyed", 0, category_names[category], "bytes", live.bytes[category], 0);
+        }
+    }
+
+    printf("memory_check: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,297 @@
+#include <stdlib.h>
+#include <math.h>
+#include "workload.h"
+
+#define DEFAULT_SEED 0x9E3779B97F4A7C15ULL
+#define PER_MILLE 1000
+#define RANDOM_DOUBLE_BITS 11
+#define RANDOM_DOUBLE_SCALE (1.0 / 9007199254740992.0)
+#define NUMBER_OF_WINNERS 3
+
+static const char *workload_locations[] = {"London", "Tel aviv", "New york", "Paris city", "Berlin", "Haifa"};
+
+struct workload_t
+{
+    WorkloadConfig config;
+    unsigned long long random_state;
+    double *zipf_cdf;
+    int *player_of_rank;
+    int *open;
+    int open_count;
+    int *ended;
+    int ended_first;
+    int ended_count;
+    int next_tournament_id;
+    int burst_tournament;
+    int burst_remaining;
+    long long operations;
+    long long exports;
+};
+
+static unsigned long long nextRandom(Workload workload)
+{
+    workload->random_state ^= workload->random_state << 13;
+    workload->random_state ^= workload->random_state >> 7;
+    workload->random_state ^= workload->random_state << 17;
+    return workload->random_state;
+}
+
+static double nextUniform(Workload workload)
+{
+    return (nextRandom(workload) >> RANDOM_DOUBLE_BITS) * RANDOM_DOUBLE_SCALE;
+}
+
+/**
+ * nextPlayer: Picks a player from the Zipf distribution by binary searching its CDF.
+ *
+ * @param workload - The generator.
+ * @return
+ *     The player id.
+ */
+static int nextPlayer(Workload workload)
+{
+    double target = nextUniform(workload);
+    int low = 0, high = workload->config.players - 1;
+    while (low < high)
+    {
+        int middle = low + (high - low) / 2;
+        if (workload->zipf_cdf[middle] < target)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return workload->player_of_rank[low];
+}
+
+/**
+ * buildPlayers: Fills the Zipf CDF, and shuffles which player id has which rank, so popular
+ * players are not simply the lowest ids.
+ *
+ * @param workload - The generator, whose arrays are allocated.
+ */
+static void buildPlayers(Workload workload)
+{
+    int players = workload->config.players;
+    double total = 0;
+    for (int rank = 0; rank < players; rank++)
+    {
+        total += 1.0 / pow(rank + 1, workload->config.zipf_exponent);
+        workload->zipf_cdf[rank] = total;
+        workload->player_of_rank[rank] = rank + 1;
+    }
+    for (int rank = 0; rank < players; rank++)
+    {
+        workload->zipf_cdf[rank] /= total;
+    }
+    workload->zipf_cdf[players - 1] = 1.0;
+    for (int i = players - 1; i > 0; i--)
+    {
+        int j = (int)(nextRandom(workload) % (i + 1));
+        int temp = workload->player_of_rank[i];
+        workload->player_of_rank[i] = workload->player_of_rank[j];
+        workload->player_of_rank[j] = temp;
+    }
+}
+
+void workloadDefaultConfig(WorkloadConfig *config)
+{
+    if (config == NULL)
+    {
+        return;
+    }
+    config->seed = DEFAULT_SEED;
+    config->players = 5000;
+    config->zipf_exponent = 1.1;
+    config->open_tournaments = 64;
+    config->kept_ended_tournaments = 256;
+    config->max_games_per_player = 200;
+    config->max_burst = 32;
+    config->max_play_time = 3600;
+    config->end_per_mille = 40;
+    config->remove_player_per_mille = 5;
+    config->average_per_mille = 150;
+    config->export_period = 20000;
+}
+
+Workload workloadCreate(const WorkloadConfig *config)
+{
+    if (config == NULL || config->players < 2 || config->open_tournaments < 1 || config->kept_ended_tournaments < 0 ||
+        config->max_games_per_player < 1 || config->max_burst < 1 || config->max_play_time < 0 ||
+        config->end_per_mille + config->remove_player_per_mille + config->average_per_mille > PER_MILLE)
+    {
+        return NULL;
+    }
+    Workload workload = malloc(sizeof(*workload));
+    if (workload == NULL)
+    {
+        return NULL;
+    }
+    workload->config = *config;
+    workload->random_state = config->seed == 0 ? DEFAULT_SEED : config->seed;
+    workload->zipf_cdf = malloc(sizeof(*workload->zipf_cdf) * config->players);
+    workload->player_of_rank = malloc(sizeof(*workload->player_of_rank) * config->players);
+    workload->open = malloc(sizeof(*workload->open) * config->open_tournaments);
+    workload->ended = malloc(sizeof(*workload->ended) * (config->kept_ended_tournaments + 1));
+    if (workload->zipf_cdf == NULL || workload->player_of_rank == NULL || workload->open == NULL || workload->ended == NULL)
+    {
+        workloadDestroy(workload);
+        return NULL;
+    }
+    workload->open_count = 0;
+    workload->ended_first = 0;
+    workload->ended_count = 0;
+    workload->next_tournament_id = 1;
+    workload->burst_tournament = 0;
+    workload->burst_remaining = 0;
+    workload->operations = 0;
+    workload->exports = 0;
+    buildPlayers(workload);
+    return workload;
+}
+
+void workloadDestroy(Workload workload)
+{
+    if (workload == NULL)
+    {
+        return;
+    }
+    free(workload->zipf_cdf);
+    free(workload->player_of_rank);
+    free(workload->open);
+    free(workload->ended);
+    free(workload);
+}
+
+/**
+ * nextGame: Generates a game between two different players in a tournament.
+ */
+static void nextGame(Workload workload, int tournament_id, WorkloadOperation *operation)
+{
+    operation->type = WORKLOAD_ADD_GAME;
+    operation->tournament_id = tournament_id;
+    operation->first_player = nextPlayer(workload);
+    do
+    {
+        operation->second_player = nextPlayer(workload);
+    } while (operation->second_player == operation->first_player);
+    operation->winner = (Winner)(nextRandom(workload) % NUMBER_OF_WINNERS);
+    operation->play_time = (int)(nextRandom(workload) % (workload->config.max_play_time + 1));
+}
+
+/**
+ * endTournament: Moves a random open tournament to the ended ones.
+ */
+static void endTournament(Workload workload, WorkloadOperation *operation)
+{
+    int index = (int)(nextRandom(workload) % workload->open_count);
+    operation->type = WORKLOAD_END_TOURNAMENT;
+    operation->tournament_id = workload->open[index];
+    workload->open[index] = workload->open[--workload->open_count];
+    int capacity = workload->config.kept_ended_tournaments + 1;
+    workload->ended[(workload->ended_first + workload->ended_count++) % capacity] = operation->tournament_id;
+}
+
+void workloadNext(Workload workload, WorkloadOperation *operation)
+{
+    if (workload == NULL || operation == NULL)
+    {
+        return;
+    }
+    workload->operations++;
+    if (workload->config.export_period > 0 && workload->operations % workload->config.export_period == 0)
+    {
+        operation->type = workload->exports++ % 2 == 0 ? WORKLOAD_SAVE_LEVELS : WORKLOAD_SAVE_STATISTICS;
+        return;
+    }
+    if (workload->ended_count > workload->config.kept_ended_tournaments)
+    {
+        operation->type = WORKLOAD_REMOVE_TOURNAMENT;
+        operation->tournament_id = workload->ended[workload->ended_first];
+        workload->ended_first = (workload->ended_first + 1) % (workload->config.kept_ended_tournaments + 1);
+        workload->ended_count--;
+        return;
+    }
+    if (workload->open_count < workload->config.open_tournaments)
+    {
+        int number_of_locations = sizeof(workload_locations) / sizeof(*workload_locations);
+        operation->type = WORKLOAD_ADD_TOURNAMENT;
+        operation->tournament_id = workload->next_tournament_id++;
+        operation->max_games_per_player = workload->config.max_games_per_player;
+        operation->location = workload_locations[nextRandom(workload) % number_of_locations];
+        workload->open[workload->open_count++] = operation->tournament_id;
+        return;
+    }
+    if (workload->burst_remaining > 0)
+    {
+        workload->burst_remaining--;
+        nextGame(workload, workload->burst_tournament, operation);
+        return;
+    }
+
+    int roll = (int)(nextRandom(workload) % PER_MILLE);
+    if (roll < workload->config.end_per_mille)
+    {
+        endTournament(workload, operation);
+    }
+    else if ((roll -= workload->config.end_per_mille) < workload->config.remove_player_per_mille)
+    {
+        operation->type = WORKLOAD_REMOVE_PLAYER;
+        operation->first_player = nextPlayer(workload);
+    }
+    else if ((roll -= workload->config.remove_player_per_mille) < workload->config.average_per_mille)
+    {
+        operation->type = WORKLOAD_AVERAGE_PLAY_TIME;
+        operation->first_player = nextPlayer(workload);
+    }
+    else
+    {
+        workload->burst_tournament = workload->open[nextRandom(workload) % workload->open_count];
+        workload->burst_remaining = (int)(nextRandom(workload) % workload->config.max_burst);
+        nextGame(workload, workload->burst_tournament, operation);
+    }
+}
+
+const char *workloadOperationName(WorkloadOperationType type)
+{
+    static const char *names[WORKLOAD_OPERATION_TYPES] = {
+        "chessAddTournament", "chessAddGame", "chessEndTournament", "chessRemoveTournament",
+        "chessRemovePlayer", "chessCalculateAveragePlayTime", "chessSavePlayersLevels",
+        "chessSaveTournamentStatistics"};
+    if (type < 0 || type >= WORKLOAD_OPERATION_TYPES)
+    {
+        return "unknown";
+    }
+    return names[type];
+}
+
+ChessResult workloadRun(ChessSystem chess, const WorkloadOperation *operation, FILE *sink, char *sink_path)
+{
+    ChessResult result = CHESS_NULL_ARGUMENT;
+    switch (operation->type)
+    {
+    case WORKLOAD_ADD_TOURNAMENT:
+        return chessAddTournament(chess, operation->tournament_id, operation->max_games_per_player, operation->location);
+    case WORKLOAD_ADD_GAME:
+        return chessAddGame(chess, operation->tournament_id, operation->first_player, operation->second_player,
+                            operation->winner, operation->play_time);
+    case WORKLOAD_END_TOURNAMENT:
+        return chessEndTournament(chess, operation->tournament_id);
+    case WORKLOAD_REMOVE_TOURNAMENT:
+        return chessRemoveTournament(chess, operation->tournament_id);
+    case WORKLOAD_REMOVE_PLAYER:
+        return chessRemovePlayer(chess, operation->first_player);
+    case WORKLOAD_AVERAGE_PLAY_TIME:
+        chessCalculateAveragePlayTime(chess, operation->first_player, &result);
+        return result;
+    case WORKLOAD_SAVE_LEVELS:
+        return chessSavePlayersLevels(chess, sink);
+    case WORKLOAD_SAVE_STATISTICS:
+        return chessSaveTournamentStatistics(chess, sink_path);
+    default:
+        return result;
+    }
+}
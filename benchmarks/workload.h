@@ -0,0 +1,127 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+#include "../chessSystem.h"
+
+/*
+* A seeded, deterministic generator of ChessSystem traffic.
+*
+* Players are picked from a Zipf distribution, so a few players play most of the games.
+* Tournaments open over time and a bounded number of them are open at once; games come in
+* bursts into one open tournament, open tournaments end, and old ended tournaments are
+* removed. Players are occasionally removed, average play time is queried, and the levels
+* and statistics are exported periodically. The same seed and configuration always give
+* the same sequence of operations.
+*
+* The following functions are available:
+*   workloadDefaultConfig   - Fills a configuration with the default mix
+*   workloadCreate          - Creates a generator
+*   workloadDestroy         - Deletes a generator
+*   workloadNext            - Generates the next operation
+*   workloadOperationName   - Returns the ChessSystem function an operation type calls
+*   workloadRun             - Runs one operation against a chess system
+*/
+
+/** Type for defining the kinds of generated operations */
+typedef enum {
+    WORKLOAD_ADD_TOURNAMENT,
+    WORKLOAD_ADD_GAME,
+    WORKLOAD_END_TOURNAMENT,
+    WORKLOAD_REMOVE_TOURNAMENT,
+    WORKLOAD_REMOVE_PLAYER,
+    WORKLOAD_AVERAGE_PLAY_TIME,
+    WORKLOAD_SAVE_LEVELS,
+    WORKLOAD_SAVE_STATISTICS,
+    WORKLOAD_OPERATION_TYPES
+} WorkloadOperationType;
+
+/** Type for defining one generated operation. Only the fields of its type are set */
+typedef struct {
+    WorkloadOperationType type;
+    int tournament_id;
+    int max_games_per_player;
+    const char *location;
+    int first_player;
+    int second_player;
+    Winner winner;
+    int play_time;
+} WorkloadOperation;
+
+/** Type for defining the mix of the generated traffic */
+typedef struct {
+    unsigned long long seed;
+    /** players ids are 1..players, player k is picked with weight 1 / k^zipf_exponent */
+    int players;
+    double zipf_exponent;
+    /** tournaments open until this many are open, then one opens when one ends */
+    int open_tournaments;
+    /** ended tournaments beyond this many are removed, oldest first */
+    int kept_ended_tournaments;
+    int max_games_per_player;
+    /** games are added in bursts of 1..max_burst games into one tournament */
+    int max_burst;
+    int max_play_time;
+    /** per mille of the operations between bursts */
+    int end_per_mille;
+    int remove_player_per_mille;
+    int average_per_mille;
+    /** every export_period operations one export runs, levels and statistics alternately */
+    int export_period;
+} WorkloadConfig;
+
+/** Type for defining the generator */
+typedef struct workload_t *Workload;
+
+/**
+* workloadDefaultConfig: Fills a configuration with the default mix.
+*
+* @param config - The configuration to fill.
+*/
+void workloadDefaultConfig(WorkloadConfig *config);
+
+/**
+* workloadCreate: Creates a generator.
+*
+* @param config - The configuration. It is copied.
+* @return
+* 	NULL - if config is NULL, not valid, or allocations failed.
+* 	A new generator otherwise.
+*/
+Workload workloadCreate(const WorkloadConfig *config);
+
+/**
+* workloadDestroy: Deallocates a generator.
+*
+* @param workload - Target generator. If it is NULL nothing will be done.
+*/
+void workloadDestroy(Workload workload);
+
+/**
+* workloadNext: Generates the next operation.
+*
+* @param workload - The generator.
+* @param operation - Where to store the operation.
+*/
+void workloadNext(Workload workload, WorkloadOperation *operation);
+
+/**
+* workloadOperationName: Returns the name of the ChessSystem function an operation type calls.
+*
+* @param type - The operation type.
+* @return
+* 	The function name.
+*/
+const char *workloadOperationName(WorkloadOperationType type);
+
+/**
+* workloadRun: Runs one operation against a chess system.
+*
+* @param chess - The chess system.
+* @param operation - The operation.
+* @param sink - An open, writable stream the levels export writes to.
+* @param sink_path - The file path the statistics export writes to.
+* @return
+* 	The result of the ChessSystem function.
+*/
+ChessResult workloadRun(ChessSystem chess, const WorkloadOperation *operation, FILE *sink, char *sink_path);
+
+#endif
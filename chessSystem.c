@@ -1,19 +1,52 @@
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include "chessSystem.h"
 #include "tournament_data.h"
+#include "chess_journal.h"
+#include "chess_export.h"
+#include "chess_trace.h"
+#include "chess_spans.h"
+#include "chess_rating.h"
+#include "pair_index.h"
+#include "player_games.h"
+#include "id_set.h"
+#include "quantile_sketch.h"
+#include "chess_query.h"
+#include "chess_shard.h"
+#include "chess_metrics_hooks.h"
 
 #define INTIAL_SIZE 50
 #define EXPAND 2
-#define NO_ID -1
 #define WINS_MULTIPLY 6
 #define LOSSES_MULTIPLY 10
 #define DRAWS_MULTIPLY 2
+#define SNAPSHOT_SEQUENCE_VERSION 2
+#define SNAPSHOT_RATINGS_VERSION 3
+#define SNAPSHOT_PENDING_VERSION 4
+#define SNAPSHOT_REMOVED_VERSION 5
+#define TRACE_OFF 0
+#define NO_PLAYER -1
+#define ALL_PLAYERS 0
+#define MEDIAN 0.5
+#define P90 0.9
+#define P99 0.99
 
 struct chess_system_t
 {
     Map tournament_list;
+    LocationTable locations;
     Map total_player_list;
+    Map removed_players;
+    Map pending_statistics;
+    ChessJournal journal;
+    long long sequence;
+    ChessTrace trace;
+    RatingLog rating_log;
+    PairIndex pair_index;
+    PlayerGames player_games;
+    IdSetTable player_tournaments;
+    QuantileSketchTable player_durations;
 };
 
 ChessSystem chessCreate()
@@ -24,19 +57,57 @@ ChessSystem chessCreate()
         return NULL;
     }
     chess_sys->tournament_list = mapCreate(tournamentCopy, keyCopy, tournamentDestroy, keyFree, keyCompare);
-    if (chess_sys->tournament_list == NULL)
+    chess_sys->locations = locationTableCreate();
+    if (chess_sys->tournament_list == NULL || chess_sys->locations == NULL)
     {
+        mapDestroy(chess_sys->tournament_list);
+        locationTableDestroy(chess_sys->locations);
         free(chess_sys);
         return NULL;
     }
 
-    chess_sys->total_player_list = mapCreate(playerDataCopy, keyCopy, playerDataDestroy, keyFree, keyCompare);
+    chess_sys->total_player_list = mapCreate(playerTotalCopy, keyCopy, playerTotalDestroy, keyFree, keyCompare);
     if (chess_sys->total_player_list == NULL)
     {
+        mapDestroy(chess_sys->tournament_list);
+        locationTableDestroy(chess_sys->locations);
+        free(chess_sys);
+        return NULL;
+    }
+    chess_sys->removed_players = mapCreate(playerDataCopy, keyCopy, playerDataDestroy, keyFree, keyCompare);
+    if (chess_sys->removed_players == NULL)
+    {
+        mapDestroy(chess_sys->tournament_list);
+        locationTableDestroy(chess_sys->locations);
+        mapDestroy(chess_sys->total_player_list);
         free(chess_sys);
+        return NULL;
+    }
+    chess_sys->pending_statistics = mapCreate(keyCopy, keyCopy, keyFree, keyFree, keyCompare);
+    chess_sys->rating_log = ratingLogCreate();
+    chess_sys->pair_index = pairIndexCreate();
+    chess_sys->player_games = playerGamesCreate();
+    chess_sys->player_tournaments = idSetTableCreate();
+    chess_sys->player_durations = quantileSketchTableCreate();
+    if (chess_sys->pending_statistics == NULL || chess_sys->rating_log == NULL || chess_sys->pair_index == NULL ||
+        chess_sys->player_games == NULL || chess_sys->player_tournaments == NULL || chess_sys->player_durations == NULL)
+    {
         mapDestroy(chess_sys->tournament_list);
+        locationTableDestroy(chess_sys->locations);
+        mapDestroy(chess_sys->total_player_list);
+        mapDestroy(chess_sys->removed_players);
+        mapDestroy(chess_sys->pending_statistics);
+        ratingLogDestroy(chess_sys->rating_log);
+        pairIndexDestroy(chess_sys->pair_index);
+        playerGamesDestroy(chess_sys->player_games);
+        idSetTableDestroy(chess_sys->player_tournaments);
+        quantileSketchTableDestroy(chess_sys->player_durations);
+        free(chess_sys);
         return NULL;
     }
+    chess_sys->journal = NULL;
+    chess_sys->sequence = 0;
+    chess_sys->trace = NULL;
     return chess_sys;
 }
 
@@ -47,18 +118,135 @@ void chessDestroy(ChessSystem chess)
         return;
     }
 
+    journalClose(chess->journal);
+    traceClose(chess->trace);
     mapDestroy(chess->tournament_list);
+    locationTableDestroy(chess->locations);
     mapDestroy(chess->total_player_list);
+    mapDestroy(chess->removed_players);
+    mapDestroy(chess->pending_statistics);
+    ratingLogDestroy(chess->rating_log);
+    pairIndexDestroy(chess->pair_index);
+    playerGamesDestroy(chess->player_games);
+    idSetTableDestroy(chess->player_tournaments);
+    quantileSketchTableDestroy(chess->player_durations);
     free(chess);
 }
 
-ChessResult chessAddTournament(ChessSystem chess, int tournament_id, int max_games_per_player, const char *tournament_location)
+/**
+ * reserveOperation: Makes room in the journal for the record of a mutating operation, before the
+ * operation changes the system, so an operation that runs out of memory is neither applied nor
+ * journaled.
+ *
+ * @param chess - The chess system.
+ * @param operation - The operation.
+ * @param location - The tournament location, used only by JOURNAL_ADD_TOURNAMENT.
+ * @return
+ *     CHESS_OUT_OF_MEMORY if the room could not be allocated, CHESS_SUCCESS otherwise.
+ */
+static ChessResult reserveOperation(ChessSystem chess, JournalOperation operation, const char *location)
+{
+    if (chess->journal == NULL || journalReserve(chess->journal, operation, location))
+    {
+        return CHESS_SUCCESS;
+    }
+    return CHESS_OUT_OF_MEMORY;
+}
+
+/**
+ * journalOperation: Gives a successful mutating operation the next sequence number, and
+ * appends it to the journal if journaling is on. The room for the record was reserved by
+ * reserveOperation, so only writing the journal can fail.
+ *
+ * @param chess - The chess system.
+ * @param operation - The operation that succeeded.
+ * @param arguments - The int arguments of the operation.
+ * @param location - The tournament location, used only by JOURNAL_ADD_TOURNAMENT.
+ * @return
+ *     CHESS_SAVE_FAILURE if writing the journal failed. The operation stays applied, and the
+ *     journal failed, so the following mutating operations are refused.
+ *     CHESS_SUCCESS otherwise.
+ */
+static ChessResult journalOperation(ChessSystem chess, JournalOperation operation, const int *arguments,
+                                    const char *location)
+{
+    chess->sequence++;
+    if (chess->journal == NULL)
+    {
+        return CHESS_SUCCESS;
+    }
+    JournalRecord record;
+    record.operation = operation;
+    record.sequence = chess->sequence;
+    memcpy(record.arguments, arguments, sizeof(record.arguments));
+    record.location = location;
+    return journalAppend(chess->journal, &record) ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
+
+/**
+ * journalFailed: Returns if the journal of the system failed. The operations after it would be
+ * lost by a recovery, so mutating operations fail until journaling is stopped or restarted.
+ */
+static bool journalFailed(ChessSystem chess)
+{
+    return journalHasFailed(chess->journal);
+}
+
+/**
+ * traceStart: Returns the start time of a call if the system is traced.
+ *
+ * @param chess - The chess system. May be NULL.
+ * @return
+ *     TRACE_OFF if chess is NULL or not traced, the metricsNow time otherwise.
+ */
+static unsigned long long traceStart(ChessSystem chess)
+{
+    if (chess == NULL || chess->trace == NULL)
+    {
+        return TRACE_OFF;
+    }
+    return metricsNow();
+}
+
+/**
+ * traceCall: Appends a finished call to the trace of the system.
+ *
+ * @param chess - The traced chess system.
+ * @param operation - The call.
+ * @param arguments - The int arguments of the call.
+ * @param location - The tournament location, used only by TRACE_ADD_TOURNAMENT.
+ * @param result - The result of the call.
+ * @param average_play_time - The returned average, used only by TRACE_AVERAGE_PLAY_TIME.
+ * @param start_ns - The traceStart time of the call.
+ */
+static void traceCall(ChessSystem chess, TraceOperation operation, const int *arguments, const char *location,
+                      ChessResult result, double average_play_time, unsigned long long start_ns)
+{
+    TraceRecord record;
+    record.operation = operation;
+    memcpy(record.arguments, arguments, sizeof(record.arguments));
+    record.location = location;
+    record.result = result;
+    record.average_play_time = average_play_time;
+    record.duration_ns = metricsNow() - start_ns;
+    traceAppend(chess->trace, &record);
+}
+
+/**
+ * addTournament: chessAddTournament without the metrics, see chessSystem.h.
+ */
+static ChessResult addTournament(ChessSystem chess, int tournament_id, int max_games_per_player, const char *tournament_location)
 {
     if (chess == NULL || chess->tournament_list == NULL || tournament_location == NULL)
     {
         return CHESS_NULL_ARGUMENT;
     }
 
+    if (journalFailed(chess))
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+
     if (tournament_id <= 0)
     {
         return CHESS_INVALID_ID;
@@ -79,7 +267,14 @@ ChessResult chessAddTournament(ChessSystem chess, int tournament_id, int max_gam
         return CHESS_INVALID_MAX_GAMES;
     }
 
-    Tournament tournament_data = tournamentCreate(tournament_location, max_games_per_player);
+    if (reserveOperation(chess, JOURNAL_ADD_TOURNAMENT, tournament_location) != CHESS_SUCCESS)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+
+    SharedLocation location = locationIntern(chess->locations, tournament_location);
+    Tournament tournament_data = tournamentCreate(location, max_games_per_player);
+    locationRelease(location);
     if (tournament_data == NULL)
     {
         return CHESS_OUT_OF_MEMORY;
@@ -91,85 +286,248 @@ ChessResult chessAddTournament(ChessSystem chess, int tournament_id, int max_gam
         return CHESS_OUT_OF_MEMORY;
     }
     tournamentDestroy(tournament_data);
-    return CHESS_SUCCESS;
+    if (locationAddTournament(location, tournament_id) == false)
+    {
+        mapRemove(chess->tournament_list, &tournament_id);
+        return CHESS_OUT_OF_MEMORY;
+    }
+    int arguments[JOURNAL_MAX_ARGUMENTS] = {tournament_id, max_games_per_player};
+    return journalOperation(chess, JOURNAL_ADD_TOURNAMENT, arguments, tournament_location);
 }
 
-ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player, int second_player, Winner winner, int play_time)
+ChessResult chessAddTournament(ChessSystem chess, int tournament_id, int max_games_per_player, const char *tournament_location)
 {
-    if (chess == NULL)
+    METRICS_API_START();
+    unsigned long long trace_start_ns = traceStart(chess);
+    SPAN_BEGIN(api_span);
+    ChessResult result = addTournament(chess, tournament_id, max_games_per_player, tournament_location);
+    SPAN_END(api_span, "chessAddTournament");
+    METRICS_API_STOP(CHESS_METRICS_ADD_TOURNAMENT);
+    if (trace_start_ns != TRACE_OFF)
     {
-        return CHESS_NULL_ARGUMENT;
+        int arguments[TRACE_MAX_ARGUMENTS] = {tournament_id, max_games_per_player};
+        traceCall(chess, TRACE_ADD_TOURNAMENT, arguments, tournament_location, result, 0, trace_start_ns);
     }
+    return result;
+}
 
-    if (tournament_id <= 0 || first_player <= 0 || second_player <= 0 || first_player == second_player)
+/**
+ * updatePlayerTotal: Adds the result of a new game to the system total of a player. A player that
+ * is not in the system yet is added, starting from the stats he kept in ended tournaments if he
+ * was removed before. Those stats stay in removed_players until the game is added.
+ *
+ * @param chess - The chess system.
+ * @param player_id - The player's id.
+ * @param wins - The wins to add.
+ * @param losses - The losses to add.
+ * @param draws - The draws to add.
+ * @return
+ *     NULL - if the player could not be added.
+ *     The total of the player otherwise.
+ */
+static PlayerTotal updatePlayerTotal(ChessSystem chess, int player_id, int wins, int losses, int draws)
+{
+    PlayerTotal total = mapGet(chess->total_player_list, &player_id);
+    if (total == NULL)
     {
-        return CHESS_INVALID_ID;
+        PlayerTotal new_total = playerTotalCreate();
+        if (new_total == NULL)
+        {
+            return NULL;
+        }
+        playerDataAdd(playerTotalStats(new_total), mapGet(chess->removed_players, &player_id), POSITIVE);
+        MapResult result = mapPut(chess->total_player_list, &player_id, new_total);
+        playerTotalDestroy(new_total);
+        if (result != MAP_SUCCESS)
+        {
+            return NULL;
+        }
+        total = mapGet(chess->total_player_list, &player_id);
     }
+    PlayerData stats = playerTotalStats(total);
+    playerSetPoints(stats, wins * TOW_POINTS + draws * ONE_POINT);
+    playerSetWins(stats, wins);
+    playerSetLosses(stats, losses);
+    playerSetDraws(stats, draws);
+    return total;
+}
 
-    if (mapContains(chess->tournament_list, (MapKeyElement)&tournament_id) == false)
+/**
+ * undoPlayerTotal: Subtracts the result of a game that failed to be added from the system total of
+ * a player, removing the total if updatePlayerTotal added it.
+ *
+ * @param chess - The chess system.
+ * @param player_id - The player's id.
+ * @param wins - The wins to subtract.
+ * @param losses - The losses to subtract.
+ * @param draws - The draws to subtract.
+ * @param added - Whether the player was not in the system before the game.
+ */
+static void undoPlayerTotal(ChessSystem chess, int player_id, int wins, int losses, int draws, bool added)
+{
+    if (added)
     {
-        return CHESS_TOURNAMENT_NOT_EXIST;
+        mapRemove(chess->total_player_list, &player_id);
+        return;
     }
+    PlayerData stats = playerTotalStats(mapGet(chess->total_player_list, &player_id));
+    playerSetPoints(stats, -(wins * TOW_POINTS + draws * ONE_POINT));
+    playerSetWins(stats, -wins);
+    playerSetLosses(stats, -losses);
+    playerSetDraws(stats, -draws);
+}
 
-    Tournament tournament = mapGet(chess->tournament_list, (MapKeyElement)&tournament_id);
-    if (tournament == NULL)
+/**
+ * gameResult: Returns the result of a game for one of its players.
+ *
+ * @param winner - The winner of the game.
+ * @param player - FIRST_PLAYER or SECOND_PLAYER, the player the result is for.
+ * @return
+ *     The result of the game for the player.
+ */
+static ChessGameResult gameResult(Winner winner, Winner player)
+{
+    if (winner == DRAW)
     {
-        return CHESS_NULL_ARGUMENT;
+        return CHESS_GAME_DRAW;
     }
+    return winner == player ? CHESS_GAME_WIN : CHESS_GAME_LOSS;
+}
 
-    if (tournamentGetStatus(tournament) == false)
+/**
+ * unindexPlayerGame: Removes a game from the game list and the duration sketch of one of its
+ * players, and the tournament from the tournaments of the player if it was not there before.
+ *
+ * @param chess - The chess system.
+ * @param player_id - The player.
+ * @param tournament_id - The tournament of the game.
+ * @param game_key - The key of the game in the tournament.
+ * @param play_time - The time the game took.
+ * @param had_tournament - Whether the player had games in the tournament before this one.
+ */
+static void unindexPlayerGame(ChessSystem chess, Player_Id player_id, int tournament_id, int game_key,
+                              Time play_time, bool had_tournament)
+{
+    quantileSketchTableRemove(chess->player_durations, player_id, play_time);
+    if (had_tournament == false)
     {
-        return CHESS_TOURNAMENT_ENDED;
+        idSetTableRemove(chess->player_tournaments, player_id, tournament_id);
     }
-    int *key_game = malloc(sizeof(int *));
-    ChessResult result = tournamentAddGame(tournament, winner, first_player, second_player, play_time, key_game);
-    if (result == CHESS_OUT_OF_MEMORY)
+    playerGamesRemoveGame(chess->player_games, player_id, tournament_id, game_key);
+}
+
+/**
+ * indexPlayerGame: Adds a game to the game list and the duration sketch of one of its players, and
+ * the tournament to the tournaments of the player. Nothing is added if an allocation fails.
+ *
+ * @param chess - The chess system.
+ * @param player_id - The player.
+ * @param tournament_id - The tournament of the game.
+ * @param game_key - The key of the game in the tournament.
+ * @param opponent_id - The other player, or DELETE_PLAYER.
+ * @param result - The result of the game for the player.
+ * @param play_time - The time the game took.
+ * @param had_tournament - Whether the player has other games in the tournament.
+ * @return
+ *     false if an allocation failed, true otherwise.
+ */
+static bool indexPlayerGame(ChessSystem chess, Player_Id player_id, int tournament_id, int game_key,
+                            Player_Id opponent_id, ChessGameResult result, Time play_time, bool had_tournament)
+{
+    if (playerGamesAdd(chess->player_games, player_id, tournament_id, game_key, opponent_id, result,
+                       play_time) == false)
     {
-        free(key_game);
-        return CHESS_OUT_OF_MEMORY;
+        return false;
     }
-
-    if (result == CHESS_SUCCESS)
+    if (idSetTableAdd(chess->player_tournaments, player_id, tournament_id) == false)
+    {
+        playerGamesRemoveGame(chess->player_games, player_id, tournament_id, game_key);
+        return false;
+    }
+    if (quantileSketchTableAdd(chess->player_durations, player_id, play_time) == false)
     {
-        PlayerData player1_data = playerDataCreate();
-        if (player1_data == NULL)
+        if (had_tournament == false)
         {
-            gameDestroy(mapGet(tournamentGetGamesMap(tournament), key_game));
-            free(key_game);
-            return CHESS_OUT_OF_MEMORY;
+            idSetTableRemove(chess->player_tournaments, player_id, tournament_id);
         }
+        playerGamesRemoveGame(chess->player_games, player_id, tournament_id, game_key);
+        return false;
+    }
+    return true;
+}
 
-        PlayerData player2_data = playerDataCreate();
-        if (player2_data == NULL)
+/**
+ * indexGame: Adds a game to the pair index, to the game lists and the duration sketches of its players,
+ * and the tournament to the tournaments of its players. A player removed from the game is left out.
+ * Nothing is added if an allocation fails.
+ *
+ * @param chess - The chess system.
+ * @param tournament_id - The tournament of the game.
+ * @param game_key - The key of the game in the tournament.
+ * @param first_player - The first player, or DELETE_PLAYER.
+ * @param second_player - The second player, or DELETE_PLAYER.
+ * @param winner - The winner of the game.
+ * @param play_time - The time the game took.
+ * @param ended - Whether the tournament already ended.
+ * @return
+ *     false if an allocation failed, true otherwise.
+ */
+static bool indexGame(ChessSystem chess, int tournament_id, int game_key, Player_Id first_player,
+                      Player_Id second_player, Winner winner, Time play_time, bool ended)
+{
+    bool paired = first_player != DELETE_PLAYER && second_player != DELETE_PLAYER;
+    bool first_had_tournament = idSetContains(idSetTableGet(chess->player_tournaments, first_player), tournament_id);
+    bool second_had_tournament = idSetContains(idSetTableGet(chess->player_tournaments, second_player),
+                                               tournament_id);
+    if (paired &&
+        pairIndexAdd(chess->pair_index, tournament_id, first_player, second_player, winner, play_time, ended) == false)
+    {
+        return false;
+    }
+    if (first_player != DELETE_PLAYER &&
+        indexPlayerGame(chess, first_player, tournament_id, game_key, second_player, gameResult(winner, FIRST_PLAYER),
+                        play_time, first_had_tournament) == false)
+    {
+        if (paired)
         {
-            gameDestroy(mapGet(tournamentGetGamesMap(tournament), key_game));
-            free(key_game);
-            playerDataDestroy(player1_data);
-            return CHESS_OUT_OF_MEMORY;
+            pairIndexRemoveLast(chess->pair_index, first_player, second_player);
         }
-
-        if (mapPut(chess->total_player_list, &first_player, player1_data) != MAP_SUCCESS ||
-            mapPut(chess->total_player_list, &second_player, player2_data) != MAP_SUCCESS)
+        return false;
+    }
+    if (second_player != DELETE_PLAYER &&
+        indexPlayerGame(chess, second_player, tournament_id, game_key, first_player, gameResult(winner, SECOND_PLAYER),
+                        play_time, second_had_tournament) == false)
+    {
+        if (first_player != DELETE_PLAYER)
         {
-            gameDestroy(mapGet(tournamentGetGamesMap(tournament), key_game));
-            result = CHESS_OUT_OF_MEMORY;
+            unindexPlayerGame(chess, first_player, tournament_id, game_key, play_time, first_had_tournament);
         }
-
-        playerDataDestroy(player1_data);
-        playerDataDestroy(player2_data);
+        if (paired)
+        {
+            pairIndexRemoveLast(chess->pair_index, first_player, second_player);
+        }
+        return false;
     }
-    free(key_game);
-    return result;
+    return true;
 }
 
-ChessResult chessRemoveTournament(ChessSystem chess, int tournament_id)
+/**
+ * addGame: chessAddGame without the metrics, see chessSystem.h.
+ */
+static ChessResult addGame(ChessSystem chess, int tournament_id, int first_player, int second_player, Winner winner, int play_time)
 {
+    SPAN_BEGIN(validate_span);
     if (chess == NULL)
     {
         return CHESS_NULL_ARGUMENT;
     }
 
-    if (tournament_id <= 0)
+    if (journalFailed(chess))
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+
+    if (tournament_id <= 0 || first_player <= 0 || second_player <= 0 || first_player == second_player)
     {
         return CHESS_INVALID_ID;
     }
@@ -179,48 +537,143 @@ ChessResult chessRemoveTournament(ChessSystem chess, int tournament_id)
         return CHESS_TOURNAMENT_NOT_EXIST;
     }
 
-    mapRemove(chess->tournament_list, &tournament_id);
-    return CHESS_SUCCESS;
-}
-
-ChessResult chessRemovePlayer(ChessSystem chess, int player_id)
-{
-    if (chess == NULL)
+    Tournament tournament = mapGet(chess->tournament_list, (MapKeyElement)&tournament_id);
+    if (tournament == NULL)
     {
         return CHESS_NULL_ARGUMENT;
     }
 
-    if (player_id <= 0)
+    if (tournamentGetStatus(tournament) == false)
     {
-        return CHESS_INVALID_ID;
+        return CHESS_TOURNAMENT_ENDED;
     }
 
-    if (mapContains(chess->total_player_list, &player_id) == false)
+    if (reserveOperation(chess, JOURNAL_ADD_GAME, NULL) != CHESS_SUCCESS)
     {
-        return CHESS_PLAYER_NOT_EXIST;
+        return CHESS_OUT_OF_MEMORY;
+    }
+    SPAN_END(validate_span, "addGame.validate");
+    SPAN_BEGIN(tournament_span);
+    int key_game;
+    ChessResult result = tournamentAddGame(tournament, winner, first_player, second_player, play_time, &key_game);
+    SPAN_END(tournament_span, "tournamentAddGame");
+    if (result == CHESS_OUT_OF_MEMORY)
+    {
+        return CHESS_OUT_OF_MEMORY;
     }
 
-    MAP_FOREACH(MapKeyElement, tournament_key, chess->tournament_list)
+    SPAN_BEGIN(players_span);
+    if (result == CHESS_SUCCESS)
     {
-        Tournament temporary_tournament = mapGet(chess->tournament_list, tournament_key);
-        if (tournamentGetStatus(temporary_tournament) && tournamentIsPlayerExist(temporary_tournament, player_id))
+        int first_wins = winner == FIRST_PLAYER, second_wins = winner == SECOND_PLAYER, draw = winner == DRAW;
+        bool first_added = mapContains(chess->total_player_list, &first_player) == false;
+        bool second_added = mapContains(chess->total_player_list, &second_player) == false;
+        PlayerTotal first_total = updatePlayerTotal(chess, first_player, first_wins, second_wins, draw);
+        PlayerTotal second_total = first_total == NULL ? NULL :
+                                  updatePlayerTotal(chess, second_player, second_wins, first_wins, draw);
+        bool logged = second_total != NULL &&
+                      ratingLogAppend(chess->rating_log, tournament_id, first_player, second_player, winner);
+        if (logged == false ||
+            indexGame(chess, tournament_id, key_game, first_player, second_player, winner, play_time, false) == false)
+        {
+            // Undone in reverse order, so a failed game leaves the system as it was
+            if (logged)
+            {
+                ratingLogRemoveLast(chess->rating_log);
+            }
+            if (second_total != NULL)
+            {
+                undoPlayerTotal(chess, second_player, second_wins, first_wins, draw, second_added);
+            }
+            if (first_total != NULL)
+            {
+                undoPlayerTotal(chess, first_player, first_wins, second_wins, draw, first_added);
+            }
+            tournamentRemoveLastGame(tournament);
+            result = CHESS_OUT_OF_MEMORY;
+        }
+        else
         {
-            tournamentRemovePlayer(temporary_tournament, player_id);
+            if (first_added)
+            {
+                mapRemove(chess->removed_players, &first_player);
+            }
+            if (second_added)
+            {
+                mapRemove(chess->removed_players, &second_player);
+            }
+            double change = ratingChange(playerGetRating(first_total), playerGetRating(second_total), winner);
+            playerSetRating(first_total, playerGetRating(first_total) + change);
+            playerSetRating(second_total, playerGetRating(second_total) - change);
         }
-        keyFree(tournament_key);
     }
+    SPAN_END(players_span, "addGame.updatePlayers");
+    if (result == CHESS_SUCCESS)
+    {
+        int arguments[JOURNAL_MAX_ARGUMENTS] = {tournament_id, first_player, second_player, winner, play_time};
+        result = journalOperation(chess, JOURNAL_ADD_GAME, arguments, NULL);
+    }
+    return result;
+}
 
-    mapRemove(chess->total_player_list, &player_id);
-    return CHESS_SUCCESS;
+ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player, int second_player, Winner winner, int play_time)
+{
+    METRICS_API_START();
+    unsigned long long trace_start_ns = traceStart(chess);
+    SPAN_BEGIN(api_span);
+    ChessResult result = addGame(chess, tournament_id, first_player, second_player, winner, play_time);
+    SPAN_END(api_span, "chessAddGame");
+    METRICS_API_STOP(CHESS_METRICS_ADD_GAME);
+    if (trace_start_ns != TRACE_OFF)
+    {
+        int arguments[TRACE_MAX_ARGUMENTS] = {tournament_id, first_player, second_player, winner, play_time};
+        traceCall(chess, TRACE_ADD_GAME, arguments, NULL, result, 0, trace_start_ns);
+    }
+    return result;
 }
 
-ChessResult chessEndTournament(ChessSystem chess, int tournament_id)
+/** The duration sketches to remove games from, and the player whose games are removed */
+typedef struct
+{
+    QuantileSketchTable durations;
+    Player_Id player;
+} DurationRemoval;
+
+/**
+ * removeGameDurations: TournamentGameVisitor that removes the time of a game from the duration
+ * sketches of its players, or only of one player if the removal has one.
+ */
+static bool removeGameDurations(void *context, const TournamentGame *game)
+{
+    DurationRemoval *removal = context;
+    if (game->first_player != DELETE_PLAYER &&
+        (removal->player == ALL_PLAYERS || removal->player == game->first_player))
+    {
+        quantileSketchTableRemove(removal->durations, game->first_player, game->play_time);
+    }
+    if (game->second_player != DELETE_PLAYER &&
+        (removal->player == ALL_PLAYERS || removal->player == game->second_player))
+    {
+        quantileSketchTableRemove(removal->durations, game->second_player, game->play_time);
+    }
+    return true;
+}
+
+/**
+ * removeTournament: chessRemoveTournament without the metrics, see chessSystem.h.
+ */
+static ChessResult removeTournament(ChessSystem chess, int tournament_id)
 {
     if (chess == NULL)
     {
         return CHESS_NULL_ARGUMENT;
     }
 
+    if (journalFailed(chess))
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+
     if (tournament_id <= 0)
     {
         return CHESS_INVALID_ID;
@@ -231,42 +684,337 @@ ChessResult chessEndTournament(ChessSystem chess, int tournament_id)
         return CHESS_TOURNAMENT_NOT_EXIST;
     }
 
-    Tournament tournament = mapGet(chess->tournament_list, (MapKeyElement)&tournament_id);
-    return tournamentEnd(tournament);
-}
-
-double chessCalculateAveragePlayTime(ChessSystem chess, int player_id, ChessResult *chess_result)
-{
-    if (chess == NULL)
-    {
-        *chess_result = CHESS_NULL_ARGUMENT;
-        return 0;
-    }
-    if (player_id <= 0)
+    if (reserveOperation(chess, JOURNAL_REMOVE_TOURNAMENT, NULL) != CHESS_SUCCESS)
     {
-        *chess_result = CHESS_INVALID_ID;
-        return 0;
+        return CHESS_OUT_OF_MEMORY;
     }
-    if (mapContains(chess->total_player_list, &player_id) == false)
+
+    Map tournament_players = mapCreate(playerDataCopy, keyCopy, playerDataDestroy, keyFree, keyCompare);
+    if (tournament_players == NULL ||
+        tournamentCopyPlayersToMap(mapGet(chess->tournament_list, &tournament_id), tournament_players) != CHESS_SUCCESS)
     {
-        *chess_result = CHESS_PLAYER_NOT_EXIST;
-        return 0;
+        mapDestroy(tournament_players);
+        return CHESS_OUT_OF_MEMORY;
     }
-    double total_time = 0;
-    int number_of_games = 0;
-    MAP_FOREACH(MapKeyElement, tournament_key, chess->tournament_list)
+    MAP_FOREACH(MapKeyElement, player_id, tournament_players)
     {
-        total_time += tournamentPlayerTotalTime(mapGet(chess->tournament_list, (MapKeyElement)tournament_key),
-                                                player_id, &number_of_games);
-        keyFree(tournament_key);
+        playerGamesRemoveTournament(chess->player_games, *(int *)player_id, tournament_id);
+        idSetTableRemove(chess->player_tournaments, *(int *)player_id, tournament_id);
+        PlayerData total = playerTotalStats(mapGet(chess->total_player_list, player_id));
+        if (total != NULL)
+        {
+            playerDataAdd(total, mapGet(tournament_players, player_id), NEGATIVE);
+        }
+        else if ((total = mapGet(chess->removed_players, player_id)) != NULL)
+        {
+            playerDataAdd(total, mapGet(tournament_players, player_id), NEGATIVE);
+            if (playerHasGames(total) == false)
+            {
+                mapRemove(chess->removed_players, player_id);
+            }
+        }
+        keyFree(player_id);
     }
-    *chess_result = CHESS_SUCCESS;
-    if (total_time == 0)
+    mapDestroy(tournament_players);
+    DurationRemoval removal = {chess->player_durations, ALL_PLAYERS};
+    tournamentForEachGame(mapGet(chess->tournament_list, &tournament_id), removeGameDurations, &removal);
+    // The games stay rated, as the ratings they gave are not taken back
+    ratingLogEndTournament(chess->rating_log, tournament_id);
+    pairIndexRemoveTournament(chess->pair_index, tournament_id);
+    locationRemoveTournament(tournamentGetSharedLocation(mapGet(chess->tournament_list, &tournament_id)), tournament_id);
+
+    mapRemove(chess->tournament_list, &tournament_id);
+    mapRemove(chess->pending_statistics, &tournament_id);
+    int arguments[JOURNAL_MAX_ARGUMENTS] = {tournament_id};
+    return journalOperation(chess, JOURNAL_REMOVE_TOURNAMENT, arguments, NULL);
+}
+
+ChessResult chessRemoveTournament(ChessSystem chess, int tournament_id)
+{
+    METRICS_API_START();
+    unsigned long long trace_start_ns = traceStart(chess);
+    SPAN_BEGIN(api_span);
+    ChessResult result = removeTournament(chess, tournament_id);
+    SPAN_END(api_span, "chessRemoveTournament");
+    METRICS_API_STOP(CHESS_METRICS_REMOVE_TOURNAMENT);
+    if (trace_start_ns != TRACE_OFF)
     {
-        return total_time;
+        int arguments[TRACE_MAX_ARGUMENTS] = {tournament_id};
+        traceCall(chess, TRACE_REMOVE_TOURNAMENT, arguments, NULL, result, 0, trace_start_ns);
     }
-
-    return total_time / number_of_games;
+    return result;
+}
+
+/**
+ * addForfeitRating: RatingForfeitVisitor that adds the change of a win given by a removal to the
+ * rating of the opponent, in the system totals.
+ */
+static void addForfeitRating(void *context, int player_id, double change)
+{
+    PlayerTotal total = mapGet(context, &player_id);
+    playerSetRating(total, playerGetRating(total) + change);
+}
+
+/** A player removed from the pair index, passed to removePlayerPairs */
+typedef struct
+{
+    PairIndex pair_index;
+    int tournament_id;
+    int player_id;
+} PairRemoval;
+
+/**
+ * removePlayerPairs: PlayerOpponentVisitor that removes the games of a removed player against one
+ * of his opponents from the pair index.
+ */
+static void removePlayerPairs(void *context, int opponent_id)
+{
+    PairRemoval *removal = context;
+    pairIndexRemovePair(removal->pair_index, removal->tournament_id, removal->player_id, opponent_id);
+}
+
+/**
+ * removePlayer: chessRemovePlayer without the metrics, see chessSystem.h.
+ */
+static ChessResult removePlayer(ChessSystem chess, int player_id)
+{
+    if (chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+
+    if (journalFailed(chess))
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+
+    if (player_id <= 0)
+    {
+        return CHESS_INVALID_ID;
+    }
+
+    if (mapContains(chess->total_player_list, &player_id) == false)
+    {
+        return CHESS_PLAYER_NOT_EXIST;
+    }
+
+    if (reserveOperation(chess, JOURNAL_REMOVE_PLAYER, NULL) != CHESS_SUCCESS)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+
+    // Every game of the player can give his opponent a win in the rating history, followed by
+    // the reset of the player, so the room for them is made before anything changes
+    PlayerData total = playerTotalStats(mapGet(chess->total_player_list, &player_id));
+    int number_of_games = playerGetWins(total) + playerGetLosses(total) + playerGetDraws(total);
+    if (ratingLogReserve(chess->rating_log, number_of_games + 1) == false)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+
+    // The tournaments of the player are copied, as removing him from them changes his set
+    IdSet player_tournaments = idSetTableGet(chess->player_tournaments, player_id);
+    int number_of_tournaments = idSetSize(player_tournaments);
+    int *tournament_ids = malloc(sizeof(*tournament_ids) * number_of_tournaments + 1);
+    if (tournament_ids == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    idSetCopyIds(player_tournaments, tournament_ids, number_of_tournaments);
+
+    // The stats the player keeps from ended tournaments go to removed_players. The entry is added
+    // first, so running out of memory leaves the player as he was
+    if (mapPut(chess->removed_players, &player_id, total) != MAP_SUCCESS)
+    {
+        free(tournament_ids);
+        return CHESS_OUT_OF_MEMORY;
+    }
+
+    for (int i = 0; i < number_of_tournaments; i++)
+    {
+        int tournament_id = tournament_ids[i];
+        Tournament tournament = mapGet(chess->tournament_list, &tournament_id);
+        if (tournamentGetStatus(tournament))
+        {
+            PairRemoval pairs = {chess->pair_index, tournament_id, player_id};
+            playerGamesRemovePlayer(chess->player_games, player_id, tournament_id, removePlayerPairs, &pairs);
+            idSetTableRemove(chess->player_tournaments, player_id, tournament_id);
+            DurationRemoval removal = {chess->player_durations, player_id};
+            tournamentForEachGame(tournament, removeGameDurations, &removal);
+            tournamentRemovePlayer(tournament, player_id, chess->total_player_list);
+            ratingLogRemovePlayer(chess->rating_log, tournament_id, player_id, addForfeitRating,
+                                  chess->total_player_list);
+        }
+    }
+    free(tournament_ids);
+    ratingLogResetPlayer(chess->rating_log, player_id);
+
+    // What is left of the total was played in ended tournaments, and counts again if the player returns
+    PlayerData removed_total = mapGet(chess->removed_players, &player_id);
+    playerDataClear(removed_total);
+    playerDataAdd(removed_total, playerTotalStats(mapGet(chess->total_player_list, &player_id)), POSITIVE);
+    if (playerHasGames(removed_total) == false)
+    {
+        mapRemove(chess->removed_players, &player_id);
+    }
+    mapRemove(chess->total_player_list, &player_id);
+    int arguments[JOURNAL_MAX_ARGUMENTS] = {player_id};
+    return journalOperation(chess, JOURNAL_REMOVE_PLAYER, arguments, NULL);
+}
+
+ChessResult chessRemovePlayer(ChessSystem chess, int player_id)
+{
+    METRICS_API_START();
+    unsigned long long trace_start_ns = traceStart(chess);
+    SPAN_BEGIN(api_span);
+    ChessResult result = removePlayer(chess, player_id);
+    SPAN_END(api_span, "chessRemovePlayer");
+    METRICS_API_STOP(CHESS_METRICS_REMOVE_PLAYER);
+    if (trace_start_ns != TRACE_OFF)
+    {
+        int arguments[TRACE_MAX_ARGUMENTS] = {player_id};
+        traceCall(chess, TRACE_REMOVE_PLAYER, arguments, NULL, result, 0, trace_start_ns);
+    }
+    return result;
+}
+
+/**
+ * endTournament: chessEndTournament without the metrics, see chessSystem.h.
+ */
+static ChessResult endTournament(ChessSystem chess, int tournament_id)
+{
+    if (chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+
+    if (journalFailed(chess))
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+
+    if (tournament_id <= 0)
+    {
+        return CHESS_INVALID_ID;
+    }
+
+    if (mapContains(chess->tournament_list, (MapKeyElement)&tournament_id) == false)
+    {
+        return CHESS_TOURNAMENT_NOT_EXIST;
+    }
+
+    if (reserveOperation(chess, JOURNAL_END_TOURNAMENT, NULL) != CHESS_SUCCESS)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+
+    Tournament tournament = mapGet(chess->tournament_list, (MapKeyElement)&tournament_id);
+    // A running tournament is not pending. It is added before it ends, so running out of memory
+    // leaves it running, and removed again if it cannot end
+    bool running = tournamentGetStatus(tournament);
+    if (running && mapPut(chess->pending_statistics, &tournament_id, &tournament_id) != MAP_SUCCESS)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    ChessResult result = tournamentEnd(tournament);
+    if (result != CHESS_SUCCESS)
+    {
+        if (running)
+        {
+            mapRemove(chess->pending_statistics, &tournament_id);
+        }
+        return result;
+    }
+    tournamentFreeze(tournament);
+    ratingLogEndTournament(chess->rating_log, tournament_id);
+    pairIndexEndTournament(chess->pair_index, tournament_id);
+    int arguments[JOURNAL_MAX_ARGUMENTS] = {tournament_id};
+    return journalOperation(chess, JOURNAL_END_TOURNAMENT, arguments, NULL);
+}
+
+ChessResult chessEndTournament(ChessSystem chess, int tournament_id)
+{
+    METRICS_API_START();
+    unsigned long long trace_start_ns = traceStart(chess);
+    SPAN_BEGIN(api_span);
+    ChessResult result = endTournament(chess, tournament_id);
+    SPAN_END(api_span, "chessEndTournament");
+    METRICS_API_STOP(CHESS_METRICS_END_TOURNAMENT);
+    if (trace_start_ns != TRACE_OFF)
+    {
+        int arguments[TRACE_MAX_ARGUMENTS] = {tournament_id};
+        traceCall(chess, TRACE_END_TOURNAMENT, arguments, NULL, result, 0, trace_start_ns);
+    }
+    return result;
+}
+
+/**
+ * playerTotalTime: Returns the total play time of a player's games in all the tournaments of a system,
+ * including the ended tournaments the player kept games in after being removed.
+ *
+ * @param chess - The chess system.
+ * @param player_id - The player's id.
+ * @param number_of_games - Where to add the number of games of the player.
+ * @return
+ *     The total play time.
+ */
+static double playerTotalTime(ChessSystem chess, int player_id, int *number_of_games)
+{
+    double total_time = 0;
+    MAP_FOREACH(MapKeyElement, tournament_key, chess->tournament_list)
+    {
+        total_time += tournamentPlayerTotalTime(mapGet(chess->tournament_list, (MapKeyElement)tournament_key),
+                                                player_id, number_of_games);
+        keyFree(tournament_key);
+    }
+    return total_time;
+}
+
+/**
+ * calculateAveragePlayTime: chessCalculateAveragePlayTime without the metrics, see chessSystem.h.
+ */
+static double calculateAveragePlayTime(ChessSystem chess, int player_id, ChessResult *chess_result)
+{
+    if (chess == NULL)
+    {
+        *chess_result = CHESS_NULL_ARGUMENT;
+        return 0;
+    }
+    if (player_id <= 0)
+    {
+        *chess_result = CHESS_INVALID_ID;
+        return 0;
+    }
+    if (mapContains(chess->total_player_list, &player_id) == false)
+    {
+        *chess_result = CHESS_PLAYER_NOT_EXIST;
+        return 0;
+    }
+    int number_of_games = 0;
+    double total_time = playerTotalTime(chess, player_id, &number_of_games);
+    *chess_result = CHESS_SUCCESS;
+    if (total_time == 0)
+    {
+        return total_time;
+    }
+
+    return total_time / number_of_games;
+}
+
+double chessCalculateAveragePlayTime(ChessSystem chess, int player_id, ChessResult *chess_result)
+{
+    METRICS_API_START();
+    unsigned long long trace_start_ns = traceStart(chess);
+    SPAN_BEGIN(api_span);
+    double result = calculateAveragePlayTime(chess, player_id, chess_result);
+    SPAN_END(api_span, "chessCalculateAveragePlayTime");
+    METRICS_API_STOP(CHESS_METRICS_AVERAGE_PLAY_TIME);
+    if (trace_start_ns != TRACE_OFF)
+    {
+        int arguments[TRACE_MAX_ARGUMENTS] = {player_id};
+        traceCall(chess, TRACE_AVERAGE_PLAY_TIME, arguments, NULL, chess_result == NULL ? CHESS_NULL_ARGUMENT : *chess_result, result, trace_start_ns);
+    }
+    return result;
 }
 
 /**
@@ -285,9 +1033,22 @@ static double calulateLevel(int wins, int losses, int draws)
     return (double)(((wins * WINS_MULTIPLY) - (losses * LOSSES_MULTIPLY) + (draws * DRAWS_MULTIPLY)) / totalGames);
 }
 
+/**
+ * playerLevel: Returns the level of a player by calulateLevel.
+ *
+ * @param total - The player's total.
+ * @return
+ *     The player's level.
+ */
+static double playerLevel(PlayerTotal total)
+{
+    PlayerData stats = playerTotalStats(total);
+    return calulateLevel(playerGetWins(stats), playerGetLosses(stats), playerGetDraws(stats));
+}
+
 /**
  * CreatePlayerMap: The function gets an empty map and fills it with players stats 
- * that play in a specific chess system.
+ * that play in a specific chess system. Used to rebuild the totals of a loaded system.
  *
  * @param chess - The chess System we check.
  * @param total_player_map - The map we want to fill.
@@ -316,132 +1077,1387 @@ static ChessResult CreatePlayerMap(ChessSystem chess, Map total_player_map)
     return CHESS_SUCCESS;
 }
 
-ChessResult chessSavePlayersLevels(ChessSystem chess, FILE *file)
+/**
+ * captureLevelRows: Captures the level of every player in the system that played at least one game,
+ * in id order, from the totals kept up to date by every game and removal.
+ *
+ * @param chess - The chess system.
+ * @param score - Returns the value of a player in the rows, playerLevel or playerGetRating.
+ * @param rows - Where to store the rows, allocated with malloc.
+ * @param count - Where to store the number of rows.
+ * @return
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - otherwise.
+ */
+static ChessResult captureLevelRows(ChessSystem chess, double (*score)(PlayerTotal), ExportLevelRow **rows, int *count)
+{
+    SPAN_BEGIN(capture_span);
+    *rows = malloc(sizeof(**rows) * (mapGetSize(chess->total_player_list) + 1));
+    if (*rows == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    *count = 0;
+    MAP_FOREACH(MapKeyElement, player_id, chess->total_player_list)
+    {
+        PlayerTotal total = mapGet(chess->total_player_list, player_id);
+        if (playerHasGames(playerTotalStats(total)))
+        {
+            (*rows)[*count].player_id = *(int *)player_id;
+            (*rows)[(*count)++].level = score(total);
+        }
+        keyFree(player_id);
+    }
+    SPAN_END(capture_span, "captureLevelRows");
+    return CHESS_SUCCESS;
+}
+
+/**
+ * savePlayersScores: Prints the players that played at least one game, by a score from the highest,
+ * in the format of chessSavePlayersLevels.
+ *
+ * @param chess - The chess system.
+ * @param file - The output stream.
+ * @param score - Returns the score of a player, playerLevel or playerGetRating.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or file are NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if an error occurred while saving.
+ *     CHESS_SUCCESS - otherwise.
+ */
+static ChessResult savePlayersScores(ChessSystem chess, FILE *file, double (*score)(PlayerTotal))
 {
     if (file == NULL || chess == NULL)
     {
         return CHESS_NULL_ARGUMENT;
     }
 
-    Map total_player_map = mapCreate(playerDataCopy, keyCopy, playerDataDestroy, keyFree, keyCompare);
-    if (total_player_map == NULL)
+    ExportLevelRow *rows;
+    int count;
+    if (captureLevelRows(chess, score, &rows, &count) != CHESS_SUCCESS)
     {
         return CHESS_OUT_OF_MEMORY;
     }
+    SPAN_BEGIN(sort_span);
+    exportSortLevels(rows, count);
+    SPAN_END(sort_span, "exportSortLevels");
+    SPAN_BEGIN(write_span);
+    ChessResult result = exportWriteLevels(file, rows, count);
+    SPAN_END(write_span, "exportWriteLevels");
+    free(rows);
+    return result;
+}
+
+/**
+ * savePlayersLevels: chessSavePlayersLevels without the metrics, see chessSystem.h.
+ */
+static ChessResult savePlayersLevels(ChessSystem chess, FILE *file)
+{
+    return savePlayersScores(chess, file, playerLevel);
+}
+
+ChessResult chessSavePlayersLevels(ChessSystem chess, FILE *file)
+{
+    METRICS_API_START();
+    unsigned long long trace_start_ns = traceStart(chess);
+    SPAN_BEGIN(api_span);
+    ChessResult result = savePlayersLevels(chess, file);
+    SPAN_END(api_span, "chessSavePlayersLevels");
+    METRICS_API_STOP(CHESS_METRICS_SAVE_LEVELS);
+    if (trace_start_ns != TRACE_OFF)
+    {
+        int arguments[TRACE_MAX_ARGUMENTS] = {0};
+        traceCall(chess, TRACE_SAVE_LEVELS, arguments, NULL, result, 0, trace_start_ns);
+    }
+    return result;
+}
+
+ChessResult chessSavePlayersLevelsAsync(ChessSystem chess, FILE *file, ChessExport *export_handle)
+{
+    if (file == NULL || chess == NULL || export_handle == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
 
-    if (CreatePlayerMap(chess, total_player_map) != CHESS_SUCCESS)
+    ExportLevelRow *rows;
+    int count;
+    if (captureLevelRows(chess, playerLevel, &rows, &count) != CHESS_SUCCESS)
     {
-        mapDestroy(total_player_map);
         return CHESS_OUT_OF_MEMORY;
     }
-    int map_size = mapGetSize(total_player_map);
-    Player_Id max_id = NO_ID;
-    double max_level = 0, level;
-    bool first;
-    PlayerData p_data;
-    for (int i = 0; i < map_size; i++)
+    *export_handle = exportLevelsStart(file, rows, count);
+    return *export_handle == NULL ? CHESS_OUT_OF_MEMORY : CHESS_SUCCESS;
+}
+
+ChessResult chessTopPlayers(ChessSystem chess, int k, int *out_ids, double *out_levels)
+{
+    if (chess == NULL || out_ids == NULL || out_levels == NULL)
     {
-        first = true;
-        MAP_FOREACH(MapKeyElement, player_id, total_player_map)
-        {
-            if (mapContains(chess->total_player_list, player_id) == false)
-            {
-                keyFree(player_id);
-                continue;
-            }
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (k <= 0)
+    {
+        return CHESS_SUCCESS;
+    }
 
-            p_data = mapGet(total_player_map, player_id);
-            if (playerGetWins(p_data) == 0 && playerGetLosses(p_data) == 0 && playerGetDraws(p_data) == 0)
-            {
-                keyFree(player_id);
-                continue;
-            }
-            level = calulateLevel(playerGetWins(p_data), playerGetLosses(p_data), playerGetDraws(p_data));
-            if (first == true || level > max_level)
-            {
-                first = false;
-                max_level = level;
-                max_id = *(int *)player_id;
-            }
-            else if (level == max_level)
-            {
-                if (keyCompare(player_id, &max_id) < 0)
-                {
-                    max_id = *(int *)player_id;
-                }
-            }
-            keyFree(player_id);
-        }
-        if (max_id != NO_ID)
-        {
-            fprintf(file, "%d %.2f\n", max_id, max_level);
-            mapRemove(total_player_map, &max_id);
-            max_id = NO_ID;
-        }
+    ExportLevelRow *rows;
+    int count;
+    if (captureLevelRows(chess, playerLevel, &rows, &count) != CHESS_SUCCESS)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    SPAN_BEGIN(select_span);
+    int selected = exportSelectTopLevels(rows, count, k);
+    SPAN_END(select_span, "exportSelectTopLevels");
+    for (int i = 0; i < k; i++)
+    {
+        out_ids[i] = i < selected ? rows[i].player_id : NO_PLAYER;
+        out_levels[i] = i < selected ? rows[i].level : 0;
     }
-    mapDestroy(total_player_map);
+    free(rows);
     return CHESS_SUCCESS;
 }
 
-ChessResult chessSaveTournamentStatistics(ChessSystem chess, char *path_file)
+ChessResult chessGeneratePairings(ChessSystem chess, int tournament_id, int *out_pairs, int capacity, int *out_count)
 {
-    if (path_file == NULL || chess == NULL)
+    if (chess == NULL || out_count == NULL || (out_pairs == NULL && capacity > 0))
     {
         return CHESS_NULL_ARGUMENT;
     }
-
-    bool ended_tournament_exsist = false;
-    MAP_FOREACH(MapKeyElement, key_element, chess->tournament_list)
+    if (tournament_id <= 0)
     {
-        if (tournamentGetStatus(mapGet(chess->tournament_list, (MapKeyElement)key_element)) == false)
-        {
-            ended_tournament_exsist = true;
-        }
-        keyFree(key_element);
+        return CHESS_INVALID_ID;
     }
-
-    if (ended_tournament_exsist == false)
+    Tournament tournament = mapGet(chess->tournament_list, &tournament_id);
+    if (tournament == NULL)
     {
-        return CHESS_NO_TOURNAMENTS_ENDED;
+        return CHESS_TOURNAMENT_NOT_EXIST;
     }
+    SPAN_BEGIN(pairings_span);
+    ChessResult result = tournamentGeneratePairings(tournament, out_pairs, capacity, out_count);
+    SPAN_END(pairings_span, "tournamentGeneratePairings");
+    return result;
+}
 
-    FILE *file_name = fopen(path_file, "w");
-    if (file_name == NULL)
+ChessResult chessTournamentsByLocation(ChessSystem chess, const char *location, int *out_ids, int capacity,
+                                       int *out_count)
+{
+    if (chess == NULL || location == NULL || out_count == NULL || (out_ids == NULL && capacity > 0))
     {
-        return CHESS_SAVE_FAILURE;
+        return CHESS_NULL_ARGUMENT;
     }
-    int longest_game_time, number_of_players, number_of_games;
-    double total_game_time, average_game_time;
-    MAP_FOREACH(MapKeyElement, tour_key, chess->tournament_list)
+    if (isValidLocationName(location) == false)
     {
-        Tournament tour_data = mapGet(chess->tournament_list, (MapKeyElement)tour_key);
-        if (tour_data == NULL)
-        {
-            return CHESS_NULL_ARGUMENT;
-        }
-        if (tournamentGetStatus(tour_data) == false)
-        {
-            number_of_games = tournamentNumberOfGames(tour_data);
-            total_game_time = 0;
-            longest_game_time = tournamentLongestGameTime(tour_data, &total_game_time);
-            if (number_of_games == 0)
-            {
-                average_game_time = 0;
-            }
-            else
-            {
-                average_game_time = total_game_time / (double)number_of_games;
-            }
-            number_of_players = tournamentsNumberOfPlayers(tour_data);
-            fprintf(file_name, "%d\n", tournamentGetWinner(tour_data));
-            fprintf(file_name, "%d\n", longest_game_time);
-            fprintf(file_name, "%.2f\n", average_game_time);
-            fprintf(file_name, "%s\n", tournamentGetLocation(tour_data));
-            fprintf(file_name, "%d\n", number_of_games);
-            fprintf(file_name, "%d\n", number_of_players);
-        }
-        keyFree(tour_key);
+        return CHESS_INVALID_LOCATION;
     }
-    fclose(file_name);
+    *out_count = locationTournaments(locationFind(chess->locations, location), out_ids, capacity);
     return CHESS_SUCCESS;
 }
+
+ChessResult chessHeadToHead(ChessSystem chess, int first_player, int second_player, int *wins, int *losses,
+                            int *draws, int *total_time)
+{
+    if (chess == NULL || wins == NULL || losses == NULL || draws == NULL || total_time == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (first_player <= 0 || second_player <= 0 || first_player == second_player)
+    {
+        return CHESS_INVALID_ID;
+    }
+    if (mapContains(chess->total_player_list, &first_player) == false ||
+        mapContains(chess->total_player_list, &second_player) == false)
+    {
+        return CHESS_PLAYER_NOT_EXIST;
+    }
+    SPAN_BEGIN(head_to_head_span);
+    pairIndexHeadToHead(chess->pair_index, first_player, second_player, wins, losses, draws, total_time);
+    SPAN_END(head_to_head_span, "pairIndexHeadToHead");
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessPlayerGames(ChessSystem chess, int player_id, long long *cursor, ChessPlayerGame *out_games,
+                             int capacity, int *out_count)
+{
+    if (chess == NULL || cursor == NULL || out_count == NULL || (out_games == NULL && capacity > 0))
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (player_id <= 0)
+    {
+        return CHESS_INVALID_ID;
+    }
+    if (mapContains(chess->total_player_list, &player_id) == false)
+    {
+        return CHESS_PLAYER_NOT_EXIST;
+    }
+    SPAN_BEGIN(page_span);
+    playerGamesPage(chess->player_games, player_id, cursor, out_games, capacity, out_count);
+    SPAN_END(page_span, "playerGamesPage");
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessCommonPlayers(ChessSystem chess, int first_tournament, int second_tournament, int *out_ids,
+                               int capacity, int *out_count)
+{
+    if (chess == NULL || out_count == NULL || (out_ids == NULL && capacity > 0))
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (first_tournament <= 0 || second_tournament <= 0)
+    {
+        return CHESS_INVALID_ID;
+    }
+    Tournament first = mapGet(chess->tournament_list, &first_tournament);
+    Tournament second = mapGet(chess->tournament_list, &second_tournament);
+    if (first == NULL || second == NULL)
+    {
+        return CHESS_TOURNAMENT_NOT_EXIST;
+    }
+    SPAN_BEGIN(intersect_span);
+    *out_count = idSetIntersect(tournamentGetPlayerSet(first), tournamentGetPlayerSet(second), out_ids, capacity);
+    SPAN_END(intersect_span, "idSetIntersect");
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessCommonTournaments(ChessSystem chess, int first_player, int second_player, int *out_ids,
+                                   int capacity, int *out_count)
+{
+    if (chess == NULL || out_count == NULL || (out_ids == NULL && capacity > 0))
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (first_player <= 0 || second_player <= 0)
+    {
+        return CHESS_INVALID_ID;
+    }
+    if (mapContains(chess->total_player_list, &first_player) == false ||
+        mapContains(chess->total_player_list, &second_player) == false)
+    {
+        return CHESS_PLAYER_NOT_EXIST;
+    }
+    SPAN_BEGIN(intersect_span);
+    *out_count = idSetIntersect(idSetTableGet(chess->player_tournaments, first_player),
+                                idSetTableGet(chess->player_tournaments, second_player), out_ids, capacity);
+    SPAN_END(intersect_span, "idSetIntersect");
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessTournamentDurationQuantile(ChessSystem chess, int tournament_id, double quantile,
+                                           double *out_duration)
+{
+    if (chess == NULL || out_duration == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (tournament_id <= 0)
+    {
+        return CHESS_INVALID_ID;
+    }
+    Tournament tournament = mapGet(chess->tournament_list, &tournament_id);
+    if (tournament == NULL)
+    {
+        return CHESS_TOURNAMENT_NOT_EXIST;
+    }
+    QuantileSketch durations = tournamentGetDurations(tournament);
+    if (quantileSketchCount(durations) == 0)
+    {
+        return CHESS_NO_GAMES;
+    }
+    *out_duration = quantileSketchQuantile(durations, quantile);
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessPlayerDurationQuantile(ChessSystem chess, int player_id, double quantile, double *out_duration)
+{
+    if (chess == NULL || out_duration == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (player_id <= 0)
+    {
+        return CHESS_INVALID_ID;
+    }
+    if (mapContains(chess->total_player_list, &player_id) == false)
+    {
+        return CHESS_PLAYER_NOT_EXIST;
+    }
+    QuantileSketch durations = quantileSketchTableGet(chess->player_durations, player_id);
+    if (quantileSketchCount(durations) == 0)
+    {
+        return CHESS_NO_GAMES;
+    }
+    *out_duration = quantileSketchQuantile(durations, quantile);
+    return CHESS_SUCCESS;
+}
+
+/**
+ * checkTimeRange: Checks the arguments of the play time queries.
+ *
+ * @param chess - The chess system.
+ * @param tournament_id - The tournament, or CHESS_ALL_TOURNAMENTS.
+ * @param min_time - The lowest play time of the range.
+ * @param max_time - The highest play time of the range.
+ * @return
+ *     CHESS_INVALID_ID - if the tournament ID is negative.
+ *     CHESS_TOURNAMENT_NOT_EXIST - if the tournament does not exist in the system.
+ *     CHESS_INVALID_PLAY_TIME - if the range is not valid.
+ *     CHESS_SUCCESS otherwise.
+ */
+static ChessResult checkTimeRange(ChessSystem chess, int tournament_id, int min_time, int max_time)
+{
+    if (tournament_id < 0)
+    {
+        return CHESS_INVALID_ID;
+    }
+    if (tournament_id != CHESS_ALL_TOURNAMENTS && mapContains(chess->tournament_list, &tournament_id) == false)
+    {
+        return CHESS_TOURNAMENT_NOT_EXIST;
+    }
+    if (min_time < 0 || max_time < min_time)
+    {
+        return CHESS_INVALID_PLAY_TIME;
+    }
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessCountGamesInTimeRange(ChessSystem chess, int tournament_id, int min_time, int max_time,
+                                       int *out_count)
+{
+    if (chess == NULL || out_count == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    ChessResult result = checkTimeRange(chess, tournament_id, min_time, max_time);
+    if (result != CHESS_SUCCESS)
+    {
+        return result;
+    }
+    if (tournament_id != CHESS_ALL_TOURNAMENTS)
+    {
+        *out_count = timeIndexCount(tournamentGetTimeIndex(mapGet(chess->tournament_list, &tournament_id)),
+                                    min_time, max_time);
+        return CHESS_SUCCESS;
+    }
+    *out_count = 0;
+    MAP_FOREACH(MapKeyElement, tour_key, chess->tournament_list)
+    {
+        *out_count += timeIndexCount(tournamentGetTimeIndex(mapGet(chess->tournament_list, tour_key)),
+                                     min_time, max_time);
+        keyFree(tour_key);
+    }
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessGamesInTimeRange(ChessSystem chess, int tournament_id, int min_time, int max_time,
+                                  ChessTimedGame *out_games, int capacity, int *out_count)
+{
+    if (chess == NULL || out_count == NULL || (out_games == NULL && capacity > 0))
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    ChessResult result = checkTimeRange(chess, tournament_id, min_time, max_time);
+    if (result != CHESS_SUCCESS)
+    {
+        return result;
+    }
+    if (tournament_id != CHESS_ALL_TOURNAMENTS)
+    {
+        *out_count = timeIndexCopyRange(tournamentGetTimeIndex(mapGet(chess->tournament_list, &tournament_id)),
+                                        tournament_id, min_time, max_time, out_games, capacity);
+        return CHESS_SUCCESS;
+    }
+    *out_count = 0;
+    MAP_FOREACH(MapKeyElement, tour_key, chess->tournament_list)
+    {
+        int room = *out_count < capacity ? capacity - *out_count : 0;
+        *out_count += timeIndexCopyRange(tournamentGetTimeIndex(mapGet(chess->tournament_list, tour_key)),
+                                         *(int *)tour_key, min_time, max_time,
+                                         room > 0 ? out_games + *out_count : NULL, room);
+        keyFree(tour_key);
+    }
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessQueryRun(ChessSystem chess, ChessQuery query, ChessQueryRow *out_rows, int capacity,
+                          int *out_count)
+{
+    if (chess == NULL || query == NULL || out_count == NULL || (out_rows == NULL && capacity > 0))
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    QueryResult result = queryResultCreate(query);
+    if (result == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    bool success = true;
+    int number_of_tournaments;
+    const int *tournament_ids = queryTournaments(query, &number_of_tournaments);
+    SPAN_BEGIN(scan_span);
+    if (tournament_ids != NULL)
+    {
+        for (int i = 0; i < number_of_tournaments && success; i++)
+        {
+            Tournament tournament = mapGet(chess->tournament_list, (MapKeyElement)&tournament_ids[i]);
+            if (tournament != NULL)
+            {
+                success = queryScan(result, tournament_ids[i], tournamentGetTimeIndex(tournament));
+            }
+        }
+    }
+    else
+    {
+        MAP_FOREACH(MapKeyElement, tour_key, chess->tournament_list)
+        {
+            if (success)
+            {
+                success = queryScan(result, *(int *)tour_key,
+                                    tournamentGetTimeIndex(mapGet(chess->tournament_list, tour_key)));
+            }
+            keyFree(tour_key);
+        }
+    }
+    SPAN_END(scan_span, "queryScan");
+    if (success)
+    {
+        *out_count = queryResultRows(result, out_rows, capacity);
+    }
+    queryResultDestroy(result);
+    return success ? CHESS_SUCCESS : CHESS_OUT_OF_MEMORY;
+}
+
+double chessGetPlayerRating(ChessSystem chess, int player_id, ChessResult *chess_result)
+{
+    if (chess == NULL)
+    {
+        *chess_result = CHESS_NULL_ARGUMENT;
+        return 0;
+    }
+    if (player_id <= 0)
+    {
+        *chess_result = CHESS_INVALID_ID;
+        return 0;
+    }
+    PlayerTotal total = mapGet(chess->total_player_list, &player_id);
+    if (total == NULL)
+    {
+        *chess_result = CHESS_PLAYER_NOT_EXIST;
+        return 0;
+    }
+    *chess_result = CHESS_SUCCESS;
+    return playerGetRating(total);
+}
+
+ChessResult chessRecalculateRatings(ChessSystem chess)
+{
+    if (chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+
+    if (journalFailed(chess))
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+
+    if (reserveOperation(chess, JOURNAL_RECALCULATE_RATINGS, NULL) != CHESS_SUCCESS)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+
+    int *ids;
+    double *ratings;
+    int count;
+    SPAN_BEGIN(recalculate_span);
+    if (ratingLogRecalculate(chess->rating_log, &ids, &ratings, &count) == false)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    SPAN_END(recalculate_span, "ratingLogRecalculate");
+    MAP_FOREACH(MapKeyElement, player_id, chess->total_player_list)
+    {
+        playerSetRating(mapGet(chess->total_player_list, player_id), ratingLookup(ids, ratings, count, *(int *)player_id));
+        keyFree(player_id);
+    }
+    free(ids);
+    free(ratings);
+    int arguments[JOURNAL_MAX_ARGUMENTS] = {0};
+    return journalOperation(chess, JOURNAL_RECALCULATE_RATINGS, arguments, NULL);
+}
+
+ChessResult chessSavePlayersRatings(ChessSystem chess, FILE *file)
+{
+    return savePlayersScores(chess, file, playerGetRating);
+}
+
+/**
+ * captureStatisticsRows: Captures the statistics of ended tournaments, in id order.
+ *
+ * @param chess - The chess system.
+ * @param tournament_keys - A map whose keys are the ids of the tournaments to capture. Tournaments
+ *     that did not end are skipped.
+ * @param copy_locations - If the locations should be copied, so the rows outlive the tournaments.
+ * @param rows - Where to store the rows, allocated with malloc.
+ * @param count - Where to store the number of rows.
+ * @return
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - otherwise.
+ */
+static ChessResult captureStatisticsRows(ChessSystem chess, Map tournament_keys, bool copy_locations,
+                                         ExportStatisticsRow **rows, int *count)
+{
+    *count = 0;
+    *rows = malloc(sizeof(**rows) * (mapGetSize(tournament_keys) + 1));
+    if (*rows == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    MAP_FOREACH(MapKeyElement, tour_key, tournament_keys)
+    {
+        Tournament tour_data = mapGet(chess->tournament_list, tour_key);
+        int tournament_id = *(int *)tour_key;
+        keyFree(tour_key);
+        if (tour_data == NULL || tournamentGetStatus(tour_data) == true)
+        {
+            continue;
+        }
+        ExportStatisticsRow *row = &(*rows)[*count];
+        row->tournament_id = tournament_id;
+        const char *location = tournamentGetLocation(tour_data);
+        if (copy_locations)
+        {
+            row->location = malloc(strlen(location) + 1);
+            if (row->location == NULL)
+            {
+                exportStatisticsRowsDestroy(*rows, *count);
+                return CHESS_OUT_OF_MEMORY;
+            }
+            strcpy(row->location, location);
+        }
+        else
+        {
+            row->location = (char *)location;
+        }
+        double total_game_time = 0;
+        row->winner = tournamentGetWinner(tour_data);
+        row->number_of_games = tournamentNumberOfGames(tour_data);
+        row->longest_game_time = tournamentLongestGameTime(tour_data, &total_game_time);
+        if (row->number_of_games == 0)
+        {
+            row->average_game_time = 0;
+        }
+        else
+        {
+            row->average_game_time = total_game_time / (double)row->number_of_games;
+        }
+        row->number_of_players = tournamentsNumberOfPlayers(tour_data);
+        QuantileSketch durations = tournamentGetDurations(tour_data);
+        row->median_game_time = quantileSketchQuantile(durations, MEDIAN);
+        row->p90_game_time = quantileSketchQuantile(durations, P90);
+        row->p99_game_time = quantileSketchQuantile(durations, P99);
+        (*count)++;
+    }
+    return CHESS_SUCCESS;
+}
+
+/**
+ * writeStatisticsFile: Captures the statistics of ended tournaments and writes them to a file.
+ *
+ * @param chess - The chess system.
+ * @param tournament_keys - A map whose keys are the ids of the tournaments to write.
+ * @param path_file - The file path.
+ * @param mode - The fopen mode of the file.
+ * @param durations - If the quantiles of the game times are written after every tournament.
+ * @return
+ *     CHESS_NO_TOURNAMENTS_ENDED - if none of the tournaments ended. The file is not opened.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if an error occurred while saving.
+ *     CHESS_SUCCESS - otherwise.
+ */
+static ChessResult writeStatisticsFile(ChessSystem chess, Map tournament_keys, const char *path_file, const char *mode,
+                                       bool durations)
+{
+    ExportStatisticsRow *rows;
+    int count;
+    if (captureStatisticsRows(chess, tournament_keys, false, &rows, &count) != CHESS_SUCCESS)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    if (count == 0)
+    {
+        free(rows);
+        return CHESS_NO_TOURNAMENTS_ENDED;
+    }
+
+    FILE *file_name = fopen(path_file, mode);
+    if (file_name == NULL)
+    {
+        free(rows);
+        return CHESS_SAVE_FAILURE;
+    }
+    ChessResult result = durations ? exportWriteDurationStatistics(file_name, rows, count) :
+                                     exportWriteStatistics(file_name, rows, count);
+    free(rows);
+    if (fclose(file_name) != 0 && result == CHESS_SUCCESS)
+    {
+        result = CHESS_SAVE_FAILURE;
+    }
+    return result;
+}
+
+/**
+ * saveTournamentStatistics: chessSaveTournamentStatistics without the metrics, see chessSystem.h.
+ */
+static ChessResult saveTournamentStatistics(ChessSystem chess, char *path_file)
+{
+    if (path_file == NULL || chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    return writeStatisticsFile(chess, chess->tournament_list, path_file, "w", false);
+}
+
+ChessResult chessSaveTournamentStatistics(ChessSystem chess, char *path_file)
+{
+    METRICS_API_START();
+    unsigned long long trace_start_ns = traceStart(chess);
+    SPAN_BEGIN(api_span);
+    ChessResult result = saveTournamentStatistics(chess, path_file);
+    SPAN_END(api_span, "chessSaveTournamentStatistics");
+    METRICS_API_STOP(CHESS_METRICS_SAVE_STATISTICS);
+    if (trace_start_ns != TRACE_OFF)
+    {
+        int arguments[TRACE_MAX_ARGUMENTS] = {0};
+        traceCall(chess, TRACE_SAVE_STATISTICS, arguments, NULL, result, 0, trace_start_ns);
+    }
+    return result;
+}
+
+ChessResult chessSaveTournamentDurationStatistics(ChessSystem chess, char *path_file)
+{
+    if (path_file == NULL || chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    return writeStatisticsFile(chess, chess->tournament_list, path_file, "w", true);
+}
+
+ChessResult chessSaveTournamentStatisticsAsync(ChessSystem chess, char *path_file, ChessExport *export_handle)
+{
+    if (path_file == NULL || chess == NULL || export_handle == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+
+    ExportStatisticsRow *rows;
+    int count;
+    if (captureStatisticsRows(chess, chess->tournament_list, true, &rows, &count) != CHESS_SUCCESS)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    if (count == 0)
+    {
+        free(rows);
+        return CHESS_NO_TOURNAMENTS_ENDED;
+    }
+    *export_handle = exportStatisticsStart(path_file, rows, count);
+    return *export_handle == NULL ? CHESS_OUT_OF_MEMORY : CHESS_SUCCESS;
+}
+
+/**
+ * clearPendingStatistics: Empties the tournaments that ended since the last append or compaction,
+ * once their statistics were written, and journals it so a recovery does not append them again.
+ *
+ * @param chess - The chess system.
+ * @return
+ *     CHESS_SAVE_FAILURE if it could not be journaled, CHESS_SUCCESS otherwise.
+ */
+static ChessResult clearPendingStatistics(ChessSystem chess)
+{
+    mapClear(chess->pending_statistics);
+    int arguments[JOURNAL_MAX_ARGUMENTS] = {0};
+    return journalOperation(chess, JOURNAL_CLEAR_STATISTICS, arguments, NULL);
+}
+
+ChessResult chessAppendTournamentStatistics(ChessSystem chess, char *path_file)
+{
+    if (path_file == NULL || chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (journalFailed(chess))
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    if (mapGetSize(chess->pending_statistics) == 0)
+    {
+        return CHESS_NO_TOURNAMENTS_ENDED;
+    }
+    // Reserved before the file is written, so the tournaments appended are always cleared
+    if (reserveOperation(chess, JOURNAL_CLEAR_STATISTICS, NULL) != CHESS_SUCCESS)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+
+    ChessResult result = writeStatisticsFile(chess, chess->pending_statistics, path_file, "a", false);
+    if (result == CHESS_SUCCESS)
+    {
+        result = clearPendingStatistics(chess);
+    }
+    return result;
+}
+
+ChessResult chessCompactTournamentStatistics(ChessSystem chess, char *path_file)
+{
+    if (chess != NULL && journalFailed(chess))
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    if (chess != NULL && path_file != NULL && reserveOperation(chess, JOURNAL_CLEAR_STATISTICS, NULL) != CHESS_SUCCESS)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    ChessResult result = chessSaveTournamentStatistics(chess, path_file);
+    if (result == CHESS_SUCCESS || result == CHESS_NO_TOURNAMENTS_ENDED)
+    {
+        ChessResult journal_result = clearPendingStatistics(chess);
+        result = journal_result == CHESS_SUCCESS ? result : journal_result;
+    }
+    return result;
+}
+
+/**
+ * capturePlayerTotals: Adds the totals of the players of a map to shard rows.
+ *
+ * @param players - The totals, by player id.
+ * @param active - If the players of the map are in the system.
+ * @param rows - The rows to add to, with room for the players.
+ * @param count - The number of rows, updated.
+ */
+static void capturePlayerTotals(Map players, bool active, ShardPlayerTotal *rows, int *count)
+{
+    MAP_FOREACH(MapKeyElement, player_id, players)
+    {
+        PlayerData p_data = mapGet(players, player_id);
+        ShardPlayerTotal *row = &rows[(*count)++];
+        row->player_id = *(int *)player_id;
+        row->active = active;
+        row->wins = playerGetWins(p_data);
+        row->losses = playerGetLosses(p_data);
+        row->draws = playerGetDraws(p_data);
+        keyFree(player_id);
+    }
+}
+
+ChessResult shardCapturePlayerTotals(ChessSystem chess, ShardPlayerTotal **rows, int *count)
+{
+    if (chess == NULL || rows == NULL || count == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    *count = 0;
+    *rows = malloc(sizeof(**rows) * (mapGetSize(chess->total_player_list) + mapGetSize(chess->removed_players) + 1));
+    if (*rows == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    capturePlayerTotals(chess->total_player_list, true, *rows, count);
+    capturePlayerTotals(chess->removed_players, false, *rows, count);
+    return CHESS_SUCCESS;
+}
+
+ChessResult shardPlayerPlayTime(ChessSystem chess, int player_id, bool *active, double *total_time,
+                                int *number_of_games)
+{
+    if (chess == NULL || active == NULL || total_time == NULL || number_of_games == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (player_id <= 0)
+    {
+        return CHESS_INVALID_ID;
+    }
+    *active = mapContains(chess->total_player_list, &player_id);
+    *number_of_games = 0;
+    *total_time = playerTotalTime(chess, player_id, number_of_games);
+    return CHESS_SUCCESS;
+}
+
+ChessResult shardCaptureStatistics(ChessSystem chess, ExportStatisticsRow **rows, int *count)
+{
+    if (chess == NULL || rows == NULL || count == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    return captureStatisticsRows(chess, chess->tournament_list, true, rows, count);
+}
+
+double shardPlayerLevel(int wins, int losses, int draws)
+{
+    return calulateLevel(wins, losses, draws);
+}
+
+ChessResult chessSaveSnapshot(ChessSystem chess, const char *path_file)
+{
+    if (chess == NULL || path_file == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+
+    SnapshotWriter writer = snapshotWriterCreate();
+    if (writer == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    bool success = snapshotWriteInt(writer, (int)(chess->sequence & 0xFFFFFFFF)) &&
+                   snapshotWriteInt(writer, (int)(chess->sequence >> 32)) &&
+                   snapshotWriteInt(writer, mapGetSize(chess->tournament_list));
+    MAP_FOREACH(MapKeyElement, tournament_key, chess->tournament_list)
+    {
+        success = success && snapshotWriteInt(writer, *(int *)tournament_key) &&
+                  tournamentSnapshotWrite(mapGet(chess->tournament_list, tournament_key), writer);
+        keyFree(tournament_key);
+    }
+    success = success && snapshotWriteInt(writer, mapGetSize(chess->total_player_list));
+    MAP_FOREACH(MapKeyElement, player_id, chess->total_player_list)
+    {
+        success = success && snapshotWriteInt(writer, *(int *)player_id) &&
+                  playerDataSnapshotWrite(playerTotalStats(mapGet(chess->total_player_list, player_id)), writer);
+        keyFree(player_id);
+    }
+    success = success && snapshotWriteInt(writer, mapGetSize(chess->total_player_list));
+    MAP_FOREACH(MapKeyElement, player_id, chess->total_player_list)
+    {
+        success = success && snapshotWriteInt(writer, *(int *)player_id) &&
+                  ratingSnapshotWrite(playerGetRating(mapGet(chess->total_player_list, player_id)), writer);
+        keyFree(player_id);
+    }
+    success = success && ratingLogSnapshotWrite(chess->rating_log, writer) &&
+              snapshotWriteInt(writer, mapGetSize(chess->pending_statistics));
+    MAP_FOREACH(MapKeyElement, tournament_key, chess->pending_statistics)
+    {
+        success = success && snapshotWriteInt(writer, *(int *)tournament_key);
+        keyFree(tournament_key);
+    }
+    success = success && snapshotWriteInt(writer, mapGetSize(chess->removed_players));
+    MAP_FOREACH(MapKeyElement, player_id, chess->removed_players)
+    {
+        success = success && snapshotWriteInt(writer, *(int *)player_id) &&
+                  playerDataSnapshotWrite(mapGet(chess->removed_players, player_id), writer);
+        keyFree(player_id);
+    }
+    if (success == false)
+    {
+        snapshotWriterDestroy(writer);
+        return CHESS_OUT_OF_MEMORY;
+    }
+
+    success = snapshotWriterSave(writer, path_file);
+    snapshotWriterDestroy(writer);
+    return success ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
+
+/**
+ * loadSnapshotTournaments: Reads the tournaments section of a snapshot into an empty chess system.
+ *
+ * @param chess - The chess system to fill.
+ * @param reader - The snapshot reader.
+ * @return
+ *     CHESS_LOAD_FAILURE - if the snapshot is truncated or corrupted.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS otherwise.
+ */
+static ChessResult loadSnapshotTournaments(ChessSystem chess, SnapshotReader reader)
+{
+    int number_of_tournaments = snapshotReadInt(reader);
+    for (int i = 0; i < number_of_tournaments; i++)
+    {
+        int tournament_id = snapshotReadInt(reader);
+        Tournament tournament = tournamentSnapshotReadHeader(reader, chess->locations);
+        if (tournament == NULL)
+        {
+            return snapshotReaderFailed(reader) ? CHESS_LOAD_FAILURE : CHESS_OUT_OF_MEMORY;
+        }
+        if (mapPut(chess->tournament_list, &tournament_id, tournament) != MAP_SUCCESS)
+        {
+            tournamentDestroy(tournament);
+            return CHESS_OUT_OF_MEMORY;
+        }
+        tournamentDestroy(tournament);
+        tournament = mapGet(chess->tournament_list, &tournament_id);
+        if (locationAddTournament(tournamentGetSharedLocation(tournament), tournament_id) == false)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+
+        ChessResult result = tournamentSnapshotReadContents(tournament, reader);
+        if (result != CHESS_SUCCESS)
+        {
+            return result;
+        }
+    }
+    return snapshotReaderFailed(reader) ? CHESS_LOAD_FAILURE : CHESS_SUCCESS;
+}
+
+/**
+ * loadSnapshotPlayers: Reads the player aggregates section of a snapshot into a chess system.
+ *
+ * @param chess - The chess system to fill.
+ * @param reader - The snapshot reader.
+ * @return
+ *     CHESS_LOAD_FAILURE - if the snapshot is truncated or corrupted.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS otherwise.
+ */
+static ChessResult loadSnapshotPlayers(ChessSystem chess, SnapshotReader reader)
+{
+    PlayerTotal total = playerTotalCreate();
+    if (total == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    ChessResult result = CHESS_SUCCESS;
+    int number_of_players = snapshotReadInt(reader);
+    for (int i = 0; i < number_of_players && result == CHESS_SUCCESS; i++)
+    {
+        int player_id = snapshotReadInt(reader);
+        if (playerDataSnapshotRead(playerTotalStats(total), reader) == false)
+        {
+            result = CHESS_LOAD_FAILURE;
+        }
+        else if (mapPut(chess->total_player_list, &player_id, total) != MAP_SUCCESS)
+        {
+            result = CHESS_OUT_OF_MEMORY;
+        }
+    }
+    playerTotalDestroy(total);
+    if (snapshotReaderFailed(reader))
+    {
+        return CHESS_LOAD_FAILURE;
+    }
+    return result;
+}
+
+/**
+ * loadSnapshotRatings: Reads the ratings of the players and the rating history of a snapshot into
+ * a chess system. Snapshots before SNAPSHOT_RATINGS_VERSION have neither, and load with the players
+ * at RATING_INITIAL and an empty history.
+ *
+ * @param chess - The chess system to fill, with its players already loaded.
+ * @param reader - The snapshot reader.
+ * @return
+ *     CHESS_LOAD_FAILURE - if the snapshot is truncated or corrupted.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS otherwise.
+ */
+static ChessResult loadSnapshotRatings(ChessSystem chess, SnapshotReader reader)
+{
+    int number_of_players = snapshotReadInt(reader);
+    for (int i = 0; i < number_of_players && snapshotReaderFailed(reader) == false; i++)
+    {
+        int player_id = snapshotReadInt(reader);
+        double rating = ratingSnapshotRead(reader);
+        PlayerTotal total = mapGet(chess->total_player_list, &player_id);
+        if (total == NULL)
+        {
+            return CHESS_LOAD_FAILURE;
+        }
+        playerSetRating(total, rating);
+    }
+    if (snapshotReaderFailed(reader))
+    {
+        return CHESS_LOAD_FAILURE;
+    }
+    return ratingLogSnapshotRead(chess->rating_log, reader);
+}
+
+/**
+ * loadSnapshotPending: Reads the tournaments that ended since the last statistics append of a
+ * snapshot into a chess system. Snapshots before SNAPSHOT_PENDING_VERSION do not have them, and
+ * load with nothing to append.
+ *
+ * @param chess - The chess system to fill, with its tournaments already loaded.
+ * @param reader - The snapshot reader.
+ * @return
+ *     CHESS_LOAD_FAILURE - if the snapshot is truncated or corrupted.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS otherwise.
+ */
+static ChessResult loadSnapshotPending(ChessSystem chess, SnapshotReader reader)
+{
+    int number_of_pending = snapshotReadInt(reader);
+    for (int i = 0; i < number_of_pending && snapshotReaderFailed(reader) == false; i++)
+    {
+        int tournament_id = snapshotReadInt(reader);
+        Tournament tournament = mapGet(chess->tournament_list, &tournament_id);
+        if (tournament == NULL || tournamentGetStatus(tournament))
+        {
+            return CHESS_LOAD_FAILURE;
+        }
+        if (mapPut(chess->pending_statistics, &tournament_id, &tournament_id) != MAP_SUCCESS)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+    }
+    return snapshotReaderFailed(reader) ? CHESS_LOAD_FAILURE : CHESS_SUCCESS;
+}
+
+/**
+ * loadSnapshotRemoved: Reads the stats removed players kept from ended tournaments into a chess
+ * system.
+ *
+ * @param chess - The chess system to fill.
+ * @param reader - The snapshot reader.
+ * @return
+ *     CHESS_LOAD_FAILURE - if the snapshot is truncated or corrupted.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS otherwise.
+ */
+static ChessResult loadSnapshotRemoved(ChessSystem chess, SnapshotReader reader)
+{
+    PlayerData stats = playerDataCreate();
+    if (stats == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    ChessResult result = CHESS_SUCCESS;
+    int number_of_players = snapshotReadInt(reader);
+    for (int i = 0; i < number_of_players && result == CHESS_SUCCESS; i++)
+    {
+        int player_id = snapshotReadInt(reader);
+        if (playerDataSnapshotRead(stats, reader) == false || mapContains(chess->total_player_list, &player_id))
+        {
+            result = CHESS_LOAD_FAILURE;
+        }
+        else if (mapPut(chess->removed_players, &player_id, stats) != MAP_SUCCESS)
+        {
+            result = CHESS_OUT_OF_MEMORY;
+        }
+    }
+    playerDataDestroy(stats);
+    if (snapshotReaderFailed(reader))
+    {
+        return CHESS_LOAD_FAILURE;
+    }
+    return result;
+}
+
+/**
+ * rebuildRemovedPlayers: Sums the stats of the players over the tournaments of a loaded system, and
+ * keeps the sums of the players that are not in it as the removed players. Snapshots before
+ * SNAPSHOT_REMOVED_VERSION do not store the removed players.
+ *
+ * @param chess - The loaded chess system.
+ * @return
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS otherwise.
+ */
+static ChessResult rebuildRemovedPlayers(ChessSystem chess)
+{
+    Map tournament_totals = mapCreate(playerDataCopy, keyCopy, playerDataDestroy, keyFree, keyCompare);
+    if (tournament_totals == NULL || CreatePlayerMap(chess, tournament_totals) != CHESS_SUCCESS)
+    {
+        mapDestroy(tournament_totals);
+        return CHESS_OUT_OF_MEMORY;
+    }
+    ChessResult result = CHESS_SUCCESS;
+    MAP_FOREACH(MapKeyElement, player_id, tournament_totals)
+    {
+        PlayerData p_data = mapGet(tournament_totals, player_id);
+        if (mapContains(chess->total_player_list, player_id) == false && playerHasGames(p_data) &&
+            mapPut(chess->removed_players, player_id, p_data) != MAP_SUCCESS)
+        {
+            result = CHESS_OUT_OF_MEMORY;
+        }
+        keyFree(player_id);
+    }
+    mapDestroy(tournament_totals);
+    return result;
+}
+
+/** The chess system whose game indexes are rebuilt, and the tournament whose games are added */
+typedef struct
+{
+    ChessSystem chess;
+    int tournament_id;
+    int game_key;
+    bool ended;
+} GameIndexLoad;
+
+/**
+ * addToGameIndexes: TournamentGameVisitor that adds a game of a loaded tournament to the game indexes.
+ */
+static bool addToGameIndexes(void *context, const TournamentGame *game)
+{
+    GameIndexLoad *load = context;
+    // Games are visited in key order, and the keys of a tournament start at 1
+    load->game_key++;
+    return indexGame(load->chess, load->tournament_id, load->game_key, game->first_player, game->second_player,
+                     game->winner, game->play_time, load->ended);
+}
+
+/**
+ * rebuildGameIndexes: Adds the games of the tournaments of a loaded system to its pair index and to
+ * the game lists of its players.
+ *
+ * @param chess - The loaded chess system.
+ * @return
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS otherwise.
+ */
+static ChessResult rebuildGameIndexes(ChessSystem chess)
+{
+    ChessResult result = CHESS_SUCCESS;
+    MAP_FOREACH(MapKeyElement, tournament_key, chess->tournament_list)
+    {
+        Tournament tournament = mapGet(chess->tournament_list, tournament_key);
+        GameIndexLoad load = {chess, *(int *)tournament_key, 0, tournamentGetStatus(tournament) == false};
+        if (result == CHESS_SUCCESS && tournamentForEachGame(tournament, addToGameIndexes, &load) == false)
+        {
+            result = CHESS_OUT_OF_MEMORY;
+        }
+        keyFree(tournament_key);
+    }
+    return result;
+}
+
+ChessSystem chessLoadSnapshot(const char *path_file, ChessResult *chess_result)
+{
+    if (path_file == NULL)
+    {
+        *chess_result = CHESS_NULL_ARGUMENT;
+        return NULL;
+    }
+
+    SnapshotReader reader = snapshotReaderOpen(path_file);
+    if (reader == NULL)
+    {
+        *chess_result = CHESS_LOAD_FAILURE;
+        return NULL;
+    }
+    ChessSystem chess = chessCreate();
+    if (chess == NULL)
+    {
+        snapshotReaderDestroy(reader);
+        *chess_result = CHESS_OUT_OF_MEMORY;
+        return NULL;
+    }
+
+    if (snapshotReaderVersion(reader) >= SNAPSHOT_SEQUENCE_VERSION)
+    {
+        unsigned int sequence_low = snapshotReadInt(reader);
+        chess->sequence = ((long long)snapshotReadInt(reader) << 32) | sequence_low;
+    }
+    ChessResult result = loadSnapshotTournaments(chess, reader);
+    if (result == CHESS_SUCCESS)
+    {
+        result = loadSnapshotPlayers(chess, reader);
+    }
+    if (result == CHESS_SUCCESS && snapshotReaderVersion(reader) < SNAPSHOT_REMOVED_VERSION)
+    {
+        result = rebuildRemovedPlayers(chess);
+    }
+    if (result == CHESS_SUCCESS)
+    {
+        result = rebuildGameIndexes(chess);
+    }
+    if (result == CHESS_SUCCESS && snapshotReaderVersion(reader) >= SNAPSHOT_RATINGS_VERSION)
+    {
+        result = loadSnapshotRatings(chess, reader);
+    }
+    if (result == CHESS_SUCCESS && snapshotReaderVersion(reader) >= SNAPSHOT_PENDING_VERSION)
+    {
+        result = loadSnapshotPending(chess, reader);
+    }
+    if (result == CHESS_SUCCESS && snapshotReaderVersion(reader) >= SNAPSHOT_REMOVED_VERSION)
+    {
+        result = loadSnapshotRemoved(chess, reader);
+    }
+    snapshotReaderDestroy(reader);
+    *chess_result = result;
+    if (result != CHESS_SUCCESS)
+    {
+        chessDestroy(chess);
+        return NULL;
+    }
+    return chess;
+}
+
+ChessResult chessJournalStart(ChessSystem chess, const char *path_file, int group_commit)
+{
+    if (chess == NULL || path_file == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    ChessJournal journal = journalOpen(path_file, group_commit < 1 ? 1 : group_commit);
+    if (journal == NULL)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    bool previous_success = journalClose(chess->journal);
+    chess->journal = journal;
+    return previous_success ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
+
+ChessResult chessJournalSync(ChessSystem chess)
+{
+    if (chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (chess->journal == NULL)
+    {
+        return CHESS_SUCCESS;
+    }
+    return journalSync(chess->journal) ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
+
+ChessResult chessJournalStop(ChessSystem chess)
+{
+    if (chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    bool success = journalClose(chess->journal);
+    chess->journal = NULL;
+    return success ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
+
+/**
+ * replayRecord: Applies one journal record to a chess system.
+ *
+ * @param chess - The chess system.
+ * @param record - The record to apply.
+ * @return
+ *     The result of the chessSystem.h function the record was made by.
+ */
+static ChessResult replayRecord(ChessSystem chess, const JournalRecord *record)
+{
+    const int *arguments = record->arguments;
+    switch (record->operation)
+    {
+    case JOURNAL_ADD_TOURNAMENT:
+        return chessAddTournament(chess, arguments[0], arguments[1], record->location);
+    case JOURNAL_ADD_GAME:
+        return chessAddGame(chess, arguments[0], arguments[1], arguments[2], arguments[3], arguments[4]);
+    case JOURNAL_REMOVE_TOURNAMENT:
+        return chessRemoveTournament(chess, arguments[0]);
+    case JOURNAL_REMOVE_PLAYER:
+        return chessRemovePlayer(chess, arguments[0]);
+    case JOURNAL_END_TOURNAMENT:
+        return chessEndTournament(chess, arguments[0]);
+    case JOURNAL_RECALCULATE_RATINGS:
+        return chessRecalculateRatings(chess);
+    case JOURNAL_CLEAR_STATISTICS:
+        return clearPendingStatistics(chess);
+    default:
+        return CHESS_LOAD_FAILURE;
+    }
+}
+
+ChessSystem chessRecover(const char *snapshot_path, const char *journal_path, ChessResult *chess_result)
+{
+    ChessSystem chess = snapshot_path == NULL ? chessCreate() : chessLoadSnapshot(snapshot_path, chess_result);
+    if (chess == NULL)
+    {
+        if (snapshot_path == NULL)
+        {
+            *chess_result = CHESS_OUT_OF_MEMORY;
+        }
+        return NULL;
+    }
+
+    JournalReader reader = journalReaderOpen(journal_path);
+    JournalRecord record;
+    ChessResult result = CHESS_SUCCESS;
+    while (result == CHESS_SUCCESS && journalReadNext(reader, &record))
+    {
+        if (record.sequence <= chess->sequence)
+        {
+            continue;
+        }
+        result = replayRecord(chess, &record) == CHESS_SUCCESS ? CHESS_SUCCESS : CHESS_LOAD_FAILURE;
+        chess->sequence = record.sequence;
+    }
+    journalReaderDestroy(reader);
+    *chess_result = result;
+    if (result != CHESS_SUCCESS)
+    {
+        chessDestroy(chess);
+        return NULL;
+    }
+    return chess;
+}
+
+ChessResult chessMemoryUsage(ChessSystem chess, ChessMemoryFootprint *total, ChessTournamentMemory *tournaments,
+                             int capacity, int *count)
+{
+    if (chess == NULL || total == NULL || count == NULL || (tournaments == NULL && capacity > 0))
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    memset(total, 0, sizeof(*total));
+    *count = 0;
+    MAP_FOREACH(MapKeyElement, tour_key, chess->tournament_list)
+    {
+        ChessMemoryFootprint footprint;
+        memset(&footprint, 0, sizeof(footprint));
+        memoryFootprintAdd(&footprint, CHESS_MEMORY_KEYS, sizeof(int), 1);
+        tournamentMemoryUsage(mapGet(chess->tournament_list, tour_key), &footprint);
+        for (int category = 0; category < CHESS_MEMORY_CATEGORIES; category++)
+        {
+            memoryFootprintAdd(total, category, footprint.bytes[category], footprint.allocations[category]);
+        }
+        if (*count < capacity)
+        {
+            tournaments[*count].tournament_id = *(int *)tour_key;
+            tournaments[*count].footprint = footprint;
+        }
+        (*count)++;
+        keyFree(tour_key);
+    }
+    size_t number_of_totals = mapGetSize(chess->total_player_list);
+    size_t number_of_removed = mapGetSize(chess->removed_players);
+    size_t number_of_players = number_of_totals + number_of_removed;
+    size_t number_of_pending = mapGetSize(chess->pending_statistics);
+    memoryFootprintAdd(total, CHESS_MEMORY_PLAYERS,
+                       number_of_totals * playerTotalAllocationSize() + number_of_removed * playerDataAllocationSize(),
+                       number_of_players);
+    memoryFootprintAdd(total, CHESS_MEMORY_KEYS, (number_of_players + 2 * number_of_pending) * sizeof(int),
+                       number_of_players + 2 * number_of_pending);
+    ratingLogMemoryUsage(chess->rating_log, total);
+    pairIndexMemoryUsage(chess->pair_index, total);
+    locationTableMemoryUsage(chess->locations, total);
+    playerGamesMemoryUsage(chess->player_games, total);
+    idSetTableMemoryUsage(chess->player_tournaments, total);
+    quantileSketchTableMemoryUsage(chess->player_durations, total);
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessTraceStart(ChessSystem chess, const char *path_file)
+{
+    if (chess == NULL || path_file == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    ChessTrace trace = traceOpen(path_file);
+    if (trace == NULL)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    traceClose(chess->trace);
+    chess->trace = trace;
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessTraceStop(ChessSystem chess)
+{
+    if (chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    bool success = traceClose(chess->trace);
+    chess->trace = NULL;
+    return success ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
@@ -2,6 +2,7 @@
 #define _CHESSSYSTEM_H
 
 #include <stdio.h>
+#include <stdbool.h>
 
 
 typedef enum {
@@ -20,7 +21,10 @@ typedef enum {
     CHESS_NO_TOURNAMENTS_ENDED,
     CHESS_SAVE_FAILURE,
     CHESS_SUCCESS,
-    CHESS_NO_GAMES
+    CHESS_NO_GAMES,
+    CHESS_LOAD_FAILURE,
+    CHESS_INVALID_QUERY,
+    CHESS_CONNECTION_FAILURE
 } ChessResult ;
 
 /*
@@ -32,9 +36,113 @@ typedef enum {
     DRAW
 } Winner;
 
+/** Type for specifying the result of a game for one of its players */
+typedef enum {
+    CHESS_GAME_WIN,
+    CHESS_GAME_LOSS,
+    CHESS_GAME_DRAW
+} ChessGameResult;
+
+/** Type for defining a game in the history of a player */
+typedef struct {
+    int tournament_id;
+    int opponent_id;
+    ChessGameResult result;
+    int play_time;
+} ChessPlayerGame;
+
+/** The cursor of chessPlayerGames once there are no more games */
+#define CHESS_GAMES_END -1
+
+/** Type for defining a game found by its play time */
+typedef struct {
+    int tournament_id;
+    int first_player;
+    int second_player;
+    Winner winner;
+    int play_time;
+} ChessTimedGame;
+
+/** The tournament ID that stands for all the tournaments of the system in the play time queries */
+#define CHESS_ALL_TOURNAMENTS 0
+
+/** Type for defining a query over the games of a chess system */
+typedef struct chess_query_t *ChessQuery;
+
+/** Type for specifying how the games of a query are grouped */
+typedef enum {
+    CHESS_GROUP_NONE,
+    CHESS_GROUP_TOURNAMENT,
+    CHESS_GROUP_PLAYER,
+    CHESS_GROUP_WINNER
+} ChessQueryGroup;
+
+/** Type for specifying the value of a game that a query aggregates */
+typedef enum {
+    CHESS_FIELD_PLAY_TIME,
+    CHESS_FIELD_POINTS,
+    CHESS_FIELD_WINS,
+    CHESS_FIELD_LOSSES,
+    CHESS_FIELD_DRAWS
+} ChessQueryField;
+
+/** Type for specifying how a query aggregates a value over a group */
+typedef enum {
+    CHESS_AGGREGATE_COUNT,
+    CHESS_AGGREGATE_SUM,
+    CHESS_AGGREGATE_MIN,
+    CHESS_AGGREGATE_MAX,
+    CHESS_AGGREGATE_AVERAGE
+} ChessQueryAggregate;
+
+/** The number of aggregates a query can have */
+#define CHESS_QUERY_MAX_AGGREGATES 8
+
+/** Type for defining a group of a query result */
+typedef struct {
+    int group;
+    int count;
+    double values[CHESS_QUERY_MAX_AGGREGATES];
+} ChessQueryRow;
+
 /** Type for representing a chess system that organizes chess tournaments */
 typedef struct chess_system_t *ChessSystem;
 
+/** Type for defining a background export */
+typedef struct chess_export_t *ChessExport;
+
+/** Type for representing a chess system split into shards by tournament ID */
+typedef struct chess_sharded_system_t *ChessShardedSystem;
+
+/** Type for defining the process wide metrics, declared in chess_metrics.h */
+typedef struct chess_metrics_t ChessMetrics;
+
+/** Type for defining the kinds of structures the memory of a chess system is counted by */
+typedef enum {
+    CHESS_MEMORY_TOURNAMENTS,
+    CHESS_MEMORY_LOCATIONS,
+    CHESS_MEMORY_GAMES,
+    CHESS_MEMORY_PLAYERS,
+    CHESS_MEMORY_KEYS,
+    CHESS_MEMORY_FROZEN,
+    CHESS_MEMORY_RATINGS,
+    CHESS_MEMORY_INDEXES,
+    CHESS_MEMORY_SKETCHES,
+    CHESS_MEMORY_CATEGORIES
+} ChessMemoryCategory;
+
+/** Type for defining bytes and allocations by kind of structure */
+typedef struct {
+    size_t bytes[CHESS_MEMORY_CATEGORIES];
+    size_t allocations[CHESS_MEMORY_CATEGORIES];
+} ChessMemoryFootprint;
+
+/** Type for defining the footprint of one tournament */
+typedef struct {
+    int tournament_id;
+    ChessMemoryFootprint footprint;
+} ChessTournamentMemory;
+
 /**
  * chessCreate: create an empty chess system.
  *
@@ -179,4 +287,813 @@ ChessResult chessSavePlayersLevels (ChessSystem chess, FILE* file);
  */
 ChessResult chessSaveTournamentStatistics (ChessSystem chess, char* path_file);
 
+/**
+ * chessAppendTournamentStatistics: appends to the file the statistics of the tournaments that ended since
+ *                                  the last append or compaction, in the format of chessSaveTournamentStatistics.
+ *                                  Ended tournaments never change, so the cost is only of the newly ended ones.
+ *                                  The tournaments to append are kept by snapshots and the journal, so a
+ *                                  system that was loaded or recovered appends what the saved one would.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param path_file - the statistics file to append to. It is created if it does not exist.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or path_file are NULL.
+ *     CHESS_NO_TOURNAMENTS_ENDED - if no tournament ended since the last append or compaction.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if an error occurred while saving. The same tournaments are appended next time.
+ *     CHESS_SUCCESS - if the statistics were appended successfully.
+ */
+ChessResult chessAppendTournamentStatistics (ChessSystem chess, char* path_file);
+
+/**
+ * chessSaveTournamentDurationStatistics: prints to the file the statistics for each tournament that ended, in
+ *                                        the format of chessSaveTournamentStatistics, each tournament followed
+ *                                        by the median, p90 and p99 game time of the tournament, one a line
+ *                                        with 2 decimals. The quantiles are estimates, as in
+ *                                        chessTournamentDurationQuantile.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param path_file - the file path which within it the tournament statistics will be saved.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or path_file are NULL.
+ *     CHESS_NO_TOURNAMENTS_ENDED - if there are no tournaments ended in the system.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if an error occurred while saving.
+ *     CHESS_SUCCESS - if the statistics were printed successfully.
+ */
+ChessResult chessSaveTournamentDurationStatistics (ChessSystem chess, char* path_file);
+
+/**
+ * chessCompactTournamentStatistics: rewrites the file with the statistics of all the ended tournaments
+ *                                   ordered by id, exactly as chessSaveTournamentStatistics, and starts
+ *                                   chessAppendTournamentStatistics over from it. Removed tournaments are dropped.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param path_file - the statistics file to rewrite.
+ * @return
+ *     The same results as chessSaveTournamentStatistics, and CHESS_OUT_OF_MEMORY if an allocation failed.
+ */
+ChessResult chessCompactTournamentStatistics (ChessSystem chess, char* path_file);
+
+/**
+ * chessSavePlayersLevelsAsync: captures the levels of all players, and sorts and prints them to the file
+ *                              on a background thread, exactly as chessSavePlayersLevels. The chess system
+ *                              may be changed or destroyed while the export runs, without affecting its output.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param file - an open, writable output stream. It must not be used until the export finished.
+ * @param export_handle - where to store the handle of the export, to pass to chessExportWait.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if one of the arguments is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed, or the thread could not be started.
+ *     CHESS_SUCCESS - if the export was started.
+ */
+ChessResult chessSavePlayersLevelsAsync (ChessSystem chess, FILE* file, ChessExport* export_handle);
+
+/**
+ * chessSaveTournamentStatisticsAsync: captures the statistics of the ended tournaments, and prints them to
+ *                                     the file on a background thread, exactly as chessSaveTournamentStatistics.
+ *                                     The chess system may be changed or destroyed while the export runs.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param path_file - the file path which within it the tournament statistics will be saved.
+ * @param export_handle - where to store the handle of the export, to pass to chessExportWait.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if one of the arguments is NULL.
+ *     CHESS_NO_TOURNAMENTS_ENDED - if there are no tournaments ended in the system. No export is started.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed, or the thread could not be started.
+ *     CHESS_SUCCESS - if the export was started.
+ */
+ChessResult chessSaveTournamentStatisticsAsync (ChessSystem chess, char* path_file, ChessExport* export_handle);
+
+/**
+ * chessExportPoll: returns if a background export finished. Does not block.
+ *
+ * @param export_handle - the export handle.
+ * @return
+ *     true - if the export finished, or export_handle is NULL.
+ *     false - otherwise.
+ */
+bool chessExportPoll (ChessExport export_handle);
+
+/**
+ * chessExportWait: waits for a background export to finish and frees its handle.
+ *
+ * @param export_handle - the export handle. It must not be used afterwards.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if export_handle is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed in the export.
+ *     CHESS_SAVE_FAILURE - if an error occurred while saving.
+ *     CHESS_SUCCESS - if the export was saved successfully.
+ */
+ChessResult chessExportWait (ChessExport export_handle);
+
+/**
+ * chessTopPlayers: returns the k players with the highest levels, by the level formula and the
+ *                  order of chessSavePlayersLevels, without printing all the players. Runs in
+ *                  O(P log k) for P players with games.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param k - the number of players to return. Nothing is returned if k is not positive.
+ * @param out_ids - an array of at least k ids, filled with the ids of the players from the highest
+ *                  level. If fewer than k players played, the rest of the array is filled with -1.
+ * @param out_levels - an array of at least k levels, filled with the levels of the players in
+ *                     out_ids, and 0 after the last player.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess, out_ids or out_levels are NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessTopPlayers (ChessSystem chess, int k, int* out_ids, double* out_levels);
+
+/**
+ * chessGeneratePairings: pairs the players of the next round of a tournament by the Swiss system. The players
+ *                        are ranked by their points in the tournament, and every player, from the top of the
+ *                        standings, is paired with the next free player he did not play in the tournament.
+ *                        Players that already played max_games_per_player games are not paired, so every
+ *                        pair can be added with chessAddGame. With an odd number of players, or when the
+ *                        remaining players all played each other, some players are left without a game.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param tournament_id - the tournament ID. Must be positive, and unique.
+ * @param out_pairs - an array of 2 * capacity ids, filled with the pairs of the round: the ids of the first
+ *                    and the second player of each pair, the pairs in the order of the standings.
+ * @param capacity - the number of pairs out_pairs can hold. Pairs after it are not stored.
+ * @param out_count - this variable will contain the number of pairs of the round, even if more than capacity.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or out_count are NULL, or out_pairs is NULL and capacity is positive.
+ *     CHESS_INVALID_ID - the tournament ID number is invalid.
+ *     CHESS_TOURNAMENT_NOT_EXIST - if the tournament does not exist in the system.
+ *     CHESS_TOURNAMENT_ENDED - if the tournament already ended.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - if the pairs were generated.
+ */
+ChessResult chessGeneratePairings (ChessSystem chess, int tournament_id, int* out_pairs, int capacity, int* out_count);
+
+/**
+ * chessTournamentsByLocation: returns the IDs of the tournaments held in a location, in increasing order.
+ *                             Every location keeps its tournaments, so the other tournaments of the
+ *                             system are not scanned.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param location - the location name. Must be non-NULL and valid as in chessAddTournament.
+ * @param out_ids - an array of capacity IDs, filled with the tournaments of the location.
+ * @param capacity - the number of IDs out_ids can hold. IDs after it are not stored.
+ * @param out_count - this variable will contain the number of tournaments in the location, even if more
+ *                    than capacity.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess, location or out_count are NULL, or out_ids is NULL and capacity is positive.
+ *     CHESS_INVALID_LOCATION - if the location name is not valid.
+ *     CHESS_SUCCESS - otherwise, also if no tournament is held in the location.
+ */
+ChessResult chessTournamentsByLocation (ChessSystem chess, const char* location, int* out_ids, int capacity,
+                                        int* out_count);
+
+/**
+ * chessHeadToHead: returns the record between two players over all the games they played against each
+ *                  other, in every tournament of the system. Games of removed tournaments are not counted,
+ *                  nor games a removed player had in tournaments that had not ended. Runs in time
+ *                  proportional to the number of games the two players played against each other.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param first_player - the player the record is counted for. Must be positive.
+ * @param second_player - the opponent. Must be positive, and different from first_player.
+ * @param wins - this variable will contain the number of games first_player won.
+ * @param losses - this variable will contain the number of games first_player lost.
+ * @param draws - this variable will contain the number of games that ended in a draw.
+ * @param total_time - this variable will contain the total play time of the games.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or any of the output arguments are NULL.
+ *     CHESS_INVALID_ID - if a player ID is not positive, or both IDs are the same.
+ *     CHESS_PLAYER_NOT_EXIST - if one of the players does not exist in the system.
+ *     CHESS_SUCCESS - if the record was returned successfully.
+ */
+ChessResult chessHeadToHead (ChessSystem chess, int first_player, int second_player, int* wins, int* losses,
+                             int* draws, int* total_time);
+
+/**
+ * chessPlayerGames: returns a page of the games of a player, in increasing tournament ID order and in the
+ *                   order the games were added within a tournament. Start with a cursor of 0 and pass the
+ *                   cursor back for the next page, until it is CHESS_GAMES_END. Games added or removed
+ *                   between pages do not move the cursor. A game whose opponent was removed from the system
+ *                   is a win, against opponent -1. A page takes time proportional to its size, and to the
+ *                   logarithm of the number of games of the player.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param player_id - player ID. Must be positive.
+ * @param cursor - the position to read from, 0 for the first game. Set to the position to read the next
+ *                 page from, or to CHESS_GAMES_END if no games are left after this page.
+ * @param out_games - an array of capacity games, filled with the games of the page.
+ * @param capacity - the number of games out_games can hold.
+ * @param out_count - this variable will contain the number of games in the page.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess, cursor or out_count are NULL, or out_games is NULL and capacity is positive.
+ *     CHESS_INVALID_ID - if the player ID is not positive.
+ *     CHESS_PLAYER_NOT_EXIST - if the player does not exist in the system.
+ *     CHESS_SUCCESS - if the page was returned successfully.
+ */
+ChessResult chessPlayerGames (ChessSystem chess, int player_id, long long* cursor, ChessPlayerGame* out_games,
+                              int capacity, int* out_count);
+
+/**
+ * chessCommonPlayers: returns the IDs of the players that played in both tournaments, in increasing order.
+ *                     Every tournament keeps a compressed bitmap of its players, so the two bitmaps are
+ *                     intersected without going over the games. A player removed from the system is not
+ *                     in the tournaments that had not ended when the player was removed.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param first_tournament - a tournament ID. Must be positive.
+ * @param second_tournament - another tournament ID. Must be positive. If it is first_tournament, the players
+ *                            of that tournament are returned.
+ * @param out_ids - an array of capacity IDs, filled with the common players.
+ * @param capacity - the number of IDs out_ids can hold. IDs after it are not stored.
+ * @param out_count - this variable will contain the number of common players, even if more than capacity.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or out_count are NULL, or out_ids is NULL and capacity is positive.
+ *     CHESS_INVALID_ID - if a tournament ID is not positive.
+ *     CHESS_TOURNAMENT_NOT_EXIST - if one of the tournaments does not exist in the system.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessCommonPlayers (ChessSystem chess, int first_tournament, int second_tournament, int* out_ids,
+                                int capacity, int* out_count);
+
+/**
+ * chessCommonTournaments: returns the IDs of the tournaments both players played in, in increasing order.
+ *                         Every player keeps a compressed bitmap of the tournaments of that player, so
+ *                         the two bitmaps are intersected without going over the tournaments.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param first_player - a player ID. Must be positive.
+ * @param second_player - another player ID. Must be positive. If it is first_player, the tournaments of
+ *                        that player are returned.
+ * @param out_ids - an array of capacity IDs, filled with the common tournaments.
+ * @param capacity - the number of IDs out_ids can hold. IDs after it are not stored.
+ * @param out_count - this variable will contain the number of common tournaments, even if more than capacity.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or out_count are NULL, or out_ids is NULL and capacity is positive.
+ *     CHESS_INVALID_ID - if a player ID is not positive.
+ *     CHESS_PLAYER_NOT_EXIST - if one of the players does not exist in the system.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessCommonTournaments (ChessSystem chess, int first_player, int second_player, int* out_ids,
+                                    int capacity, int* out_count);
+
+/**
+ * chessTournamentDurationQuantile: returns an estimate of a quantile of the play times of the games of a
+ *                                  tournament, such as 0.5 for the median or 0.99 for p99. Every tournament
+ *                                  keeps a streaming sketch of its play times, of a few KB at most no matter
+ *                                  how many games it has, and the estimate is within 1% of the play time
+ *                                  of that rank.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param tournament_id - the tournament ID. Must be positive.
+ * @param quantile - the quantile, between 0 and 1. Values outside are taken as 0 or 1.
+ * @param out_duration - this variable will contain the estimate.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or out_duration are NULL.
+ *     CHESS_INVALID_ID - the tournament ID number is invalid.
+ *     CHESS_TOURNAMENT_NOT_EXIST - if the tournament does not exist in the system.
+ *     CHESS_NO_GAMES - if the tournament has no games.
+ *     CHESS_SUCCESS - if the estimate was returned successfully.
+ */
+ChessResult chessTournamentDurationQuantile (ChessSystem chess, int tournament_id, double quantile,
+                                             double* out_duration);
+
+/**
+ * chessPlayerDurationQuantile: returns an estimate of a quantile of the play times of the games of a player,
+ *                              over the games listed by chessPlayerGames, with the accuracy of
+ *                              chessTournamentDurationQuantile.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param player_id - the player ID. Must be positive.
+ * @param quantile - the quantile, between 0 and 1. Values outside are taken as 0 or 1.
+ * @param out_duration - this variable will contain the estimate.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or out_duration are NULL.
+ *     CHESS_INVALID_ID - if the player ID number is invalid.
+ *     CHESS_PLAYER_NOT_EXIST - if the player does not exist in the system.
+ *     CHESS_NO_GAMES - if the player has no games.
+ *     CHESS_SUCCESS - if the estimate was returned successfully.
+ */
+ChessResult chessPlayerDurationQuantile (ChessSystem chess, int player_id, double quantile, double* out_duration);
+
+/**
+ * chessCountGamesInTimeRange: returns the number of games with a play time between min_time and max_time,
+ *                             inclusive, in a tournament or in the whole system. Every tournament keeps its
+ *                             games ordered by play time, so a count takes a binary search per tournament.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param tournament_id - the tournament ID, or CHESS_ALL_TOURNAMENTS for every tournament of the system.
+ * @param min_time - the lowest play time of the range. Must be non-negative.
+ * @param max_time - the highest play time of the range. Must not be lower than min_time.
+ * @param out_count - this variable will contain the number of games.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or out_count are NULL.
+ *     CHESS_INVALID_ID - if the tournament ID is negative.
+ *     CHESS_TOURNAMENT_NOT_EXIST - if the tournament does not exist in the system.
+ *     CHESS_INVALID_PLAY_TIME - if min_time is negative or max_time is lower than min_time.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessCountGamesInTimeRange (ChessSystem chess, int tournament_id, int min_time, int max_time,
+                                        int* out_count);
+
+/**
+ * chessGamesInTimeRange: returns the games with a play time between min_time and max_time, inclusive, in a
+ *                        tournament or in the whole system, in increasing tournament ID order, and in
+ *                        increasing play time order inside a tournament. A player removed from a game of a
+ *                        tournament that had not ended is -1 in it, with the winner changed as in
+ *                        chessRemovePlayer. Only the games in the range are read.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param tournament_id - the tournament ID, or CHESS_ALL_TOURNAMENTS for every tournament of the system.
+ * @param min_time - the lowest play time of the range. Must be non-negative.
+ * @param max_time - the highest play time of the range. Must not be lower than min_time.
+ * @param out_games - an array of capacity games, filled with the games in the range.
+ * @param capacity - the number of games out_games can hold. Games after it are not stored.
+ * @param out_count - this variable will contain the number of games in the range, even if more than capacity.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or out_count are NULL, or out_games is NULL and capacity is positive.
+ *     CHESS_INVALID_ID - if the tournament ID is negative.
+ *     CHESS_TOURNAMENT_NOT_EXIST - if the tournament does not exist in the system.
+ *     CHESS_INVALID_PLAY_TIME - if min_time is negative or max_time is lower than min_time.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessGamesInTimeRange (ChessSystem chess, int tournament_id, int min_time, int max_time,
+                                   ChessTimedGame* out_games, int capacity, int* out_count);
+
+/**
+ * chessQueryCreate: creates a query over the games of a chess system, with no filters, no grouping and no
+ *                   aggregates. A query is built with the chessQuery functions below, run with chessQueryRun
+ *                   on any number of systems, and freed with chessQueryDestroy.
+ *
+ *                   A query reads every game that passes all its filters. A game is seen from the side of
+ *                   one of its players, which the points, wins, losses and draws fields are counted for:
+ *                   - with a player filter, from the side of that player;
+ *                   - grouped by player, from the side of each of its players, so the game is in the
+ *                     groups of both;
+ *                   - otherwise from the side of the first player.
+ *                   A player removed from a game of a tournament that had not ended is left out of it, as in
+ *                   chessPlayerGames.
+ *
+ * @return A new query in case of success, and NULL otherwise (e.g. in case of an allocation error).
+ */
+ChessQuery chessQueryCreate();
+
+/**
+ * chessQueryDestroy: frees a query.
+ *
+ * @param query - the query to free. A NULL value is allowed, and in that case the function does nothing.
+ */
+void chessQueryDestroy(ChessQuery query);
+
+/**
+ * chessQueryFilterTournaments: keeps only the games of a set of tournaments. Tournaments of the set that do not
+ *                              exist in the system are skipped when the query runs. Replaces the set of a
+ *                              previous call.
+ *
+ * @param query - a query. Must be non-NULL.
+ * @param tournament_ids - the IDs of the tournaments.
+ * @param count - the number of IDs.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if query is NULL, or tournament_ids is NULL and count is positive.
+ *     CHESS_INVALID_ID - if one of the IDs is not positive.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessQueryFilterTournaments (ChessQuery query, const int* tournament_ids, int count);
+
+/**
+ * chessQueryFilterPlayer: keeps only the games of a player, seen from the side of that player.
+ *
+ * @param query - a query. Must be non-NULL.
+ * @param player_id - the player ID. Must be positive.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if query is NULL.
+ *     CHESS_INVALID_ID - if the player ID is not positive.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessQueryFilterPlayer (ChessQuery query, int player_id);
+
+/**
+ * chessQueryFilterWinner: keeps the games that ended with a winner kind. The first call keeps only games of that
+ *                         kind, and every call adds its kind to the kept ones.
+ *
+ * @param query - a query. Must be non-NULL.
+ * @param winner - FIRST_PLAYER, SECOND_PLAYER or DRAW.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if query is NULL.
+ *     CHESS_INVALID_QUERY - if winner is not a winner kind.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessQueryFilterWinner (ChessQuery query, Winner winner);
+
+/**
+ * chessQueryFilterTime: keeps only the games with a play time between min_time and max_time, inclusive. The
+ *                       games of a tournament are read from its play time index, so only the games in the
+ *                       range are read.
+ *
+ * @param query - a query. Must be non-NULL.
+ * @param min_time - the lowest play time of the range. Must be non-negative.
+ * @param max_time - the highest play time of the range. Must not be lower than min_time.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if query is NULL.
+ *     CHESS_INVALID_PLAY_TIME - if min_time is negative or max_time is lower than min_time.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessQueryFilterTime (ChessQuery query, int min_time, int max_time);
+
+/**
+ * chessQueryGroupBy: sets how the games of a query are grouped. A query with CHESS_GROUP_NONE, the default, has
+ *                    one group of all the games, with the group 0. The groups of CHESS_GROUP_WINNER are the values
+ *                    of Winner.
+ *
+ * @param query - a query. Must be non-NULL.
+ * @param group - the grouping.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if query is NULL.
+ *     CHESS_INVALID_QUERY - if group is not a grouping.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessQueryGroupBy (ChessQuery query, ChessQueryGroup group);
+
+/**
+ * chessQueryAggregate: adds an aggregate of a field to a query. The aggregates are computed for every group, in
+ *                      the order they were added. CHESS_AGGREGATE_COUNT counts the games of the group whatever
+ *                      the field.
+ *
+ * @param query - a query. Must be non-NULL.
+ * @param aggregate - the aggregate.
+ * @param field - the value of a game that is aggregated.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if query is NULL.
+ *     CHESS_INVALID_QUERY - if aggregate or field are not valid, or the query already has
+ *                           CHESS_QUERY_MAX_AGGREGATES aggregates.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessQueryAggregate (ChessQuery query, ChessQueryAggregate aggregate, ChessQueryField field);
+
+/**
+ * chessQueryRun: runs a query over the games of a chess system, and returns its groups in increasing group
+ *                order. The games are read in one pass, in batches whose filters, fields and aggregates are
+ *                computed column by column. Groups with no games are not returned.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param query - the query. Must be non-NULL.
+ * @param out_rows - an array of capacity rows, filled with the groups. The values of a row are the aggregates of
+ *                   the query, in the order they were added.
+ * @param capacity - the number of rows out_rows can hold. Rows after it are not stored.
+ * @param out_count - this variable will contain the number of groups, even if more than capacity.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess, query or out_count are NULL, or out_rows is NULL and capacity is positive.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessQueryRun (ChessSystem chess, ChessQuery query, ChessQueryRow* out_rows, int capacity,
+                           int* out_count);
+
+/**
+ * chessGetPlayerRating: returns the Elo rating of a player. Every player starts at 1500, and every
+ *                       game moves the ratings of its two players by up to 32 points, by the result
+ *                       and the expected result of their ratings. Ratings are not taken back when a
+ *                       tournament is removed. When a player is removed, every game of his in a
+ *                       tournament that had not ended becomes a win of his opponent, which adds 32
+ *                       points times the score the opponent gains. A removed player that plays again
+ *                       starts over from 1500.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param player_id - player ID. Must be positive.
+ * @param chess_result - this variable will contain the returned error code.
+ * @return
+ *     The rating of the player in case of success, and 0 otherwise. chess_result will contain:
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_INVALID_ID - if the player ID is not positive.
+ *     CHESS_PLAYER_NOT_EXIST - if the player does not exist in the system.
+ *     CHESS_SUCCESS - if the rating was returned successfully.
+ */
+double chessGetPlayerRating (ChessSystem chess, int player_id, ChessResult* chess_result);
+
+/**
+ * chessRecalculateRatings: rates all the players again from 1500, by every game and removal in the
+ *                          order they happened, as described in chessGetPlayerRating. It gives the
+ *                          ratings the games and removals gave one by one, and is used to check them
+ *                          or to rebuild them.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - if the ratings were recalculated.
+ */
+ChessResult chessRecalculateRatings (ChessSystem chess);
+
+/**
+ * chessSavePlayersRatings: prints the rating of each player that played at least one game, in the format
+ *                          and order of chessSavePlayersLevels, with the rating in place of the level.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param file - an open, writable output stream, to which the ratings are printed.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or file are NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if an error occurred while saving.
+ *     CHESS_SUCCESS - if the ratings were printed successfully.
+ */
+ChessResult chessSavePlayersRatings (ChessSystem chess, FILE* file);
+
+/**
+ * chessSaveSnapshot: saves the whole chess system - tournaments, locations, games, player
+ *                    aggregates, ratings, the stats removed players kept and the tournaments
+ *                    chessAppendTournamentStatistics has yet to append - to a versioned and
+ *                    checksummed binary snapshot file.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param path_file - the file path to which the snapshot will be saved.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or path_file are NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if an error occurred while saving.
+ *     CHESS_SUCCESS - if the snapshot was saved successfully.
+ */
+ChessResult chessSaveSnapshot (ChessSystem chess, const char* path_file);
+
+/**
+ * chessLoadSnapshot: creates a chess system from a snapshot file saved by chessSaveSnapshot.
+ *                    The file is mapped into memory and the system is built directly from it,
+ *                    with the stored player aggregates and ended tournaments already frozen.
+ *
+ * @param path_file - the snapshot file path.
+ * @param chess_result - this variable will contain the returned error code.
+ * @return
+ *     A new chess system in case of success, and NULL otherwise. chess_result will contain:
+ *     CHESS_NULL_ARGUMENT - if path_file is NULL.
+ *     CHESS_LOAD_FAILURE - if the file could not be read, or is not a valid snapshot.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - if the chess system was loaded successfully.
+ */
+ChessSystem chessLoadSnapshot (const char* path_file, ChessResult* chess_result);
+
+/**
+ * chessJournalStart: starts appending every successful chessAddTournament, chessAddGame,
+ *                    chessRemoveTournament, chessRemovePlayer, chessEndTournament and chessRecalculateRatings
+ *                    call, and every statistics append or compaction, to a journal file.
+ *                    Records are written and synced in groups, so a crash loses at most the
+ *                    last group_commit - 1 operations. A journal that was already started is closed first.
+ *                    The room for the record of an operation is allocated before the operation changes
+ *                    the system, so an operation that returns CHESS_OUT_OF_MEMORY is neither applied nor
+ *                    journaled. An operation whose record could not be written is applied, but returns
+ *                    CHESS_SAVE_FAILURE, and once the journal failed every mutating operation returns it
+ *                    until journaling is stopped or restarted, as a recovery would not see them.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param path_file - the journal file path. An existing journal is appended to, after a torn
+ *     record left at its end by a crash is truncated.
+ * @param group_commit - number of operations synced together. Values below 1 are treated as 1.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or path_file are NULL.
+ *     CHESS_SAVE_FAILURE - if the journal could not be opened, or the previous journal failed.
+ *     CHESS_SUCCESS - if journaling was started successfully.
+ */
+ChessResult chessJournalStart (ChessSystem chess, const char* path_file, int group_commit);
+
+/**
+ * chessJournalSync: writes and syncs the journal operations of the current group.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_SAVE_FAILURE - if writing the journal failed since it was started.
+ *     CHESS_SUCCESS - if the journal is up to date, or journaling is off.
+ */
+ChessResult chessJournalSync (ChessSystem chess);
+
+/**
+ * chessJournalStop: syncs and closes the journal. Following operations are not journaled.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_SAVE_FAILURE - if writing the journal failed since it was started.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessJournalStop (ChessSystem chess);
+
+/**
+ * chessRecover: rebuilds a chess system from the latest snapshot and the journal tail - the journaled
+ *               operations that happened after the snapshot was saved. A half written record at the
+ *               end of the journal, left by a crash, ends the replay.
+ *
+ * @param snapshot_path - the snapshot file path, or NULL to replay the journal from an empty system.
+ * @param journal_path - the journal file path. If it is NULL or missing only the snapshot is loaded.
+ * @param chess_result - this variable will contain the returned error code.
+ * @return
+ *     A new chess system in case of success, and NULL otherwise. chess_result will contain:
+ *     CHESS_LOAD_FAILURE - if the snapshot is not valid, or a journal operation could not be replayed.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - if the chess system was recovered successfully.
+ */
+ChessSystem chessRecover (const char* snapshot_path, const char* journal_path, ChessResult* chess_result);
+
+/**
+ * chessTraceStart: starts recording every call of the chessSystem.h operations on the system - add and
+ *                  remove tournament, add game, remove player, end tournament, average play time and both
+ *                  exports - with its arguments, result and duration, to a compact binary trace file.
+ *                  Failed calls are recorded too, so replaying the trace on an empty system repeats the
+ *                  exact same calls and results. A trace that was already started is closed first.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param path_file - the trace file path. An existing file is replaced.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or path_file are NULL.
+ *     CHESS_SAVE_FAILURE - if the trace file could not be created.
+ *     CHESS_SUCCESS - if tracing started.
+ */
+ChessResult chessTraceStart (ChessSystem chess, const char* path_file);
+
+/**
+ * chessTraceStop: writes the buffered trace records and closes the trace. Following calls are not traced.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_SAVE_FAILURE - if writing the trace failed since it was started.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessTraceStop (ChessSystem chess);
+
+/**
+ * chessSpansStart: starts recording the spans of the internal phases - each public operation, and inside them
+ *                  phases such as captureLevelRows, the sort and the writes of chessSavePlayersLevels, or the
+ *                  validation, tournamentAddGame and player updates of chessAddGame - as Chrome trace-event
+ *                  JSON, for trace viewers. Spans are recorded only when the chess system is compiled with
+ *                  -DCHESS_SPANS. Recording can also be started by setting the CHESS_SPANS_FILE environment
+ *                  variable. A recording that was already started is closed first.
+ *
+ * @param path_file - the JSON file path. An existing file is replaced.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if path_file is NULL.
+ *     CHESS_SAVE_FAILURE - if the file could not be created.
+ *     CHESS_SUCCESS - if recording started.
+ */
+ChessResult chessSpansStart (const char* path_file);
+
+/**
+ * chessSpansStop: stops recording spans and closes the JSON file.
+ *
+ * @return
+ *     CHESS_SAVE_FAILURE - if writing the file failed.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessSpansStop ();
+
+/**
+ * chessGetMetrics: copies the process wide metrics - calls and latency histograms of every public
+ *                  operation, and counts of map lookups, puts, iterations and key copies.
+ *                  The metrics are collected only when the chess system is compiled with -DCHESS_METRICS,
+ *                  otherwise they are all zero.
+ *
+ * @param metrics - where to copy the metrics.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if metrics is NULL.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessGetMetrics (ChessMetrics* metrics);
+
+/**
+ * chessResetMetrics: zeroes the process wide metrics.
+ */
+void chessResetMetrics ();
+
+/**
+ * chessDumpMetrics: prints the process wide metrics as a table of the operations, with their calls, average,
+ *                   p50, p99, p999 and max latency in nanoseconds, followed by the map operation counters.
+ *
+ * @param file - an open, writable output stream.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if file is NULL.
+ *     CHESS_SAVE_FAILURE - if an error occurred while printing.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessDumpMetrics (FILE* file);
+
+/**
+ * chessMemoryUsage: returns the memory allocated for the data of the chess system, by tournament and by
+ *                   kind of structure - tournaments, locations, games, players, keys and frozen tournaments.
+ *                   Each tournament's footprint includes its key in the system. The total adds the players
+ *                   totals of the system and their keys. Memory of the map library nodes is not included.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param total - where to store the footprint of the whole system.
+ * @param tournaments - where to store the footprint of each tournament, in id order. May be NULL if
+ *                      capacity is 0.
+ * @param capacity - the number of footprints tournaments can hold. Further tournaments are only counted.
+ * @param count - where to store the number of tournaments in the system.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess, total or count are NULL, or tournaments is NULL and capacity is positive.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessMemoryUsage (ChessSystem chess, ChessMemoryFootprint* total, ChessTournamentMemory* tournaments,
+                              int capacity, int* count);
+
+/**
+ * chessLiveMemory: returns the process wide counters of the accounting allocator - the bytes and allocations
+ *                  currently live of every kind of structure, over all the chess systems.
+ *
+ * @param live - where to store the counters.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if live is NULL.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessLiveMemory (ChessMemoryFootprint* live);
+
+/**
+ * chessShardedCreate: create an empty chess system split into shards. Every shard is an independent chess
+ *                     system with its own worker thread, holding the tournaments whose ID modulo the number of
+ *                     shards is its index. The chessSharded functions behave exactly as the chess functions of
+ *                     the same name on one system with all the tournaments, and may be called by one thread at
+ *                     a time.
+ *
+ * @param number_of_shards - the number of shards. Must be positive.
+ * @return A new sharded system in case of success, and NULL if number_of_shards is not positive, an allocation
+ *     failed or a thread could not be started.
+ */
+ChessShardedSystem chessShardedCreate (int number_of_shards);
+
+/**
+ * chessShardedDestroy: stop the threads of a sharded system and free it, and all its shards, from memory.
+ *
+ * @param sharded - the sharded system to free from memory. A NULL value is allowed, and in that case the
+ *     function does nothing.
+ */
+void chessShardedDestroy (ChessShardedSystem sharded);
+
+/**
+ * chessShardedAddTournament: chessAddTournament, run on the shard of the tournament.
+ *
+ * @return
+ *     The same results as chessAddTournament.
+ */
+ChessResult chessShardedAddTournament (ChessShardedSystem sharded, int tournament_id, int max_games_per_player,
+                                       const char* tournament_location);
+
+/**
+ * chessShardedAddGame: chessAddGame, run on the shard of the tournament.
+ *
+ * @return
+ *     The same results as chessAddGame.
+ */
+ChessResult chessShardedAddGame (ChessShardedSystem sharded, int tournament_id, int first_player,
+                                 int second_player, Winner winner, int play_time);
+
+/**
+ * chessShardedRemoveTournament: chessRemoveTournament, run on the shard of the tournament.
+ *
+ * @return
+ *     The same results as chessRemoveTournament.
+ */
+ChessResult chessShardedRemoveTournament (ChessShardedSystem sharded, int tournament_id);
+
+/**
+ * chessShardedRemovePlayer: chessRemovePlayer, run on all the shards at once. The player is removed if any
+ *                           shard had it.
+ *
+ * @return
+ *     The same results as chessRemovePlayer.
+ */
+ChessResult chessShardedRemovePlayer (ChessShardedSystem sharded, int player_id);
+
+/**
+ * chessShardedEndTournament: chessEndTournament, run on the shard of the tournament.
+ *
+ * @return
+ *     The same results as chessEndTournament.
+ */
+ChessResult chessShardedEndTournament (ChessShardedSystem sharded, int tournament_id);
+
+/**
+ * chessShardedCalculateAveragePlayTime: chessCalculateAveragePlayTime, from the play times of the player's
+ *                                       games in all the shards, gathered at once.
+ *
+ * @return
+ *     The same results as chessCalculateAveragePlayTime.
+ */
+double chessShardedCalculateAveragePlayTime (ChessShardedSystem sharded, int player_id, ChessResult* chess_result);
+
+/**
+ * chessShardedSavePlayersLevels: chessSavePlayersLevels, from the totals of every player summed over all the
+ *                                shards, gathered at once.
+ *
+ * @return
+ *     The same results as chessSavePlayersLevels.
+ */
+ChessResult chessShardedSavePlayersLevels (ChessShardedSystem sharded, FILE* file);
+
+/**
+ * chessShardedSaveTournamentStatistics: chessSaveTournamentStatistics, from the statistics of the ended
+ *                                       tournaments of all the shards, gathered at once and merged in ID order.
+ *
+ * @return
+ *     The same results as chessSaveTournamentStatistics.
+ */
+ChessResult chessShardedSaveTournamentStatistics (ChessShardedSystem sharded, char* path_file);
+
 #endif //_CHESSSYSTEM_H
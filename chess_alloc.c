@@ -0,0 +1,68 @@
+#include <stdlib.h>
+#include "chessSystem.h"
+#include "chess_alloc.h"
+
+static ChessMemoryFootprint live_memory;
+
+/**
+ * countMemory: Atomically adds to the live counters of a kind of structure.
+ *
+ * @param category - The kind of structure.
+ * @param bytes - The bytes to add, negative to subtract.
+ * @param allocations - The allocations to add, negative to subtract.
+ */
+static void countMemory(ChessMemoryCategory category, long long bytes, int allocations)
+{
+    __atomic_fetch_add(&live_memory.bytes[category], (size_t)bytes, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&live_memory.allocations[category], (size_t)(long long)allocations, __ATOMIC_RELAXED);
+}
+
+void *accountedMalloc(size_t size, ChessMemoryCategory category)
+{
+    void *pointer = malloc(size);
+    if (pointer != NULL)
+    {
+        countMemory(category, (long long)size, 1);
+    }
+    return pointer;
+}
+
+void *accountedRealloc(void *pointer, size_t old_size, size_t size, ChessMemoryCategory category)
+{
+    void *resized = realloc(pointer, size);
+    if (resized != NULL)
+    {
+        countMemory(category, (long long)size - (long long)old_size, pointer == NULL ? 1 : 0);
+    }
+    return resized;
+}
+
+void accountedFree(void *pointer, size_t size, ChessMemoryCategory category)
+{
+    if (pointer == NULL)
+    {
+        return;
+    }
+    free(pointer);
+    countMemory(category, -(long long)size, -1);
+}
+
+void memoryFootprintAdd(ChessMemoryFootprint *footprint, ChessMemoryCategory category, size_t bytes, size_t allocations)
+{
+    footprint->bytes[category] += bytes;
+    footprint->allocations[category] += allocations;
+}
+
+ChessResult chessLiveMemory(ChessMemoryFootprint *live)
+{
+    if (live == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    for (int category = 0; category < CHESS_MEMORY_CATEGORIES; category++)
+    {
+        live->bytes[category] = __atomic_load_n(&live_memory.bytes[category], __ATOMIC_RELAXED);
+        live->allocations[category] = __atomic_load_n(&live_memory.allocations[category], __ATOMIC_RELAXED);
+    }
+    return CHESS_SUCCESS;
+}
@@ -0,0 +1,73 @@
+#ifndef CHESS_ALLOC_H
+#define CHESS_ALLOC_H
+#include <stddef.h>
+#include "chessSystem.h"
+
+/*
+* The accounting allocator of the chess system data.
+*
+* Games, players, keys, tournaments, locations, frozen tournaments, the rating history, the
+* indexes over the games and the sketches of their durations are allocated and freed through it,
+* with the size and the kind of structure, and it keeps process wide counters of the live bytes
+* and allocations of every kind.
+* Memory allocated inside the map library (its nodes) and by the journal, snapshots, exports
+* and queries is not counted.
+*
+* The counters are updated atomically, so they stay exact with several threads.
+*
+* The following functions are available:
+*   accountedMalloc       - Allocates memory of a kind
+*   accountedRealloc      - Resizes memory of a kind
+*   accountedFree         - Frees memory of a kind
+*   memoryFootprintAdd    - Adds bytes and allocations of a kind to a footprint
+*   chessLiveMemory       - Returns the live counters (declared in chessSystem.h)
+*   chessMemoryUsage      - Returns the footprint of a chess system (declared in chessSystem.h)
+*
+* The kinds of structures and the footprints are declared in chessSystem.h, for the callers of
+* chessMemoryUsage and chessLiveMemory.
+*/
+
+/**
+* accountedMalloc: Allocates memory and counts it as live.
+*
+* @param size - The number of bytes.
+* @param category - The kind of structure.
+* @return
+* 	NULL - if the allocation failed.
+* 	The memory otherwise.
+*/
+void *accountedMalloc(size_t size, ChessMemoryCategory category);
+
+/**
+* accountedRealloc: Resizes memory allocated by accountedMalloc.
+*
+* @param pointer - The memory.
+* @param old_size - The size it was allocated with.
+* @param size - The new size.
+* @param category - The kind of structure it was allocated as.
+* @return
+* 	NULL - if the allocation failed, in which case the memory is not changed.
+* 	The resized memory otherwise.
+*/
+void *accountedRealloc(void *pointer, size_t old_size, size_t size, ChessMemoryCategory category);
+
+/**
+* accountedFree: Frees memory allocated by accountedMalloc.
+*
+* @param pointer - The memory. If it is NULL nothing will be done.
+* @param size - The size it was allocated with.
+* @param category - The kind of structure it was allocated as.
+*/
+void accountedFree(void *pointer, size_t size, ChessMemoryCategory category);
+
+/**
+* memoryFootprintAdd: Adds bytes and allocations of a kind of structure to a footprint.
+*
+* @param footprint - The footprint.
+* @param category - The kind of structure.
+* @param bytes - The number of bytes.
+* @param allocations - The number of allocations.
+*/
+void memoryFootprintAdd(ChessMemoryFootprint *footprint, ChessMemoryCategory category, size_t bytes, size_t allocations);
+
+#endif
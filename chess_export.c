@@ -0,0 +1,340 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "chess_export.h"
+#include "fast_writer.h"
+#include "chess_utilities.h"
+
+#define NEW_LINE '\n'
+
+struct chess_export_t
+{
+    pthread_t thread;
+    pthread_mutex_t lock;
+    bool done;
+    ChessResult result;
+    FILE *file;
+    char *path_file;
+    ExportLevelRow *level_rows;
+    ExportStatisticsRow *statistics_rows;
+    int count;
+};
+
+/**
+ * compareLevelRows: qsort comparison of the levels export order.
+ */
+static int compareLevelRows(const void *first, const void *second)
+{
+    const ExportLevelRow *row1 = first, *row2 = second;
+    if (row1->level > row2->level)
+    {
+        return -1;
+    }
+    if (row1->level < row2->level)
+    {
+        return 1;
+    }
+    return (row1->player_id > row2->player_id) - (row1->player_id < row2->player_id);
+}
+
+void exportSortLevels(ExportLevelRow *rows, int count)
+{
+    if (rows == NULL || count <= 1)
+    {
+        return;
+    }
+    qsort(rows, count, sizeof(*rows), compareLevelRows);
+}
+
+/**
+ * siftTopLevelsDown: Restores the heap of the selected rows below a position. The root of the heap
+ * is the selected row that comes last in the levels export order.
+ *
+ * @param heap - The heap rows.
+ * @param size - The number of rows in the heap.
+ * @param position - The position whose row may come before its children.
+ */
+static void siftTopLevelsDown(ExportLevelRow *heap, int size, int position)
+{
+    while (true)
+    {
+        int last = position;
+        int left = 2 * position + 1, right = left + 1;
+        if (left < size && compareLevelRows(&heap[left], &heap[last]) > 0)
+        {
+            last = left;
+        }
+        if (right < size && compareLevelRows(&heap[right], &heap[last]) > 0)
+        {
+            last = right;
+        }
+        if (last == position)
+        {
+            return;
+        }
+        ExportLevelRow temp = heap[position];
+        heap[position] = heap[last];
+        heap[last] = temp;
+        position = last;
+    }
+}
+
+int exportSelectTopLevels(ExportLevelRow *rows, int count, int k)
+{
+    if (rows == NULL || count <= 0 || k <= 0)
+    {
+        return 0;
+    }
+    int size = k < count ? k : count;
+    for (int i = size / 2 - 1; i >= 0; i--)
+    {
+        siftTopLevelsDown(rows, size, i);
+    }
+    for (int i = size; i < count; i++)
+    {
+        if (compareLevelRows(&rows[i], &rows[0]) < 0)
+        {
+            ExportLevelRow temp = rows[0];
+            rows[0] = rows[i];
+            rows[i] = temp;
+            siftTopLevelsDown(rows, size, 0);
+        }
+    }
+    exportSortLevels(rows, size);
+    return size;
+}
+
+ChessResult exportWriteLevels(FILE *file, const ExportLevelRow *rows, int count)
+{
+    FastWriter writer = fastWriterCreate(file);
+    if (writer == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        fastWriterPutInt(writer, rows[i].player_id);
+        fastWriterPutChar(writer, SPACE);
+        fastWriterPutFixed2(writer, rows[i].level);
+        fastWriterPutChar(writer, NEW_LINE);
+    }
+    return fastWriterDestroy(writer) ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
+
+/**
+ * writeStatisticsRow: Writes the lines of one row of the statistics export.
+ */
+static void writeStatisticsRow(FastWriter writer, const ExportStatisticsRow *row)
+{
+    fastWriterPutInt(writer, row->winner);
+    fastWriterPutChar(writer, NEW_LINE);
+    fastWriterPutInt(writer, row->longest_game_time);
+    fastWriterPutChar(writer, NEW_LINE);
+    fastWriterPutFixed2(writer, row->average_game_time);
+    fastWriterPutChar(writer, NEW_LINE);
+    fastWriterPutString(writer, row->location);
+    fastWriterPutChar(writer, NEW_LINE);
+    fastWriterPutInt(writer, row->number_of_games);
+    fastWriterPutChar(writer, NEW_LINE);
+    fastWriterPutInt(writer, row->number_of_players);
+    fastWriterPutChar(writer, NEW_LINE);
+}
+
+ChessResult exportWriteStatistics(FILE *file, const ExportStatisticsRow *rows, int count)
+{
+    FastWriter writer = fastWriterCreate(file);
+    if (writer == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        writeStatisticsRow(writer, &rows[i]);
+    }
+    return fastWriterDestroy(writer) ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
+
+ChessResult exportWriteDurationStatistics(FILE *file, const ExportStatisticsRow *rows, int count)
+{
+    FastWriter writer = fastWriterCreate(file);
+    if (writer == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        writeStatisticsRow(writer, &rows[i]);
+        fastWriterPutFixed2(writer, rows[i].median_game_time);
+        fastWriterPutChar(writer, NEW_LINE);
+        fastWriterPutFixed2(writer, rows[i].p90_game_time);
+        fastWriterPutChar(writer, NEW_LINE);
+        fastWriterPutFixed2(writer, rows[i].p99_game_time);
+        fastWriterPutChar(writer, NEW_LINE);
+    }
+    return fastWriterDestroy(writer) ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
+
+void exportStatisticsRowsDestroy(ExportStatisticsRow *rows, int count)
+{
+    if (rows == NULL)
+    {
+        return;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        free(rows[i].location);
+    }
+    free(rows);
+}
+
+/**
+ * exportDestroy: Frees an export handle and the rows it owns. The thread must have been joined.
+ *
+ * @param export_handle - The export handle.
+ */
+static void exportDestroy(ChessExport export_handle)
+{
+    pthread_mutex_destroy(&export_handle->lock);
+    free(export_handle->level_rows);
+    exportStatisticsRowsDestroy(export_handle->statistics_rows, export_handle->count);
+    free(export_handle->path_file);
+    free(export_handle);
+}
+
+/**
+ * exportWorker: The background thread. Sorts and writes the level rows to the stream, or writes
+ * the statistics rows to the file, and then marks the export as done.
+ *
+ * @param argument - The export handle.
+ * @return
+ *     NULL.
+ */
+static void *exportWorker(void *argument)
+{
+    ChessExport export_handle = argument;
+    ChessResult result;
+    if (export_handle->path_file == NULL)
+    {
+        exportSortLevels(export_handle->level_rows, export_handle->count);
+        result = exportWriteLevels(export_handle->file, export_handle->level_rows, export_handle->count);
+    }
+    else
+    {
+        FILE *file = fopen(export_handle->path_file, "w");
+        if (file == NULL)
+        {
+            result = CHESS_SAVE_FAILURE;
+        }
+        else
+        {
+            result = exportWriteStatistics(file, export_handle->statistics_rows, export_handle->count);
+            if (fclose(file) != 0 && result == CHESS_SUCCESS)
+            {
+                result = CHESS_SAVE_FAILURE;
+            }
+        }
+    }
+    pthread_mutex_lock(&export_handle->lock);
+    export_handle->result = result;
+    export_handle->done = true;
+    pthread_mutex_unlock(&export_handle->lock);
+    return NULL;
+}
+
+/**
+ * exportStart: Allocates an export handle and starts its thread.
+ *
+ * @param export_handle - A handle whose rows, file and path are already set.
+ * @return
+ *     false - if the thread could not be started.
+ *     true - otherwise.
+ */
+static bool exportStart(ChessExport export_handle)
+{
+    export_handle->done = false;
+    export_handle->result = CHESS_SUCCESS;
+    if (pthread_mutex_init(&export_handle->lock, NULL) != 0)
+    {
+        return false;
+    }
+    if (pthread_create(&export_handle->thread, NULL, exportWorker, export_handle) != 0)
+    {
+        pthread_mutex_destroy(&export_handle->lock);
+        return false;
+    }
+    return true;
+}
+
+ChessExport exportLevelsStart(FILE *file, ExportLevelRow *rows, int count)
+{
+    ChessExport export_handle = malloc(sizeof(*export_handle));
+    if (export_handle == NULL)
+    {
+        free(rows);
+        return NULL;
+    }
+    export_handle->file = file;
+    export_handle->path_file = NULL;
+    export_handle->level_rows = rows;
+    export_handle->statistics_rows = NULL;
+    export_handle->count = count;
+    if (exportStart(export_handle) == false)
+    {
+        free(rows);
+        free(export_handle);
+        return NULL;
+    }
+    return export_handle;
+}
+
+ChessExport exportStatisticsStart(const char *path_file, ExportStatisticsRow *rows, int count)
+{
+    ChessExport export_handle = malloc(sizeof(*export_handle));
+    char *path_copy = malloc(strlen(path_file) + 1);
+    if (export_handle == NULL || path_copy == NULL)
+    {
+        free(export_handle);
+        free(path_copy);
+        exportStatisticsRowsDestroy(rows, count);
+        return NULL;
+    }
+    strcpy(path_copy, path_file);
+    export_handle->file = NULL;
+    export_handle->path_file = path_copy;
+    export_handle->level_rows = NULL;
+    export_handle->statistics_rows = rows;
+    export_handle->count = count;
+    if (exportStart(export_handle) == false)
+    {
+        exportStatisticsRowsDestroy(rows, count);
+        free(path_copy);
+        free(export_handle);
+        return NULL;
+    }
+    return export_handle;
+}
+
+bool chessExportPoll(ChessExport export_handle)
+{
+    if (export_handle == NULL)
+    {
+        return true;
+    }
+    pthread_mutex_lock(&export_handle->lock);
+    bool done = export_handle->done;
+    pthread_mutex_unlock(&export_handle->lock);
+    return done;
+}
+
+ChessResult chessExportWait(ChessExport export_handle)
+{
+    if (export_handle == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    pthread_join(export_handle->thread, NULL);
+    ChessResult result = export_handle->result;
+    exportDestroy(export_handle);
+    return result;
+}
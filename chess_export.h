@@ -0,0 +1,139 @@
+#ifndef CHESS_EXPORT_H
+#define CHESS_EXPORT_H
+#include <stdbool.h>
+#include <stdio.h>
+#include "chessSystem.h"
+
+/*
+* Formatting and writing of the levels and statistics exports, separated from the chess system
+* so it can run on rows captured ahead of time, either on the caller's thread or on a background
+* worker thread.
+*
+* The following functions are available:
+*   exportSortLevels          - Sorts level rows in the order of the levels export
+*   exportSelectTopLevels     - Moves the first rows of the levels export order to the front, sorted
+*   exportWriteLevels         - Writes level rows in the levels export format
+*   exportWriteStatistics     - Writes statistics rows in the statistics export format
+*   exportWriteDurationStatistics - Writes statistics rows with the quantiles of their game times
+*   exportLevelsStart         - Sorts and writes level rows on a background thread
+*   exportStatisticsStart     - Writes statistics rows to a file on a background thread
+*   chessExportPoll           - Returns if a background export finished (declared in chessSystem.h)
+*   chessExportWait           - Waits for a background export and returns its result (declared in chessSystem.h)
+*/
+
+/** Type for defining one line of the levels export */
+typedef struct {
+    int player_id;
+    double level;
+} ExportLevelRow;
+
+/** Type for defining the lines of one ended tournament in the statistics export */
+typedef struct {
+    int tournament_id;
+    int winner;
+    int longest_game_time;
+    double average_game_time;
+    char *location;
+    int number_of_games;
+    int number_of_players;
+    double median_game_time;
+    double p90_game_time;
+    double p99_game_time;
+} ExportStatisticsRow;
+
+/**
+* exportSortLevels: Sorts level rows by level from highest to lowest, and by id from lowest to
+*   highest between players with the same level.
+*
+* @param rows - The rows.
+* @param count - The number of rows.
+*/
+void exportSortLevels(ExportLevelRow *rows, int count);
+
+/**
+* exportSelectTopLevels: Moves the k rows that come first in the order of exportSortLevels to the
+*   front of the array, sorted in that order, using a bounded heap in O(count * log k). The order
+*   of the other rows is unspecified.
+*
+* @param rows - The rows.
+* @param count - The number of rows.
+* @param k - The number of rows to select.
+* @return
+* 	The number of selected rows, the smaller of k and count (0 if k is not positive).
+*/
+int exportSelectTopLevels(ExportLevelRow *rows, int count, int k);
+
+/**
+* exportWriteLevels: Writes level rows, in their order, as "id level" lines.
+*
+* @param file - An open, writable output stream.
+* @param rows - The rows.
+* @param count - The number of rows.
+* @return
+*     CHESS_OUT_OF_MEMORY - if the writer could not be allocated.
+*     CHESS_SAVE_FAILURE - if an error occurred while writing.
+*     CHESS_SUCCESS - otherwise.
+*/
+ChessResult exportWriteLevels(FILE *file, const ExportLevelRow *rows, int count);
+
+/**
+* exportWriteStatistics: Writes statistics rows, in their order, in the statistics export format.
+*
+* @param file - An open, writable output stream.
+* @param rows - The rows.
+* @param count - The number of rows.
+* @return
+*     CHESS_OUT_OF_MEMORY - if the writer could not be allocated.
+*     CHESS_SAVE_FAILURE - if an error occurred while writing.
+*     CHESS_SUCCESS - otherwise.
+*/
+ChessResult exportWriteStatistics(FILE *file, const ExportStatisticsRow *rows, int count);
+
+/**
+* exportWriteDurationStatistics: Writes statistics rows, in their order, in the statistics export
+*   format followed by the median, p90 and p99 game times of the row, one a line with 2 decimals.
+*
+* @param file - An open, writable output stream.
+* @param rows - The rows.
+* @param count - The number of rows.
+* @return
+*     CHESS_OUT_OF_MEMORY - if the writer could not be allocated.
+*     CHESS_SAVE_FAILURE - if an error occurred while writing.
+*     CHESS_SUCCESS - otherwise.
+*/
+ChessResult exportWriteDurationStatistics(FILE *file, const ExportStatisticsRow *rows, int count);
+
+/**
+* exportLevelsStart: Starts a background thread that sorts the rows and writes them to the stream.
+*
+* @param file - An open, writable output stream. It must not be used until the export finished.
+* @param rows - Rows allocated with malloc. The export takes ownership of them.
+* @param count - The number of rows.
+* @return
+* 	NULL - if the thread could not be started, in which case the rows are freed.
+* 	A new export handle otherwise.
+*/
+ChessExport exportLevelsStart(FILE *file, ExportLevelRow *rows, int count);
+
+/**
+* exportStatisticsStart: Starts a background thread that writes the rows to a file.
+*
+* @param path_file - The file path to write to.
+* @param rows - Rows allocated with malloc, whose locations are allocated with malloc too.
+*     The export takes ownership of them.
+* @param count - The number of rows.
+* @return
+* 	NULL - if the thread could not be started, in which case the rows are freed.
+* 	A new export handle otherwise.
+*/
+ChessExport exportStatisticsStart(const char *path_file, ExportStatisticsRow *rows, int count);
+
+/**
+* exportStatisticsRowsDestroy: Frees statistics rows and their locations.
+*
+* @param rows - The rows. If rows is NULL nothing will be done.
+* @param count - The number of rows.
+*/
+void exportStatisticsRowsDestroy(ExportStatisticsRow *rows, int count);
+
+#endif
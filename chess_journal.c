@@ -0,0 +1,403 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "chess_journal.h"
+#include "chess_snapshot.h"
+#include "chess_utilities.h"
+
+#define INITIAL_CAPACITY 4096
+#define EXPAND 2
+#define HEADER_SIZE (JOURNAL_MAGIC_LENGTH + 1)
+#define CHECKSUM_SIZE 4
+#define BYTE_BITS 8
+#define BYTE_MASK 0xFF
+#define FILE_MODE 0644
+
+struct chess_journal_t
+{
+    int descriptor;
+    unsigned char *group;
+    size_t size;
+    size_t capacity;
+    int group_commit;
+    int records_in_group;
+    bool failed;
+};
+
+struct journal_reader_t
+{
+    unsigned char *contents;
+    size_t size;
+    size_t offset;
+};
+
+/**
+ * operationArguments: Returns the number of int arguments recorded for an operation.
+ *
+ * @param operation - The journal operation.
+ * @return
+ *     -1 if the operation is unknown, the number of arguments otherwise.
+ */
+static int operationArguments(JournalOperation operation)
+{
+    switch (operation)
+    {
+    case JOURNAL_ADD_TOURNAMENT:
+        return 2;
+    case JOURNAL_ADD_GAME:
+        return 5;
+    case JOURNAL_REMOVE_TOURNAMENT:
+    case JOURNAL_REMOVE_PLAYER:
+    case JOURNAL_END_TOURNAMENT:
+        return 1;
+    case JOURNAL_RECALCULATE_RATINGS:
+    case JOURNAL_CLEAR_STATISTICS:
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+/**
+ * validLength: Returns the length of the header and the valid records at the start of a journal
+ * file, where the next record must be appended.
+ *
+ * @param path_file - The journal file path.
+ * @param file_size - The size of the file.
+ * @return
+ *     -1 if the file is not a journal or could not be read,
+ *     0 if it is empty or holds only part of a header, the length otherwise.
+ */
+static long long validLength(const char *path_file, long long file_size)
+{
+    if (file_size < HEADER_SIZE)
+    {
+        return 0;
+    }
+    JournalReader reader = journalReaderOpen(path_file);
+    if (reader == NULL)
+    {
+        return -1;
+    }
+    JournalRecord record;
+    while (journalReadNext(reader, &record))
+    {
+    }
+    long long length = (long long)reader->offset;
+    journalReaderDestroy(reader);
+    return length;
+}
+
+ChessJournal journalOpen(const char *path_file, int group_commit)
+{
+    if (path_file == NULL || group_commit <= 0)
+    {
+        return NULL;
+    }
+    ChessJournal journal = malloc(sizeof(*journal));
+    if (journal == NULL)
+    {
+        return NULL;
+    }
+    journal->group = malloc(INITIAL_CAPACITY);
+    journal->descriptor = open(path_file, O_WRONLY | O_CREAT | O_APPEND, FILE_MODE);
+    struct stat file_status;
+    long long length = -1;
+    if (journal->group != NULL && journal->descriptor >= 0 && fstat(journal->descriptor, &file_status) == 0)
+    {
+        // A crash can leave a torn record at the end, which would hide the records appended after it
+        length = validLength(path_file, (long long)file_status.st_size);
+    }
+    if (length < 0 || (length < (long long)file_status.st_size && ftruncate(journal->descriptor, (off_t)length) != 0))
+    {
+        if (journal->descriptor >= 0)
+        {
+            close(journal->descriptor);
+        }
+        free(journal->group);
+        free(journal);
+        return NULL;
+    }
+    journal->size = 0;
+    journal->capacity = INITIAL_CAPACITY;
+    journal->group_commit = group_commit;
+    journal->records_in_group = 0;
+    journal->failed = false;
+    if (length == 0)
+    {
+        memcpy(journal->group, JOURNAL_MAGIC, JOURNAL_MAGIC_LENGTH);
+        journal->group[JOURNAL_MAGIC_LENGTH] = JOURNAL_VERSION;
+        journal->size = HEADER_SIZE;
+    }
+    return journal;
+}
+
+bool journalSync(ChessJournal journal)
+{
+    if (journal == NULL)
+    {
+        return false;
+    }
+    size_t written = 0;
+    while (journal->failed == false && written < journal->size)
+    {
+        ssize_t result = write(journal->descriptor, journal->group + written, journal->size - written);
+        if (result < 0)
+        {
+            journal->failed = true;
+        }
+        else
+        {
+            written += result;
+        }
+    }
+    if (journal->failed == false && journal->size > 0 && fsync(journal->descriptor) != 0)
+    {
+        journal->failed = true;
+    }
+    journal->size = 0;
+    journal->records_in_group = 0;
+    return journal->failed == false;
+}
+
+bool journalHasFailed(ChessJournal journal)
+{
+    return journal != NULL && journal->failed;
+}
+
+bool journalClose(ChessJournal journal)
+{
+    if (journal == NULL)
+    {
+        return true;
+    }
+    bool success = journalSync(journal);
+    success = (close(journal->descriptor) == 0) && success;
+    free(journal->group);
+    free(journal);
+    return success;
+}
+
+/**
+ * reserveGroup: Makes sure the current group has room for one more record.
+ *
+ * @param journal - The journal.
+ * @param length - The maximal size of the record.
+ * @return
+ *     false - if the group could not grow.
+ *     true - otherwise.
+ */
+static bool reserveGroup(ChessJournal journal, size_t length)
+{
+    if (journal->size + length <= journal->capacity)
+    {
+        return true;
+    }
+    size_t new_capacity = journal->capacity;
+    while (new_capacity < journal->size + length)
+    {
+        new_capacity *= EXPAND;
+    }
+    unsigned char *new_group = realloc(journal->group, new_capacity);
+    if (new_group == NULL)
+    {
+        return false;
+    }
+    journal->group = new_group;
+    journal->capacity = new_capacity;
+    return true;
+}
+
+/**
+ * recordMaxLength: Returns the largest size a record of an operation can take.
+ *
+ * @param number_of_arguments - The number of int arguments of the operation.
+ * @param location_length - The length of the location, 0 if the operation has none.
+ * @return
+ *     The size of the operation byte, the sequence, the arguments, the location and the CRC.
+ */
+static size_t recordMaxLength(int number_of_arguments, size_t location_length)
+{
+    return 1 + MAX_VARINT_SIZE * (number_of_arguments + 2) + location_length + CHECKSUM_SIZE;
+}
+
+bool journalReserve(ChessJournal journal, JournalOperation operation, const char *location)
+{
+    if (journal == NULL || journal->failed)
+    {
+        return false;
+    }
+    int number_of_arguments = operationArguments(operation);
+    if (number_of_arguments < 0 || (operation == JOURNAL_ADD_TOURNAMENT && location == NULL))
+    {
+        return false;
+    }
+    size_t location_length = operation == JOURNAL_ADD_TOURNAMENT ? strlen(location) : 0;
+    return reserveGroup(journal, recordMaxLength(number_of_arguments, location_length));
+}
+
+bool journalAppend(ChessJournal journal, const JournalRecord *record)
+{
+    if (journal == NULL || record == NULL || journal->failed)
+    {
+        return false;
+    }
+    int number_of_arguments = operationArguments(record->operation);
+    if (number_of_arguments < 0)
+    {
+        return false;
+    }
+    size_t location_length = record->operation == JOURNAL_ADD_TOURNAMENT ? strlen(record->location) : 0;
+    if (reserveGroup(journal, recordMaxLength(number_of_arguments, location_length)) == false)
+    {
+        journal->failed = true;
+        return false;
+    }
+
+    unsigned char *start = journal->group + journal->size;
+    size_t length = 0;
+    start[length++] = (unsigned char)record->operation;
+    length += varintPut(start + length, (unsigned long long)record->sequence);
+    for (int i = 0; i < number_of_arguments; i++)
+    {
+        length += varintPut(start + length, zigzagEncode(record->arguments[i]));
+    }
+    if (record->operation == JOURNAL_ADD_TOURNAMENT)
+    {
+        length += varintPut(start + length, location_length);
+        memcpy(start + length, record->location, location_length);
+        length += location_length;
+    }
+    unsigned int checksum = snapshotChecksum(start, length);
+    for (int i = 0; i < CHECKSUM_SIZE; i++)
+    {
+        start[length++] = (unsigned char)((checksum >> (i * BYTE_BITS)) & BYTE_MASK);
+    }
+    journal->size += length;
+    journal->records_in_group++;
+
+    if (journal->records_in_group >= journal->group_commit)
+    {
+        return journalSync(journal);
+    }
+    return true;
+}
+
+JournalReader journalReaderOpen(const char *path_file)
+{
+    if (path_file == NULL)
+    {
+        return NULL;
+    }
+    FILE *file = fopen(path_file, "rb");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+    JournalReader reader = malloc(sizeof(*reader));
+    if (reader == NULL)
+    {
+        fclose(file);
+        return NULL;
+    }
+    reader->size = 0;
+    reader->offset = HEADER_SIZE;
+    size_t capacity = INITIAL_CAPACITY;
+    reader->contents = malloc(capacity);
+    size_t read_bytes;
+    while (reader->contents != NULL &&
+           (read_bytes = fread(reader->contents + reader->size, 1, capacity - reader->size, file)) > 0)
+    {
+        reader->size += read_bytes;
+        if (reader->size == capacity)
+        {
+            capacity *= EXPAND;
+            unsigned char *new_contents = realloc(reader->contents, capacity);
+            if (new_contents == NULL)
+            {
+                free(reader->contents);
+            }
+            reader->contents = new_contents;
+        }
+    }
+    bool valid = reader->contents != NULL && ferror(file) == 0 && reader->size >= HEADER_SIZE &&
+                 memcmp(reader->contents, JOURNAL_MAGIC, JOURNAL_MAGIC_LENGTH) == 0 &&
+                 reader->contents[JOURNAL_MAGIC_LENGTH] <= JOURNAL_VERSION;
+    fclose(file);
+    if (valid == false)
+    {
+        journalReaderDestroy(reader);
+        return NULL;
+    }
+    return reader;
+}
+
+void journalReaderDestroy(JournalReader reader)
+{
+    if (reader == NULL)
+    {
+        return;
+    }
+    free(reader->contents);
+    free(reader);
+}
+
+bool journalReadNext(JournalReader reader, JournalRecord *record)
+{
+    if (reader == NULL || record == NULL || reader->offset >= reader->size)
+    {
+        return false;
+    }
+    size_t offset = reader->offset;
+    unsigned long long value;
+    record->operation = reader->contents[offset++];
+    int number_of_arguments = operationArguments(record->operation);
+    if (number_of_arguments < 0 || varintGet(reader->contents, reader->size, &offset, &value) == false)
+    {
+        return false;
+    }
+    record->sequence = (long long)value;
+    for (int i = 0; i < number_of_arguments; i++)
+    {
+        if (varintGet(reader->contents, reader->size, &offset, &value) == false)
+        {
+            return false;
+        }
+        record->arguments[i] = (int)zigzagDecode(value);
+    }
+    record->location = NULL;
+    size_t location_length = 0;
+    if (record->operation == JOURNAL_ADD_TOURNAMENT)
+    {
+        if (varintGet(reader->contents, reader->size, &offset, &value) == false || value > reader->size - offset)
+        {
+            return false;
+        }
+        location_length = value;
+        offset += location_length;
+    }
+    if (reader->size - offset < CHECKSUM_SIZE)
+    {
+        return false;
+    }
+    unsigned int checksum = 0;
+    for (int i = 0; i < CHECKSUM_SIZE; i++)
+    {
+        checksum |= (unsigned int)reader->contents[offset + i] << (i * BYTE_BITS);
+    }
+    if (checksum != snapshotChecksum(reader->contents + reader->offset, offset - reader->offset))
+    {
+        return false;
+    }
+    if (record->operation == JOURNAL_ADD_TOURNAMENT)
+    {
+        /* the checksum is no longer needed, its first byte terminates the location string */
+        reader->contents[offset] = '\0';
+        record->location = (const char *)reader->contents + offset - location_length;
+    }
+    reader->offset = offset + CHECKSUM_SIZE;
+    return true;
+}
@@ -0,0 +1,162 @@
+#ifndef CHESS_JOURNAL_H
+#define CHESS_JOURNAL_H
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define JOURNAL_MAGIC "CHSJ"
+#define JOURNAL_MAGIC_LENGTH 4
+#define JOURNAL_VERSION 3
+#define JOURNAL_MAX_ARGUMENTS 5
+
+/*
+* Journal file layout:
+*   magic and version   - the 4 bytes "CHSJ" followed by one version byte.
+*   records             - one record per successful mutating operation, each made of:
+*                         operation byte, varint sequence number, zigzag varint arguments,
+*                         the location string for JOURNAL_ADD_TOURNAMENT (varint length and bytes)
+*                         and a 32 bit CRC of all the record bytes before it.
+*
+* A crash can leave the last record half written. Reading stops at the first record that is
+* truncated or fails its CRC, so the journal tail is always a prefix of the operations.
+*
+* The following functions are available:
+*   journalOpen         - Opens a journal file for appending
+*   journalHasFailed    - Returns if writing the journal failed
+*   journalClose        - Writes the pending records, syncs and closes the journal
+*   journalReserve      - Makes room for the record of an operation before it is applied
+*   journalAppend       - Adds a record, writing and syncing a group once it is full
+*   journalSync         - Writes and syncs the pending records
+*   journalReaderOpen   - Reads a journal file for replay
+*   journalReaderDestroy- Deletes a journal reader
+*   journalReadNext     - Decodes the next valid record of the journal
+*/
+
+/** Type for defining the mutating operations recorded in the journal */
+typedef enum {
+    JOURNAL_ADD_TOURNAMENT = 1,
+    JOURNAL_ADD_GAME,
+    JOURNAL_REMOVE_TOURNAMENT,
+    JOURNAL_REMOVE_PLAYER,
+    JOURNAL_END_TOURNAMENT,
+    JOURNAL_RECALCULATE_RATINGS,
+    JOURNAL_CLEAR_STATISTICS
+} JournalOperation;
+
+/**
+* Type for defining one journal record. The arguments are the int arguments of the
+* operation in the order of the chessSystem.h function, location is used only by
+* JOURNAL_ADD_TOURNAMENT.
+*/
+typedef struct {
+    JournalOperation operation;
+    long long sequence;
+    int arguments[JOURNAL_MAX_ARGUMENTS];
+    const char *location;
+} JournalRecord;
+
+/** Type for defining an open journal */
+typedef struct chess_journal_t *ChessJournal;
+
+/** Type for defining a journal reader */
+typedef struct journal_reader_t *JournalReader;
+
+/**
+* journalOpen: Opens a journal file for appending, creating it if needed. A torn record at the end
+*   of an existing journal, left by a crash, is truncated so the next records follow the valid ones.
+*
+* @param path_file - The journal file path.
+* @param group_commit - Number of records that are written and synced together. A crash can
+*     lose at most the last group_commit - 1 operations. Must be positive.
+* @return
+* 	NULL - if the file could not be opened or truncated, is not a journal, or an allocation failed.
+* 	A new journal otherwise.
+*/
+ChessJournal journalOpen(const char *path_file, int group_commit);
+
+/**
+* journalHasFailed: Returns if a write or sync of the journal failed since it was opened, after
+*   which no more records are added.
+*
+* @param journal - The journal.
+* @return
+* 	false - if journal is NULL or did not fail.
+* 	true - otherwise.
+*/
+bool journalHasFailed(ChessJournal journal);
+
+/**
+* journalClose: Writes and syncs the pending records and closes the journal.
+*
+* @param journal - Target journal. If journal is NULL nothing will be done.
+* @return
+* 	false - if a write or sync of the journal failed since it was opened.
+* 	true - otherwise.
+*/
+bool journalClose(ChessJournal journal);
+
+/**
+* journalReserve: Makes room in the current group for the record of an operation, before the
+*   operation changes anything. The next journalAppend of such a record then allocates nothing, and
+*   fails only if writing or syncing the group fails. A failed reservation does not fail the journal.
+*
+* @param journal - The journal.
+* @param operation - The operation of the record.
+* @param location - The location of the record, used only by JOURNAL_ADD_TOURNAMENT.
+* @return
+* 	false - if the input is NULL, the journal failed or an allocation failed.
+* 	true - otherwise.
+*/
+bool journalReserve(ChessJournal journal, JournalOperation operation, const char *location);
+
+/**
+* journalAppend: Adds a record to the current group. Once the group holds group_commit records
+*   it is written with a single write and synced with a single fsync.
+*
+* @param journal - The journal.
+* @param record - The record to add.
+* @return
+* 	false - if the input is NULL, an allocation failed or a write or sync failed.
+* 	true - otherwise.
+*/
+bool journalAppend(ChessJournal journal, const JournalRecord *record);
+
+/**
+* journalSync: Writes and syncs the records of the current group even if it is not full.
+*
+* @param journal - The journal.
+* @return
+* 	false - if the input is NULL or a write or sync of the journal failed.
+* 	true - otherwise.
+*/
+bool journalSync(ChessJournal journal);
+
+/**
+* journalReaderOpen: Reads a whole journal file for replay.
+*
+* @param path_file - The journal file path.
+* @return
+* 	NULL - if the file could not be read, is not a journal, or an allocation failed.
+* 	A new journal reader otherwise.
+*/
+JournalReader journalReaderOpen(const char *path_file);
+
+/**
+* journalReaderDestroy: Deallocates a journal reader.
+*
+* @param reader - Target reader. If reader is NULL nothing will be done.
+*/
+void journalReaderDestroy(JournalReader reader);
+
+/**
+* journalReadNext: Decodes the next record of the journal. The location of the record points
+*   into the reader and stays valid until the reader is destroyed.
+*
+* @param reader - The journal reader.
+* @param record - Where to store the decoded record.
+* @return
+* 	false - if there are no more records, or the next record is truncated or corrupted.
+* 	true - otherwise.
+*/
+bool journalReadNext(JournalReader reader, JournalRecord *record);
+
+#endif
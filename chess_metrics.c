@@ -0,0 +1,186 @@
+#define _POSIX_C_SOURCE 200809L
+#include <time.h>
+#include "chessSystem.h"
+#include "chess_metrics.h"
+
+#define NANOSECONDS_PER_SECOND 1000000000ULL
+#define MEDIAN 0.5
+#define PERCENTILE_99 0.99
+#define PERCENTILE_999 0.999
+
+ChessMetrics chess_metrics;
+
+unsigned long long metricsNow()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * NANOSECONDS_PER_SECOND + now.tv_nsec;
+}
+
+/**
+ * bucketOf: Returns the histogram bucket of a latency.
+ *
+ * @param latency - The latency in nanoseconds.
+ * @return
+ *     The bucket.
+ */
+static int bucketOf(unsigned long long latency)
+{
+    if (latency < CHESS_METRICS_SUB_BUCKETS)
+    {
+        return (int)latency;
+    }
+    int highest_bit = 0;
+    while ((latency >> highest_bit) > 1)
+    {
+        highest_bit++;
+    }
+    int shift = highest_bit - CHESS_METRICS_SUB_BUCKET_BITS;
+    return ((shift + 1) << CHESS_METRICS_SUB_BUCKET_BITS) + (int)((latency >> shift) & (CHESS_METRICS_SUB_BUCKETS - 1));
+}
+
+unsigned long long metricsBucketUpperBound(int bucket)
+{
+    if (bucket < CHESS_METRICS_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    int shift = (bucket >> CHESS_METRICS_SUB_BUCKET_BITS) - 1;
+    unsigned long long mantissa = CHESS_METRICS_SUB_BUCKETS + (bucket & (CHESS_METRICS_SUB_BUCKETS - 1));
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void metricsRecordApi(ChessMetricsApi api, unsigned long long start_ns)
+{
+    unsigned long long latency = metricsNow() - start_ns;
+    ChessApiMetrics *api_metrics = &chess_metrics.apis[api];
+    metricsCount(&api_metrics->calls);
+    __atomic_fetch_add(&api_metrics->total_ns, latency, __ATOMIC_RELAXED);
+    metricsCount(&api_metrics->latency_buckets[bucketOf(latency)]);
+    unsigned long long max_ns = __atomic_load_n(&api_metrics->max_ns, __ATOMIC_RELAXED);
+    // A failed exchange reloads max_ns, so the loop ends once a call with a higher latency stored it
+    while (latency > max_ns &&
+           __atomic_compare_exchange_n(&api_metrics->max_ns, &max_ns, latency, true, __ATOMIC_RELAXED,
+                                       __ATOMIC_RELAXED) == false)
+    {
+    }
+}
+
+/**
+ * copyCounters: Copies counters of the metrics one by one with atomic loads, or zeroes them with
+ * atomic stores.
+ *
+ * @param target - Where to copy the counters.
+ * @param source - The counters, or NULL to zero the target.
+ * @param count - The number of counters.
+ */
+static void copyCounters(unsigned long long *target, const unsigned long long *source, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (source == NULL)
+        {
+            __atomic_store_n(&target[i], 0, __ATOMIC_RELAXED);
+        }
+        else
+        {
+            target[i] = __atomic_load_n(&source[i], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/**
+ * copyMetrics: Copies or zeroes all the counters of the metrics, see copyCounters.
+ */
+static void copyMetrics(ChessMetrics *target, const ChessMetrics *source)
+{
+    for (int api = 0; api < CHESS_METRICS_APIS; api++)
+    {
+        copyCounters(&target->apis[api].calls, source == NULL ? NULL : &source->apis[api].calls, 1);
+        copyCounters(&target->apis[api].total_ns, source == NULL ? NULL : &source->apis[api].total_ns, 1);
+        copyCounters(&target->apis[api].max_ns, source == NULL ? NULL : &source->apis[api].max_ns, 1);
+        copyCounters(target->apis[api].latency_buckets, source == NULL ? NULL : source->apis[api].latency_buckets,
+                     CHESS_METRICS_BUCKETS);
+    }
+    copyCounters(&target->map_gets, source == NULL ? NULL : &source->map_gets, 1);
+    copyCounters(&target->map_puts, source == NULL ? NULL : &source->map_puts, 1);
+    copyCounters(&target->map_iterations, source == NULL ? NULL : &source->map_iterations, 1);
+    copyCounters(&target->key_copies, source == NULL ? NULL : &source->key_copies, 1);
+}
+
+const char *metricsApiName(ChessMetricsApi api)
+{
+    static const char *names[CHESS_METRICS_APIS] = {
+        "chessAddTournament", "chessAddGame", "chessRemoveTournament", "chessRemovePlayer",
+        "chessEndTournament", "chessCalculateAveragePlayTime", "chessSavePlayersLevels",
+        "chessSaveTournamentStatistics"};
+    if (api < 0 || api >= CHESS_METRICS_APIS)
+    {
+        return "unknown";
+    }
+    return names[api];
+}
+
+unsigned long long metricsPercentile(const ChessApiMetrics *api_metrics, double fraction)
+{
+    if (api_metrics == NULL || api_metrics->calls == 0)
+    {
+        return 0;
+    }
+    unsigned long long rank = (unsigned long long)(fraction * api_metrics->calls);
+    if (rank >= api_metrics->calls)
+    {
+        rank = api_metrics->calls - 1;
+    }
+    unsigned long long seen = 0;
+    for (int bucket = 0; bucket < CHESS_METRICS_BUCKETS; bucket++)
+    {
+        seen += api_metrics->latency_buckets[bucket];
+        if (seen > rank)
+        {
+            unsigned long long bound = metricsBucketUpperBound(bucket);
+            return bound < api_metrics->max_ns ? bound : api_metrics->max_ns;
+        }
+    }
+    return api_metrics->max_ns;
+}
+
+ChessResult chessGetMetrics(ChessMetrics *metrics)
+{
+    if (metrics == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    copyMetrics(metrics, &chess_metrics);
+    return CHESS_SUCCESS;
+}
+
+void chessResetMetrics()
+{
+    copyMetrics(&chess_metrics, NULL);
+}
+
+ChessResult chessDumpMetrics(FILE *file)
+{
+    if (file == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+#ifndef CHESS_METRICS
+    fprintf(file, "# metrics disabled, build with -DCHESS_METRICS\n");
+#endif
+    ChessMetrics metrics;
+    copyMetrics(&metrics, &chess_metrics);
+    fprintf(file, "%-30s %12s %12s %10s %10s %10s %10s\n", "api", "calls", "avg_ns", "p50_ns", "p99_ns", "p999_ns", "max_ns");
+    for (int api = 0; api < CHESS_METRICS_APIS; api++)
+    {
+        const ChessApiMetrics *api_metrics = &metrics.apis[api];
+        fprintf(file, "%-30s %12llu %12llu %10llu %10llu %10llu %10llu\n", metricsApiName(api), api_metrics->calls,
+                api_metrics->calls == 0 ? 0 : api_metrics->total_ns / api_metrics->calls,
+                metricsPercentile(api_metrics, MEDIAN), metricsPercentile(api_metrics, PERCENTILE_99),
+                metricsPercentile(api_metrics, PERCENTILE_999), api_metrics->max_ns);
+    }
+    fprintf(file, "map_gets %llu\nmap_puts %llu\nmap_iterations %llu\nkey_copies %llu\n", metrics.map_gets,
+            metrics.map_puts, metrics.map_iterations, metrics.key_copies);
+    return ferror(file) ? CHESS_SAVE_FAILURE : CHESS_SUCCESS;
+}
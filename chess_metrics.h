@@ -0,0 +1,124 @@
+#ifndef CHESS_METRICS_H
+#define CHESS_METRICS_H
+#include "chessSystem.h"
+
+/*
+* Opt-in hot path metrics of the chess system: calls and latency of every public operation,
+* and counts of the map operations and key copies they trigger.
+*
+* Metrics are collected only when the sources are compiled with -DCHESS_METRICS. Without it
+* the hooks in chess_metrics_hooks.h compile to nothing, and chessGetMetrics returns zeros.
+* The counters are process wide and updated atomically, so they stay exact with several threads
+* using chess systems at once.
+*
+* Latencies are kept in log-bucketed histograms: the first CHESS_METRICS_SUB_BUCKETS
+* nanosecond values get a bucket each, and every following power of two is split into
+* CHESS_METRICS_SUB_BUCKETS buckets, so a bucket bound is at most 25% above a latency in it.
+*
+* The following functions are available:
+*   metricsCount               - Counts one event
+*   metricsNow                 - Returns a monotonic time in nanoseconds
+*   metricsRecordApi           - Records one call of an operation
+*   metricsApiName             - Returns the name of an operation
+*   metricsBucketUpperBound    - Returns the highest latency of a histogram bucket
+*   metricsPercentile          - Returns a latency percentile of an operation
+*   chessGetMetrics            - Copies the metrics (declared in chessSystem.h)
+*   chessResetMetrics          - Zeroes the metrics (declared in chessSystem.h)
+*   chessDumpMetrics           - Prints the metrics (declared in chessSystem.h)
+*/
+
+#define CHESS_METRICS_SUB_BUCKET_BITS 2
+#define CHESS_METRICS_SUB_BUCKETS (1 << CHESS_METRICS_SUB_BUCKET_BITS)
+#define CHESS_METRICS_BUCKETS (64 * CHESS_METRICS_SUB_BUCKETS)
+
+/** Type for defining the measured operations */
+typedef enum {
+    CHESS_METRICS_ADD_TOURNAMENT,
+    CHESS_METRICS_ADD_GAME,
+    CHESS_METRICS_REMOVE_TOURNAMENT,
+    CHESS_METRICS_REMOVE_PLAYER,
+    CHESS_METRICS_END_TOURNAMENT,
+    CHESS_METRICS_AVERAGE_PLAY_TIME,
+    CHESS_METRICS_SAVE_LEVELS,
+    CHESS_METRICS_SAVE_STATISTICS,
+    CHESS_METRICS_APIS
+} ChessMetricsApi;
+
+/** Type for defining the metrics of one operation */
+typedef struct {
+    unsigned long long calls;
+    unsigned long long total_ns;
+    unsigned long long max_ns;
+    unsigned long long latency_buckets[CHESS_METRICS_BUCKETS];
+} ChessApiMetrics;
+
+/** Type for defining all the metrics, ChessMetrics in chessSystem.h */
+struct chess_metrics_t {
+    ChessApiMetrics apis[CHESS_METRICS_APIS];
+    unsigned long long map_gets;
+    unsigned long long map_puts;
+    /** mapGetFirst and mapGetNext calls, one per MAP_FOREACH iteration and one per loop end */
+    unsigned long long map_iterations;
+    unsigned long long key_copies;
+};
+
+/** The process wide metrics, updated by the hooks */
+extern ChessMetrics chess_metrics;
+
+/**
+* metricsCount: Counts one event in a counter of chess_metrics.
+*
+* @param counter - The counter.
+*/
+static inline void metricsCount(unsigned long long *counter)
+{
+    __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+}
+
+/**
+* metricsNow: Returns a monotonic time in nanoseconds.
+*
+* @return
+* 	The time.
+*/
+unsigned long long metricsNow();
+
+/**
+* metricsRecordApi: Records one call of an operation that started at a given time.
+*
+* @param api - The operation.
+* @param start_ns - The metricsNow time when the call started.
+*/
+void metricsRecordApi(ChessMetricsApi api, unsigned long long start_ns);
+
+/**
+* metricsApiName: Returns the name of the public function of an operation.
+*
+* @param api - The operation.
+* @return
+* 	The function name.
+*/
+const char *metricsApiName(ChessMetricsApi api);
+
+/**
+* metricsBucketUpperBound: Returns the highest latency that falls in a histogram bucket.
+*
+* @param bucket - The bucket, between 0 and CHESS_METRICS_BUCKETS - 1.
+* @return
+* 	The latency in nanoseconds.
+*/
+unsigned long long metricsBucketUpperBound(int bucket);
+
+/**
+* metricsPercentile: Returns the latency below which a fraction of the calls of an operation are,
+*   rounded up to the bound of its bucket.
+*
+* @param api_metrics - The metrics of the operation.
+* @param fraction - The fraction, between 0 and 1.
+* @return
+* 	0 - if there are no calls.
+* 	The latency in nanoseconds otherwise.
+*/
+unsigned long long metricsPercentile(const ChessApiMetrics *api_metrics, double fraction);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef CHESS_METRICS_HOOKS_H
+#define CHESS_METRICS_HOOKS_H
+#include "./mtm_map/map.h"
+#include "chess_metrics.h"
+
+/*
+* Metrics hooks of the instrumented sources. Must be included after every other header, since
+* it redirects the map functions the source calls to counting wrappers.
+*
+* METRICS_API_START opens a timed call in a function body, and METRICS_API_STOP records it.
+* Without -DCHESS_METRICS all of them compile to nothing.
+*/
+
+#ifdef CHESS_METRICS
+static inline MapDataElement metricsMapGet(Map map, MapKeyElement key_element)
+{
+    metricsCount(&chess_metrics.map_gets);
+    return mapGet(map, key_element);
+}
+
+static inline MapResult metricsMapPut(Map map, MapKeyElement key_element, MapDataElement data_element)
+{
+    metricsCount(&chess_metrics.map_puts);
+    return mapPut(map, key_element, data_element);
+}
+
+static inline MapKeyElement metricsMapGetFirst(Map map)
+{
+    metricsCount(&chess_metrics.map_iterations);
+    return mapGetFirst(map);
+}
+
+static inline MapKeyElement metricsMapGetNext(Map map)
+{
+    metricsCount(&chess_metrics.map_iterations);
+    return mapGetNext(map);
+}
+
+#define mapGet metricsMapGet
+#define mapPut metricsMapPut
+#define mapGetFirst metricsMapGetFirst
+#define mapGetNext metricsMapGetNext
+#define METRICS_API_START() unsigned long long metrics_start_ns = metricsNow()
+#define METRICS_API_STOP(api) metricsRecordApi(api, metrics_start_ns)
+#else
+#define METRICS_API_START()
+#define METRICS_API_STOP(api)
+#endif
+
+#endif
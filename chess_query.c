@@ -0,0 +1,511 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include "chess_query.h"
+#include "game_data.h"
+#include "chess_utilities.h"
+
+#define NO_PLAYER 0
+#define ALL_WINNERS 0
+#define NUMBER_OF_FIELDS (CHESS_FIELD_DRAWS + 1)
+#define WIN_POINTS 2
+#define DRAW_POINTS 1
+#define MINIMUM_CAPACITY 4
+#define EXPAND 2
+
+struct chess_query_t
+{
+    int *tournament_ids;
+    int number_of_tournaments;
+    bool filter_tournaments;
+    int player_id;
+    int winners;
+    int min_time;
+    int max_time;
+    ChessQueryGroup group;
+    ChessQueryAggregate aggregates[CHESS_QUERY_MAX_AGGREGATES];
+    ChessQueryField fields[CHESS_QUERY_MAX_AGGREGATES];
+    int number_of_aggregates;
+};
+
+/** The games of one group so far, and the sums, minimums and maximums of the aggregated fields */
+typedef struct
+{
+    int group;
+    int count;
+    double sums[CHESS_QUERY_MAX_AGGREGATES];
+    double minimums[CHESS_QUERY_MAX_AGGREGATES];
+    double maximums[CHESS_QUERY_MAX_AGGREGATES];
+} QueryGroup;
+
+/** The groups, and a hash table of their positions by group */
+struct query_result_t
+{
+    ChessQuery query;
+    QueryGroup *groups;
+    int number_of_groups;
+    int capacity;
+    HashTable positions;
+};
+
+/** The rows of one batch: the game and the player each row is seen from, and the fields of the rows */
+typedef struct
+{
+    int games[2 * QUERY_BATCH];
+    int players[2 * QUERY_BATCH];
+    bool first_side[2 * QUERY_BATCH];
+    int groups[2 * QUERY_BATCH];
+    double fields[NUMBER_OF_FIELDS][2 * QUERY_BATCH];
+    int size;
+} QueryRows;
+
+ChessQuery chessQueryCreate()
+{
+    ChessQuery query = malloc(sizeof(*query));
+    if (query == NULL)
+    {
+        return NULL;
+    }
+    query->tournament_ids = NULL;
+    query->number_of_tournaments = 0;
+    query->filter_tournaments = false;
+    query->player_id = NO_PLAYER;
+    query->winners = ALL_WINNERS;
+    query->min_time = 0;
+    query->max_time = INT_MAX;
+    query->group = CHESS_GROUP_NONE;
+    query->number_of_aggregates = 0;
+    return query;
+}
+
+void chessQueryDestroy(ChessQuery query)
+{
+    if (query == NULL)
+    {
+        return;
+    }
+    free(query->tournament_ids);
+    free(query);
+}
+
+/**
+ * compareIds: qsort comparison of ids in increasing order.
+ */
+static int compareIds(const void *first, const void *second)
+{
+    int id1 = *(const int *)first, id2 = *(const int *)second;
+    return (id1 > id2) - (id1 < id2);
+}
+
+ChessResult chessQueryFilterTournaments(ChessQuery query, const int *tournament_ids, int count)
+{
+    if (query == NULL || (tournament_ids == NULL && count > 0))
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (tournament_ids[i] <= 0)
+        {
+            return CHESS_INVALID_ID;
+        }
+    }
+    int *ids = malloc(sizeof(*ids) * (count + 1));
+    if (ids == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    if (count > 0)
+    {
+        memcpy(ids, tournament_ids, sizeof(*ids) * count);
+        qsort(ids, count, sizeof(*ids), compareIds);
+    }
+    int unique = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (unique == 0 || ids[unique - 1] != ids[i])
+        {
+            ids[unique++] = ids[i];
+        }
+    }
+    free(query->tournament_ids);
+    query->tournament_ids = ids;
+    query->number_of_tournaments = unique;
+    query->filter_tournaments = true;
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessQueryFilterPlayer(ChessQuery query, int player_id)
+{
+    if (query == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (player_id <= 0)
+    {
+        return CHESS_INVALID_ID;
+    }
+    query->player_id = player_id;
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessQueryFilterWinner(ChessQuery query, Winner winner)
+{
+    if (query == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (winner != FIRST_PLAYER && winner != SECOND_PLAYER && winner != DRAW)
+    {
+        return CHESS_INVALID_QUERY;
+    }
+    query->winners |= 1 << winner;
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessQueryFilterTime(ChessQuery query, int min_time, int max_time)
+{
+    if (query == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (min_time < 0 || max_time < min_time)
+    {
+        return CHESS_INVALID_PLAY_TIME;
+    }
+    query->min_time = min_time;
+    query->max_time = max_time;
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessQueryGroupBy(ChessQuery query, ChessQueryGroup group)
+{
+    if (query == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (group != CHESS_GROUP_NONE && group != CHESS_GROUP_TOURNAMENT && group != CHESS_GROUP_PLAYER &&
+        group != CHESS_GROUP_WINNER)
+    {
+        return CHESS_INVALID_QUERY;
+    }
+    query->group = group;
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessQueryAggregate(ChessQuery query, ChessQueryAggregate aggregate, ChessQueryField field)
+{
+    if (query == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (aggregate < CHESS_AGGREGATE_COUNT || aggregate > CHESS_AGGREGATE_AVERAGE || field < CHESS_FIELD_PLAY_TIME ||
+        field > CHESS_FIELD_DRAWS || query->number_of_aggregates == CHESS_QUERY_MAX_AGGREGATES)
+    {
+        return CHESS_INVALID_QUERY;
+    }
+    query->aggregates[query->number_of_aggregates] = aggregate;
+    query->fields[query->number_of_aggregates] = field;
+    query->number_of_aggregates++;
+    return CHESS_SUCCESS;
+}
+
+const int *queryTournaments(ChessQuery query, int *count)
+{
+    *count = query->number_of_tournaments;
+    return query->filter_tournaments ? query->tournament_ids : NULL;
+}
+
+QueryResult queryResultCreate(ChessQuery query)
+{
+    QueryResult result = malloc(sizeof(*result));
+    if (result == NULL)
+    {
+        return NULL;
+    }
+    result->query = query;
+    result->groups = NULL;
+    result->number_of_groups = 0;
+    result->capacity = 0;
+    result->positions = hashTableCreate(sizeof(int), HASH_TABLE_UNCOUNTED);
+    if (result->positions == NULL)
+    {
+        free(result);
+        return NULL;
+    }
+    return result;
+}
+
+void queryResultDestroy(QueryResult result)
+{
+    if (result == NULL)
+    {
+        return;
+    }
+    free(result->groups);
+    hashTableDestroy(result->positions);
+    free(result);
+}
+
+/**
+ * findGroup: Returns the position of a group in a result, adding the group if it is not there.
+ *
+ * @param result - The result.
+ * @param group - The group.
+ * @return
+ *     -1 if an allocation failed, the position otherwise.
+ */
+static int findGroup(QueryResult result, int group)
+{
+    int *position = hashTableGet(result->positions, (unsigned int)group);
+    if (position != NULL)
+    {
+        return *position;
+    }
+    if (result->number_of_groups == result->capacity)
+    {
+        int capacity = result->capacity == 0 ? MINIMUM_CAPACITY : result->capacity * EXPAND;
+        QueryGroup *groups = realloc(result->groups, sizeof(*groups) * capacity);
+        if (groups == NULL)
+        {
+            return -1;
+        }
+        result->groups = groups;
+        result->capacity = capacity;
+    }
+    position = hashTablePut(result->positions, (unsigned int)group);
+    if (position == NULL)
+    {
+        return -1;
+    }
+    QueryGroup *new_group = &result->groups[result->number_of_groups];
+    new_group->group = group;
+    new_group->count = 0;
+    for (int i = 0; i < CHESS_QUERY_MAX_AGGREGATES; i++)
+    {
+        new_group->sums[i] = 0;
+        new_group->minimums[i] = DBL_MAX;
+        new_group->maximums[i] = -DBL_MAX;
+    }
+    *position = result->number_of_groups++;
+    return *position;
+}
+
+/**
+ * selectRows: Filters a batch of games into rows, each a game seen from the side of one player.
+ *
+ * @param query - The query.
+ * @param count - The number of games of the batch.
+ * @param first_players - The first players of the games.
+ * @param second_players - The second players of the games.
+ * @param winners - The winners of the games.
+ * @param rows - Where to store the rows.
+ */
+static void selectRows(ChessQuery query, int count, const int *first_players, const int *second_players,
+                       const Winner *winners, QueryRows *rows)
+{
+    int size = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (query->winners != ALL_WINNERS && (query->winners & (1 << winners[i])) == 0)
+        {
+            continue;
+        }
+        if (query->player_id != NO_PLAYER)
+        {
+            rows->games[size] = i;
+            rows->players[size] = query->player_id;
+            rows->first_side[size] = first_players[i] == query->player_id;
+            size += first_players[i] == query->player_id || second_players[i] == query->player_id;
+            continue;
+        }
+        if (query->group != CHESS_GROUP_PLAYER || first_players[i] != DELETE_PLAYER)
+        {
+            rows->games[size] = i;
+            rows->players[size] = first_players[i];
+            rows->first_side[size] = true;
+            size++;
+        }
+        if (query->group == CHESS_GROUP_PLAYER && second_players[i] != DELETE_PLAYER)
+        {
+            rows->games[size] = i;
+            rows->players[size] = second_players[i];
+            rows->first_side[size] = false;
+            size++;
+        }
+    }
+    rows->size = size;
+}
+
+/**
+ * computeFields: Computes the fields of the rows of a batch.
+ *
+ * @param rows - The rows.
+ * @param winners - The winners of the games of the batch.
+ * @param play_times - The play times of the games of the batch.
+ */
+static void computeFields(QueryRows *rows, const Winner *winners, const int *play_times)
+{
+    for (int k = 0; k < rows->size; k++)
+    {
+        Winner winner = winners[rows->games[k]];
+        bool won = winner == (rows->first_side[k] ? FIRST_PLAYER : SECOND_PLAYER);
+        bool drawn = winner == DRAW;
+        rows->fields[CHESS_FIELD_PLAY_TIME][k] = play_times[rows->games[k]];
+        rows->fields[CHESS_FIELD_WINS][k] = won;
+        rows->fields[CHESS_FIELD_DRAWS][k] = drawn;
+        rows->fields[CHESS_FIELD_LOSSES][k] = !won && !drawn;
+        rows->fields[CHESS_FIELD_POINTS][k] = WIN_POINTS * won + DRAW_POINTS * drawn;
+    }
+}
+
+/**
+ * assignGroups: Finds the groups of the rows of a batch, adding the groups that are not in the result.
+ *
+ * @param result - The result.
+ * @param tournament_id - The tournament of the batch.
+ * @param winners - The winners of the games of the batch.
+ * @param rows - The rows.
+ * @return
+ *     false if an allocation failed, true otherwise.
+ */
+static bool assignGroups(QueryResult result, int tournament_id, const Winner *winners, QueryRows *rows)
+{
+    ChessQueryGroup grouping = result->query->group;
+    int last_group = 0, last_position = -1;
+    for (int k = 0; k < rows->size; k++)
+    {
+        int group = 0;
+        if (grouping == CHESS_GROUP_TOURNAMENT)
+        {
+            group = tournament_id;
+        }
+        else if (grouping == CHESS_GROUP_PLAYER)
+        {
+            group = rows->players[k];
+        }
+        else if (grouping == CHESS_GROUP_WINNER)
+        {
+            group = winners[rows->games[k]];
+        }
+        if (last_position == -1 || group != last_group)
+        {
+            last_position = findGroup(result, group);
+            last_group = group;
+            if (last_position == -1)
+            {
+                return false;
+            }
+        }
+        rows->groups[k] = last_position;
+    }
+    return true;
+}
+
+/**
+ * aggregateRows: Folds the rows of a batch into their groups, one aggregate at a time.
+ */
+static void aggregateRows(QueryResult result, const QueryRows *rows)
+{
+    for (int k = 0; k < rows->size; k++)
+    {
+        result->groups[rows->groups[k]].count++;
+    }
+    for (int i = 0; i < result->query->number_of_aggregates; i++)
+    {
+        if (result->query->aggregates[i] == CHESS_AGGREGATE_COUNT)
+        {
+            continue;
+        }
+        const double *values = rows->fields[result->query->fields[i]];
+        for (int k = 0; k < rows->size; k++)
+        {
+            QueryGroup *group = &result->groups[rows->groups[k]];
+            group->sums[i] += values[k];
+            group->minimums[i] = values[k] < group->minimums[i] ? values[k] : group->minimums[i];
+            group->maximums[i] = values[k] > group->maximums[i] ? values[k] : group->maximums[i];
+        }
+    }
+}
+
+bool queryScan(QueryResult result, int tournament_id, TimeIndex index)
+{
+    int first_players[QUERY_BATCH], second_players[QUERY_BATCH], play_times[QUERY_BATCH];
+    Winner winners[QUERY_BATCH];
+    QueryRows *rows = malloc(sizeof(*rows));
+    if (rows == NULL)
+    {
+        return false;
+    }
+    int first;
+    int number_of_games = timeIndexRange(index, result->query->min_time, result->query->max_time, &first);
+    bool success = true;
+    for (int offset = 0; offset < number_of_games && success; offset += QUERY_BATCH)
+    {
+        int count = number_of_games - offset < QUERY_BATCH ? number_of_games - offset : QUERY_BATCH;
+        timeIndexColumns(index, first + offset, count, first_players, second_players, winners, play_times);
+        selectRows(result->query, count, first_players, second_players, winners, rows);
+        computeFields(rows, winners, play_times);
+        success = assignGroups(result, tournament_id, winners, rows);
+        if (success)
+        {
+            aggregateRows(result, rows);
+        }
+    }
+    free(rows);
+    return success;
+}
+
+/**
+ * compareGroups: qsort comparison of groups in increasing group order.
+ */
+static int compareGroups(const void *first, const void *second)
+{
+    return compareIds(&((const QueryGroup *)first)->group, &((const QueryGroup *)second)->group);
+}
+
+int queryResultRows(QueryResult result, ChessQueryRow *out_rows, int capacity)
+{
+    if (result->number_of_groups > 0)
+    {
+        qsort(result->groups, result->number_of_groups, sizeof(*result->groups), compareGroups);
+        for (int i = 0; i < result->number_of_groups; i++)
+        {
+            *(int *)hashTableGet(result->positions, (unsigned int)result->groups[i].group) = i;
+        }
+    }
+    for (int row = 0; row < result->number_of_groups && row < capacity; row++)
+    {
+        const QueryGroup *group = &result->groups[row];
+        out_rows[row].group = group->group;
+        out_rows[row].count = group->count;
+        for (int i = 0; i < CHESS_QUERY_MAX_AGGREGATES; i++)
+        {
+            double value = 0;
+            if (i < result->query->number_of_aggregates)
+            {
+                switch (result->query->aggregates[i])
+                {
+                case CHESS_AGGREGATE_COUNT:
+                    value = group->count;
+                    break;
+                case CHESS_AGGREGATE_SUM:
+                    value = group->sums[i];
+                    break;
+                case CHESS_AGGREGATE_MIN:
+                    value = group->minimums[i];
+                    break;
+                case CHESS_AGGREGATE_MAX:
+                    value = group->maximums[i];
+                    break;
+                case CHESS_AGGREGATE_AVERAGE:
+                    value = group->sums[i] / group->count;
+                    break;
+                }
+            }
+            out_rows[row].values[i] = value;
+        }
+    }
+    return result->number_of_groups;
+}
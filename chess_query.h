@@ -0,0 +1,88 @@
+#ifndef CHESS_QUERY_H
+#define CHESS_QUERY_H
+#include <stdbool.h>
+#include "chessSystem.h"
+#include "time_index.h"
+
+/*
+* Queries over the games of a chess system: filters, a grouping and aggregates, run in one pass.
+*
+* The games of every tournament are read from its play time index, only in the time range of the
+* query, in batches of QUERY_BATCH games copied column by column. Each batch is filtered into a
+* selection of (game, side) rows, the fields are computed for the whole selection, and every
+* aggregate is folded into the groups of the rows, one column at a time. The groups are kept in a
+* hash table by group, and sorted only when the result is read.
+*
+* The following functions are available:
+*   chessQueryCreate            - Creates a query (declared in chessSystem.h)
+*   chessQueryDestroy           - Deletes a query (declared in chessSystem.h)
+*   chessQueryFilterTournaments - Keeps the games of a set of tournaments (declared in chessSystem.h)
+*   chessQueryFilterPlayer      - Keeps the games of a player (declared in chessSystem.h)
+*   chessQueryFilterWinner      - Keeps the games with a winner kind (declared in chessSystem.h)
+*   chessQueryFilterTime        - Keeps the games in a play time range (declared in chessSystem.h)
+*   chessQueryGroupBy           - Sets the grouping of a query (declared in chessSystem.h)
+*   chessQueryAggregate         - Adds an aggregate to a query (declared in chessSystem.h)
+*   queryTournaments            - Returns the set of tournaments of a query
+*   queryResultCreate           - Creates the empty result of a query
+*   queryResultDestroy          - Deletes a result
+*   queryScan                   - Adds the games of a tournament to a result
+*   queryResultRows             - Copies the groups of a result
+*/
+
+#define QUERY_BATCH 256
+
+/** Type for defining the result of a query while it runs */
+typedef struct query_result_t *QueryResult;
+
+/**
+* queryTournaments: Returns the tournaments a query is filtered to.
+*
+* @param query - The query.
+* @param count - Where to store the number of tournaments.
+* @return
+* 	NULL - if the query is not filtered by tournament, and reads all of them.
+* 	The ids of the tournaments otherwise, in increasing order and without repeats.
+*/
+const int *queryTournaments(ChessQuery query, int *count);
+
+/**
+* queryResultCreate: Allocates the empty result of a query.
+*
+* @param query - The query. It must not change until the result is destroyed.
+* @return
+* 	NULL - if allocations failed.
+* 	A new result in case of success.
+*/
+QueryResult queryResultCreate(ChessQuery query);
+
+/**
+* queryResultDestroy: Deallocates a result.
+*
+* @param result - Target result. If result is NULL nothing will be done.
+*/
+void queryResultDestroy(QueryResult result);
+
+/**
+* queryScan: Adds the games of a tournament that pass the filters of the query to a result.
+*
+* @param result - The result.
+* @param tournament_id - The id of the tournament.
+* @param index - The play time index of the tournament.
+* @return
+* 	false - if an allocation failed.
+* 	true - otherwise.
+*/
+bool queryScan(QueryResult result, int tournament_id, TimeIndex index);
+
+/**
+* queryResultRows: Copies the groups of a result, in increasing group order.
+*
+* @param result - The result.
+* @param out_rows - Where to copy the groups.
+* @param capacity - The number of groups out_rows holds. Groups after it are counted but not copied.
+* @return
+* 	The number of groups.
+*/
+int queryResultRows(QueryResult result, ChessQueryRow *out_rows, int capacity);
+
+#endif
@@ -0,0 +1,561 @@
+#include <math.h>
+#include <string.h>
+#include "chess_rating.h"
+#include "chess_alloc.h"
+#include "chess_utilities.h"
+
+#define INITIAL_CAPACITY 256
+#define EXPAND 2
+#define INT_COLUMNS 4
+#define WINNER_MASK 3
+#define ENDED_FLAG 4
+#define FORFEITED_FLAG 8
+#define FORFEIT_EVENT 16
+#define RESET_EVENT 32
+#define EVENT_TOURNAMENT 0
+#define NO_PLAYER 0
+#define CHAIN_END -1
+#define RATING_BASE 10.0
+#define WIN_SCORE 1.0
+#define DRAW_SCORE 0.5
+#define LOSS_SCORE 0.0
+#define INT_BITS 32
+#define LOW_BITS_MASK 0xFFFFFFFFULL
+
+/**
+ * The entries are kept in one allocation of parallel arrays: the tournaments, the first players,
+ * the second players and the next game of the same tournament, followed by the results. A game
+ * has the Winner in the low bits of its result, ENDED_FLAG once its tournament ended or was
+ * removed, and FORFEITED_FLAG once one of its players was removed. An event has the tournament
+ * EVENT_TOURNAMENT and only a first player: FORFEIT_EVENT is a win by a removal, with the result
+ * the player had in the game in the low bits, and RESET_EVENT puts a removed player back at
+ * RATING_INITIAL.
+ *
+ * heads is a hash table from a tournament to its newest game, whose chain of next games goes over
+ * the games a removal can still forfeit, so ending the tournament or removing a player from it
+ * visits only its games. A tournament leaves the table once its chain is empty.
+ */
+struct rating_log_t
+{
+    void *block;
+    int *tournament_ids;
+    int *first_players;
+    int *second_players;
+    int *next_games;
+    unsigned char *results;
+    int size;
+    int capacity;
+    HashTable heads;
+};
+
+/**
+ * gameScore: Returns the score of the first player of a game.
+ *
+ * @param winner - The result of the game.
+ * @return
+ *     1 for a win, 0.5 for a draw and 0 for a loss.
+ */
+static double gameScore(Winner winner)
+{
+    if (winner == FIRST_PLAYER)
+    {
+        return WIN_SCORE;
+    }
+    return winner == DRAW ? DRAW_SCORE : LOSS_SCORE;
+}
+
+double ratingChange(double rating, double opponent_rating, Winner winner)
+{
+    double expected = 1.0 / (1.0 + pow(RATING_BASE, (opponent_rating - rating) / RATING_SCALE));
+    return RATING_K_FACTOR * (gameScore(winner) - expected);
+}
+
+/**
+ * forfeitChange: Returns how much the rating of a player changes when a game becomes his win
+ * because his opponent was removed.
+ *
+ * @param winner - The result the player had in the game, as its first player.
+ * @return
+ *     RATING_K_FACTOR times the score the player gains.
+ */
+static double forfeitChange(Winner winner)
+{
+    return RATING_K_FACTOR * (WIN_SCORE - gameScore(winner));
+}
+
+/**
+ * blockSize: Returns the bytes of the arrays of a history.
+ *
+ * @param capacity - The number of games the arrays hold.
+ * @return
+ *     The size of the block.
+ */
+static size_t blockSize(int capacity)
+{
+    return (sizeof(int) * INT_COLUMNS + sizeof(unsigned char)) * (size_t)capacity;
+}
+
+/**
+ * tournamentHead: Returns where the newest game of a tournament is kept.
+ *
+ * @param log - The history.
+ * @param tournament_id - The tournament.
+ * @return
+ *     NULL if the tournament has no linked games, the head of its chain otherwise.
+ */
+static int *tournamentHead(RatingLog log, int tournament_id)
+{
+    return hashTableGet(log->heads, (unsigned int)tournament_id);
+}
+
+RatingLog ratingLogCreate()
+{
+    RatingLog log = accountedMalloc(sizeof(*log), CHESS_MEMORY_RATINGS);
+    if (log == NULL)
+    {
+        return NULL;
+    }
+    log->block = NULL;
+    log->tournament_ids = NULL;
+    log->first_players = NULL;
+    log->second_players = NULL;
+    log->next_games = NULL;
+    log->results = NULL;
+    log->size = 0;
+    log->capacity = 0;
+    log->heads = hashTableCreate(sizeof(int), CHESS_MEMORY_RATINGS);
+    if (log->heads == NULL)
+    {
+        accountedFree(log, sizeof(*log), CHESS_MEMORY_RATINGS);
+        return NULL;
+    }
+    return log;
+}
+
+void ratingLogDestroy(RatingLog log)
+{
+    if (log == NULL)
+    {
+        return;
+    }
+    accountedFree(log->block, blockSize(log->capacity), CHESS_MEMORY_RATINGS);
+    hashTableDestroy(log->heads);
+    accountedFree(log, sizeof(*log), CHESS_MEMORY_RATINGS);
+}
+
+/**
+ * expandLog: Moves the games of a history to arrays of twice the capacity.
+ *
+ * @param log - The history.
+ * @return
+ *     false if the allocation failed, true otherwise.
+ */
+static bool expandLog(RatingLog log)
+{
+    int capacity = log->capacity == 0 ? INITIAL_CAPACITY : log->capacity * EXPAND;
+    void *block = accountedMalloc(blockSize(capacity), CHESS_MEMORY_RATINGS);
+    if (block == NULL)
+    {
+        return false;
+    }
+    int *tournament_ids = block;
+    int *first_players = tournament_ids + capacity;
+    int *second_players = first_players + capacity;
+    int *next_games = second_players + capacity;
+    unsigned char *results = (unsigned char *)(next_games + capacity);
+    if (log->size > 0)
+    {
+        memcpy(tournament_ids, log->tournament_ids, sizeof(int) * log->size);
+        memcpy(first_players, log->first_players, sizeof(int) * log->size);
+        memcpy(second_players, log->second_players, sizeof(int) * log->size);
+        memcpy(next_games, log->next_games, sizeof(int) * log->size);
+        memcpy(results, log->results, log->size);
+    }
+    accountedFree(log->block, blockSize(log->capacity), CHESS_MEMORY_RATINGS);
+    log->block = block;
+    log->tournament_ids = tournament_ids;
+    log->first_players = first_players;
+    log->second_players = second_players;
+    log->next_games = next_games;
+    log->results = results;
+    log->capacity = capacity;
+    return true;
+}
+
+/**
+ * reserveEntries: Makes sure the arrays of a history have room for more entries.
+ *
+ * @param log - The history.
+ * @param count - The number of entries to add.
+ * @return
+ *     false if an allocation failed, true otherwise.
+ */
+static bool reserveEntries(RatingLog log, int count)
+{
+    while (log->size + count > log->capacity)
+    {
+        if (expandLog(log) == false)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * appendEntry: Adds an entry at the end of a history, and links it to its tournament if a removal
+ * can still forfeit it.
+ *
+ * @param log - The history.
+ * @param tournament_id - The tournament of a game, EVENT_TOURNAMENT for an event.
+ * @param first_player - The first player.
+ * @param second_player - The second player, NO_PLAYER for an event.
+ * @param result - The result, with its flags.
+ * @return
+ *     false if an allocation failed, true otherwise. An event, or an entry whose room was
+ *     reserved and that is not linked, cannot fail.
+ */
+static bool appendEntry(RatingLog log, int tournament_id, int first_player, int second_player, unsigned char result)
+{
+    if (reserveEntries(log, 1) == false)
+    {
+        return false;
+    }
+    int *head = NULL;
+    if (tournament_id != EVENT_TOURNAMENT && (result & (ENDED_FLAG | FORFEITED_FLAG)) == 0 &&
+        (head = tournamentHead(log, tournament_id)) == NULL)
+    {
+        head = hashTablePut(log->heads, (unsigned int)tournament_id);
+        if (head == NULL)
+        {
+            return false;
+        }
+        *head = CHAIN_END;
+    }
+    log->tournament_ids[log->size] = tournament_id;
+    log->first_players[log->size] = first_player;
+    log->second_players[log->size] = second_player;
+    log->results[log->size] = result;
+    log->next_games[log->size] = CHAIN_END;
+    if (head != NULL)
+    {
+        log->next_games[log->size] = *head;
+        *head = log->size;
+    }
+    log->size++;
+    return true;
+}
+
+bool ratingLogAppend(RatingLog log, int tournament_id, int first_player, int second_player, Winner winner)
+{
+    return log != NULL && appendEntry(log, tournament_id, first_player, second_player, (unsigned char)winner);
+}
+
+bool ratingLogReserve(RatingLog log, int count)
+{
+    return log != NULL && reserveEntries(log, count);
+}
+
+void ratingLogRemoveLast(RatingLog log)
+{
+    if (log == NULL || log->size == 0)
+    {
+        return;
+    }
+    // The last game is the newest of its tournament, the first of its chain
+    log->size--;
+    int *head = tournamentHead(log, log->tournament_ids[log->size]);
+    *head = log->next_games[log->size];
+    if (*head == CHAIN_END)
+    {
+        hashTableRemove(log->heads, (unsigned int)log->tournament_ids[log->size]);
+    }
+}
+
+void ratingLogEndTournament(RatingLog log, int tournament_id)
+{
+    int *head = log == NULL ? NULL : tournamentHead(log, tournament_id);
+    if (head == NULL)
+    {
+        return;
+    }
+    for (int game = *head; game != CHAIN_END; game = log->next_games[game])
+    {
+        log->results[game] |= ENDED_FLAG;
+    }
+    hashTableRemove(log->heads, (unsigned int)tournament_id);
+}
+
+void ratingLogRemovePlayer(RatingLog log, int tournament_id, int player_id, RatingForfeitVisitor visit, void *context)
+{
+    int *link = log == NULL ? NULL : tournamentHead(log, tournament_id);
+    if (link == NULL)
+    {
+        return;
+    }
+    while (*link != CHAIN_END)
+    {
+        int game = *link;
+        if (log->first_players[game] != player_id && log->second_players[game] != player_id)
+        {
+            link = &log->next_games[game];
+            continue;
+        }
+        // The game leaves the chain, as the opponent wins it once
+        *link = log->next_games[game];
+        log->results[game] |= FORFEITED_FLAG;
+        Winner winner = (Winner)(log->results[game] & WINNER_MASK);
+        int opponent = log->first_players[game];
+        if (opponent == player_id)
+        {
+            opponent = log->second_players[game];
+            winner = winner == DRAW ? DRAW : (winner == FIRST_PLAYER ? SECOND_PLAYER : FIRST_PLAYER);
+        }
+        if (winner != FIRST_PLAYER)
+        {
+            appendEntry(log, EVENT_TOURNAMENT, opponent, NO_PLAYER, (unsigned char)(FORFEIT_EVENT | winner));
+            if (visit != NULL)
+            {
+                visit(context, opponent, forfeitChange(winner));
+            }
+        }
+    }
+    if (*tournamentHead(log, tournament_id) == CHAIN_END)
+    {
+        hashTableRemove(log->heads, (unsigned int)tournament_id);
+    }
+}
+
+void ratingLogResetPlayer(RatingLog log, int player_id)
+{
+    if (log != NULL)
+    {
+        appendEntry(log, EVENT_TOURNAMENT, player_id, NO_PLAYER, RESET_EVENT);
+    }
+}
+
+/**
+ * compareIds: qsort comparison of player ids.
+ */
+static int compareIds(const void *first, const void *second)
+{
+    int id1 = *(const int *)first, id2 = *(const int *)second;
+    return (id1 > id2) - (id1 < id2);
+}
+
+/**
+ * findId: Binary searches sorted player ids.
+ *
+ * @param ids - The ids, in increasing order.
+ * @param count - The number of ids.
+ * @param player_id - The id to find.
+ * @return
+ *     The index of the id, -1 if it is not in ids.
+ */
+static int findId(const int *ids, int count, int player_id)
+{
+    int low = 0, high = count - 1;
+    while (low <= high)
+    {
+        int middle = low + (high - low) / 2;
+        if (ids[middle] == player_id)
+        {
+            return middle;
+        }
+        if (ids[middle] < player_id)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+    return -1;
+}
+
+bool ratingLogRecalculate(RatingLog log, int **ids, double **ratings, int *count)
+{
+    if (log == NULL || ids == NULL || ratings == NULL || count == NULL)
+    {
+        return false;
+    }
+    int size = log->size;
+    int *players = malloc(sizeof(int) * 2 * (size_t)size + 1);
+    int *first_indexes = malloc(sizeof(int) * (size_t)size + 1);
+    int *second_indexes = malloc(sizeof(int) * (size_t)size + 1);
+    if (players == NULL || first_indexes == NULL || second_indexes == NULL)
+    {
+        free(players);
+        free(first_indexes);
+        free(second_indexes);
+        return false;
+    }
+
+    // Number the players densely, so the rating pass works on flat arrays
+    int number_of_ids = 0;
+    for (int i = 0; i < size; i++)
+    {
+        players[number_of_ids++] = log->first_players[i];
+        if (log->tournament_ids[i] != EVENT_TOURNAMENT)
+        {
+            players[number_of_ids++] = log->second_players[i];
+        }
+    }
+    qsort(players, number_of_ids, sizeof(int), compareIds);
+    int number_of_players = 0;
+    for (int i = 0; i < number_of_ids; i++)
+    {
+        if (number_of_players == 0 || players[number_of_players - 1] != players[i])
+        {
+            players[number_of_players++] = players[i];
+        }
+    }
+    for (int i = 0; i < size; i++)
+    {
+        first_indexes[i] = findId(players, number_of_players, log->first_players[i]);
+        second_indexes[i] = log->tournament_ids[i] == EVENT_TOURNAMENT ? -1 :
+                            findId(players, number_of_players, log->second_players[i]);
+    }
+    double *player_ratings = malloc(sizeof(double) * (size_t)number_of_players + 1);
+    if (player_ratings == NULL)
+    {
+        free(players);
+        free(first_indexes);
+        free(second_indexes);
+        return false;
+    }
+    for (int i = 0; i < number_of_players; i++)
+    {
+        player_ratings[i] = RATING_INITIAL;
+    }
+
+    // Every game depends on the ratings left by the entries before it, so the pass is in order
+    for (int i = 0; i < size; i++)
+    {
+        int first = first_indexes[i], second = second_indexes[i];
+        Winner winner = (Winner)(log->results[i] & WINNER_MASK);
+        if (log->results[i] & RESET_EVENT)
+        {
+            player_ratings[first] = RATING_INITIAL;
+            continue;
+        }
+        if (log->results[i] & FORFEIT_EVENT)
+        {
+            player_ratings[first] += forfeitChange(winner);
+            continue;
+        }
+        double change = ratingChange(player_ratings[first], player_ratings[second], winner);
+        player_ratings[first] += change;
+        player_ratings[second] -= change;
+    }
+
+    free(first_indexes);
+    free(second_indexes);
+    *ids = players;
+    *ratings = player_ratings;
+    *count = number_of_players;
+    return true;
+}
+
+double ratingLookup(const int *ids, const double *ratings, int count, int player_id)
+{
+    if (ids == NULL || ratings == NULL)
+    {
+        return RATING_INITIAL;
+    }
+    int index = findId(ids, count, player_id);
+    return index < 0 ? RATING_INITIAL : ratings[index];
+}
+
+bool ratingLogSnapshotWrite(RatingLog log, SnapshotWriter writer)
+{
+    if (log == NULL || writer == NULL)
+    {
+        return false;
+    }
+    bool success = snapshotWriteInt(writer, log->size);
+    for (int i = 0; i < log->size && success; i++)
+    {
+        success = snapshotWriteInt(writer, log->tournament_ids[i]) &&
+                  snapshotWriteInt(writer, log->first_players[i]) &&
+                  snapshotWriteInt(writer, log->second_players[i]) &&
+                  snapshotWriteInt(writer, log->results[i]);
+    }
+    return success;
+}
+
+/**
+ * validEntry: Checks an entry read from a snapshot: a game of two different players with a
+ * result and its flags, or an event of one player.
+ *
+ * @return
+ *     false if the entry could not be written by ratingLogSnapshotWrite, true otherwise.
+ */
+static bool validEntry(int tournament_id, int first_player, int second_player, int result)
+{
+    if (tournament_id == EVENT_TOURNAMENT)
+    {
+        return first_player > 0 && second_player == NO_PLAYER &&
+               (result == RESET_EVENT || result == (FORFEIT_EVENT | SECOND_PLAYER) ||
+                result == (FORFEIT_EVENT | DRAW));
+    }
+    return tournament_id > 0 && first_player > 0 && second_player > 0 && first_player != second_player &&
+           (result & WINNER_MASK) <= DRAW && (result & ~(WINNER_MASK | ENDED_FLAG | FORFEITED_FLAG)) == 0;
+}
+
+ChessResult ratingLogSnapshotRead(RatingLog log, SnapshotReader reader)
+{
+    if (log == NULL || reader == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    int size = snapshotReadInt(reader);
+    for (int i = 0; i < size && snapshotReaderFailed(reader) == false; i++)
+    {
+        int tournament_id = snapshotReadInt(reader);
+        int first_player = snapshotReadInt(reader);
+        int second_player = snapshotReadInt(reader);
+        int result = snapshotReadInt(reader);
+        if (validEntry(tournament_id, first_player, second_player, result) == false)
+        {
+            return CHESS_LOAD_FAILURE;
+        }
+        if (appendEntry(log, tournament_id, first_player, second_player, (unsigned char)result) == false)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+    }
+    return snapshotReaderFailed(reader) ? CHESS_LOAD_FAILURE : CHESS_SUCCESS;
+}
+
+bool ratingSnapshotWrite(double rating, SnapshotWriter writer)
+{
+    unsigned long long bits;
+    memcpy(&bits, &rating, sizeof(bits));
+    return snapshotWriteInt(writer, (int)(bits & LOW_BITS_MASK)) &&
+           snapshotWriteInt(writer, (int)(bits >> INT_BITS));
+}
+
+double ratingSnapshotRead(SnapshotReader reader)
+{
+    unsigned long long bits = (unsigned int)snapshotReadInt(reader);
+    bits |= (unsigned long long)(unsigned int)snapshotReadInt(reader) << INT_BITS;
+    double rating;
+    memcpy(&rating, &bits, sizeof(rating));
+    return rating;
+}
+
+void ratingLogMemoryUsage(RatingLog log, ChessMemoryFootprint *footprint)
+{
+    if (log == NULL || footprint == NULL)
+    {
+        return;
+    }
+    memoryFootprintAdd(footprint, CHESS_MEMORY_RATINGS, sizeof(*log), 1);
+    hashTableMemoryUsage(log->heads, footprint);
+    if (log->block != NULL)
+    {
+        memoryFootprintAdd(footprint, CHESS_MEMORY_RATINGS, blockSize(log->capacity), 1);
+    }
+}
@@ -0,0 +1,220 @@
+#ifndef CHESS_RATING_H
+#define CHESS_RATING_H
+#include <stdbool.h>
+#include "chessSystem.h"
+#include "chess_snapshot.h"
+
+#define RATING_INITIAL 1500.0
+#define RATING_K_FACTOR 32.0
+#define RATING_SCALE 400.0
+
+/*
+* Elo ratings of the players and the history of the rated games.
+*
+* Every game moves the ratings of its two players by ratingChange when it is added. The history
+* keeps everything that moved a rating, in the order it happened, in parallel arrays (tournament,
+* players and result), so a batch re-rating goes over it in one flat pass with no map lookups and
+* ends with the ratings the games gave one by one. Ratings are never taken back: a game stays when
+* its tournament is removed. Removing a player from a tournament that did not end gives his
+* opponents the games they did not win, and each such win is an event that adds the score they
+* gained times RATING_K_FACTOR. The removed player then gets an event that puts him back at
+* RATING_INITIAL, as a removed player that plays again starts over. The games of each running
+* tournament are linked, so ending it or removing a player from it costs only its games.
+*
+* The following functions are available:
+*   ratingChange               - Returns the rating change of the first player of a game
+*   ratingLogCreate            - Creates an empty history
+*   ratingLogDestroy           - Deletes a history
+*   ratingLogAppend            - Adds a game at the end of the history
+*   ratingLogReserve           - Makes room for entries, so adding them cannot fail
+*   ratingLogRemoveLast        - Removes the last game of the history
+*   ratingLogEndTournament     - Marks the games of a tournament as ended
+*   ratingLogRemovePlayer      - Adds the wins the opponents of a removed player get in a tournament
+*   ratingLogResetPlayer       - Puts a removed player back at RATING_INITIAL
+*   ratingLogRecalculate       - Rates all the players of the history from the start
+*   ratingLookup               - Finds a player in the result of ratingLogRecalculate
+*   ratingLogSnapshotWrite     - Appends the history to a binary snapshot
+*   ratingLogSnapshotRead      - Reads the history of a binary snapshot
+*   ratingSnapshotWrite        - Appends a rating to a binary snapshot
+*   ratingSnapshotRead         - Reads the next rating of a binary snapshot
+*   ratingLogMemoryUsage       - Adds the memory of the history to a footprint
+*/
+
+/** Type for defining the history of the rated games */
+typedef struct rating_log_t *RatingLog;
+
+/** Type for a function called with the rating change of every win given by a removal */
+typedef void (*RatingForfeitVisitor)(void *context, int player_id, double change);
+
+/**
+* ratingChange: Returns how much the rating of the first player of a game changes. The second
+*   player changes by the same amount in the other direction.
+*
+* @param rating - The rating of the first player before the game.
+* @param opponent_rating - The rating of the second player before the game.
+* @param winner - The result of the game.
+* @return
+* 	RATING_K_FACTOR times the difference between the score and the expected score.
+*/
+double ratingChange(double rating, double opponent_rating, Winner winner);
+
+/**
+* ratingLogCreate: Allocates an empty history.
+*
+* @return
+* 	NULL - if allocations failed.
+* 	A new history in case of success.
+*/
+RatingLog ratingLogCreate();
+
+/**
+* ratingLogDestroy: Deallocates a history.
+*
+* @param log - Target history. If log is NULL nothing will be done.
+*/
+void ratingLogDestroy(RatingLog log);
+
+/**
+* ratingLogAppend: Adds a game at the end of the history.
+*
+* @param log - The history.
+* @param tournament_id - The tournament of the game.
+* @param first_player - The first player.
+* @param second_player - The second player.
+* @param winner - The result of the game.
+* @return
+* 	false - if the input is NULL or an allocation failed.
+* 	true - otherwise.
+*/
+bool ratingLogAppend(RatingLog log, int tournament_id, int first_player, int second_player, Winner winner);
+
+/**
+* ratingLogReserve: Makes room for more entries, so the next count entries ratingLogRemovePlayer
+*   and ratingLogResetPlayer add allocate nothing.
+*
+* @param log - The history.
+* @param count - The number of entries.
+* @return
+* 	false - if the input is NULL or an allocation failed.
+* 	true - otherwise.
+*/
+bool ratingLogReserve(RatingLog log, int count);
+
+/**
+* ratingLogRemoveLast: Removes the last game added to the history, as when adding the game to its
+*   tournament failed.
+*
+* @param log - The history. If log is NULL or empty nothing will be done.
+*/
+void ratingLogRemoveLast(RatingLog log);
+
+/**
+* ratingLogEndTournament: Marks the games of a tournament as ended, when it ends or is removed, so
+*   removing a player no longer changes them. The games stay rated.
+*
+* @param log - The history. If log is NULL nothing will be done.
+* @param tournament_id - The tournament.
+*/
+void ratingLogEndTournament(RatingLog log, int tournament_id);
+
+/**
+* ratingLogRemovePlayer: Gives the opponents of a removed player the games he has in a tournament
+*   that did not end, as the tournament does. Every game an opponent did not win adds an event,
+*   and visit is called with the rating change of the opponent. A game is given once, so removing
+*   the opponent afterwards gives it to no one.
+*
+* @param log - The history. If log is NULL nothing will be done.
+* @param tournament_id - The tournament.
+* @param player_id - The removed player.
+* @param visit - Called with every opponent that wins a game and his change. May be NULL.
+* @param context - Passed to visit.
+*/
+void ratingLogRemovePlayer(RatingLog log, int tournament_id, int player_id, RatingForfeitVisitor visit, void *context);
+
+/**
+* ratingLogResetPlayer: Adds an event that puts a removed player back at RATING_INITIAL.
+*
+* @param log - The history. If log is NULL nothing will be done.
+* @param player_id - The removed player.
+*/
+void ratingLogResetPlayer(RatingLog log, int player_id);
+
+/**
+* ratingLogRecalculate: Rates every player of the history from RATING_INITIAL, going over the
+*   games and events once in the order they were added.
+*
+* @param log - The history.
+* @param ids - Where to store the player ids in increasing order, allocated with malloc.
+* @param ratings - Where to store the ratings of the players in ids, allocated with malloc.
+* @param count - Where to store the number of players.
+* @return
+* 	false - if the input is NULL or an allocation failed.
+* 	true - otherwise.
+*/
+bool ratingLogRecalculate(RatingLog log, int **ids, double **ratings, int *count);
+
+/**
+* ratingLookup: Finds the rating of a player in the result of ratingLogRecalculate.
+*
+* @param ids - The player ids, in increasing order.
+* @param ratings - The ratings of the players in ids.
+* @param count - The number of players.
+* @param player_id - The player to find.
+* @return
+* 	RATING_INITIAL - if the player is not in ids.
+* 	The rating of the player otherwise.
+*/
+double ratingLookup(const int *ids, const double *ratings, int count, int player_id);
+
+/**
+* ratingLogSnapshotWrite: Appends the games and events of the history, in order, to a binary snapshot.
+*
+* @param log - The history.
+* @param writer - The snapshot writer.
+* @return
+* 	false - if the input is NULL or the snapshot could not grow.
+* 	true - otherwise.
+*/
+bool ratingLogSnapshotWrite(RatingLog log, SnapshotWriter writer);
+
+/**
+* ratingLogSnapshotRead: Appends the games and events written by ratingLogSnapshotWrite to a history.
+*
+* @param log - The history.
+* @param reader - The snapshot reader.
+* @return
+* 	CHESS_LOAD_FAILURE - if the snapshot is truncated or corrupted.
+* 	CHESS_OUT_OF_MEMORY - if an allocation failed.
+* 	CHESS_SUCCESS otherwise.
+*/
+ChessResult ratingLogSnapshotRead(RatingLog log, SnapshotReader reader);
+
+/**
+* ratingSnapshotWrite: Appends the exact bits of a rating to a binary snapshot.
+*
+* @param rating - The rating.
+* @param writer - The snapshot writer.
+* @return
+* 	false - if the input is NULL or the snapshot could not grow.
+* 	true - otherwise.
+*/
+bool ratingSnapshotWrite(double rating, SnapshotWriter writer);
+
+/**
+* ratingSnapshotRead: Reads the next rating written by ratingSnapshotWrite.
+*
+* @param reader - The snapshot reader.
+* @return
+* 	The rating. Check snapshotReaderFailed for a truncated snapshot.
+*/
+double ratingSnapshotRead(SnapshotReader reader);
+
+/**
+* ratingLogMemoryUsage: Adds the memory of the history to a footprint.
+*
+* @param log - The history. If log is NULL nothing will be added.
+* @param footprint - The footprint to add to.
+*/
+void ratingLogMemoryUsage(RatingLog log, ChessMemoryFootprint *footprint);
+
+#endif
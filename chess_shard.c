@@ -0,0 +1,633 @@
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "chess_shard.h"
+
+#define SHARD_MAX_ARGUMENTS 5
+#define FIRST_SHARD 0
+
+/** Type for defining the calls a shard worker runs */
+typedef enum {
+    SHARD_ADD_TOURNAMENT,
+    SHARD_ADD_GAME,
+    SHARD_REMOVE_TOURNAMENT,
+    SHARD_REMOVE_PLAYER,
+    SHARD_END_TOURNAMENT,
+    SHARD_PLAY_TIME,
+    SHARD_PLAYER_TOTALS,
+    SHARD_STATISTICS,
+    SHARD_STOP
+} ShardOperation;
+
+/** A call to a shard, with its arguments and what it returns */
+typedef struct
+{
+    ShardOperation operation;
+    int arguments[SHARD_MAX_ARGUMENTS];
+    const char *location;
+    ChessResult result;
+    bool active;
+    double total_time;
+    int number_of_games;
+    ShardPlayerTotal *players;
+    ExportStatisticsRow *statistics;
+    int count;
+} ShardCall;
+
+/** A shard: its system, the worker that owns it, and the call handed to the worker, NULL when idle */
+typedef struct
+{
+    ChessSystem chess;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    ShardCall *call;
+} Shard;
+
+struct chess_sharded_system_t
+{
+    Shard *shards;
+    int number_of_shards;
+};
+
+/**
+ * shardCallInit: Sets a call to an operation, with no results yet.
+ *
+ * @param call - The call.
+ * @param operation - The operation to run.
+ * @param arguments - SHARD_MAX_ARGUMENTS int arguments of the operation, or NULL if it has none.
+ * @param location - The tournament location, used only by SHARD_ADD_TOURNAMENT.
+ */
+static void shardCallInit(ShardCall *call, ShardOperation operation, const int *arguments, const char *location)
+{
+    memset(call, 0, sizeof(*call));
+    call->operation = operation;
+    if (arguments != NULL)
+    {
+        memcpy(call->arguments, arguments, sizeof(call->arguments));
+    }
+    call->location = location;
+    call->players = NULL;
+    call->statistics = NULL;
+}
+
+/**
+ * runCall: Runs a call on the system of a shard.
+ *
+ * @param chess - The system of the shard.
+ * @param call - The call. Its results are stored in it.
+ */
+static void runCall(ChessSystem chess, ShardCall *call)
+{
+    const int *arguments = call->arguments;
+    switch (call->operation)
+    {
+    case SHARD_ADD_TOURNAMENT:
+        call->result = chessAddTournament(chess, arguments[0], arguments[1], call->location);
+        break;
+    case SHARD_ADD_GAME:
+        call->result = chessAddGame(chess, arguments[0], arguments[1], arguments[2], arguments[3], arguments[4]);
+        break;
+    case SHARD_REMOVE_TOURNAMENT:
+        call->result = chessRemoveTournament(chess, arguments[0]);
+        break;
+    case SHARD_REMOVE_PLAYER:
+        call->result = chessRemovePlayer(chess, arguments[0]);
+        break;
+    case SHARD_END_TOURNAMENT:
+        call->result = chessEndTournament(chess, arguments[0]);
+        break;
+    case SHARD_PLAY_TIME:
+        call->result = shardPlayerPlayTime(chess, arguments[0], &call->active, &call->total_time,
+                                           &call->number_of_games);
+        break;
+    case SHARD_PLAYER_TOTALS:
+        call->result = shardCapturePlayerTotals(chess, &call->players, &call->count);
+        break;
+    case SHARD_STATISTICS:
+        call->result = shardCaptureStatistics(chess, &call->statistics, &call->count);
+        break;
+    case SHARD_STOP:
+        call->result = CHESS_SUCCESS;
+        break;
+    }
+}
+
+/**
+ * shardWorker: The thread of a shard. Runs the calls handed to it one at a time, until SHARD_STOP.
+ *
+ * @param argument - The shard.
+ * @return
+ *     NULL.
+ */
+static void *shardWorker(void *argument)
+{
+    Shard *shard = argument;
+    bool running = true;
+    while (running)
+    {
+        pthread_mutex_lock(&shard->lock);
+        while (shard->call == NULL)
+        {
+            pthread_cond_wait(&shard->changed, &shard->lock);
+        }
+        ShardCall *call = shard->call;
+        pthread_mutex_unlock(&shard->lock);
+
+        runCall(shard->chess, call);
+        running = call->operation != SHARD_STOP;
+
+        pthread_mutex_lock(&shard->lock);
+        shard->call = NULL;
+        pthread_cond_broadcast(&shard->changed);
+        pthread_mutex_unlock(&shard->lock);
+    }
+    return NULL;
+}
+
+/**
+ * shardSubmit: Hands a call to the worker of a shard, which must be idle, without waiting for it.
+ */
+static void shardSubmit(Shard *shard, ShardCall *call)
+{
+    pthread_mutex_lock(&shard->lock);
+    shard->call = call;
+    pthread_cond_broadcast(&shard->changed);
+    pthread_mutex_unlock(&shard->lock);
+}
+
+/**
+ * shardWait: Waits until the worker of a shard finished its call.
+ */
+static void shardWait(Shard *shard)
+{
+    pthread_mutex_lock(&shard->lock);
+    while (shard->call != NULL)
+    {
+        pthread_cond_wait(&shard->changed, &shard->lock);
+    }
+    pthread_mutex_unlock(&shard->lock);
+}
+
+/**
+ * shardStart: Creates the system of a shard and starts its worker.
+ *
+ * @param shard - The shard.
+ * @return
+ *     false - if an allocation failed or the thread could not be started.
+ *     true - otherwise.
+ */
+static bool shardStart(Shard *shard)
+{
+    shard->call = NULL;
+    shard->chess = chessCreate();
+    if (shard->chess == NULL)
+    {
+        return false;
+    }
+    if (pthread_mutex_init(&shard->lock, NULL) != 0)
+    {
+        chessDestroy(shard->chess);
+        return false;
+    }
+    if (pthread_cond_init(&shard->changed, NULL) != 0)
+    {
+        pthread_mutex_destroy(&shard->lock);
+        chessDestroy(shard->chess);
+        return false;
+    }
+    if (pthread_create(&shard->thread, NULL, shardWorker, shard) != 0)
+    {
+        pthread_cond_destroy(&shard->changed);
+        pthread_mutex_destroy(&shard->lock);
+        chessDestroy(shard->chess);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * shardStop: Stops the worker of a shard and destroys its system.
+ */
+static void shardStop(Shard *shard)
+{
+    ShardCall call;
+    shardCallInit(&call, SHARD_STOP, NULL, NULL);
+    shardSubmit(shard, &call);
+    pthread_join(shard->thread, NULL);
+    pthread_cond_destroy(&shard->changed);
+    pthread_mutex_destroy(&shard->lock);
+    chessDestroy(shard->chess);
+}
+
+ChessShardedSystem chessShardedCreate(int number_of_shards)
+{
+    if (number_of_shards <= 0)
+    {
+        return NULL;
+    }
+    ChessShardedSystem sharded = malloc(sizeof(*sharded));
+    if (sharded == NULL)
+    {
+        return NULL;
+    }
+    sharded->shards = malloc(sizeof(*sharded->shards) * number_of_shards);
+    sharded->number_of_shards = 0;
+    if (sharded->shards == NULL)
+    {
+        free(sharded);
+        return NULL;
+    }
+    while (sharded->number_of_shards < number_of_shards)
+    {
+        if (shardStart(&sharded->shards[sharded->number_of_shards]) == false)
+        {
+            chessShardedDestroy(sharded);
+            return NULL;
+        }
+        sharded->number_of_shards++;
+    }
+    return sharded;
+}
+
+void chessShardedDestroy(ChessShardedSystem sharded)
+{
+    if (sharded == NULL)
+    {
+        return;
+    }
+    for (int i = 0; i < sharded->number_of_shards; i++)
+    {
+        shardStop(&sharded->shards[i]);
+    }
+    free(sharded->shards);
+    free(sharded);
+}
+
+/**
+ * runOnTournament: Runs a call on the shard of a tournament, and waits for it. Invalid ids go to the
+ * first shard, which rejects them as the unsharded system does.
+ *
+ * @param sharded - The sharded system.
+ * @param tournament_id - The tournament.
+ * @param call - The call.
+ * @return
+ *     The result of the call.
+ */
+static ChessResult runOnTournament(ChessShardedSystem sharded, int tournament_id, ShardCall *call)
+{
+    Shard *shard = &sharded->shards[tournament_id > 0 ? tournament_id % sharded->number_of_shards : FIRST_SHARD];
+    shardSubmit(shard, call);
+    shardWait(shard);
+    return call->result;
+}
+
+/**
+ * runOnAll: Runs a call on every shard at once, and waits for all of them.
+ *
+ * @param sharded - The sharded system.
+ * @param call - The call to run.
+ * @return
+ *     The calls of the shards, allocated with malloc, or NULL if the allocation failed.
+ */
+static ShardCall *runOnAll(ChessShardedSystem sharded, const ShardCall *call)
+{
+    ShardCall *calls = malloc(sizeof(*calls) * sharded->number_of_shards);
+    if (calls == NULL)
+    {
+        return NULL;
+    }
+    for (int i = 0; i < sharded->number_of_shards; i++)
+    {
+        calls[i] = *call;
+        shardSubmit(&sharded->shards[i], &calls[i]);
+    }
+    for (int i = 0; i < sharded->number_of_shards; i++)
+    {
+        shardWait(&sharded->shards[i]);
+    }
+    return calls;
+}
+
+ChessResult chessShardedAddTournament(ChessShardedSystem sharded, int tournament_id, int max_games_per_player,
+                                      const char *tournament_location)
+{
+    if (sharded == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    int arguments[SHARD_MAX_ARGUMENTS] = {tournament_id, max_games_per_player};
+    ShardCall call;
+    shardCallInit(&call, SHARD_ADD_TOURNAMENT, arguments, tournament_location);
+    return runOnTournament(sharded, tournament_id, &call);
+}
+
+ChessResult chessShardedAddGame(ChessShardedSystem sharded, int tournament_id, int first_player, int second_player,
+                                Winner winner, int play_time)
+{
+    if (sharded == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    int arguments[SHARD_MAX_ARGUMENTS] = {tournament_id, first_player, second_player, winner, play_time};
+    ShardCall call;
+    shardCallInit(&call, SHARD_ADD_GAME, arguments, NULL);
+    return runOnTournament(sharded, tournament_id, &call);
+}
+
+ChessResult chessShardedRemoveTournament(ChessShardedSystem sharded, int tournament_id)
+{
+    if (sharded == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    int arguments[SHARD_MAX_ARGUMENTS] = {tournament_id};
+    ShardCall call;
+    shardCallInit(&call, SHARD_REMOVE_TOURNAMENT, arguments, NULL);
+    return runOnTournament(sharded, tournament_id, &call);
+}
+
+ChessResult chessShardedEndTournament(ChessShardedSystem sharded, int tournament_id)
+{
+    if (sharded == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    int arguments[SHARD_MAX_ARGUMENTS] = {tournament_id};
+    ShardCall call;
+    shardCallInit(&call, SHARD_END_TOURNAMENT, arguments, NULL);
+    return runOnTournament(sharded, tournament_id, &call);
+}
+
+ChessResult chessShardedRemovePlayer(ChessShardedSystem sharded, int player_id)
+{
+    if (sharded == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (player_id <= 0)
+    {
+        return CHESS_INVALID_ID;
+    }
+    int arguments[SHARD_MAX_ARGUMENTS] = {player_id};
+    ShardCall call;
+    shardCallInit(&call, SHARD_REMOVE_PLAYER, arguments, NULL);
+    ShardCall *calls = runOnAll(sharded, &call);
+    if (calls == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    // The player is removed if any shard had it, and an allocation failure in any shard is reported
+    ChessResult result = CHESS_PLAYER_NOT_EXIST;
+    for (int i = 0; i < sharded->number_of_shards; i++)
+    {
+        if (calls[i].result == CHESS_OUT_OF_MEMORY || (calls[i].result == CHESS_SUCCESS && result != CHESS_OUT_OF_MEMORY))
+        {
+            result = calls[i].result;
+        }
+    }
+    free(calls);
+    return result;
+}
+
+double chessShardedCalculateAveragePlayTime(ChessShardedSystem sharded, int player_id, ChessResult *chess_result)
+{
+    if (sharded == NULL)
+    {
+        *chess_result = CHESS_NULL_ARGUMENT;
+        return 0;
+    }
+    if (player_id <= 0)
+    {
+        *chess_result = CHESS_INVALID_ID;
+        return 0;
+    }
+    int arguments[SHARD_MAX_ARGUMENTS] = {player_id};
+    ShardCall call;
+    shardCallInit(&call, SHARD_PLAY_TIME, arguments, NULL);
+    ShardCall *calls = runOnAll(sharded, &call);
+    if (calls == NULL)
+    {
+        *chess_result = CHESS_OUT_OF_MEMORY;
+        return 0;
+    }
+    bool active = false;
+    double total_time = 0;
+    int number_of_games = 0;
+    for (int i = 0; i < sharded->number_of_shards; i++)
+    {
+        active = active || calls[i].active;
+        total_time += calls[i].total_time;
+        number_of_games += calls[i].number_of_games;
+    }
+    free(calls);
+    if (active == false)
+    {
+        *chess_result = CHESS_PLAYER_NOT_EXIST;
+        return 0;
+    }
+    *chess_result = CHESS_SUCCESS;
+    if (total_time == 0)
+    {
+        return total_time;
+    }
+    return total_time / number_of_games;
+}
+
+/**
+ * comparePlayerTotals: qsort comparison of player totals in increasing id order.
+ */
+static int comparePlayerTotals(const void *first, const void *second)
+{
+    int id1 = ((const ShardPlayerTotal *)first)->player_id, id2 = ((const ShardPlayerTotal *)second)->player_id;
+    return (id1 > id2) - (id1 < id2);
+}
+
+/**
+ * mergeLevelRows: Sums the totals every shard has of each player, and captures the level of every
+ * player that is in some shard and played at least one game.
+ *
+ * @param calls - The SHARD_PLAYER_TOTALS calls of the shards. Their rows are freed.
+ * @param number_of_shards - The number of shards.
+ * @param rows - Where to store the level rows, allocated with malloc.
+ * @param count - Where to store the number of level rows.
+ * @return
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed in a shard or here.
+ *     CHESS_SUCCESS - otherwise.
+ */
+static ChessResult mergeLevelRows(ShardCall *calls, int number_of_shards, ExportLevelRow **rows, int *count)
+{
+    bool success = true;
+    int number_of_totals = 0;
+    for (int i = 0; i < number_of_shards; i++)
+    {
+        if (calls[i].result != CHESS_SUCCESS)
+        {
+            success = false;
+            calls[i].players = NULL;
+            calls[i].count = 0;
+        }
+        number_of_totals += calls[i].count;
+    }
+    ShardPlayerTotal *totals = success ? malloc(sizeof(*totals) * (number_of_totals + 1)) : NULL;
+    *rows = totals != NULL ? malloc(sizeof(**rows) * (number_of_totals + 1)) : NULL;
+    if (*rows == NULL)
+    {
+        free(totals);
+        for (int i = 0; i < number_of_shards; i++)
+        {
+            free(calls[i].players);
+        }
+        return CHESS_OUT_OF_MEMORY;
+    }
+    number_of_totals = 0;
+    for (int i = 0; i < number_of_shards; i++)
+    {
+        memcpy(totals + number_of_totals, calls[i].players, sizeof(*totals) * calls[i].count);
+        number_of_totals += calls[i].count;
+        free(calls[i].players);
+    }
+    qsort(totals, number_of_totals, sizeof(*totals), comparePlayerTotals);
+    *count = 0;
+    for (int first = 0, last = 0; first < number_of_totals; first = last)
+    {
+        ShardPlayerTotal sum = totals[first];
+        for (last = first + 1; last < number_of_totals && totals[last].player_id == sum.player_id; last++)
+        {
+            sum.active = sum.active || totals[last].active;
+            sum.wins += totals[last].wins;
+            sum.losses += totals[last].losses;
+            sum.draws += totals[last].draws;
+        }
+        if (sum.active && sum.wins + sum.losses + sum.draws > 0)
+        {
+            (*rows)[*count].player_id = sum.player_id;
+            (*rows)[(*count)++].level = shardPlayerLevel(sum.wins, sum.losses, sum.draws);
+        }
+    }
+    free(totals);
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessShardedSavePlayersLevels(ChessShardedSystem sharded, FILE *file)
+{
+    if (sharded == NULL || file == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    ShardCall call;
+    shardCallInit(&call, SHARD_PLAYER_TOTALS, NULL, NULL);
+    ShardCall *calls = runOnAll(sharded, &call);
+    if (calls == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    ExportLevelRow *rows;
+    int count;
+    ChessResult result = mergeLevelRows(calls, sharded->number_of_shards, &rows, &count);
+    free(calls);
+    if (result != CHESS_SUCCESS)
+    {
+        return result;
+    }
+    exportSortLevels(rows, count);
+    result = exportWriteLevels(file, rows, count);
+    free(rows);
+    return result;
+}
+
+/**
+ * compareStatisticsRows: qsort comparison of statistics rows in increasing tournament id order.
+ */
+static int compareStatisticsRows(const void *first, const void *second)
+{
+    int id1 = ((const ExportStatisticsRow *)first)->tournament_id;
+    int id2 = ((const ExportStatisticsRow *)second)->tournament_id;
+    return (id1 > id2) - (id1 < id2);
+}
+
+/**
+ * mergeStatisticsRows: Moves the statistics rows of every shard to one array, in tournament id order.
+ *
+ * @param calls - The SHARD_STATISTICS calls of the shards. Their rows are moved or freed.
+ * @param number_of_shards - The number of shards.
+ * @param rows - Where to store the rows, allocated with malloc.
+ * @param count - Where to store the number of rows.
+ * @return
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed in a shard or here.
+ *     CHESS_SUCCESS - otherwise.
+ */
+static ChessResult mergeStatisticsRows(ShardCall *calls, int number_of_shards, ExportStatisticsRow **rows, int *count)
+{
+    bool success = true;
+    *count = 0;
+    for (int i = 0; i < number_of_shards; i++)
+    {
+        if (calls[i].result != CHESS_SUCCESS)
+        {
+            success = false;
+            calls[i].statistics = NULL;
+            calls[i].count = 0;
+        }
+        *count += calls[i].count;
+    }
+    *rows = success ? malloc(sizeof(**rows) * (*count + 1)) : NULL;
+    if (*rows == NULL)
+    {
+        for (int i = 0; i < number_of_shards; i++)
+        {
+            exportStatisticsRowsDestroy(calls[i].statistics, calls[i].count);
+        }
+        return CHESS_OUT_OF_MEMORY;
+    }
+    *count = 0;
+    for (int i = 0; i < number_of_shards; i++)
+    {
+        memcpy(*rows + *count, calls[i].statistics, sizeof(**rows) * calls[i].count);
+        *count += calls[i].count;
+        free(calls[i].statistics);
+    }
+    qsort(*rows, *count, sizeof(**rows), compareStatisticsRows);
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessShardedSaveTournamentStatistics(ChessShardedSystem sharded, char *path_file)
+{
+    if (sharded == NULL || path_file == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    ShardCall call;
+    shardCallInit(&call, SHARD_STATISTICS, NULL, NULL);
+    ShardCall *calls = runOnAll(sharded, &call);
+    if (calls == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    ExportStatisticsRow *rows;
+    int count;
+    ChessResult result = mergeStatisticsRows(calls, sharded->number_of_shards, &rows, &count);
+    free(calls);
+    if (result != CHESS_SUCCESS)
+    {
+        return result;
+    }
+    if (count == 0)
+    {
+        free(rows);
+        return CHESS_NO_TOURNAMENTS_ENDED;
+    }
+    FILE *file = fopen(path_file, "w");
+    if (file == NULL)
+    {
+        exportStatisticsRowsDestroy(rows, count);
+        return CHESS_SAVE_FAILURE;
+    }
+    result = exportWriteStatistics(file, rows, count);
+    exportStatisticsRowsDestroy(rows, count);
+    if (fclose(file) != 0 && result == CHESS_SUCCESS)
+    {
+        result = CHESS_SAVE_FAILURE;
+    }
+    return result;
+}
@@ -0,0 +1,102 @@
+#ifndef CHESS_SHARD_H
+#define CHESS_SHARD_H
+#include <stdbool.h>
+#include "chessSystem.h"
+#include "chess_export.h"
+
+/*
+* A chess system split into independent shards, each a ChessSystem owned by its own worker thread.
+*
+* A tournament belongs to the shard tournament_id % number_of_shards, so its games, and the totals
+* its games add to its players, are all in that shard. The calls about one tournament are routed to
+* its shard. The calls about a player run on every shard at once (scatter) and their results are
+* merged (gather): a player is in the system if it is in any shard, and its totals and play time
+* are the sums of its totals and play times in the shards. A shard where a removed player did not
+* return keeps the games that player had in ended tournaments apart, as the unsharded system does
+* until the player returns, so the sums count them exactly when the unsharded system would.
+*
+* The workers run one call at a time, handed over through a mutex and a condition variable.
+*
+* The following functions are available:
+*   chessShardedCreate          - Creates a sharded system (declared in chessSystem.h)
+*   chessShardedDestroy         - Deletes a sharded system (declared in chessSystem.h)
+*   chessShardedAddTournament   - Adds a tournament on its shard (declared in chessSystem.h)
+*   chessShardedAddGame         - Adds a game on the shard of its tournament (declared in chessSystem.h)
+*   chessShardedRemoveTournament - Removes a tournament from its shard (declared in chessSystem.h)
+*   chessShardedRemovePlayer    - Removes a player from every shard (declared in chessSystem.h)
+*   chessShardedEndTournament   - Ends a tournament on its shard (declared in chessSystem.h)
+*   chessShardedCalculateAveragePlayTime - Merges the play times of every shard (declared in chessSystem.h)
+*   chessShardedSavePlayersLevels - Merges the totals of every shard and prints the levels (declared in chessSystem.h)
+*   chessShardedSaveTournamentStatistics - Merges the statistics of every shard (declared in chessSystem.h)
+*   shardCapturePlayerTotals    - Captures the totals of the players of a shard (defined in chessSystem.c)
+*   shardPlayerPlayTime         - Returns the play time of a player in a shard (defined in chessSystem.c)
+*   shardCaptureStatistics      - Captures the statistics of the ended tournaments of a shard (defined in chessSystem.c)
+*   shardPlayerLevel            - Returns the level of merged totals (defined in chessSystem.c)
+*/
+
+/** Type for defining the totals of one player in one shard */
+typedef struct {
+    int player_id;
+    bool active;
+    int wins;
+    int losses;
+    int draws;
+} ShardPlayerTotal;
+
+/**
+* shardCapturePlayerTotals: Captures the totals of the players of a system: those in the system, and
+*   those removed from it that kept games in ended tournaments.
+*
+* @param chess - The chess system.
+* @param rows - Where to store the rows, allocated with malloc.
+* @param count - Where to store the number of rows.
+* @return
+*     CHESS_NULL_ARGUMENT - if one of the arguments is NULL.
+*     CHESS_OUT_OF_MEMORY - if an allocation failed.
+*     CHESS_SUCCESS - otherwise.
+*/
+ChessResult shardCapturePlayerTotals(ChessSystem chess, ShardPlayerTotal **rows, int *count);
+
+/**
+* shardPlayerPlayTime: Returns the total play time and the number of games of a player in all the
+*   tournaments of a system, whether or not the player is in it.
+*
+* @param chess - The chess system.
+* @param player_id - The player's id.
+* @param active - Where to store if the player is in the system.
+* @param total_time - Where to store the total play time.
+* @param number_of_games - Where to store the number of games.
+* @return
+*     CHESS_NULL_ARGUMENT - if one of the arguments is NULL.
+*     CHESS_INVALID_ID - if the player ID number is invalid.
+*     CHESS_SUCCESS - otherwise.
+*/
+ChessResult shardPlayerPlayTime(ChessSystem chess, int player_id, bool *active, double *total_time,
+                                int *number_of_games);
+
+/**
+* shardCaptureStatistics: Captures the statistics of the ended tournaments of a system, in id order,
+*   with their locations copied.
+*
+* @param chess - The chess system.
+* @param rows - Where to store the rows, allocated with malloc, to free with exportStatisticsRowsDestroy.
+* @param count - Where to store the number of rows.
+* @return
+*     CHESS_NULL_ARGUMENT - if one of the arguments is NULL.
+*     CHESS_OUT_OF_MEMORY - if an allocation failed.
+*     CHESS_SUCCESS - otherwise.
+*/
+ChessResult shardCaptureStatistics(ChessSystem chess, ExportStatisticsRow **rows, int *count);
+
+/**
+* shardPlayerLevel: Returns the level of a player by the level formula of chessSavePlayersLevels.
+*
+* @param wins - The player's number of wins.
+* @param losses - The player's number of losses.
+* @param draws - The player's number of draws.
+* @return
+*     The player's level.
+*/
+double shardPlayerLevel(int wins, int losses, int draws);
+
+#endif
@@ -0,0 +1,323 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "chess_snapshot.h"
+
+#define INITIAL_CAPACITY 4096
+#define EXPAND 2
+#define INT_SIZE 4
+#define BYTE_BITS 8
+#define BYTE_MASK 0xFF
+#define CRC_POLYNOMIAL 0xEDB88320u
+#define CRC_TABLE_SIZE 256
+#define TEMPORARY_SUFFIX ".tmp"
+
+struct snapshot_writer_t
+{
+    unsigned char *payload;
+    size_t size;
+    size_t capacity;
+};
+
+struct snapshot_reader_t
+{
+    unsigned char *mapping;
+    size_t mapping_size;
+    const unsigned char *payload;
+    size_t size;
+    size_t offset;
+    int version;
+    bool failed;
+};
+
+static unsigned int crc_table[CRC_TABLE_SIZE];
+static bool crc_table_ready = false;
+
+/**
+ * putInt: Stores an integer as 4 little endian bytes.
+ *
+ * @param destination - Where to store the bytes.
+ * @param value - The value to store.
+ */
+static void putInt(unsigned char *destination, unsigned int value)
+{
+    for (int i = 0; i < INT_SIZE; i++)
+    {
+        destination[i] = (unsigned char)((value >> (i * BYTE_BITS)) & BYTE_MASK);
+    }
+}
+
+/**
+ * getInt: Loads an integer stored as 4 little endian bytes.
+ *
+ * @param source - The stored bytes.
+ * @return
+ *     The stored value.
+ */
+static unsigned int getInt(const unsigned char *source)
+{
+    unsigned int value = 0;
+    for (int i = 0; i < INT_SIZE; i++)
+    {
+        value |= (unsigned int)source[i] << (i * BYTE_BITS);
+    }
+    return value;
+}
+
+unsigned int snapshotChecksum(const void *bytes, size_t length)
+{
+    if (crc_table_ready == false)
+    {
+        for (unsigned int i = 0; i < CRC_TABLE_SIZE; i++)
+        {
+            unsigned int crc = i;
+            for (int bit = 0; bit < BYTE_BITS; bit++)
+            {
+                crc = (crc & 1) ? (crc >> 1) ^ CRC_POLYNOMIAL : crc >> 1;
+            }
+            crc_table[i] = crc;
+        }
+        crc_table_ready = true;
+    }
+
+    const unsigned char *current = bytes;
+    unsigned int crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc = crc_table[(crc ^ current[i]) & BYTE_MASK] ^ (crc >> BYTE_BITS);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+SnapshotWriter snapshotWriterCreate()
+{
+    SnapshotWriter writer = malloc(sizeof(*writer));
+    if (writer == NULL)
+    {
+        return NULL;
+    }
+    writer->payload = malloc(INITIAL_CAPACITY);
+    if (writer->payload == NULL)
+    {
+        free(writer);
+        return NULL;
+    }
+    writer->size = 0;
+    writer->capacity = INITIAL_CAPACITY;
+    return writer;
+}
+
+void snapshotWriterDestroy(SnapshotWriter writer)
+{
+    if (writer == NULL)
+    {
+        return;
+    }
+    free(writer->payload);
+    free(writer);
+}
+
+/**
+ * writerReserve: Makes sure the payload has room for more bytes.
+ *
+ * @param writer - The snapshot writer.
+ * @param length - The number of bytes about to be appended.
+ * @return
+ *     false - if the payload could not grow.
+ *     true - otherwise.
+ */
+static bool writerReserve(SnapshotWriter writer, size_t length)
+{
+    if (writer->size + length <= writer->capacity)
+    {
+        return true;
+    }
+    size_t new_capacity = writer->capacity;
+    while (new_capacity < writer->size + length)
+    {
+        new_capacity *= EXPAND;
+    }
+    unsigned char *new_payload = realloc(writer->payload, new_capacity);
+    if (new_payload == NULL)
+    {
+        return false;
+    }
+    writer->payload = new_payload;
+    writer->capacity = new_capacity;
+    return true;
+}
+
+bool snapshotWriteInt(SnapshotWriter writer, int value)
+{
+    if (writer == NULL || writerReserve(writer, INT_SIZE) == false)
+    {
+        return false;
+    }
+    putInt(writer->payload + writer->size, (unsigned int)value);
+    writer->size += INT_SIZE;
+    return true;
+}
+
+bool snapshotWriteBytes(SnapshotWriter writer, const void *bytes, int length)
+{
+    if (writer == NULL || bytes == NULL || length < 0 || writerReserve(writer, length) == false)
+    {
+        return false;
+    }
+    memcpy(writer->payload + writer->size, bytes, length);
+    writer->size += length;
+    return true;
+}
+
+bool snapshotWriterSave(SnapshotWriter writer, const char *path_file)
+{
+    if (writer == NULL || path_file == NULL)
+    {
+        return false;
+    }
+    unsigned char header[SNAPSHOT_HEADER_SIZE];
+    memcpy(header, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LENGTH);
+    putInt(header + 4, SNAPSHOT_VERSION);
+    putInt(header + 8, (unsigned int)(writer->size & 0xFFFFFFFFu));
+    putInt(header + 12, (unsigned int)((unsigned long long)writer->size >> 32));
+    putInt(header + 16, snapshotChecksum(writer->payload, writer->size));
+
+    char *temporary_path = malloc(strlen(path_file) + strlen(TEMPORARY_SUFFIX) + 1);
+    if (temporary_path == NULL)
+    {
+        return false;
+    }
+    strcpy(temporary_path, path_file);
+    strcat(temporary_path, TEMPORARY_SUFFIX);
+
+    FILE *file = fopen(temporary_path, "wb");
+    if (file == NULL)
+    {
+        free(temporary_path);
+        return false;
+    }
+    bool success = fwrite(header, 1, SNAPSHOT_HEADER_SIZE, file) == SNAPSHOT_HEADER_SIZE &&
+                   fwrite(writer->payload, 1, writer->size, file) == writer->size;
+    success = (fflush(file) == 0) && success;
+    success = (fsync(fileno(file)) == 0) && success;
+    success = (fclose(file) == 0) && success;
+    if (success)
+    {
+        success = rename(temporary_path, path_file) == 0;
+    }
+    if (success == false)
+    {
+        remove(temporary_path);
+    }
+    free(temporary_path);
+    return success;
+}
+
+SnapshotReader snapshotReaderOpen(const char *path_file)
+{
+    if (path_file == NULL)
+    {
+        return NULL;
+    }
+    int descriptor = open(path_file, O_RDONLY);
+    if (descriptor < 0)
+    {
+        return NULL;
+    }
+    struct stat file_status;
+    if (fstat(descriptor, &file_status) != 0 || file_status.st_size < SNAPSHOT_HEADER_SIZE)
+    {
+        close(descriptor);
+        return NULL;
+    }
+    size_t mapping_size = (size_t)file_status.st_size;
+    unsigned char *mapping = mmap(NULL, mapping_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (mapping == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    unsigned long long payload_size = getInt(mapping + 8) | ((unsigned long long)getInt(mapping + 12) << 32);
+    if (memcmp(mapping, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LENGTH) != 0 ||
+        getInt(mapping + 4) > SNAPSHOT_VERSION ||
+        payload_size != mapping_size - SNAPSHOT_HEADER_SIZE ||
+        getInt(mapping + 16) != snapshotChecksum(mapping + SNAPSHOT_HEADER_SIZE, payload_size))
+    {
+        munmap(mapping, mapping_size);
+        return NULL;
+    }
+
+    SnapshotReader reader = malloc(sizeof(*reader));
+    if (reader == NULL)
+    {
+        munmap(mapping, mapping_size);
+        return NULL;
+    }
+    reader->mapping = mapping;
+    reader->mapping_size = mapping_size;
+    reader->payload = mapping + SNAPSHOT_HEADER_SIZE;
+    reader->size = payload_size;
+    reader->offset = 0;
+    reader->version = (int)getInt(mapping + 4);
+    reader->failed = false;
+    return reader;
+}
+
+void snapshotReaderDestroy(SnapshotReader reader)
+{
+    if (reader == NULL)
+    {
+        return;
+    }
+    munmap(reader->mapping, reader->mapping_size);
+    free(reader);
+}
+
+int snapshotReaderVersion(SnapshotReader reader)
+{
+    if (reader == NULL)
+    {
+        return 0;
+    }
+    return reader->version;
+}
+
+int snapshotReadInt(SnapshotReader reader)
+{
+    if (reader == NULL || reader->failed || reader->size - reader->offset < INT_SIZE)
+    {
+        if (reader != NULL)
+        {
+            reader->failed = true;
+        }
+        return 0;
+    }
+    int value = (int)getInt(reader->payload + reader->offset);
+    reader->offset += INT_SIZE;
+    return value;
+}
+
+const void *snapshotReadBytes(SnapshotReader reader, int length)
+{
+    if (reader == NULL || reader->failed || length < 0 || reader->size - reader->offset < (size_t)length)
+    {
+        if (reader != NULL)
+        {
+            reader->failed = true;
+        }
+        return NULL;
+    }
+    const void *bytes = reader->payload + reader->offset;
+    reader->offset += length;
+    return bytes;
+}
+
+bool snapshotReaderFailed(SnapshotReader reader)
+{
+    return reader == NULL || reader->failed;
+}
@@ -0,0 +1,160 @@
+#ifndef CHESS_SNAPSHOT_H
+#define CHESS_SNAPSHOT_H
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define SNAPSHOT_MAGIC "CHSS"
+#define SNAPSHOT_MAGIC_LENGTH 4
+#define SNAPSHOT_VERSION 5
+#define SNAPSHOT_HEADER_SIZE 20
+
+/*
+* Binary snapshot file layout (all integers are 32 bit little endian):
+*   magic           - the 4 bytes "CHSS".
+*   version         - SNAPSHOT_VERSION of the writer.
+*   payload length  - number of payload bytes that follow the header (64 bit).
+*   checksum        - CRC-32 of the payload.
+*   payload         - the records written by the snapshot writer.
+*
+* The following functions are available:
+*   snapshotWriterCreate    - Creates a new empty snapshot writer
+*   snapshotWriterDestroy   - Deletes an existing snapshot writer
+*   snapshotWriteInt        - Appends an integer to the payload
+*   snapshotWriteBytes      - Appends raw bytes to the payload
+*   snapshotWriterSave      - Writes the header and payload to a file atomically
+*   snapshotReaderOpen      - Maps a snapshot file and validates its header and checksum
+*   snapshotReaderDestroy   - Unmaps the file and deletes the reader
+*   snapshotReaderVersion   - Returns the version the file was written with
+*   snapshotReadInt         - Reads the next integer of the payload
+*   snapshotReadBytes       - Returns a pointer to the next raw bytes of the payload
+*   snapshotReaderFailed    - Returns if a read went past the end of the payload
+*   snapshotChecksum        - Calculates the CRC-32 of a buffer
+*/
+
+/** Type for defining a snapshot writer */
+typedef struct snapshot_writer_t *SnapshotWriter;
+
+/** Type for defining a snapshot reader */
+typedef struct snapshot_reader_t *SnapshotReader;
+
+/**
+* snapshotWriterCreate: Allocates a new snapshot writer with an empty payload.
+*
+* @return
+* 	NULL - if allocations failed.
+* 	A new snapshot writer in case of success.
+*/
+SnapshotWriter snapshotWriterCreate();
+
+/**
+* snapshotWriterDestroy: Deallocates an existing snapshot writer.
+*
+* @param writer - Target writer to be deallocated. If writer is NULL nothing will be done.
+*/
+void snapshotWriterDestroy(SnapshotWriter writer);
+
+/**
+* snapshotWriteInt: Appends an integer to the payload.
+*
+* @param writer - The snapshot writer.
+* @param value - The value to append.
+* @return
+* 	false - if the input is NULL or the payload could not grow.
+* 	true - otherwise.
+*/
+bool snapshotWriteInt(SnapshotWriter writer, int value);
+
+/**
+* snapshotWriteBytes: Appends raw bytes to the payload.
+*
+* @param writer - The snapshot writer.
+* @param bytes - The bytes to append.
+* @param length - The number of bytes to append.
+* @return
+* 	false - if the input is NULL or the payload could not grow.
+* 	true - otherwise.
+*/
+bool snapshotWriteBytes(SnapshotWriter writer, const void *bytes, int length);
+
+/**
+* snapshotWriterSave: Writes the header and the payload to a file. The file is first written
+*   to a temporary path and then renamed, so an existing snapshot is never left half written.
+*
+* @param writer - The snapshot writer.
+* @param path_file - The path of the snapshot file.
+* @return
+* 	false - if the input is NULL or an error occurred while saving.
+* 	true - otherwise.
+*/
+bool snapshotWriterSave(SnapshotWriter writer, const char *path_file);
+
+/**
+* snapshotReaderOpen: Maps a snapshot file into memory and validates its magic, version,
+*   payload length and checksum.
+*
+* @param path_file - The path of the snapshot file.
+* @return
+* 	NULL - if the file could not be mapped or is not a valid snapshot.
+* 	A new snapshot reader positioned at the start of the payload otherwise.
+*/
+SnapshotReader snapshotReaderOpen(const char *path_file);
+
+/**
+* snapshotReaderDestroy: Unmaps the snapshot file and deallocates the reader.
+*
+* @param reader - Target reader to be deallocated. If reader is NULL nothing will be done.
+*/
+void snapshotReaderDestroy(SnapshotReader reader);
+
+/**
+* snapshotReaderVersion: Returns the version the snapshot file was written with.
+*
+* @param reader - The snapshot reader.
+* @return
+* 	0 - if reader is NULL.
+*   The version from the file header otherwise.
+*/
+int snapshotReaderVersion(SnapshotReader reader);
+
+/**
+* snapshotReadInt: Reads the next integer of the payload.
+*
+* @param reader - The snapshot reader.
+* @return
+* 	0 - if the payload has no more integers, in which case the reader is marked as failed.
+*   The next integer otherwise.
+*/
+int snapshotReadInt(SnapshotReader reader);
+
+/**
+* snapshotReadBytes: Returns a pointer into the mapped payload and skips over the bytes.
+*
+* @param reader - The snapshot reader.
+* @param length - The number of bytes to skip over.
+* @return
+* 	NULL - if the payload is shorter than length, in which case the reader is marked as failed.
+*   A pointer to the bytes otherwise. It stays valid until the reader is destroyed.
+*/
+const void *snapshotReadBytes(SnapshotReader reader, int length);
+
+/**
+* snapshotReaderFailed: Returns if one of the reads went past the end of the payload.
+*
+* @param reader - The snapshot reader.
+* @return
+* 	true - if reader is NULL or a read failed.
+* 	false - otherwise.
+*/
+bool snapshotReaderFailed(SnapshotReader reader);
+
+/**
+* snapshotChecksum: Calculates the CRC-32 of a buffer.
+*
+* @param bytes - The buffer.
+* @param length - The number of bytes in the buffer.
+* @return
+*   The CRC-32 of the buffer.
+*/
+unsigned int snapshotChecksum(const void *bytes, size_t length);
+
+#endif
@@ -0,0 +1,130 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "chessSystem.h"
+#include "chess_spans.h"
+#include "chess_metrics.h"
+
+#define NANOSECONDS_PER_MICROSECOND 1000.0
+#define PROCESS_ID 1
+
+static pthread_mutex_t spans_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t spans_environment_once = PTHREAD_ONCE_INIT;
+static FILE *spans_file = NULL;
+static bool spans_recording = false;
+static bool spans_first_event = true;
+static unsigned long long spans_origin_ns = 0;
+
+/**
+ * openSpans: Starts writing the events of a new trace to a file. Must be called with the lock held.
+ *
+ * @param path_file - The file path.
+ * @return
+ *     false - if the file could not be created.
+ *     true - otherwise.
+ */
+static bool openSpans(const char *path_file)
+{
+    FILE *file = fopen(path_file, "w");
+    if (file == NULL)
+    {
+        return false;
+    }
+    if (spans_file != NULL)
+    {
+        fprintf(spans_file, "\n]}\n");
+        fclose(spans_file);
+    }
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    spans_file = file;
+    spans_first_event = true;
+    spans_origin_ns = metricsNow();
+    __atomic_store_n(&spans_recording, true, __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * stopAtExit: Closes a recording that was not stopped, so the file stays valid JSON.
+ */
+static void stopAtExit()
+{
+    chessSpansStop();
+}
+
+/**
+ * startFromEnvironment: Starts recording to the file named by CHESS_SPANS_FILE, if it is set.
+ */
+static void startFromEnvironment()
+{
+    const char *path_file = getenv(SPANS_FILE_VARIABLE);
+    if (path_file != NULL && path_file[0] != '\0')
+    {
+        pthread_mutex_lock(&spans_lock);
+        if (spans_file == NULL)
+        {
+            openSpans(path_file);
+        }
+        pthread_mutex_unlock(&spans_lock);
+    }
+    atexit(stopAtExit);
+}
+
+unsigned long long spanBegin()
+{
+    pthread_once(&spans_environment_once, startFromEnvironment);
+    if (__atomic_load_n(&spans_recording, __ATOMIC_ACQUIRE) == false)
+    {
+        return SPAN_OFF;
+    }
+    return metricsNow();
+}
+
+void spanEnd(const char *name, unsigned long long start_ns)
+{
+    if (start_ns == SPAN_OFF)
+    {
+        return;
+    }
+    unsigned long long end_ns = metricsNow();
+    pthread_mutex_lock(&spans_lock);
+    if (spans_file != NULL && start_ns >= spans_origin_ns)
+    {
+        fprintf(spans_file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%lu}",
+                spans_first_event ? "" : ",", name, (start_ns - spans_origin_ns) / NANOSECONDS_PER_MICROSECOND,
+                (end_ns - start_ns) / NANOSECONDS_PER_MICROSECOND, PROCESS_ID,
+                (unsigned long)pthread_self() & 0xFFFFFFUL);
+        spans_first_event = false;
+    }
+    pthread_mutex_unlock(&spans_lock);
+}
+
+ChessResult chessSpansStart(const char *path_file)
+{
+    if (path_file == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    pthread_once(&spans_environment_once, startFromEnvironment);
+    pthread_mutex_lock(&spans_lock);
+    bool success = openSpans(path_file);
+    pthread_mutex_unlock(&spans_lock);
+    return success ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
+
+ChessResult chessSpansStop()
+{
+    pthread_mutex_lock(&spans_lock);
+    __atomic_store_n(&spans_recording, false, __ATOMIC_RELEASE);
+    bool success = true;
+    if (spans_file != NULL)
+    {
+        fprintf(spans_file, "\n]}\n");
+        success = ferror(spans_file) == 0;
+        success = (fclose(spans_file) == 0) && success;
+        spans_file = NULL;
+    }
+    pthread_mutex_unlock(&spans_lock);
+    return success ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
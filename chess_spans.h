@@ -0,0 +1,51 @@
+#ifndef CHESS_SPANS_H
+#define CHESS_SPANS_H
+
+/*
+* Scoped span instrumentation of internal phases, written as Chrome trace-event JSON that
+* trace viewers (chrome://tracing, Perfetto) load directly.
+*
+* Spans are compiled in only with -DCHESS_SPANS; without it SPAN_BEGIN and SPAN_END compile to
+* nothing. When compiled in, recording is off until it is turned on at run time, either by
+* chessSpansStart or by setting the CHESS_SPANS_FILE environment variable to a file path before
+* the first span; a recording left running is closed when the program exits. Every finished
+* span is one complete ("X") event with its start and duration in microseconds and the thread
+* that ran it. A span whose scope is left early, by a return before its SPAN_END, is not
+* recorded.
+*
+* The following functions are available:
+*   spanBegin          - Returns the start of a span, or SPAN_OFF when not recording
+*   spanEnd            - Records a finished span
+*   chessSpansStart    - Starts recording to a file (declared in chessSystem.h)
+*   chessSpansStop     - Stops recording and closes the file (declared in chessSystem.h)
+*/
+
+#define SPAN_OFF 0
+#define SPANS_FILE_VARIABLE "CHESS_SPANS_FILE"
+
+#ifdef CHESS_SPANS
+#define SPAN_BEGIN(span) unsigned long long span = spanBegin()
+#define SPAN_END(span, name) spanEnd(name, span)
+#else
+#define SPAN_BEGIN(span)
+#define SPAN_END(span, name)
+#endif
+
+/**
+* spanBegin: Returns the start time of a span.
+*
+* @return
+* 	SPAN_OFF - if spans are not being recorded.
+* 	The start time in nanoseconds otherwise.
+*/
+unsigned long long spanBegin();
+
+/**
+* spanEnd: Records a span that started at a given time and ends now.
+*
+* @param name - The span name.
+* @param start_ns - The spanBegin time. If it is SPAN_OFF nothing will be recorded.
+*/
+void spanEnd(const char *name, unsigned long long start_ns);
+
+#endif
@@ -0,0 +1,299 @@
+#include <stdio.h>
+#include <string.h>
+#include "chess_trace.h"
+#include "chess_utilities.h"
+
+#define BUFFER_SIZE (1 << 16)
+#define INITIAL_CAPACITY 4096
+#define EXPAND 2
+#define HEADER_SIZE (TRACE_MAGIC_LENGTH + 1)
+#define DOUBLE_SIZE 8
+#define BYTE_BITS 8
+#define BYTE_MASK 0xFF
+#define MAX_RECORD_SIZE (1 + MAX_VARINT_SIZE * (TRACE_MAX_ARGUMENTS + 1) + 1 + DOUBLE_SIZE)
+
+struct chess_trace_t
+{
+    FILE *file;
+    unsigned char buffer[BUFFER_SIZE];
+    size_t size;
+    bool failed;
+};
+
+struct trace_reader_t
+{
+    unsigned char *contents;
+    size_t size;
+    size_t offset;
+};
+
+/**
+ * operationArguments: Returns the number of int arguments recorded for an operation.
+ *
+ * @param operation - The trace operation.
+ * @return
+ *     -1 if the operation is unknown, the number of arguments otherwise.
+ */
+static int operationArguments(TraceOperation operation)
+{
+    switch (operation)
+    {
+    case TRACE_ADD_TOURNAMENT:
+        return 2;
+    case TRACE_ADD_GAME:
+        return 5;
+    case TRACE_REMOVE_TOURNAMENT:
+    case TRACE_REMOVE_PLAYER:
+    case TRACE_END_TOURNAMENT:
+    case TRACE_AVERAGE_PLAY_TIME:
+        return 1;
+    case TRACE_SAVE_LEVELS:
+    case TRACE_SAVE_STATISTICS:
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+/**
+ * traceWrite: Writes bytes to the trace through its buffer.
+ *
+ * @param trace - The trace.
+ * @param bytes - The bytes.
+ * @param length - The number of bytes.
+ */
+static void traceWrite(ChessTrace trace, const unsigned char *bytes, size_t length)
+{
+    if (trace->size + length > BUFFER_SIZE)
+    {
+        if (trace->size > 0 && fwrite(trace->buffer, 1, trace->size, trace->file) != trace->size)
+        {
+            trace->failed = true;
+        }
+        trace->size = 0;
+    }
+    if (length > BUFFER_SIZE)
+    {
+        if (fwrite(bytes, 1, length, trace->file) != length)
+        {
+            trace->failed = true;
+        }
+        return;
+    }
+    memcpy(trace->buffer + trace->size, bytes, length);
+    trace->size += length;
+}
+
+ChessTrace traceOpen(const char *path_file)
+{
+    if (path_file == NULL)
+    {
+        return NULL;
+    }
+    ChessTrace trace = malloc(sizeof(*trace));
+    if (trace == NULL)
+    {
+        return NULL;
+    }
+    trace->file = fopen(path_file, "wb");
+    if (trace->file == NULL)
+    {
+        free(trace);
+        return NULL;
+    }
+    trace->size = 0;
+    trace->failed = false;
+    unsigned char header[HEADER_SIZE];
+    memcpy(header, TRACE_MAGIC, TRACE_MAGIC_LENGTH);
+    header[TRACE_MAGIC_LENGTH] = TRACE_VERSION;
+    traceWrite(trace, header, HEADER_SIZE);
+    return trace;
+}
+
+bool traceClose(ChessTrace trace)
+{
+    if (trace == NULL)
+    {
+        return true;
+    }
+    if (trace->size > 0 && fwrite(trace->buffer, 1, trace->size, trace->file) != trace->size)
+    {
+        trace->failed = true;
+    }
+    bool success = (fclose(trace->file) == 0) && trace->failed == false;
+    free(trace);
+    return success;
+}
+
+bool traceAppend(ChessTrace trace, const TraceRecord *record)
+{
+    if (trace == NULL || record == NULL)
+    {
+        return false;
+    }
+    int number_of_arguments = operationArguments(record->operation);
+    if (number_of_arguments < 0)
+    {
+        return false;
+    }
+    unsigned char encoded[MAX_RECORD_SIZE];
+    size_t length = 0;
+    encoded[length++] = (unsigned char)record->operation;
+    for (int i = 0; i < number_of_arguments; i++)
+    {
+        length += varintPut(encoded + length, zigzagEncode(record->arguments[i]));
+    }
+    if (record->operation == TRACE_ADD_TOURNAMENT)
+    {
+        size_t location_length = record->location == NULL ? 0 : strlen(record->location);
+        length += varintPut(encoded + length, location_length);
+        traceWrite(trace, encoded, length);
+        traceWrite(trace, (const unsigned char *)(location_length == 0 ? "" : record->location), location_length + 1);
+        length = 0;
+    }
+    encoded[length++] = (unsigned char)record->result;
+    if (record->operation == TRACE_AVERAGE_PLAY_TIME)
+    {
+        unsigned long long bits;
+        memcpy(&bits, &record->average_play_time, sizeof(bits));
+        for (int i = 0; i < DOUBLE_SIZE; i++)
+        {
+            encoded[length++] = (unsigned char)((bits >> (i * BYTE_BITS)) & BYTE_MASK);
+        }
+    }
+    length += varintPut(encoded + length, record->duration_ns);
+    traceWrite(trace, encoded, length);
+    return trace->failed == false;
+}
+
+TraceReader traceReaderOpen(const char *path_file)
+{
+    if (path_file == NULL)
+    {
+        return NULL;
+    }
+    FILE *file = fopen(path_file, "rb");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+    TraceReader reader = malloc(sizeof(*reader));
+    if (reader == NULL)
+    {
+        fclose(file);
+        return NULL;
+    }
+    reader->size = 0;
+    reader->offset = HEADER_SIZE;
+    size_t capacity = INITIAL_CAPACITY;
+    reader->contents = malloc(capacity);
+    size_t read_bytes;
+    while (reader->contents != NULL &&
+           (read_bytes = fread(reader->contents + reader->size, 1, capacity - reader->size, file)) > 0)
+    {
+        reader->size += read_bytes;
+        if (reader->size == capacity)
+        {
+            capacity *= EXPAND;
+            unsigned char *new_contents = realloc(reader->contents, capacity);
+            if (new_contents == NULL)
+            {
+                free(reader->contents);
+            }
+            reader->contents = new_contents;
+        }
+    }
+    bool valid = reader->contents != NULL && ferror(file) == 0 && reader->size >= HEADER_SIZE &&
+                 memcmp(reader->contents, TRACE_MAGIC, TRACE_MAGIC_LENGTH) == 0 &&
+                 reader->contents[TRACE_MAGIC_LENGTH] <= TRACE_VERSION;
+    fclose(file);
+    if (valid == false)
+    {
+        traceReaderDestroy(reader);
+        return NULL;
+    }
+    return reader;
+}
+
+void traceReaderDestroy(TraceReader reader)
+{
+    if (reader == NULL)
+    {
+        return;
+    }
+    free(reader->contents);
+    free(reader);
+}
+
+bool traceReadNext(TraceReader reader, TraceRecord *record)
+{
+    if (reader == NULL || record == NULL || reader->offset >= reader->size)
+    {
+        return false;
+    }
+    size_t offset = reader->offset;
+    unsigned long long value;
+    record->operation = reader->contents[offset++];
+    int number_of_arguments = operationArguments(record->operation);
+    if (number_of_arguments < 0)
+    {
+        return false;
+    }
+    for (int i = 0; i < number_of_arguments; i++)
+    {
+        if (varintGet(reader->contents, reader->size, &offset, &value) == false)
+        {
+            return false;
+        }
+        record->arguments[i] = (int)zigzagDecode(value);
+    }
+    record->location = NULL;
+    if (record->operation == TRACE_ADD_TOURNAMENT)
+    {
+        if (varintGet(reader->contents, reader->size, &offset, &value) == false || value >= reader->size - offset ||
+            reader->contents[offset + value] != '\0')
+        {
+            return false;
+        }
+        record->location = (const char *)reader->contents + offset;
+        offset += value + 1;
+    }
+    if (offset >= reader->size)
+    {
+        return false;
+    }
+    record->result = (ChessResult)reader->contents[offset++];
+    record->average_play_time = 0;
+    if (record->operation == TRACE_AVERAGE_PLAY_TIME)
+    {
+        if (reader->size - offset < DOUBLE_SIZE)
+        {
+            return false;
+        }
+        unsigned long long bits = 0;
+        for (int i = 0; i < DOUBLE_SIZE; i++)
+        {
+            bits |= (unsigned long long)reader->contents[offset++] << (i * BYTE_BITS);
+        }
+        memcpy(&record->average_play_time, &bits, sizeof(bits));
+    }
+    if (varintGet(reader->contents, reader->size, &offset, &record->duration_ns) == false)
+    {
+        return false;
+    }
+    reader->offset = offset;
+    return true;
+}
+
+const char *traceOperationName(TraceOperation operation)
+{
+    static const char *names[TRACE_OPERATIONS] = {
+        "unknown", "chessAddTournament", "chessAddGame", "chessRemoveTournament", "chessRemovePlayer",
+        "chessEndTournament", "chessCalculateAveragePlayTime", "chessSavePlayersLevels",
+        "chessSaveTournamentStatistics"};
+    if (operation <= 0 || operation >= TRACE_OPERATIONS)
+    {
+        return names[0];
+    }
+    return names[operation];
+}
@@ -0,0 +1,137 @@
+#ifndef CHESS_TRACE_H
+#define CHESS_TRACE_H
+#include <stdbool.h>
+#include <stdlib.h>
+#include "chessSystem.h"
+
+#define TRACE_MAGIC "CHTR"
+#define TRACE_MAGIC_LENGTH 4
+#define TRACE_VERSION 1
+#define TRACE_MAX_ARGUMENTS 5
+
+/*
+* Trace file layout:
+*   magic and version   - the 4 bytes "CHTR" followed by one version byte.
+*   records             - one record per traced call, successful or not, each made of:
+*                         operation byte, zigzag varint arguments, the location string for
+*                         TRACE_ADD_TOURNAMENT (varint length, bytes and a terminating zero),
+*                         the result byte, the returned average as 8 little endian bytes of
+*                         its IEEE bits for TRACE_AVERAGE_PLAY_TIME, and a varint of the call
+*                         duration in nanoseconds.
+*
+* Unlike the journal, the trace records queries, exports and failed calls, so replaying it
+* repeats the exact same calls and can check every result.
+*
+* The following functions are available:
+*   traceOpen           - Creates a trace file
+*   traceClose          - Writes the buffered records and closes the trace
+*   traceAppend         - Adds a record
+*   traceReaderOpen     - Reads a trace file
+*   traceReaderDestroy  - Deletes a trace reader
+*   traceReadNext       - Decodes the next record of the trace
+*   traceOperationName  - Returns the ChessSystem function of an operation
+*/
+
+/** Type for defining the traced calls */
+typedef enum {
+    TRACE_ADD_TOURNAMENT = 1,
+    TRACE_ADD_GAME,
+    TRACE_REMOVE_TOURNAMENT,
+    TRACE_REMOVE_PLAYER,
+    TRACE_END_TOURNAMENT,
+    TRACE_AVERAGE_PLAY_TIME,
+    TRACE_SAVE_LEVELS,
+    TRACE_SAVE_STATISTICS,
+    TRACE_OPERATIONS
+} TraceOperation;
+
+/**
+* Type for defining one trace record. The arguments are the int arguments of the call in the
+* order of the chessSystem.h function, location is used only by TRACE_ADD_TOURNAMENT and
+* average_play_time only by TRACE_AVERAGE_PLAY_TIME.
+*/
+typedef struct {
+    TraceOperation operation;
+    int arguments[TRACE_MAX_ARGUMENTS];
+    const char *location;
+    ChessResult result;
+    double average_play_time;
+    unsigned long long duration_ns;
+} TraceRecord;
+
+/** Type for defining an open trace */
+typedef struct chess_trace_t *ChessTrace;
+
+/** Type for defining a trace reader */
+typedef struct trace_reader_t *TraceReader;
+
+/**
+* traceOpen: Creates a trace file, replacing an existing one.
+*
+* @param path_file - The trace file path.
+* @return
+* 	NULL - if the file could not be created or an allocation failed.
+* 	A new trace otherwise.
+*/
+ChessTrace traceOpen(const char *path_file);
+
+/**
+* traceClose: Writes the buffered records and closes the trace.
+*
+* @param trace - Target trace. If trace is NULL nothing will be done.
+* @return
+* 	false - if a write of the trace failed since it was opened.
+* 	true - otherwise.
+*/
+bool traceClose(ChessTrace trace);
+
+/**
+* traceAppend: Adds a record to the trace buffer, writing the buffer when it is full.
+*
+* @param trace - The trace.
+* @param record - The record to add.
+* @return
+* 	false - if the input is NULL, the operation is unknown or a write failed.
+* 	true - otherwise.
+*/
+bool traceAppend(ChessTrace trace, const TraceRecord *record);
+
+/**
+* traceReaderOpen: Reads a whole trace file.
+*
+* @param path_file - The trace file path.
+* @return
+* 	NULL - if the file could not be read, is not a trace, or an allocation failed.
+* 	A new trace reader otherwise.
+*/
+TraceReader traceReaderOpen(const char *path_file);
+
+/**
+* traceReaderDestroy: Deallocates a trace reader.
+*
+* @param reader - Target reader. If reader is NULL nothing will be done.
+*/
+void traceReaderDestroy(TraceReader reader);
+
+/**
+* traceReadNext: Decodes the next record of the trace. The location of the record points
+*   into the reader and stays valid until the reader is destroyed.
+*
+* @param reader - The trace reader.
+* @param record - Where to store the decoded record.
+* @return
+* 	false - if there are no more records, or the next record is truncated or not valid.
+* 	true - otherwise.
+*/
+bool traceReadNext(TraceReader reader, TraceRecord *record);
+
+/**
+* traceOperationName: Returns the name of the ChessSystem function of a traced operation.
+*
+* @param operation - The operation.
+* @return
+* 	The function name.
+*/
+const char *traceOperationName(TraceOperation operation);
+
+#endif
@@ -1,4 +1,34 @@
 #include "chess_utilities.h"
+#include "chess_metrics.h"
+#include "chess_alloc.h"
+
+#define VARINT_MASK 0x7F
+#define VARINT_CONTINUE 0x80
+#define VARINT_BITS 7
+#define LOCATION_CHARACTERS 256
+#define LOCATION_FIRST 1
+#define LOCATION_REST 2
+#define ID_BITS 32
+#define EMPTY_KEY (~0ULL)
+#define HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL
+#define HASH_BITS 64
+#define MINIMUM_TABLE_BITS 4
+#define EXPAND 2
+
+/**
+ * The keys and the values are one allocation: table_size keys, EMPTY_KEY in the free slots,
+ * followed by the value of each slot.
+ */
+struct hash_table_t
+{
+    unsigned long long *keys;
+    unsigned char *values;
+    size_t value_size;
+    ChessMemoryCategory category;
+    int table_size;
+    int table_bits;
+    int used_slots;
+};
 
 int keyCompare(MapKeyElement x, MapKeyElement y)
 {
@@ -10,7 +40,7 @@ void keyFree(MapKeyElement x)
     if(x == NULL){
         return;
     }
-    free(x);
+    accountedFree(x, sizeof(int), CHESS_MEMORY_KEYS);
 }
 
 MapKeyElement keyCopy(MapKeyElement x)
@@ -18,29 +48,297 @@ MapKeyElement keyCopy(MapKeyElement x)
     if(x == NULL){
         return NULL;
     }
-    int* copy_ptr = malloc(sizeof(*copy_ptr));
+    int* copy_ptr = accountedMalloc(sizeof(*copy_ptr), CHESS_MEMORY_KEYS);
     if(copy_ptr == NULL){
         return NULL;
     }
     *copy_ptr = *(int *)x;
+#ifdef CHESS_METRICS
+    metricsCount(&chess_metrics.key_copies);
+#endif
     return copy_ptr;
 }
 
+/**
+ * The classes of the characters of a location name: F for the first character, a capital letter,
+ * and R for the others, a lower case letter or a space. Characters from 128 are in no class.
+ */
+#define F LOCATION_FIRST
+#define R LOCATION_REST
+static const unsigned char location_characters[LOCATION_CHARACTERS] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    R, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, F, F, F, F, F, F, F, F, F, F, F, F, F, F, F,
+    F, F, F, F, F, F, F, F, F, F, F, 0, 0, 0, 0, 0,
+    0, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R,
+    R, R, R, R, R, R, R, R, R, R, R, 0, 0, 0, 0, 0,
+};
+#undef F
+#undef R
+
 bool isValidLocationName(const char *location)
 {
-    int current = 0;
-    if (location[0] < CAPITAL_A || location[0] > CAPITAL_Z)
+    const unsigned char *current = (const unsigned char *)location;
+    if ((location_characters[*current] & LOCATION_FIRST) == 0)
     {
         return false;
     }
-    current++;
-    while (current < strlen(location))
+    // The terminating '\0' is in no class, so the loop ends on it or on the first invalid character
+    while (location_characters[*++current] & LOCATION_REST)
+    {
+    }
+    return *current == '\0';
+}
+
+size_t varintPut(unsigned char *destination, unsigned long long value)
+{
+    size_t length = 0;
+    while (value > VARINT_MASK)
+    {
+        destination[length++] = (unsigned char)((value & VARINT_MASK) | VARINT_CONTINUE);
+        value >>= VARINT_BITS;
+    }
+    destination[length++] = (unsigned char)value;
+    return length;
+}
+
+bool varintGet(const unsigned char *source, size_t size, size_t *offset, unsigned long long *value)
+{
+    *value = 0;
+    for (int shift = 0; shift < MAX_VARINT_SIZE * VARINT_BITS; shift += VARINT_BITS)
     {
-        if ((location[current] < LOWER_A || location[current] > LOWER_Z) && location[current] != SPACE)
+        if (*offset >= size)
         {
             return false;
         }
-        current++;
+        unsigned char byte = source[(*offset)++];
+        *value |= (unsigned long long)(byte & VARINT_MASK) << shift;
+        if ((byte & VARINT_CONTINUE) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+unsigned long long zigzagEncode(long long value)
+{
+    return ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63);
+}
+
+long long zigzagDecode(unsigned long long value)
+{
+    return (long long)(value >> 1) ^ -(long long)(value & 1);
+}
+
+unsigned long long pairKey(int player1, int player2)
+{
+    unsigned int low = (unsigned int)(player1 < player2 ? player1 : player2);
+    unsigned int high = (unsigned int)(player1 < player2 ? player2 : player1);
+    return ((unsigned long long)low << ID_BITS) | high;
+}
+
+/**
+ * tableMalloc: Allocates memory of a hash table, counted as its kind unless it is uncounted.
+ */
+static void *tableMalloc(size_t size, ChessMemoryCategory category)
+{
+    return category == HASH_TABLE_UNCOUNTED ? malloc(size) : accountedMalloc(size, category);
+}
+
+/**
+ * tableFree: Frees memory allocated by tableMalloc.
+ */
+static void tableFree(void *pointer, size_t size, ChessMemoryCategory category)
+{
+    if (category == HASH_TABLE_UNCOUNTED)
+    {
+        free(pointer);
+        return;
     }
+    accountedFree(pointer, size, category);
+}
+
+/**
+ * slotsSize: Returns the bytes of the keys and values of a table of table_size slots.
+ */
+static size_t slotsSize(HashTable table, int table_size)
+{
+    return (sizeof(*table->keys) + table->value_size) * (size_t)table_size;
+}
+
+/**
+ * homeSlot: Returns the slot a key is looked for first.
+ */
+static int homeSlot(unsigned long long key, int bits)
+{
+    return (int)((key * HASH_MULTIPLIER) >> (HASH_BITS - bits));
+}
+
+/**
+ * findSlot: Returns the slot of a key, or the empty slot where it would be.
+ */
+static int findSlot(HashTable table, unsigned long long key)
+{
+    int mask = table->table_size - 1;
+    int slot = homeSlot(key, table->table_bits);
+    while (table->keys[slot] != EMPTY_KEY && table->keys[slot] != key)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/**
+ * resizeTable: Moves the keys and values of a table to a table of 2^bits slots.
+ *
+ * @param table - The table.
+ * @param bits - The bits of the new size.
+ * @return
+ *     false if the allocation failed, true otherwise.
+ */
+static bool resizeTable(HashTable table, int bits)
+{
+    int size = 1 << bits;
+    unsigned long long *keys = tableMalloc(slotsSize(table, size), table->category);
+    if (keys == NULL)
+    {
+        return false;
+    }
+    unsigned long long *old_keys = table->keys;
+    unsigned char *old_values = table->values;
+    int old_size = table->table_size;
+    table->keys = keys;
+    table->values = (unsigned char *)(keys + size);
+    table->table_size = size;
+    table->table_bits = bits;
+    for (int slot = 0; slot < size; slot++)
+    {
+        keys[slot] = EMPTY_KEY;
+    }
+    for (int slot = 0; slot < old_size; slot++)
+    {
+        if (old_keys[slot] != EMPTY_KEY)
+        {
+            int new_slot = findSlot(table, old_keys[slot]);
+            keys[new_slot] = old_keys[slot];
+            memcpy(table->values + table->value_size * new_slot, old_values + table->value_size * slot,
+                   table->value_size);
+        }
+    }
+    tableFree(old_keys, slotsSize(table, old_size), table->category);
     return true;
 }
+
+HashTable hashTableCreate(size_t value_size, ChessMemoryCategory category)
+{
+    HashTable table = tableMalloc(sizeof(*table), category);
+    if (table == NULL)
+    {
+        return NULL;
+    }
+    table->keys = NULL;
+    table->values = NULL;
+    table->value_size = value_size;
+    table->category = category;
+    table->table_size = 0;
+    table->table_bits = 0;
+    table->used_slots = 0;
+    if (resizeTable(table, MINIMUM_TABLE_BITS) == false)
+    {
+        tableFree(table, sizeof(*table), category);
+        return NULL;
+    }
+    return table;
+}
+
+void hashTableDestroy(HashTable table)
+{
+    if (table == NULL)
+    {
+        return;
+    }
+    tableFree(table->keys, slotsSize(table, table->table_size), table->category);
+    tableFree(table, sizeof(*table), table->category);
+}
+
+void *hashTableGet(HashTable table, unsigned long long key)
+{
+    int slot = findSlot(table, key);
+    return table->keys[slot] == key ? table->values + table->value_size * slot : NULL;
+}
+
+void *hashTablePut(HashTable table, unsigned long long key)
+{
+    int slot = findSlot(table, key);
+    if (table->keys[slot] == key)
+    {
+        return table->values + table->value_size * slot;
+    }
+    if (EXPAND * (table->used_slots + 1) > table->table_size)
+    {
+        if (resizeTable(table, table->table_bits + 1) == false)
+        {
+            return NULL;
+        }
+        slot = findSlot(table, key);
+    }
+    table->keys[slot] = key;
+    table->used_slots++;
+    memset(table->values + table->value_size * slot, 0, table->value_size);
+    return table->values + table->value_size * slot;
+}
+
+void hashTableRemove(HashTable table, unsigned long long key)
+{
+    int hole = table == NULL ? 0 : findSlot(table, key);
+    if (table == NULL || table->keys[hole] != key)
+    {
+        return;
+    }
+    // A key after the hole moves back into it unless its probing starts after the hole
+    int mask = table->table_size - 1;
+    for (int slot = (hole + 1) & mask; table->keys[slot] != EMPTY_KEY; slot = (slot + 1) & mask)
+    {
+        int home = homeSlot(table->keys[slot], table->table_bits);
+        if (((slot - home) & mask) >= ((slot - hole) & mask))
+        {
+            table->keys[hole] = table->keys[slot];
+            memcpy(table->values + table->value_size * hole, table->values + table->value_size * slot,
+                   table->value_size);
+            hole = slot;
+        }
+    }
+    table->keys[hole] = EMPTY_KEY;
+    table->used_slots--;
+}
+
+void *hashTableNext(HashTable table, int *position, unsigned long long *key)
+{
+    for (; *position < table->table_size; (*position)++)
+    {
+        int slot = *position;
+        if (table->keys[slot] != EMPTY_KEY)
+        {
+            (*position)++;
+            if (key != NULL)
+            {
+                *key = table->keys[slot];
+            }
+            return table->values + table->value_size * slot;
+        }
+    }
+    return NULL;
+}
+
+void hashTableMemoryUsage(HashTable table, ChessMemoryFootprint *footprint)
+{
+    if (table == NULL || footprint == NULL || table->category == HASH_TABLE_UNCOUNTED)
+    {
+        return;
+    }
+    memoryFootprintAdd(footprint, table->category, sizeof(*table), 1);
+    memoryFootprintAdd(footprint, table->category, slotsSize(table, table->table_size), 1);
+}
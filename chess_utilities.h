@@ -3,12 +3,23 @@
 #include <stdlib.h>
 #include <string.h>
 #include "./mtm_map/map.h"
+#include "chess_alloc.h"
 
 #define CAPITAL_A 'A'
 #define CAPITAL_Z 'Z'
 #define LOWER_A 'a'
 #define LOWER_Z 'z'
 #define SPACE ' '
+#define MAX_VARINT_SIZE 10
+#define HASH_TABLE_UNCOUNTED CHESS_MEMORY_CATEGORIES
+
+/**
+ * Type for defining an open addressing hash table from 64 bit keys to values of one size, kept in
+ * the table. A key is found by Fibonacci hashing and linear probing, and the table doubles once it
+ * is half full, so a lookup reads about one slot. Removing a key moves the keys after it back, so
+ * the table has no deleted slots. Keys are any value but ~0ULL, such as an id or a pairKey.
+ */
+typedef struct hash_table_t *HashTable;
 
 /**
  * keyCompare: Compares between two given keys.
@@ -47,5 +58,124 @@ MapKeyElement keyCopy(MapKeyElement x);
  */
 bool isValidLocationName(const char *location);
 
+/**
+ * varintPut: Stores an unsigned value using 7 bits per byte, low bits first.
+ *
+ * @param destination - Where to store the bytes. Must have room for MAX_VARINT_SIZE bytes.
+ * @param value - The value to store.
+ * @return
+ *     The number of bytes used.
+ */
+size_t varintPut(unsigned char *destination, unsigned long long value);
+
+/**
+ * varintGet: Loads a value stored by varintPut.
+ *
+ * @param source - The stored bytes.
+ * @param size - The number of bytes in source.
+ * @param offset - The offset of the value in source, advanced past it.
+ * @param value - Where to store the value.
+ * @return
+ *     false - if the value is truncated or too long.
+ *     true - otherwise.
+ */
+bool varintGet(const unsigned char *source, size_t size, size_t *offset, unsigned long long *value);
+
+/**
+ * zigzagEncode: Maps signed values to unsigned values so that small negative values stay short as varints.
+ *
+ * @param value - The signed value.
+ * @return
+ *     The encoded value.
+ */
+unsigned long long zigzagEncode(long long value);
+
+/**
+ * zigzagDecode: Reverses zigzagEncode.
+ *
+ * @param value - The encoded value.
+ * @return
+ *     The signed value.
+ */
+long long zigzagDecode(unsigned long long value);
+
+/**
+ * pairKey: Returns the key of a pair of players, the same for both orders of the ids.
+ *
+ * @param player1 - A player id.
+ * @param player2 - Another player id.
+ * @return
+ *     The lower id in the high 32 bits and the higher id in the low 32 bits.
+ */
+unsigned long long pairKey(int player1, int player2);
+
+/**
+ * hashTableCreate: Allocates an empty hash table.
+ *
+ * @param value_size - The size of the values. May be 0 for a set of keys.
+ * @param category - The kind of structure the table is counted as, HASH_TABLE_UNCOUNTED for a
+ *     table that is not part of the system data.
+ * @return
+ *     NULL if an allocation failed, a new table otherwise.
+ */
+HashTable hashTableCreate(size_t value_size, ChessMemoryCategory category);
+
+/**
+ * hashTableDestroy: Deallocates a hash table. The values are not freed.
+ *
+ * @param table - Target table. If table is NULL nothing will be done.
+ */
+void hashTableDestroy(HashTable table);
+
+/**
+ * hashTableGet: Returns the value of a key.
+ *
+ * @param table - The table.
+ * @param key - The key.
+ * @return
+ *     NULL if the key is not in the table, its value otherwise. The value moves with the next
+ *     hashTablePut or hashTableRemove.
+ */
+void *hashTableGet(HashTable table, unsigned long long key);
+
+/**
+ * hashTablePut: Returns the value of a key, adding the key with a value of zeros if it is not in
+ * the table.
+ *
+ * @param table - The table.
+ * @param key - The key.
+ * @return
+ *     NULL if the table could not grow, the value otherwise. The value moves with the next
+ *     hashTablePut or hashTableRemove.
+ */
+void *hashTablePut(HashTable table, unsigned long long key);
+
+/**
+ * hashTableRemove: Removes a key and its value from a hash table.
+ *
+ * @param table - The table. If table is NULL or the key is not in it nothing will be done.
+ * @param key - The key.
+ */
+void hashTableRemove(HashTable table, unsigned long long key);
+
+/**
+ * hashTableNext: Goes over the keys of a hash table, in no particular order.
+ *
+ * @param table - The table.
+ * @param position - Where the walk is, 0 to start. It is advanced past the returned key.
+ * @param key - Where to store the key. May be NULL.
+ * @return
+ *     NULL once there are no more keys, the value of the next key otherwise.
+ */
+void *hashTableNext(HashTable table, int *position, unsigned long long *key);
+
+/**
+ * hashTableMemoryUsage: Adds the memory of a hash table, without what its values point to, to a footprint.
+ *
+ * @param table - The table. If table is NULL or not counted nothing will be added.
+ * @param footprint - The footprint to add to.
+ */
+void hashTableMemoryUsage(HashTable table, ChessMemoryFootprint *footprint);
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "fast_writer.h"
+
+#define MAX_INT_DIGITS 12
+#define MAX_DOUBLE_DIGITS 400
+#define FAST_LIMIT 1e9
+#define TIE_DISTANCE 1e-4
+#define HALF 0.5
+#define HUNDRED 100
+#define TEN 10
+#define DECIMAL_PART_LENGTH 3
+
+struct fast_writer_t
+{
+    FILE *file;
+    char *buffer;
+    size_t size;
+    bool failed;
+};
+
+FastWriter fastWriterCreate(FILE *file)
+{
+    if (file == NULL)
+    {
+        return NULL;
+    }
+    FastWriter writer = malloc(sizeof(*writer));
+    if (writer == NULL)
+    {
+        return NULL;
+    }
+    writer->buffer = malloc(FAST_WRITER_BUFFER_SIZE);
+    if (writer->buffer == NULL)
+    {
+        free(writer);
+        return NULL;
+    }
+    writer->file = file;
+    writer->size = 0;
+    writer->failed = false;
+    return writer;
+}
+
+bool fastWriterFlush(FastWriter writer)
+{
+    if (writer == NULL)
+    {
+        return false;
+    }
+    if (writer->size > 0 && fwrite(writer->buffer, 1, writer->size, writer->file) != writer->size)
+    {
+        writer->failed = true;
+    }
+    writer->size = 0;
+    return writer->failed == false;
+}
+
+bool fastWriterDestroy(FastWriter writer)
+{
+    if (writer == NULL)
+    {
+        return true;
+    }
+    bool success = fastWriterFlush(writer);
+    free(writer->buffer);
+    free(writer);
+    return success;
+}
+
+/**
+ * writerReserve: Makes room in the buffer, flushing it if needed.
+ *
+ * @param writer - The writer.
+ * @param length - The number of bytes about to be written. Must not exceed the buffer size.
+ * @return
+ *     A pointer to where the bytes should be written.
+ */
+static char *writerReserve(FastWriter writer, size_t length)
+{
+    if (writer->size + length > FAST_WRITER_BUFFER_SIZE)
+    {
+        fastWriterFlush(writer);
+    }
+    return writer->buffer + writer->size;
+}
+
+/**
+ * writerPutBytes: Writes raw bytes of any length.
+ *
+ * @param writer - The writer.
+ * @param bytes - The bytes to write.
+ * @param length - The number of bytes.
+ */
+static void writerPutBytes(FastWriter writer, const char *bytes, size_t length)
+{
+    while (length > 0)
+    {
+        size_t chunk = length < FAST_WRITER_BUFFER_SIZE ? length : FAST_WRITER_BUFFER_SIZE;
+        memcpy(writerReserve(writer, chunk), bytes, chunk);
+        writer->size += chunk;
+        bytes += chunk;
+        length -= chunk;
+    }
+}
+
+/**
+ * putUnsigned: Writes the decimal digits of an unsigned value.
+ *
+ * @param writer - The writer.
+ * @param value - The value to write.
+ */
+static void putUnsigned(FastWriter writer, unsigned long long value)
+{
+    char digits[MAX_INT_DIGITS * 2];
+    int start = sizeof(digits);
+    do
+    {
+        digits[--start] = (char)('0' + value % TEN);
+        value /= TEN;
+    } while (value > 0);
+    writerPutBytes(writer, digits + start, sizeof(digits) - start);
+}
+
+void fastWriterPutInt(FastWriter writer, int value)
+{
+    if (writer == NULL)
+    {
+        return;
+    }
+    unsigned long long magnitude = value < 0 ? -(long long)value : value;
+    if (value < 0)
+    {
+        fastWriterPutChar(writer, '-');
+    }
+    putUnsigned(writer, magnitude);
+}
+
+void fastWriterPutFixed2(FastWriter writer, double value)
+{
+    if (writer == NULL)
+    {
+        return;
+    }
+    double magnitude = signbit(value) ? -value : value;
+    double scaled = magnitude * HUNDRED;
+    double tie_distance = 0;
+    if (magnitude < FAST_LIMIT)
+    {
+        tie_distance = scaled - (double)(unsigned long long)scaled - HALF;
+    }
+    /* near a rounding tie the error of the multiplication may change the result, so printf decides */
+    if (isfinite(value) == false || magnitude >= FAST_LIMIT ||
+        (tie_distance < TIE_DISTANCE && tie_distance > -TIE_DISTANCE))
+    {
+        char formatted[MAX_DOUBLE_DIGITS];
+        int length = snprintf(formatted, sizeof(formatted), "%.2f", value);
+        writerPutBytes(writer, formatted, length);
+        return;
+    }
+
+    unsigned long long rounded = (unsigned long long)(scaled + HALF);
+    if (signbit(value))
+    {
+        fastWriterPutChar(writer, '-');
+    }
+    putUnsigned(writer, rounded / HUNDRED);
+    char *decimals = writerReserve(writer, DECIMAL_PART_LENGTH);
+    decimals[0] = '.';
+    decimals[1] = (char)('0' + rounded % HUNDRED / TEN);
+    decimals[2] = (char)('0' + rounded % TEN);
+    writer->size += DECIMAL_PART_LENGTH;
+}
+
+void fastWriterPutString(FastWriter writer, const char *string)
+{
+    if (writer == NULL || string == NULL)
+    {
+        return;
+    }
+    writerPutBytes(writer, string, strlen(string));
+}
+
+void fastWriterPutChar(FastWriter writer, char character)
+{
+    if (writer == NULL)
+    {
+        return;
+    }
+    *writerReserve(writer, 1) = character;
+    writer->size++;
+}
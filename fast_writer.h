@@ -0,0 +1,89 @@
+#ifndef FAST_WRITER_H
+#define FAST_WRITER_H
+#include <stdbool.h>
+#include <stdio.h>
+
+#define FAST_WRITER_BUFFER_SIZE (1 << 16)
+
+/*
+* A buffered writer for the text exports. Values are formatted straight into a large
+* buffer without parsing a format string, and the buffer is handed to the stream with a
+* single fwrite when it fills up.
+*
+* The following functions are available:
+*   fastWriterCreate     - Creates a new writer on top of an open stream
+*   fastWriterDestroy    - Flushes the writer and deletes it, leaving the stream open
+*   fastWriterPutInt     - Writes an int, like "%d"
+*   fastWriterPutFixed2  - Writes a double with 2 decimals, byte identical to "%.2f"
+*   fastWriterPutString  - Writes a string, like "%s"
+*   fastWriterPutChar    - Writes one character
+*   fastWriterFlush      - Hands the buffered bytes to the stream
+*/
+
+/** Type for defining the fast writer */
+typedef struct fast_writer_t *FastWriter;
+
+/**
+* fastWriterCreate: Allocates a new writer that writes to an open stream.
+*
+* @param file - An open, writable output stream.
+* @return
+* 	NULL - if file is NULL or allocations failed.
+* 	A new writer in case of success.
+*/
+FastWriter fastWriterCreate(FILE *file);
+
+/**
+* fastWriterDestroy: Flushes the buffered bytes and deallocates the writer. The stream is not closed.
+*
+* @param writer - Target writer. If writer is NULL nothing will be done.
+* @return
+* 	false - if one of the writes to the stream failed.
+* 	true - otherwise.
+*/
+bool fastWriterDestroy(FastWriter writer);
+
+/**
+* fastWriterPutInt: Writes an int in decimal, the same as fprintf with "%d".
+*
+* @param writer - The writer.
+* @param value - The value to write.
+*/
+void fastWriterPutInt(FastWriter writer, int value);
+
+/**
+* fastWriterPutFixed2: Writes a double with two decimals. The output is byte identical to
+*   fprintf with "%.2f", including the rounding of values that are close to a tie.
+*
+* @param writer - The writer.
+* @param value - The value to write.
+*/
+void fastWriterPutFixed2(FastWriter writer, double value);
+
+/**
+* fastWriterPutString: Writes a string, the same as fprintf with "%s".
+*
+* @param writer - The writer.
+* @param string - The string to write.
+*/
+void fastWriterPutString(FastWriter writer, const char *string);
+
+/**
+* fastWriterPutChar: Writes one character.
+*
+* @param writer - The writer.
+* @param character - The character to write.
+*/
+void fastWriterPutChar(FastWriter writer, char character);
+
+/**
+* fastWriterFlush: Hands the buffered bytes to the stream.
+*
+* @param writer - The writer.
+* @return
+* 	false - if writer is NULL or one of the writes to the stream failed.
+* 	true - otherwise.
+*/
+bool fastWriterFlush(FastWriter writer);
+
+#endif
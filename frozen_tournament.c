@@ -0,0 +1,476 @@
+#include <string.h>
+#include "frozen_tournament.h"
+#include "chess_utilities.h"
+#include "chess_alloc.h"
+
+#define WINNER_BITS 2
+#define WINNER_MASK 3
+#define VARINTS_PER_GAME 3
+#define MINIMUM_CAPACITY 16
+#define EXPAND 2
+
+typedef struct
+{
+    Player_Id id;
+    int points;
+    int wins;
+    int losses;
+    int draws;
+    int games;
+    int total_time;
+} FrozenPlayer;
+
+struct frozen_tournament_t
+{
+    unsigned char *games;
+    int games_size;
+    size_t games_allocated;
+    int number_of_games;
+    FrozenPlayer *players;
+    int number_of_players;
+    int players_capacity;
+    int longest_game_time;
+    double total_game_time;
+};
+
+/**
+ * findPlayer: Binary searches the players array.
+ *
+ * @param frozen - The frozen tournament.
+ * @param player_id - The player id.
+ * @return
+ *     NULL if the player is not in the array, the player otherwise.
+ */
+static FrozenPlayer *findPlayer(FrozenTournament frozen, Player_Id player_id)
+{
+    int low = 0, high = frozen->number_of_players - 1;
+    while (low <= high)
+    {
+        int middle = low + (high - low) / 2;
+        if (frozen->players[middle].id == player_id)
+        {
+            return &frozen->players[middle];
+        }
+        if (frozen->players[middle].id < player_id)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * addGameToPlayer: Counts a game in the stats of one of its players.
+ *
+ * @param frozen - The frozen tournament.
+ * @param player_id - The player id. Removed players are skipped.
+ * @param time - The game time.
+ */
+static void addGameToPlayer(FrozenTournament frozen, Player_Id player_id, Time time)
+{
+    FrozenPlayer *player = findPlayer(frozen, player_id);
+    if (player != NULL)
+    {
+        player->games++;
+        player->total_time += time;
+    }
+}
+
+/**
+ * freezePlayers: Fills the players array from the players map.
+ *
+ * @param frozen - The frozen tournament.
+ * @param player_list - The players map.
+ * @return
+ *     false - if an allocation failed.
+ *     true - otherwise.
+ */
+static bool freezePlayers(FrozenTournament frozen, Map player_list)
+{
+    frozen->players = accountedMalloc(sizeof(*frozen->players) * (mapGetSize(player_list) + 1), CHESS_MEMORY_FROZEN);
+    if (frozen->players == NULL)
+    {
+        return false;
+    }
+    frozen->number_of_players = mapGetSize(player_list);
+    frozen->players_capacity = frozen->number_of_players + 1;
+    int index = 0;
+    MAP_FOREACH(MapKeyElement, player_id, player_list)
+    {
+        PlayerData player_data = mapGet(player_list, player_id);
+        FrozenPlayer *player = &frozen->players[index++];
+        player->id = *(int *)player_id;
+        player->points = playerGetPoints(player_data);
+        player->wins = playerGetWins(player_data);
+        player->losses = playerGetLosses(player_data);
+        player->draws = playerGetDraws(player_data);
+        player->games = 0;
+        player->total_time = 0;
+        keyFree(player_id);
+    }
+    return true;
+}
+
+/**
+ * encodeGame: Appends a game to the games stream, which has room for it, and adds it to the
+ * longest and total game time.
+ *
+ * @param frozen - The frozen tournament.
+ * @param player1 - The first player id.
+ * @param player2 - The second player id.
+ * @param winner - The winner.
+ * @param time - The game time.
+ */
+static void encodeGame(FrozenTournament frozen, Player_Id player1, Player_Id player2, Winner winner, Time time)
+{
+    size_t size = frozen->games_size;
+    size += varintPut(frozen->games + size, zigzagEncode(player1));
+    size += varintPut(frozen->games + size, zigzagEncode((long long)player2 - player1));
+    size += varintPut(frozen->games + size, ((unsigned long long)time << WINNER_BITS) | winner);
+    frozen->games_size = size;
+    frozen->number_of_games++;
+    frozen->total_game_time += time;
+    if (frozen->longest_game_time < time)
+    {
+        frozen->longest_game_time = time;
+    }
+}
+
+/**
+ * packGames: Shrinks the games stream to its size. The stream stays as it is if that fails.
+ *
+ * @param frozen - The frozen tournament.
+ */
+static void packGames(FrozenTournament frozen)
+{
+    unsigned char *packed_games = accountedRealloc(frozen->games, frozen->games_allocated, frozen->games_size + 1,
+                                                   CHESS_MEMORY_FROZEN);
+    if (packed_games != NULL)
+    {
+        frozen->games = packed_games;
+        frozen->games_allocated = frozen->games_size + 1;
+    }
+}
+
+/**
+ * freezeGames: Encodes the games map into the games stream and counts the games of every player.
+ *
+ * @param frozen - The frozen tournament, whose players array is already filled.
+ * @param games - The games map.
+ * @return
+ *     false - if an allocation failed.
+ *     true - otherwise.
+ */
+static bool freezeGames(FrozenTournament frozen, Map games)
+{
+    size_t capacity = (size_t)mapGetSize(games) * VARINTS_PER_GAME * MAX_VARINT_SIZE + 1;
+    frozen->games = accountedMalloc(capacity, CHESS_MEMORY_FROZEN);
+    if (frozen->games == NULL)
+    {
+        return false;
+    }
+    frozen->games_allocated = capacity;
+    MAP_FOREACH(MapKeyElement, game_key, games)
+    {
+        Game_Data game_data = mapGet(games, game_key);
+        Player_Id player1 = gameGetFirstPlayer(game_data), player2 = gameGetSecondPlayer(game_data);
+        Time time = gameGetTime(game_data);
+        encodeGame(frozen, player1, player2, (Winner)gameGetWinner(game_data), time);
+        addGameToPlayer(frozen, player1, time);
+        addGameToPlayer(frozen, player2, time);
+        keyFree(game_key);
+    }
+    packGames(frozen);
+    return true;
+}
+
+FrozenTournament frozenCreate(Map games, Map player_list)
+{
+    if (games == NULL || player_list == NULL)
+    {
+        return NULL;
+    }
+    FrozenTournament frozen = frozenBegin();
+    if (frozen == NULL)
+    {
+        return NULL;
+    }
+    if (freezePlayers(frozen, player_list) == false || freezeGames(frozen, games) == false)
+    {
+        frozenDestroy(frozen);
+        return NULL;
+    }
+    return frozen;
+}
+
+void frozenDestroy(FrozenTournament frozen)
+{
+    if (frozen == NULL)
+    {
+        return;
+    }
+    accountedFree(frozen->games, frozen->games_allocated, CHESS_MEMORY_FROZEN);
+    accountedFree(frozen->players, sizeof(*frozen->players) * frozen->players_capacity, CHESS_MEMORY_FROZEN);
+    accountedFree(frozen, sizeof(*frozen), CHESS_MEMORY_FROZEN);
+}
+
+FrozenTournament frozenBegin()
+{
+    FrozenTournament frozen = accountedMalloc(sizeof(*frozen), CHESS_MEMORY_FROZEN);
+    if (frozen == NULL)
+    {
+        return NULL;
+    }
+    frozen->games = NULL;
+    frozen->games_size = 0;
+    frozen->games_allocated = 0;
+    frozen->number_of_games = 0;
+    frozen->players = NULL;
+    frozen->number_of_players = 0;
+    frozen->players_capacity = 0;
+    frozen->longest_game_time = 0;
+    frozen->total_game_time = 0;
+    return frozen;
+}
+
+bool frozenAddGame(FrozenTournament frozen, Player_Id player1, Player_Id player2, Winner winner, Time time)
+{
+    if (frozen == NULL)
+    {
+        return false;
+    }
+    if (frozen->games_allocated - frozen->games_size < VARINTS_PER_GAME * MAX_VARINT_SIZE)
+    {
+        size_t capacity = frozen->games_allocated < MINIMUM_CAPACITY * VARINTS_PER_GAME * MAX_VARINT_SIZE ?
+                          MINIMUM_CAPACITY * VARINTS_PER_GAME * MAX_VARINT_SIZE : frozen->games_allocated * EXPAND;
+        unsigned char *games = accountedRealloc(frozen->games, frozen->games_allocated, capacity, CHESS_MEMORY_FROZEN);
+        if (games == NULL)
+        {
+            return false;
+        }
+        frozen->games = games;
+        frozen->games_allocated = capacity;
+    }
+    encodeGame(frozen, player1, player2, winner, time);
+    return true;
+}
+
+bool frozenAddPlayer(FrozenTournament frozen, Player_Id player_id, PlayerData player_data)
+{
+    if (frozen == NULL || player_data == NULL)
+    {
+        return false;
+    }
+    if (frozen->number_of_players + 1 >= frozen->players_capacity)
+    {
+        int capacity = frozen->players_capacity == 0 ? MINIMUM_CAPACITY : frozen->players_capacity * EXPAND;
+        FrozenPlayer *players = accountedRealloc(frozen->players, sizeof(*players) * frozen->players_capacity,
+                                                 sizeof(*players) * capacity, CHESS_MEMORY_FROZEN);
+        if (players == NULL)
+        {
+            return false;
+        }
+        frozen->players = players;
+        frozen->players_capacity = capacity;
+    }
+    FrozenPlayer *player = &frozen->players[frozen->number_of_players++];
+    player->id = player_id;
+    player->points = playerGetPoints(player_data);
+    player->wins = playerGetWins(player_data);
+    player->losses = playerGetLosses(player_data);
+    player->draws = playerGetDraws(player_data);
+    player->games = 0;
+    player->total_time = 0;
+    return true;
+}
+
+bool frozenFinish(FrozenTournament frozen)
+{
+    if (frozen == NULL)
+    {
+        return false;
+    }
+    for (int i = 1; i < frozen->number_of_players; i++)
+    {
+        if (frozen->players[i - 1].id >= frozen->players[i].id)
+        {
+            return false;
+        }
+    }
+    Player_Id player1, player2;
+    Winner winner;
+    Time time;
+    for (int offset = frozenGetGame(frozen, 0, &player1, &player2, &winner, &time); offset != FROZEN_GAMES_END;
+         offset = frozenGetGame(frozen, offset, &player1, &player2, &winner, &time))
+    {
+        addGameToPlayer(frozen, player1, time);
+        addGameToPlayer(frozen, player2, time);
+    }
+    packGames(frozen);
+    return true;
+}
+
+FrozenTournament frozenCopy(FrozenTournament frozen)
+{
+    if (frozen == NULL)
+    {
+        return NULL;
+    }
+    FrozenTournament copy = accountedMalloc(sizeof(*copy), CHESS_MEMORY_FROZEN);
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+    *copy = *frozen;
+    copy->games_allocated = frozen->games_size + 1;
+    copy->games = accountedMalloc(copy->games_allocated, CHESS_MEMORY_FROZEN);
+    copy->players_capacity = frozen->number_of_players + 1;
+    copy->players = accountedMalloc(sizeof(*copy->players) * copy->players_capacity, CHESS_MEMORY_FROZEN);
+    if (copy->games == NULL || copy->players == NULL)
+    {
+        frozenDestroy(copy);
+        return NULL;
+    }
+    memcpy(copy->games, frozen->games, frozen->games_size);
+    memcpy(copy->players, frozen->players, sizeof(*copy->players) * frozen->number_of_players);
+    return copy;
+}
+
+int frozenNumberOfGames(FrozenTournament frozen)
+{
+    if (frozen == NULL)
+    {
+        return -1;
+    }
+    return frozen->number_of_games;
+}
+
+int frozenNumberOfPlayers(FrozenTournament frozen)
+{
+    if (frozen == NULL)
+    {
+        return -1;
+    }
+    return frozen->number_of_players;
+}
+
+int frozenLongestGameTime(FrozenTournament frozen)
+{
+    if (frozen == NULL)
+    {
+        return -1;
+    }
+    return frozen->longest_game_time;
+}
+
+double frozenTotalGameTime(FrozenTournament frozen)
+{
+    if (frozen == NULL)
+    {
+        return -1;
+    }
+    return frozen->total_game_time;
+}
+
+bool frozenPlayerExist(FrozenTournament frozen, Player_Id player_id)
+{
+    if (frozen == NULL)
+    {
+        return false;
+    }
+    return findPlayer(frozen, player_id) != NULL;
+}
+
+int frozenPlayerTotalTime(FrozenTournament frozen, Player_Id player_id, int *number_of_games_per_player)
+{
+    if (frozen == NULL)
+    {
+        return 0;
+    }
+    FrozenPlayer *player = findPlayer(frozen, player_id);
+    if (player == NULL)
+    {
+        return 0;
+    }
+    *number_of_games_per_player += player->games;
+    return player->total_time;
+}
+
+Player_Id frozenGetPlayer(FrozenTournament frozen, int index, PlayerData player_data)
+{
+    if (frozen == NULL || index < 0 || index >= frozen->number_of_players)
+    {
+        return -1;
+    }
+    FrozenPlayer *player = &frozen->players[index];
+    playerSetPoints(player_data, player->points);
+    playerSetWins(player_data, player->wins);
+    playerSetLosses(player_data, player->losses);
+    playerSetDraws(player_data, player->draws);
+    return player->id;
+}
+
+ChessResult frozenCopyPlayersToMap(FrozenTournament frozen, Map total_player_map)
+{
+    if (frozen == NULL || total_player_map == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    for (int i = 0; i < frozen->number_of_players; i++)
+    {
+        Player_Id player_id = frozen->players[i].id;
+        PlayerData p_data = mapGet(total_player_map, &player_id);
+        if (p_data == NULL)
+        {
+            p_data = playerDataCreate();
+            if (p_data == NULL)
+            {
+                return CHESS_OUT_OF_MEMORY;
+            }
+            MapResult result = mapPut(total_player_map, &player_id, p_data);
+            playerDataDestroy(p_data);
+            if (result != MAP_SUCCESS)
+            {
+                return CHESS_OUT_OF_MEMORY;
+            }
+            p_data = mapGet(total_player_map, &player_id);
+        }
+        frozenGetPlayer(frozen, i, p_data);
+    }
+    return CHESS_SUCCESS;
+}
+
+int frozenGetGame(FrozenTournament frozen, int offset, Player_Id *player1, Player_Id *player2, Winner *winner, Time *time)
+{
+    if (frozen == NULL || offset < 0 || offset >= frozen->games_size)
+    {
+        return FROZEN_GAMES_END;
+    }
+    size_t position = offset;
+    unsigned long long first, difference, time_and_winner;
+    if (!varintGet(frozen->games, frozen->games_size, &position, &first) ||
+        !varintGet(frozen->games, frozen->games_size, &position, &difference) ||
+        !varintGet(frozen->games, frozen->games_size, &position, &time_and_winner))
+    {
+        return FROZEN_GAMES_END;
+    }
+    *player1 = (Player_Id)zigzagDecode(first);
+    *player2 = (Player_Id)(zigzagDecode(first) + zigzagDecode(difference));
+    *winner = (Winner)(time_and_winner & WINNER_MASK);
+    *time = (Time)(time_and_winner >> WINNER_BITS);
+    return (int)position;
+}
+
+void frozenMemoryUsage(FrozenTournament frozen, ChessMemoryFootprint *footprint)
+{
+    if (frozen == NULL || footprint == NULL)
+    {
+        return;
+    }
+    size_t bytes = sizeof(*frozen) + sizeof(*frozen->players) * frozen->players_capacity + frozen->games_allocated;
+    memoryFootprintAdd(footprint, CHESS_MEMORY_FROZEN, bytes, 3);
+}
@@ -0,0 +1,232 @@
+#ifndef FROZEN_TOURNAMENT_H
+#define FROZEN_TOURNAMENT_H
+#include <stdbool.h>
+#include <stdlib.h>
+#include "game_data.h"
+#include "chess_alloc.h"
+
+#define FROZEN_GAMES_END -1
+
+/*
+* A read-only packed form of the games and players of an ended tournament.
+*
+* Games are kept in one byte stream, in game key order, each game being three varints:
+* zigzag(player1), zigzag(player2 - player1) and time * 4 + winner. Players are kept in an
+* array sorted by id, together with their points, wins, losses, draws, number of games and
+* total play time, so per player queries are a binary search. The longest game and total
+* play time of the tournament are calculated once. A frozen tournament is made from the maps of
+* a tournament that ended, or built game by game and player by player, as when it is loaded.
+*
+* The following functions are available:
+*   frozenCreate             - Packs the games and players maps of a tournament
+*   frozenBegin              - Creates an empty frozen tournament to build
+*   frozenAddGame            - Appends a game to a frozen tournament being built
+*   frozenAddPlayer          - Appends a player to a frozen tournament being built
+*   frozenFinish             - Completes a frozen tournament being built
+*   frozenDestroy            - Deletes a frozen tournament
+*   frozenCopy               - Copies a frozen tournament
+*   frozenNumberOfGames      - Returns the number of games
+*   frozenNumberOfPlayers    - Returns the number of players in the players array
+*   frozenLongestGameTime    - Returns the time of the longest game
+*   frozenTotalGameTime      - Returns the sum of the games time
+*   frozenPlayerExist        - Returns if a player plays in one of the games
+*   frozenPlayerTotalTime    - Returns the total time and number of games of a player
+*   frozenGetPlayer          - Returns the id and stats of the player at an index of the players array
+*   frozenCopyPlayersToMap   - Adds the players stats to a players map
+*   frozenGetGame            - Decodes the game at an offset of the games stream
+*   frozenMemoryUsage        - Adds the memory of a frozen tournament to a footprint
+*/
+
+/** Type for defining the frozen tournament */
+typedef struct frozen_tournament_t *FrozenTournament;
+
+/**
+* frozenCreate: Packs the games and players of a tournament.
+*
+* @param games - The games map of the tournament, keyed by game key.
+* @param player_list - The players map of the tournament, keyed by player id.
+* @return
+* 	NULL - if the input is NULL or allocations failed.
+* 	A new frozen tournament in case of success. The maps are not changed.
+*/
+FrozenTournament frozenCreate(Map games, Map player_list);
+
+/**
+* frozenBegin: Allocates a frozen tournament without games and players, to be built by
+*   frozenAddGame and frozenAddPlayer and completed by frozenFinish.
+*
+* @return
+* 	NULL - if allocations failed.
+* 	A new frozen tournament in case of success.
+*/
+FrozenTournament frozenBegin();
+
+/**
+* frozenAddGame: Appends a game to a frozen tournament being built. Games are added in game key order.
+*
+* @param frozen - The frozen tournament.
+* @param player1 - The first player id.
+* @param player2 - The second player id.
+* @param winner - The winner.
+* @param time - The game time.
+* @return
+* 	false - if frozen is NULL or an allocation failed.
+* 	true - otherwise.
+*/
+bool frozenAddGame(FrozenTournament frozen, Player_Id player1, Player_Id player2, Winner winner, Time time);
+
+/**
+* frozenAddPlayer: Appends a player to a frozen tournament being built. Players are added in
+*   increasing id order.
+*
+* @param frozen - The frozen tournament.
+* @param player_id - The player id.
+* @param player_data - The stats of the player in the tournament.
+* @return
+* 	false - if the input is NULL or an allocation failed.
+* 	true - otherwise.
+*/
+bool frozenAddPlayer(FrozenTournament frozen, Player_Id player_id, PlayerData player_data);
+
+/**
+* frozenFinish: Completes a frozen tournament being built, counting the games of every player.
+*
+* @param frozen - The frozen tournament.
+* @return
+* 	false - if frozen is NULL or its players were not added in increasing id order.
+* 	true - otherwise.
+*/
+bool frozenFinish(FrozenTournament frozen);
+
+/**
+* frozenDestroy: Deallocates a frozen tournament.
+*
+* @param frozen - Target frozen tournament. If it is NULL nothing will be done.
+*/
+void frozenDestroy(FrozenTournament frozen);
+
+/**
+* frozenCopy: Creates a copy of a frozen tournament.
+*
+* @param frozen - Target frozen tournament.
+* @return
+* 	NULL if a NULL was sent or a memory allocation failed.
+* 	A new frozen tournament containing the same games and players otherwise.
+*/
+FrozenTournament frozenCopy(FrozenTournament frozen);
+
+/**
+* frozenNumberOfGames: Returns the number of games.
+*
+* @param frozen - The frozen tournament.
+* @return
+* 	-1 - if frozen is NULL.
+*   The number of games otherwise.
+*/
+int frozenNumberOfGames(FrozenTournament frozen);
+
+/**
+* frozenNumberOfPlayers: Returns the number of players in the players array.
+*
+* @param frozen - The frozen tournament.
+* @return
+* 	-1 - if frozen is NULL.
+*   The number of players otherwise.
+*/
+int frozenNumberOfPlayers(FrozenTournament frozen);
+
+/**
+* frozenLongestGameTime: Returns the time of the longest game.
+*
+* @param frozen - The frozen tournament.
+* @return
+* 	-1 - if frozen is NULL.
+*   The longest game time, 0 if there are no games, otherwise.
+*/
+int frozenLongestGameTime(FrozenTournament frozen);
+
+/**
+* frozenTotalGameTime: Returns the sum of the time of all the games.
+*
+* @param frozen - The frozen tournament.
+* @return
+* 	-1 - if frozen is NULL.
+*   The total time otherwise.
+*/
+double frozenTotalGameTime(FrozenTournament frozen);
+
+/**
+* frozenPlayerExist: Returns if the player plays in one of the games.
+*
+* @param frozen - The frozen tournament.
+* @param player_id - The player id.
+* @return
+* 	false - if frozen is NULL or the player does not play in the tournament.
+* 	true - otherwise.
+*/
+bool frozenPlayerExist(FrozenTournament frozen, Player_Id player_id);
+
+/**
+* frozenPlayerTotalTime: Returns the sum of the time of the games the player plays in, and adds
+*   the number of those games to a counter.
+*
+* @param frozen - The frozen tournament.
+* @param player_id - The player id.
+* @param number_of_games_per_player - pointer to a counter of the player's games.
+* @return
+* 	0 - if frozen is NULL or the player does not play in the tournament.
+*   The total time of the player's games otherwise.
+*/
+int frozenPlayerTotalTime(FrozenTournament frozen, Player_Id player_id, int *number_of_games_per_player);
+
+/**
+* frozenGetPlayer: Returns the id and stats of the player at an index of the players array.
+*   The array is sorted by id.
+*
+* @param frozen - The frozen tournament.
+* @param index - The index, between 0 and frozenNumberOfPlayers - 1.
+* @param player_data - A player to which the stored stats are added. May be NULL.
+* @return
+* 	-1 - if frozen is NULL or the index is out of range.
+*   The player id otherwise.
+*/
+Player_Id frozenGetPlayer(FrozenTournament frozen, int index, PlayerData player_data);
+
+/**
+* frozenCopyPlayersToMap: Adds the stats of every player to a players map, putting players
+*   that are not in the map yet.
+*
+* @param frozen - The frozen tournament.
+* @param total_player_map - The players map to add into.
+* @return
+*     CHESS_NULL_ARGUMENT - if the input is NULL.
+*     CHESS_OUT_OF_MEMORY - if there was a problem putting a player in the map.
+*     CHESS_SUCCESS - otherwise.
+*/
+ChessResult frozenCopyPlayersToMap(FrozenTournament frozen, Map total_player_map);
+
+/**
+* frozenGetGame: Decodes the game at an offset of the games stream. The first game is at offset 0,
+*   and games are decoded in game key order.
+*
+* @param frozen - The frozen tournament.
+* @param offset - The offset of the game.
+* @param player1 - Where to store the first player id.
+* @param player2 - Where to store the second player id.
+* @param winner - Where to store the winner.
+* @param time - Where to store the game time.
+* @return
+* 	FROZEN_GAMES_END - if frozen is NULL or there are no more games.
+*   The offset of the next game otherwise.
+*/
+int frozenGetGame(FrozenTournament frozen, int offset, Player_Id *player1, Player_Id *player2, Winner *winner, Time *time);
+
+/**
+* frozenMemoryUsage: Adds the memory allocated for a frozen tournament to a footprint.
+*
+* @param frozen - The frozen tournament. If it is NULL nothing will be added.
+* @param footprint - The footprint to add to.
+*/
+void frozenMemoryUsage(FrozenTournament frozen, ChessMemoryFootprint *footprint);
+
+#endif
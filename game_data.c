@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include "game_data.h"
+#include "chess_alloc.h"
 
 
 struct game_data_t
@@ -14,7 +15,7 @@ struct game_data_t
 
 Game_Data gameCreate(Winner winner, Player_Id player1, Player_Id player2, Time time)
 {
-    Game_Data game_data = malloc(sizeof(*game_data));
+    Game_Data game_data = accountedMalloc(sizeof(*game_data), CHESS_MEMORY_GAMES);
     if (game_data == NULL)
     {
         return NULL;
@@ -33,7 +34,12 @@ void gameDestroy(MapDataElement game_data)
     {
         return;
     }
-    free(game_data);
+    accountedFree(game_data, sizeof(struct game_data_t), CHESS_MEMORY_GAMES);
+}
+
+size_t gameAllocationSize()
+{
+    return sizeof(struct game_data_t);
 }
 
 static Game_Data gameCopyInternal(Game_Data game_data)
@@ -100,7 +106,7 @@ static void playerListUpdateAfterRemovePlayer(Winner result, Map playerList, Map
     }
 }
 
-void gameRemovePlayer(Game_Data game_data, Player_Id player, Map playerList)
+void gameRemovePlayer(Game_Data game_data, Player_Id player, Map playerList, Map totalPlayerList)
 {
     if (game_data == NULL || playerList == NULL)
     {
@@ -115,6 +121,10 @@ void gameRemovePlayer(Game_Data game_data, Player_Id player, Map playerList)
         if (game_data->player2 != DELETE_PLAYER && gameGetWinner(game_data) != SECOND_PLAYER)
         {
             playerListUpdateAfterRemovePlayer(game_data->winner, playerList, &game_data->player2);
+            if (totalPlayerList != NULL)
+            {
+                playerListUpdateAfterRemovePlayer(game_data->winner, totalPlayerList, &game_data->player2);
+            }
             game_data->winner = SECOND_PLAYER;
         }
         game_data->player1 = DELETE_PLAYER;
@@ -124,6 +134,10 @@ void gameRemovePlayer(Game_Data game_data, Player_Id player, Map playerList)
         if (game_data->player1 != DELETE_PLAYER && gameGetWinner(game_data) != FIRST_PLAYER)
         {
             playerListUpdateAfterRemovePlayer(game_data->winner, playerList, &game_data->player1);
+            if (totalPlayerList != NULL)
+            {
+                playerListUpdateAfterRemovePlayer(game_data->winner, totalPlayerList, &game_data->player1);
+            }
             game_data->winner = FIRST_PLAYER;
         }
         game_data->player2 = DELETE_PLAYER;
@@ -138,3 +152,46 @@ Time gameGetTime(Game_Data game_data)
     }
     return game_data->time;
 }
+
+Player_Id gameGetFirstPlayer(Game_Data game_data)
+{
+    if (game_data == NULL)
+    {
+        return DELETE_PLAYER;
+    }
+    return game_data->player1;
+}
+
+Player_Id gameGetSecondPlayer(Game_Data game_data)
+{
+    if (game_data == NULL)
+    {
+        return DELETE_PLAYER;
+    }
+    return game_data->player2;
+}
+
+bool gameSnapshotWrite(Game_Data game_data, SnapshotWriter writer)
+{
+    if (game_data == NULL || writer == NULL)
+    {
+        return false;
+    }
+    return snapshotWriteInt(writer, game_data->player1) &&
+           snapshotWriteInt(writer, game_data->player2) &&
+           snapshotWriteInt(writer, game_data->winner) &&
+           snapshotWriteInt(writer, game_data->time);
+}
+
+bool gameSnapshotRead(Game_Data game_data, SnapshotReader reader)
+{
+    if (game_data == NULL || reader == NULL)
+    {
+        return false;
+    }
+    game_data->player1 = snapshotReadInt(reader);
+    game_data->player2 = snapshotReadInt(reader);
+    game_data->winner = snapshotReadInt(reader);
+    game_data->time = snapshotReadInt(reader);
+    return snapshotReaderFailed(reader) == false;
+}
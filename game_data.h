@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include "player_data.h"
+#include "chess_snapshot.h"
 
 #define ZERO_POINTS 0
 #define ONE_POINT 1
@@ -19,6 +20,11 @@
 *   gameRemovePlayer     - Removes a player,identified by his id, from the game and sets the other
 *                          player stutus accordingly.        
 *   gameGetTime	-        - Returns the amount of time the game took.
+*   gameGetFirstPlayer   - Returns the id of the first player.
+*   gameGetSecondPlayer  - Returns the id of the second player.
+*   gameSnapshotWrite    - Appends the game to a binary snapshot.
+*   gameSnapshotRead     - Overwrites a game with the next game of a binary snapshot.
+*   gameAllocationSize   - Returns the number of bytes allocated for one game.
 */
 
 /** Type for defining the game_data */
@@ -51,6 +57,14 @@ Game_Data gameCreate(Winner winner, Player_Id player1, Player_Id player2, Time t
 */
 void gameDestroy(MapDataElement game_data);
 
+/**
+* gameAllocationSize: Returns the number of bytes allocated for one game.
+*
+* @return
+* 	The size of a game.
+*/
+size_t gameAllocationSize();
+
 /**
 * gameCopy: Creates a copy of target game.
 *
@@ -80,9 +94,10 @@ bool gameContains(Game_Data game_data, Player_Id player);
 * @param game_data -The game to remove player elements from.
 * @param player -The player to find and remove from the game.
 * @param playerList -The player list to be updated according to the new statistics.
+* @param totalPlayerList -The system totals of the players, updated the same way. May be NULL.
 *
 */
-void gameRemovePlayer(Game_Data game_data, Player_Id player, Map playerList);
+void gameRemovePlayer(Game_Data game_data, Player_Id player, Map playerList, Map totalPlayerList);
 
 /**
 * gameGetWinner: Returns the winner of the game.
@@ -103,4 +118,47 @@ Player_Id gameGetWinner(Game_Data game_data);
 */
 Time gameGetTime(Game_Data game_data);
 
+/**
+* gameGetFirstPlayer: Returns the id of the first player of the game.
+*
+* @param game_data - The game.
+* @return
+* 	DELETE_PLAYER - if a NULL was sent as input, or the player was removed.
+*   The first player id otherwise.
+*/
+Player_Id gameGetFirstPlayer(Game_Data game_data);
+
+/**
+* gameGetSecondPlayer: Returns the id of the second player of the game.
+*
+* @param game_data - The game.
+* @return
+* 	DELETE_PLAYER - if a NULL was sent as input, or the player was removed.
+*   The second player id otherwise.
+*/
+Player_Id gameGetSecondPlayer(Game_Data game_data);
+
+/**
+* gameSnapshotWrite: Appends the game's players, winner and time to a binary snapshot.
+*
+* @param game_data - The game to write.
+* @param writer - The snapshot writer.
+* @return
+* 	false - if the input is NULL or the snapshot could not grow.
+* 	true - otherwise.
+*/
+bool gameSnapshotWrite(Game_Data game_data, SnapshotWriter writer);
+
+/**
+* gameSnapshotRead: Overwrites an existing game with the next game of a binary snapshot.
+*   Reusing one game for a whole snapshot saves an allocation per loaded game.
+*
+* @param game_data - The game to overwrite.
+* @param reader - The snapshot reader.
+* @return
+* 	false - if the input is NULL or the snapshot is truncated.
+* 	true - otherwise.
+*/
+bool gameSnapshotRead(Game_Data game_data, SnapshotReader reader);
+
 #endif
\ No newline at end of file
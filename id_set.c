@@ -0,0 +1,618 @@
+#include <stdlib.h>
+#include <string.h>
+#include "id_set.h"
+#include "chess_utilities.h"
+
+#define LOW_BITS 16
+#define LOW_MASK 0xFFFF
+#define WORD_BITS 64
+#define BITMAP_WORDS ((LOW_MASK + 1) / WORD_BITS)
+#define MINIMUM_CAPACITY 4
+#define EXPAND 2
+
+/**
+ * The ids of a set with the same high bits. The low bits are in values, sorted, while there are
+ * at most ID_ARRAY_MAX of them, and in bits otherwise. capacity is the number of values allocated,
+ * 0 for a bitmap.
+ */
+typedef struct
+{
+    int high;
+    int cardinality;
+    int capacity;
+    unsigned short *values;
+    unsigned long long *bits;
+} IdContainer;
+
+struct id_set_t
+{
+    IdContainer *containers;
+    int size;
+    int capacity;
+};
+
+/** The sets of the keys, by key. A key whose set became empty is removed */
+struct id_set_table_t
+{
+    HashTable sets;
+};
+
+/**
+ * bitmapSize: Returns the bytes of a bitmap container.
+ */
+static size_t bitmapSize()
+{
+    return sizeof(unsigned long long) * BITMAP_WORDS;
+}
+
+/**
+ * containerPosition: Binary searches the first container of a set with high bits not less than high.
+ */
+static int containerPosition(IdSet set, int high)
+{
+    int low = 0, end = set->size;
+    while (low < end)
+    {
+        int middle = low + (end - low) / 2;
+        if (set->containers[middle].high < high)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            end = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * valuePosition: Binary searches the first value of an array container not less than a value.
+ */
+static int valuePosition(const IdContainer *container, unsigned short value)
+{
+    int low = 0, end = container->cardinality;
+    while (low < end)
+    {
+        int middle = low + (end - low) / 2;
+        if (container->values[middle] < value)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            end = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * containerContains: Checks if the low bits of an id are in a container.
+ */
+static bool containerContains(const IdContainer *container, unsigned short value)
+{
+    if (container->bits != NULL)
+    {
+        return (container->bits[value / WORD_BITS] >> (value % WORD_BITS)) & 1;
+    }
+    int position = valuePosition(container, value);
+    return position < container->cardinality && container->values[position] == value;
+}
+
+/**
+ * freeContainer: Frees the values or the bits of a container.
+ */
+static void freeContainer(IdContainer *container)
+{
+    accountedFree(container->values, sizeof(*container->values) * container->capacity, CHESS_MEMORY_INDEXES);
+    accountedFree(container->bits, bitmapSize(), CHESS_MEMORY_INDEXES);
+    container->values = NULL;
+    container->bits = NULL;
+    container->capacity = 0;
+}
+
+/**
+ * toBitmap: Moves the values of a full array container to a bitmap.
+ *
+ * @param container - The container.
+ * @return
+ *     false if the allocation failed, true otherwise.
+ */
+static bool toBitmap(IdContainer *container)
+{
+    unsigned long long *bits = accountedMalloc(bitmapSize(), CHESS_MEMORY_INDEXES);
+    if (bits == NULL)
+    {
+        return false;
+    }
+    memset(bits, 0, bitmapSize());
+    for (int i = 0; i < container->cardinality; i++)
+    {
+        bits[container->values[i] / WORD_BITS] |= 1ULL << (container->values[i] % WORD_BITS);
+    }
+    freeContainer(container);
+    container->bits = bits;
+    return true;
+}
+
+/**
+ * toArray: Moves the values of a bitmap container that became sparse to an array. The container
+ * stays a bitmap if the allocation fails.
+ *
+ * @param container - The container.
+ */
+static void toArray(IdContainer *container)
+{
+    unsigned short *values = accountedMalloc(sizeof(*values) * ID_ARRAY_MAX, CHESS_MEMORY_INDEXES);
+    if (values == NULL)
+    {
+        return;
+    }
+    int size = 0;
+    for (int word = 0; word < BITMAP_WORDS; word++)
+    {
+        for (unsigned long long bits = container->bits[word]; bits != 0; bits &= bits - 1)
+        {
+            values[size++] = (unsigned short)(word * WORD_BITS + __builtin_ctzll(bits));
+        }
+    }
+    freeContainer(container);
+    container->values = values;
+    container->capacity = ID_ARRAY_MAX;
+}
+
+/**
+ * containerAdd: Adds the low bits of an id to a container that does not have them.
+ *
+ * @param container - The container.
+ * @param value - The low bits.
+ * @return
+ *     false if an allocation failed, true otherwise.
+ */
+static bool containerAdd(IdContainer *container, unsigned short value)
+{
+    if (container->bits == NULL && container->cardinality == ID_ARRAY_MAX && toBitmap(container) == false)
+    {
+        return false;
+    }
+    if (container->bits != NULL)
+    {
+        container->bits[value / WORD_BITS] |= 1ULL << (value % WORD_BITS);
+        container->cardinality++;
+        return true;
+    }
+    if (container->cardinality == container->capacity)
+    {
+        int capacity = container->capacity == 0 ? MINIMUM_CAPACITY : container->capacity * EXPAND;
+        capacity = capacity > ID_ARRAY_MAX ? ID_ARRAY_MAX : capacity;
+        unsigned short *values = accountedRealloc(container->values, sizeof(*values) * container->capacity,
+                                                  sizeof(*values) * capacity, CHESS_MEMORY_INDEXES);
+        if (values == NULL)
+        {
+            return false;
+        }
+        container->values = values;
+        container->capacity = capacity;
+    }
+    int position = valuePosition(container, value);
+    memmove(container->values + position + 1, container->values + position,
+            sizeof(*container->values) * (container->cardinality - position));
+    container->values[position] = value;
+    container->cardinality++;
+    return true;
+}
+
+/**
+ * containerRemove: Removes the low bits of an id from a container that has them.
+ */
+static void containerRemove(IdContainer *container, unsigned short value)
+{
+    container->cardinality--;
+    if (container->bits != NULL)
+    {
+        container->bits[value / WORD_BITS] &= ~(1ULL << (value % WORD_BITS));
+        if (container->cardinality <= ID_ARRAY_MAX)
+        {
+            toArray(container);
+        }
+        return;
+    }
+    int position = valuePosition(container, value);
+    memmove(container->values + position, container->values + position + 1,
+            sizeof(*container->values) * (container->cardinality - position));
+}
+
+IdSet idSetCreate()
+{
+    IdSet set = accountedMalloc(sizeof(*set), CHESS_MEMORY_INDEXES);
+    if (set == NULL)
+    {
+        return NULL;
+    }
+    set->containers = NULL;
+    set->size = 0;
+    set->capacity = 0;
+    return set;
+}
+
+void idSetDestroy(IdSet set)
+{
+    if (set == NULL)
+    {
+        return;
+    }
+    for (int i = 0; i < set->size; i++)
+    {
+        freeContainer(&set->containers[i]);
+    }
+    accountedFree(set->containers, sizeof(*set->containers) * set->capacity, CHESS_MEMORY_INDEXES);
+    accountedFree(set, sizeof(*set), CHESS_MEMORY_INDEXES);
+}
+
+IdSet idSetCopy(IdSet set)
+{
+    if (set == NULL)
+    {
+        return NULL;
+    }
+    IdSet copy = idSetCreate();
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+    if (set->size == 0)
+    {
+        return copy;
+    }
+    copy->containers = accountedMalloc(sizeof(*copy->containers) * set->size, CHESS_MEMORY_INDEXES);
+    if (copy->containers == NULL)
+    {
+        idSetDestroy(copy);
+        return NULL;
+    }
+    copy->capacity = set->size;
+    for (int i = 0; i < set->size; i++)
+    {
+        const IdContainer *source = &set->containers[i];
+        IdContainer *container = &copy->containers[i];
+        *container = *source;
+        size_t bytes = source->bits != NULL ? bitmapSize() : sizeof(*source->values) * source->capacity;
+        void *data = accountedMalloc(bytes, CHESS_MEMORY_INDEXES);
+        container->values = source->bits != NULL ? NULL : data;
+        container->bits = source->bits != NULL ? data : NULL;
+        if (data == NULL)
+        {
+            container->capacity = 0;
+            copy->size = i;
+            idSetDestroy(copy);
+            return NULL;
+        }
+        memcpy(data, source->bits != NULL ? (void *)source->bits : (void *)source->values, bytes);
+    }
+    copy->size = set->size;
+    return copy;
+}
+
+bool idSetAdd(IdSet set, int id)
+{
+    if (set == NULL)
+    {
+        return false;
+    }
+    int high = (int)((unsigned int)id >> LOW_BITS);
+    unsigned short value = (unsigned short)(id & LOW_MASK);
+    int position = containerPosition(set, high);
+    if (position < set->size && set->containers[position].high == high)
+    {
+        return containerContains(&set->containers[position], value) ||
+               containerAdd(&set->containers[position], value);
+    }
+    if (set->size == set->capacity)
+    {
+        int capacity = set->capacity == 0 ? 1 : set->capacity * EXPAND;
+        IdContainer *containers = accountedRealloc(set->containers, sizeof(*containers) * set->capacity,
+                                                   sizeof(*containers) * capacity, CHESS_MEMORY_INDEXES);
+        if (containers == NULL)
+        {
+            return false;
+        }
+        set->containers = containers;
+        set->capacity = capacity;
+    }
+    IdContainer container = {high, 0, 0, NULL, NULL};
+    if (containerAdd(&container, value) == false)
+    {
+        return false;
+    }
+    memmove(set->containers + position + 1, set->containers + position,
+            sizeof(*set->containers) * (set->size - position));
+    set->containers[position] = container;
+    set->size++;
+    return true;
+}
+
+void idSetRemove(IdSet set, int id)
+{
+    if (set == NULL)
+    {
+        return;
+    }
+    int high = (int)((unsigned int)id >> LOW_BITS);
+    unsigned short value = (unsigned short)(id & LOW_MASK);
+    int position = containerPosition(set, high);
+    if (position == set->size || set->containers[position].high != high ||
+        containerContains(&set->containers[position], value) == false)
+    {
+        return;
+    }
+    containerRemove(&set->containers[position], value);
+    if (set->containers[position].cardinality == 0)
+    {
+        freeContainer(&set->containers[position]);
+        memmove(set->containers + position, set->containers + position + 1,
+                sizeof(*set->containers) * (set->size - position - 1));
+        set->size--;
+    }
+}
+
+bool idSetContains(IdSet set, int id)
+{
+    if (set == NULL)
+    {
+        return false;
+    }
+    int high = (int)((unsigned int)id >> LOW_BITS);
+    int position = containerPosition(set, high);
+    return position < set->size && set->containers[position].high == high &&
+           containerContains(&set->containers[position], (unsigned short)(id & LOW_MASK));
+}
+
+/**
+ * emitId: Stores an id of a copy or an intersection if there is room for it, and counts it.
+ */
+static void emitId(int *out_ids, int capacity, int *count, int high, int value)
+{
+    if (*count < capacity)
+    {
+        out_ids[*count] = (high << LOW_BITS) | value;
+    }
+    (*count)++;
+}
+
+/**
+ * intersectContainers: Adds the ids of two containers with the same high bits that are in both.
+ */
+static void intersectContainers(const IdContainer *first, const IdContainer *second, int *out_ids, int capacity,
+                                int *count)
+{
+    if (first->bits != NULL && second->bits != NULL)
+    {
+        for (int word = 0; word < BITMAP_WORDS; word++)
+        {
+            for (unsigned long long bits = first->bits[word] & second->bits[word]; bits != 0; bits &= bits - 1)
+            {
+                emitId(out_ids, capacity, count, first->high, word * WORD_BITS + __builtin_ctzll(bits));
+            }
+        }
+        return;
+    }
+    if (first->bits != NULL || second->bits != NULL)
+    {
+        const IdContainer *array = first->bits != NULL ? second : first;
+        const IdContainer *bitmap = first->bits != NULL ? first : second;
+        for (int i = 0; i < array->cardinality; i++)
+        {
+            if (containerContains(bitmap, array->values[i]))
+            {
+                emitId(out_ids, capacity, count, first->high, array->values[i]);
+            }
+        }
+        return;
+    }
+    int i = 0, j = 0;
+    while (i < first->cardinality && j < second->cardinality)
+    {
+        if (first->values[i] < second->values[j])
+        {
+            i++;
+        }
+        else if (first->values[i] > second->values[j])
+        {
+            j++;
+        }
+        else
+        {
+            emitId(out_ids, capacity, count, first->high, first->values[i]);
+            i++;
+            j++;
+        }
+    }
+}
+
+int idSetSize(IdSet set)
+{
+    int size = 0;
+    for (int i = 0; set != NULL && i < set->size; i++)
+    {
+        size += set->containers[i].cardinality;
+    }
+    return size;
+}
+
+int idSetCopyIds(IdSet set, int *out_ids, int capacity)
+{
+    int count = 0;
+    for (int i = 0; set != NULL && i < set->size; i++)
+    {
+        const IdContainer *container = &set->containers[i];
+        if (container->bits == NULL)
+        {
+            for (int j = 0; j < container->cardinality; j++)
+            {
+                emitId(out_ids, capacity, &count, container->high, container->values[j]);
+            }
+            continue;
+        }
+        for (int word = 0; word < BITMAP_WORDS; word++)
+        {
+            for (unsigned long long bits = container->bits[word]; bits != 0; bits &= bits - 1)
+            {
+                emitId(out_ids, capacity, &count, container->high, word * WORD_BITS + __builtin_ctzll(bits));
+            }
+        }
+    }
+    return count;
+}
+
+int idSetIntersect(IdSet first, IdSet second, int *out_ids, int capacity)
+{
+    int count = 0;
+    if (first == NULL || second == NULL)
+    {
+        return count;
+    }
+    int i = 0, j = 0;
+    while (i < first->size && j < second->size)
+    {
+        if (first->containers[i].high < second->containers[j].high)
+        {
+            i++;
+        }
+        else if (first->containers[i].high > second->containers[j].high)
+        {
+            j++;
+        }
+        else
+        {
+            intersectContainers(&first->containers[i++], &second->containers[j++], out_ids, capacity, &count);
+        }
+    }
+    return count;
+}
+
+void idSetMemoryUsage(IdSet set, ChessMemoryFootprint *footprint)
+{
+    if (set == NULL || footprint == NULL)
+    {
+        return;
+    }
+    memoryFootprintAdd(footprint, CHESS_MEMORY_INDEXES, sizeof(*set), 1);
+    if (set->containers != NULL)
+    {
+        memoryFootprintAdd(footprint, CHESS_MEMORY_INDEXES, sizeof(*set->containers) * set->capacity, 1);
+    }
+    for (int i = 0; i < set->size; i++)
+    {
+        const IdContainer *container = &set->containers[i];
+        if (container->bits != NULL)
+        {
+            memoryFootprintAdd(footprint, CHESS_MEMORY_INDEXES, bitmapSize(), 1);
+        }
+        else if (container->values != NULL)
+        {
+            memoryFootprintAdd(footprint, CHESS_MEMORY_INDEXES, sizeof(*container->values) * container->capacity, 1);
+        }
+    }
+}
+
+IdSetTable idSetTableCreate()
+{
+    IdSetTable table = accountedMalloc(sizeof(*table), CHESS_MEMORY_INDEXES);
+    if (table == NULL)
+    {
+        return NULL;
+    }
+    table->sets = hashTableCreate(sizeof(IdSet), CHESS_MEMORY_INDEXES);
+    if (table->sets == NULL)
+    {
+        accountedFree(table, sizeof(*table), CHESS_MEMORY_INDEXES);
+        return NULL;
+    }
+    return table;
+}
+
+void idSetTableDestroy(IdSetTable table)
+{
+    if (table == NULL)
+    {
+        return;
+    }
+    int position = 0;
+    for (IdSet *set = hashTableNext(table->sets, &position, NULL); set != NULL;
+         set = hashTableNext(table->sets, &position, NULL))
+    {
+        idSetDestroy(*set);
+    }
+    hashTableDestroy(table->sets);
+    accountedFree(table, sizeof(*table), CHESS_MEMORY_INDEXES);
+}
+
+IdSet idSetTableGet(IdSetTable table, int key)
+{
+    if (table == NULL)
+    {
+        return NULL;
+    }
+    IdSet *set = hashTableGet(table->sets, (unsigned int)key);
+    return set == NULL ? NULL : *set;
+}
+
+bool idSetTableAdd(IdSetTable table, int key, int id)
+{
+    if (table == NULL)
+    {
+        return false;
+    }
+    IdSet *set = hashTablePut(table->sets, (unsigned int)key);
+    if (set == NULL)
+    {
+        return false;
+    }
+    if (*set == NULL && (*set = idSetCreate()) == NULL)
+    {
+        hashTableRemove(table->sets, (unsigned int)key);
+        return false;
+    }
+    if (idSetAdd(*set, id) == false)
+    {
+        if ((*set)->size == 0)
+        {
+            idSetDestroy(*set);
+            hashTableRemove(table->sets, (unsigned int)key);
+        }
+        return false;
+    }
+    return true;
+}
+
+void idSetTableRemove(IdSetTable table, int key, int id)
+{
+    IdSet *set = table == NULL ? NULL : hashTableGet(table->sets, (unsigned int)key);
+    if (set == NULL)
+    {
+        return;
+    }
+    idSetRemove(*set, id);
+    if ((*set)->size == 0)
+    {
+        idSetDestroy(*set);
+        hashTableRemove(table->sets, (unsigned int)key);
+    }
+}
+
+void idSetTableMemoryUsage(IdSetTable table, ChessMemoryFootprint *footprint)
+{
+    if (table == NULL || footprint == NULL)
+    {
+        return;
+    }
+    memoryFootprintAdd(footprint, CHESS_MEMORY_INDEXES, sizeof(*table), 1);
+    hashTableMemoryUsage(table->sets, footprint);
+    int position = 0;
+    for (IdSet *set = hashTableNext(table->sets, &position, NULL); set != NULL;
+         set = hashTableNext(table->sets, &position, NULL))
+    {
+        idSetMemoryUsage(*set, footprint);
+    }
+}
@@ -0,0 +1,198 @@
+#ifndef ID_SET_H
+#define ID_SET_H
+#include <stdbool.h>
+#include "chess_alloc.h"
+
+/*
+* Compressed sets of positive ids, in the layout of roaring bitmaps.
+*
+* The ids are split by their high 16 bits into containers, kept sorted by those bits. A container
+* holds the low 16 bits of its ids in a sorted array while it has at most ID_ARRAY_MAX of them, and
+* in a bitmap of all 65536 values when it has more, so a set takes about 2 bytes an id when sparse
+* and 1 bit an id when dense. A membership check is a binary search over the few containers and a
+* bit test or a search of at most ID_ARRAY_MAX values. Two sets are intersected container by
+* container: merging two arrays, testing the values of an array in a bitmap, or a word by word AND
+* of two bitmaps.
+*
+* A table of sets maps an id (such as a player) to a set (such as the tournaments of the player).
+*
+* The following functions are available:
+*   idSetCreate             - Creates an empty set
+*   idSetDestroy            - Deletes a set
+*   idSetCopy               - Copies a set
+*   idSetAdd                - Adds an id to a set
+*   idSetRemove             - Removes an id from a set
+*   idSetContains           - Checks if an id is in a set
+*   idSetSize               - Returns the number of ids in a set
+*   idSetCopyIds            - Copies the ids of a set
+*   idSetIntersect          - Copies the ids that are in two sets
+*   idSetMemoryUsage        - Adds the memory of a set to a footprint
+*   idSetTableCreate        - Creates an empty table of sets
+*   idSetTableDestroy       - Deletes a table of sets and its sets
+*   idSetTableGet           - Returns the set of a key
+*   idSetTableAdd           - Adds an id to the set of a key
+*   idSetTableRemove        - Removes an id from the set of a key
+*   idSetTableMemoryUsage   - Adds the memory of a table and its sets to a footprint
+*/
+
+#define ID_ARRAY_MAX 4096
+
+/** Type for defining a set of ids */
+typedef struct id_set_t *IdSet;
+
+/** Type for defining a table of sets of ids, by key */
+typedef struct id_set_table_t *IdSetTable;
+
+/**
+* idSetCreate: Allocates an empty set.
+*
+* @return
+* 	NULL - if allocations failed.
+* 	A new set in case of success.
+*/
+IdSet idSetCreate();
+
+/**
+* idSetDestroy: Deallocates a set.
+*
+* @param set - Target set. If set is NULL nothing will be done.
+*/
+void idSetDestroy(IdSet set);
+
+/**
+* idSetCopy: Creates a copy of a set.
+*
+* @param set - Target set.
+* @return
+* 	NULL if a NULL was sent or a memory allocation failed.
+* 	A new set with the same ids otherwise.
+*/
+IdSet idSetCopy(IdSet set);
+
+/**
+* idSetAdd: Adds an id to a set. Adding an id that is in the set does nothing.
+*
+* @param set - The set.
+* @param id - The id. Must be positive.
+* @return
+* 	false - if the input is NULL or an allocation failed.
+* 	true - otherwise.
+*/
+bool idSetAdd(IdSet set, int id);
+
+/**
+* idSetRemove: Removes an id from a set. Removing an id that is not in the set does nothing.
+*
+* @param set - The set. If set is NULL nothing will be done.
+* @param id - The id.
+*/
+void idSetRemove(IdSet set, int id);
+
+/**
+* idSetContains: Checks if an id is in a set.
+*
+* @param set - The set.
+* @param id - The id.
+* @return
+* 	false - if set is NULL or the id is not in it.
+* 	true - otherwise.
+*/
+bool idSetContains(IdSet set, int id);
+
+/**
+* idSetSize: Returns the number of ids in a set.
+*
+* @param set - The set. A NULL set is empty.
+* @return
+* 	The number of ids in the set.
+*/
+int idSetSize(IdSet set);
+
+/**
+* idSetCopyIds: Copies the ids of a set, in increasing order.
+*
+* @param set - The set. A NULL set is empty.
+* @param out_ids - Where to copy the ids.
+* @param capacity - The number of ids out_ids holds. Ids after it are counted but not copied.
+* @return
+* 	The number of ids in the set.
+*/
+int idSetCopyIds(IdSet set, int *out_ids, int capacity);
+
+/**
+* idSetIntersect: Copies the ids that are in both sets, in increasing order.
+*
+* @param first - A set. A NULL set is empty.
+* @param second - Another set. A NULL set is empty.
+* @param out_ids - Where to copy the ids.
+* @param capacity - The number of ids out_ids holds. Ids after it are counted but not copied.
+* @return
+* 	The number of ids in both sets.
+*/
+int idSetIntersect(IdSet first, IdSet second, int *out_ids, int capacity);
+
+/**
+* idSetMemoryUsage: Adds the memory of a set to a footprint.
+*
+* @param set - The set. If set is NULL nothing will be added.
+* @param footprint - The footprint to add to.
+*/
+void idSetMemoryUsage(IdSet set, ChessMemoryFootprint *footprint);
+
+/**
+* idSetTableCreate: Allocates an empty table of sets.
+*
+* @return
+* 	NULL - if allocations failed.
+* 	A new table in case of success.
+*/
+IdSetTable idSetTableCreate();
+
+/**
+* idSetTableDestroy: Deallocates a table and its sets.
+*
+* @param table - Target table. If table is NULL nothing will be done.
+*/
+void idSetTableDestroy(IdSetTable table);
+
+/**
+* idSetTableGet: Returns the set of a key.
+*
+* @param table - The table.
+* @param key - The key.
+* @return
+* 	NULL - if the input is NULL or the set of the key is empty.
+* 	The set otherwise.
+*/
+IdSet idSetTableGet(IdSetTable table, int key);
+
+/**
+* idSetTableAdd: Adds an id to the set of a key, creating the set if needed.
+*
+* @param table - The table.
+* @param key - The key. Must be positive.
+* @param id - The id. Must be positive.
+* @return
+* 	false - if the input is NULL or an allocation failed.
+* 	true - otherwise.
+*/
+bool idSetTableAdd(IdSetTable table, int key, int id);
+
+/**
+* idSetTableRemove: Removes an id from the set of a key, and frees the set once it is empty.
+*
+* @param table - The table. If table is NULL nothing will be done.
+* @param key - The key.
+* @param id - The id.
+*/
+void idSetTableRemove(IdSetTable table, int key, int id);
+
+/**
+* idSetTableMemoryUsage: Adds the memory of a table and its sets to a footprint.
+*
+* @param table - The table. If table is NULL nothing will be added.
+* @param footprint - The footprint to add to.
+*/
+void idSetTableMemoryUsage(IdSetTable table, ChessMemoryFootprint *footprint);
+
+#endif
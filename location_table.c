@@ -0,0 +1,319 @@
+#include <stdlib.h>
+#include <string.h>
+#include "location_table.h"
+
+#define MINIMUM_BUCKETS 16
+#define MINIMUM_CAPACITY 4
+#define EXPAND 2
+#define FNV_OFFSET 2166136261U
+#define FNV_PRIME 16777619U
+
+/** A location, its references, its tournaments and its name, in one allocation */
+struct shared_location_t
+{
+    SharedLocation next;
+    LocationTable table;
+    unsigned int hash;
+    int references;
+    int *tournament_ids;
+    int number_of_tournaments;
+    int capacity;
+    size_t length;
+    char name[];
+};
+
+/** The locations are chained in buckets by the hash of their names */
+struct location_table_t
+{
+    SharedLocation *buckets;
+    int number_of_buckets;
+    int number_of_locations;
+};
+
+/**
+ * hashName: Returns the FNV-1a hash of a name, and its length.
+ */
+static unsigned int hashName(const char *name, size_t *length)
+{
+    unsigned int hash = FNV_OFFSET;
+    const unsigned char *current = (const unsigned char *)name;
+    for (; *current != '\0'; current++)
+    {
+        hash = (hash ^ *current) * FNV_PRIME;
+    }
+    *length = (size_t)(current - (const unsigned char *)name);
+    return hash;
+}
+
+/**
+ * locationSize: Returns the bytes of a location with a name of a length.
+ */
+static size_t locationSize(size_t length)
+{
+    return sizeof(struct shared_location_t) + length + 1;
+}
+
+LocationTable locationTableCreate()
+{
+    LocationTable table = accountedMalloc(sizeof(*table), CHESS_MEMORY_LOCATIONS);
+    if (table == NULL)
+    {
+        return NULL;
+    }
+    table->buckets = accountedMalloc(sizeof(*table->buckets) * MINIMUM_BUCKETS, CHESS_MEMORY_LOCATIONS);
+    if (table->buckets == NULL)
+    {
+        accountedFree(table, sizeof(*table), CHESS_MEMORY_LOCATIONS);
+        return NULL;
+    }
+    memset(table->buckets, 0, sizeof(*table->buckets) * MINIMUM_BUCKETS);
+    table->number_of_buckets = MINIMUM_BUCKETS;
+    table->number_of_locations = 0;
+    return table;
+}
+
+void locationTableDestroy(LocationTable table)
+{
+    if (table == NULL)
+    {
+        return;
+    }
+    accountedFree(table->buckets, sizeof(*table->buckets) * table->number_of_buckets, CHESS_MEMORY_LOCATIONS);
+    accountedFree(table, sizeof(*table), CHESS_MEMORY_LOCATIONS);
+}
+
+/**
+ * findLocation: Returns the location of a name in a table.
+ *
+ * @param table - The table.
+ * @param name - The name.
+ * @param hash - The hash of the name.
+ * @param length - The length of the name.
+ * @return
+ *     NULL if the name is not in the table, the location otherwise.
+ */
+static SharedLocation findLocation(LocationTable table, const char *name, unsigned int hash, size_t length)
+{
+    SharedLocation location = table->buckets[hash & (table->number_of_buckets - 1)];
+    while (location != NULL &&
+           (location->hash != hash || location->length != length || memcmp(location->name, name, length) != 0))
+    {
+        location = location->next;
+    }
+    return location;
+}
+
+/**
+ * expandTable: Moves the locations of a table to twice the buckets. The table keeps its buckets
+ * if the allocation fails, which only makes the chains longer.
+ *
+ * @param table - The table.
+ */
+static void expandTable(LocationTable table)
+{
+    int number_of_buckets = table->number_of_buckets * EXPAND;
+    SharedLocation *buckets = accountedMalloc(sizeof(*buckets) * number_of_buckets, CHESS_MEMORY_LOCATIONS);
+    if (buckets == NULL)
+    {
+        return;
+    }
+    memset(buckets, 0, sizeof(*buckets) * number_of_buckets);
+    for (int bucket = 0; bucket < table->number_of_buckets; bucket++)
+    {
+        SharedLocation location = table->buckets[bucket];
+        while (location != NULL)
+        {
+            SharedLocation next = location->next;
+            SharedLocation *chain = &buckets[location->hash & (number_of_buckets - 1)];
+            location->next = *chain;
+            *chain = location;
+            location = next;
+        }
+    }
+    accountedFree(table->buckets, sizeof(*table->buckets) * table->number_of_buckets, CHESS_MEMORY_LOCATIONS);
+    table->buckets = buckets;
+    table->number_of_buckets = number_of_buckets;
+}
+
+SharedLocation locationIntern(LocationTable table, const char *name)
+{
+    if (table == NULL || name == NULL)
+    {
+        return NULL;
+    }
+    size_t length;
+    unsigned int hash = hashName(name, &length);
+    SharedLocation location = findLocation(table, name, hash, length);
+    if (location != NULL)
+    {
+        location->references++;
+        return location;
+    }
+    location = accountedMalloc(locationSize(length), CHESS_MEMORY_LOCATIONS);
+    if (location == NULL)
+    {
+        return NULL;
+    }
+    location->table = table;
+    location->hash = hash;
+    location->references = 1;
+    location->tournament_ids = NULL;
+    location->number_of_tournaments = 0;
+    location->capacity = 0;
+    location->length = length;
+    memcpy(location->name, name, length + 1);
+    if (table->number_of_locations >= table->number_of_buckets)
+    {
+        expandTable(table);
+    }
+    SharedLocation *chain = &table->buckets[hash & (table->number_of_buckets - 1)];
+    location->next = *chain;
+    *chain = location;
+    table->number_of_locations++;
+    return location;
+}
+
+SharedLocation locationFind(LocationTable table, const char *name)
+{
+    if (table == NULL || name == NULL)
+    {
+        return NULL;
+    }
+    size_t length;
+    unsigned int hash = hashName(name, &length);
+    return findLocation(table, name, hash, length);
+}
+
+void locationRetain(SharedLocation location)
+{
+    if (location != NULL)
+    {
+        location->references++;
+    }
+}
+
+void locationRelease(SharedLocation location)
+{
+    if (location == NULL || --location->references > 0)
+    {
+        return;
+    }
+    LocationTable table = location->table;
+    SharedLocation *link = &table->buckets[location->hash & (table->number_of_buckets - 1)];
+    while (*link != location)
+    {
+        link = &(*link)->next;
+    }
+    *link = location->next;
+    table->number_of_locations--;
+    accountedFree(location->tournament_ids, sizeof(int) * location->capacity, CHESS_MEMORY_LOCATIONS);
+    accountedFree(location, locationSize(location->length), CHESS_MEMORY_LOCATIONS);
+}
+
+const char *locationName(SharedLocation location)
+{
+    return location == NULL ? NULL : location->name;
+}
+
+/**
+ * tournamentPosition: Binary searches the first tournament of a location with an id not less than an id.
+ *
+ * @param location - The location.
+ * @param tournament_id - The id.
+ * @return
+ *     The index of the tournament, number_of_tournaments if there is none.
+ */
+static int tournamentPosition(SharedLocation location, int tournament_id)
+{
+    int low = 0, high = location->number_of_tournaments;
+    while (low < high)
+    {
+        int middle = low + (high - low) / 2;
+        if (location->tournament_ids[middle] < tournament_id)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+bool locationAddTournament(SharedLocation location, int tournament_id)
+{
+    if (location == NULL)
+    {
+        return false;
+    }
+    if (location->number_of_tournaments == location->capacity)
+    {
+        int capacity = location->capacity == 0 ? MINIMUM_CAPACITY : location->capacity * EXPAND;
+        int *tournament_ids = accountedRealloc(location->tournament_ids, sizeof(int) * location->capacity,
+                                               sizeof(int) * capacity, CHESS_MEMORY_LOCATIONS);
+        if (tournament_ids == NULL)
+        {
+            return false;
+        }
+        location->tournament_ids = tournament_ids;
+        location->capacity = capacity;
+    }
+    int position = tournamentPosition(location, tournament_id);
+    memmove(location->tournament_ids + position + 1, location->tournament_ids + position,
+            sizeof(int) * (location->number_of_tournaments - position));
+    location->tournament_ids[position] = tournament_id;
+    location->number_of_tournaments++;
+    return true;
+}
+
+void locationRemoveTournament(SharedLocation location, int tournament_id)
+{
+    if (location == NULL)
+    {
+        return;
+    }
+    int position = tournamentPosition(location, tournament_id);
+    if (position == location->number_of_tournaments || location->tournament_ids[position] != tournament_id)
+    {
+        return;
+    }
+    memmove(location->tournament_ids + position, location->tournament_ids + position + 1,
+            sizeof(int) * (location->number_of_tournaments - position - 1));
+    location->number_of_tournaments--;
+}
+
+int locationTournaments(SharedLocation location, int *out_ids, int capacity)
+{
+    if (location == NULL)
+    {
+        return 0;
+    }
+    int count = location->number_of_tournaments < capacity ? location->number_of_tournaments : capacity;
+    if (count > 0)
+    {
+        memcpy(out_ids, location->tournament_ids, sizeof(int) * count);
+    }
+    return location->number_of_tournaments;
+}
+
+void locationTableMemoryUsage(LocationTable table, ChessMemoryFootprint *footprint)
+{
+    if (table == NULL || footprint == NULL)
+    {
+        return;
+    }
+    memoryFootprintAdd(footprint, CHESS_MEMORY_LOCATIONS, sizeof(*table), 1);
+    memoryFootprintAdd(footprint, CHESS_MEMORY_LOCATIONS, sizeof(*table->buckets) * table->number_of_buckets, 1);
+    for (int bucket = 0; bucket < table->number_of_buckets; bucket++)
+    {
+        for (SharedLocation location = table->buckets[bucket]; location != NULL; location = location->next)
+        {
+            memoryFootprintAdd(footprint, CHESS_MEMORY_LOCATIONS, locationSize(location->length), 1);
+            if (location->tournament_ids != NULL)
+            {
+                memoryFootprintAdd(footprint, CHESS_MEMORY_LOCATIONS, sizeof(int) * location->capacity, 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#ifndef LOCATION_TABLE_H
+#define LOCATION_TABLE_H
+#include <stdbool.h>
+#include <stddef.h>
+#include "chess_alloc.h"
+
+/*
+* The locations of a chess system, each kept once and shared by the tournaments held in it.
+*
+* A location is interned in a chained hash table of its name, and counts the references of the
+* tournaments (and their copies) that hold it. It is freed, and leaves the table, with its last
+* reference. A location also keeps the ids of the tournaments held in it in increasing order, so
+* the tournaments of a location are listed without going over the other tournaments.
+*
+* The following functions are available:
+*   locationTableCreate        - Creates an empty table
+*   locationTableDestroy       - Deletes a table
+*   locationIntern             - Returns the location of a name, adding it if needed, with a reference
+*   locationFind               - Returns the location of a name, without a reference
+*   locationRetain             - Adds a reference to a location
+*   locationRelease            - Removes a reference from a location
+*   locationName               - Returns the name of a location
+*   locationAddTournament      - Adds a tournament to the tournaments of a location
+*   locationRemoveTournament   - Removes a tournament from the tournaments of a location
+*   locationTournaments        - Copies the tournaments of a location
+*   locationTableMemoryUsage   - Adds the memory of the table to a footprint
+*/
+
+/** Type for defining the locations of a chess system */
+typedef struct location_table_t *LocationTable;
+
+/** Type for defining a location shared by the tournaments held in it */
+typedef struct shared_location_t *SharedLocation;
+
+/**
+* locationTableCreate: Allocates an empty table.
+*
+* @return
+* 	NULL - if allocations failed.
+* 	A new table in case of success.
+*/
+LocationTable locationTableCreate();
+
+/**
+* locationTableDestroy: Deallocates a table. Its locations must all be released before.
+*
+* @param table - Target table. If table is NULL nothing will be done.
+*/
+void locationTableDestroy(LocationTable table);
+
+/**
+* locationIntern: Returns the location of a name, adding it to the table if it is not there, with
+*   a reference the caller releases with locationRelease.
+*
+* @param table - The table.
+* @param name - The name of the location.
+* @return
+* 	NULL - if the input is NULL or an allocation failed.
+* 	The location otherwise.
+*/
+SharedLocation locationIntern(LocationTable table, const char *name);
+
+/**
+* locationFind: Returns the location of a name, without adding a reference.
+*
+* @param table - The table.
+* @param name - The name of the location.
+* @return
+* 	NULL - if the input is NULL or no tournament holds the location.
+* 	The location otherwise.
+*/
+SharedLocation locationFind(LocationTable table, const char *name);
+
+/**
+* locationRetain: Adds a reference to a location.
+*
+* @param location - The location. If location is NULL nothing will be done.
+*/
+void locationRetain(SharedLocation location);
+
+/**
+* locationRelease: Removes a reference from a location, and frees it with the last reference.
+*
+* @param location - The location. If location is NULL nothing will be done.
+*/
+void locationRelease(SharedLocation location);
+
+/**
+* locationName: Returns the name of a location.
+*
+* @param location - The location.
+* @return
+* 	NULL - if location is NULL.
+* 	The name otherwise.
+*/
+const char *locationName(SharedLocation location);
+
+/**
+* locationAddTournament: Adds a tournament to the tournaments of a location.
+*
+* @param location - The location.
+* @param tournament_id - The tournament.
+* @return
+* 	false - if the input is NULL or an allocation failed.
+* 	true - otherwise.
+*/
+bool locationAddTournament(SharedLocation location, int tournament_id);
+
+/**
+* locationRemoveTournament: Removes a tournament from the tournaments of a location.
+*
+* @param location - The location. If location is NULL nothing will be done.
+* @param tournament_id - The tournament.
+*/
+void locationRemoveTournament(SharedLocation location, int tournament_id);
+
+/**
+* locationTournaments: Copies the tournaments of a location, in increasing id order.
+*
+* @param location - The location. A NULL location has no tournaments.
+* @param out_ids - Where to copy the ids.
+* @param capacity - The number of ids out_ids holds. Ids after it are counted but not copied.
+* @return
+* 	The number of tournaments of the location.
+*/
+int locationTournaments(SharedLocation location, int *out_ids, int capacity);
+
+/**
+* locationTableMemoryUsage: Adds the memory of the table and its locations to a footprint.
+*
+* @param table - The table. If table is NULL nothing will be added.
+* @param footprint - The footprint to add to.
+*/
+void locationTableMemoryUsage(LocationTable table, ChessMemoryFootprint *footprint);
+
+#endif
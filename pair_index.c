@@ -0,0 +1,341 @@
+#include <stdlib.h>
+#include "pair_index.h"
+#include "chess_alloc.h"
+#include "chess_utilities.h"
+
+#define MINIMUM_CAPACITY 16
+#define EXPAND 2
+#define CHAIN_END -1
+#define FREE_RECORD 0
+#define WINNER_MASK 3
+#define ENDED_FLAG 4
+
+/**
+ * A game of a pair of players. The result is the Winner with the lower id as the first player,
+ * and ENDED_FLAG once the tournament ended. A game is in two chains, the games of its pair and
+ * the games of its tournament, and links both ways in each so it leaves them in O(1). Free
+ * records have FREE_RECORD as their tournament, and are chained through next.
+ */
+typedef struct
+{
+    unsigned long long pair;
+    int tournament_id;
+    int play_time;
+    int previous;
+    int next;
+    int tournament_previous;
+    int tournament_next;
+    unsigned char result;
+} PairGame;
+
+/**
+ * heads is a hash table from the pairKey of a pair of players to the newest of its games, and
+ * tournaments is a hash table from a tournament to the newest of its games. A pair or a
+ * tournament whose last game was removed leaves its table.
+ */
+struct pair_index_t
+{
+    HashTable heads;
+    HashTable tournaments;
+    PairGame *games;
+    int games_size;
+    int games_capacity;
+    int free_games;
+};
+
+PairIndex pairIndexCreate()
+{
+    PairIndex index = accountedMalloc(sizeof(*index), CHESS_MEMORY_INDEXES);
+    if (index == NULL)
+    {
+        return NULL;
+    }
+    index->games = NULL;
+    index->games_size = 0;
+    index->games_capacity = 0;
+    index->free_games = CHAIN_END;
+    index->heads = hashTableCreate(sizeof(int), CHESS_MEMORY_INDEXES);
+    index->tournaments = hashTableCreate(sizeof(int), CHESS_MEMORY_INDEXES);
+    if (index->heads == NULL || index->tournaments == NULL)
+    {
+        hashTableDestroy(index->heads);
+        hashTableDestroy(index->tournaments);
+        accountedFree(index, sizeof(*index), CHESS_MEMORY_INDEXES);
+        return NULL;
+    }
+    return index;
+}
+
+void pairIndexDestroy(PairIndex index)
+{
+    if (index == NULL)
+    {
+        return;
+    }
+    hashTableDestroy(index->heads);
+    hashTableDestroy(index->tournaments);
+    accountedFree(index->games, sizeof(*index->games) * index->games_capacity, CHESS_MEMORY_INDEXES);
+    accountedFree(index, sizeof(*index), CHESS_MEMORY_INDEXES);
+}
+
+/**
+ * allocateGame: Takes a record from the free list, or from the end of the pool.
+ *
+ * @param index - The index.
+ * @return
+ *     CHAIN_END if the pool could not grow, the record otherwise.
+ */
+static int allocateGame(PairIndex index)
+{
+    if (index->free_games != CHAIN_END)
+    {
+        int game = index->free_games;
+        index->free_games = index->games[game].next;
+        return game;
+    }
+    if (index->games_size == index->games_capacity)
+    {
+        int capacity = index->games_capacity == 0 ? MINIMUM_CAPACITY : index->games_capacity * EXPAND;
+        PairGame *games = accountedRealloc(index->games, sizeof(*games) * index->games_capacity,
+                                           sizeof(*games) * capacity, CHESS_MEMORY_INDEXES);
+        if (games == NULL)
+        {
+            return CHAIN_END;
+        }
+        index->games = games;
+        index->games_capacity = capacity;
+    }
+    return index->games_size++;
+}
+
+/**
+ * findHead: Returns the head of a chain in one of the tables, adding the key with an empty chain
+ * if it is missing.
+ *
+ * @param table - heads or tournaments.
+ * @param key - The key of the chain.
+ * @return
+ *     NULL if the table could not grow, the head otherwise.
+ */
+static int *findHead(HashTable table, unsigned long long key)
+{
+    int *head = hashTableGet(table, key);
+    if (head == NULL)
+    {
+        head = hashTablePut(table, key);
+        if (head == NULL)
+        {
+            return NULL;
+        }
+        *head = CHAIN_END;
+    }
+    return head;
+}
+
+bool pairIndexAdd(PairIndex index, int tournament_id, int first_player, int second_player, Winner winner,
+                  int play_time, bool ended)
+{
+    if (index == NULL)
+    {
+        return false;
+    }
+    unsigned long long key = pairKey(first_player, second_player);
+    int *head = findHead(index->heads, key);
+    int *tournament_head = head == NULL ? NULL : findHead(index->tournaments, (unsigned int)tournament_id);
+    int game = tournament_head == NULL ? CHAIN_END : allocateGame(index);
+    if (game == CHAIN_END)
+    {
+        // Keys added for this game are removed, so a failure leaves the index as it was
+        if (head != NULL && *head == CHAIN_END)
+        {
+            hashTableRemove(index->heads, key);
+        }
+        if (tournament_head != NULL && *tournament_head == CHAIN_END)
+        {
+            hashTableRemove(index->tournaments, (unsigned int)tournament_id);
+        }
+        return false;
+    }
+    // Results are kept for the lower id, so both orders of a pair read the same records
+    if (first_player > second_player && winner != DRAW)
+    {
+        winner = winner == FIRST_PLAYER ? SECOND_PLAYER : FIRST_PLAYER;
+    }
+    PairGame *record = &index->games[game];
+    record->pair = key;
+    record->tournament_id = tournament_id;
+    record->play_time = play_time;
+    record->result = (unsigned char)(winner | (ended ? ENDED_FLAG : 0));
+    record->previous = CHAIN_END;
+    record->next = *head;
+    if (*head != CHAIN_END)
+    {
+        index->games[*head].previous = game;
+    }
+    *head = game;
+    record->tournament_previous = CHAIN_END;
+    record->tournament_next = *tournament_head;
+    if (*tournament_head != CHAIN_END)
+    {
+        index->games[*tournament_head].tournament_previous = game;
+    }
+    *tournament_head = game;
+    return true;
+}
+
+/**
+ * freeGame: Unlinks a game from the chains of its pair and of its tournament, removes the keys
+ * of chains it leaves empty, and moves it to the free list.
+ *
+ * @param index - The index.
+ * @param game - The game.
+ */
+static void freeGame(PairIndex index, int game)
+{
+    PairGame *record = &index->games[game];
+    if (record->previous == CHAIN_END)
+    {
+        int *head = hashTableGet(index->heads, record->pair);
+        *head = record->next;
+        if (*head == CHAIN_END)
+        {
+            hashTableRemove(index->heads, record->pair);
+        }
+    }
+    else
+    {
+        index->games[record->previous].next = record->next;
+    }
+    if (record->next != CHAIN_END)
+    {
+        index->games[record->next].previous = record->previous;
+    }
+    unsigned long long tournament_key = (unsigned int)record->tournament_id;
+    if (record->tournament_previous == CHAIN_END)
+    {
+        int *head = hashTableGet(index->tournaments, tournament_key);
+        *head = record->tournament_next;
+        if (*head == CHAIN_END)
+        {
+            hashTableRemove(index->tournaments, tournament_key);
+        }
+    }
+    else
+    {
+        index->games[record->tournament_previous].tournament_next = record->tournament_next;
+    }
+    if (record->tournament_next != CHAIN_END)
+    {
+        index->games[record->tournament_next].tournament_previous = record->tournament_previous;
+    }
+    record->tournament_id = FREE_RECORD;
+    record->next = index->free_games;
+    index->free_games = game;
+}
+
+void pairIndexRemoveLast(PairIndex index, int first_player, int second_player)
+{
+    if (index == NULL)
+    {
+        return;
+    }
+    // The newest game of a pair is the first of its chain
+    int *head = hashTableGet(index->heads, pairKey(first_player, second_player));
+    if (head != NULL)
+    {
+        freeGame(index, *head);
+    }
+}
+
+void pairIndexEndTournament(PairIndex index, int tournament_id)
+{
+    if (index == NULL)
+    {
+        return;
+    }
+    int *head = hashTableGet(index->tournaments, (unsigned int)tournament_id);
+    for (int game = head == NULL ? CHAIN_END : *head; game != CHAIN_END; game = index->games[game].tournament_next)
+    {
+        index->games[game].result |= ENDED_FLAG;
+    }
+}
+
+void pairIndexRemoveTournament(PairIndex index, int tournament_id)
+{
+    if (index == NULL)
+    {
+        return;
+    }
+    // Freeing the last game of the chain removes the key, so the head is read again every time
+    for (int *head = hashTableGet(index->tournaments, (unsigned int)tournament_id); head != NULL;
+         head = hashTableGet(index->tournaments, (unsigned int)tournament_id))
+    {
+        freeGame(index, *head);
+    }
+}
+
+void pairIndexRemovePair(PairIndex index, int tournament_id, int first_player, int second_player)
+{
+    if (index == NULL)
+    {
+        return;
+    }
+    int *head = hashTableGet(index->heads, pairKey(first_player, second_player));
+    int game = head == NULL ? CHAIN_END : *head;
+    while (game != CHAIN_END)
+    {
+        int next = index->games[game].next;
+        if (index->games[game].tournament_id == tournament_id)
+        {
+            freeGame(index, game);
+        }
+        game = next;
+    }
+}
+
+void pairIndexHeadToHead(PairIndex index, int first_player, int second_player, int *wins, int *losses,
+                         int *draws, int *total_time)
+{
+    *wins = 0;
+    *losses = 0;
+    *draws = 0;
+    *total_time = 0;
+    int *head = hashTableGet(index->heads, pairKey(first_player, second_player));
+    if (head == NULL)
+    {
+        return;
+    }
+    Winner first_won = first_player < second_player ? FIRST_PLAYER : SECOND_PLAYER;
+    for (int game = *head; game != CHAIN_END; game = index->games[game].next)
+    {
+        Winner winner = (Winner)(index->games[game].result & WINNER_MASK);
+        if (winner == DRAW)
+        {
+            (*draws)++;
+        }
+        else if (winner == first_won)
+        {
+            (*wins)++;
+        }
+        else
+        {
+            (*losses)++;
+        }
+        *total_time += index->games[game].play_time;
+    }
+}
+
+void pairIndexMemoryUsage(PairIndex index, ChessMemoryFootprint *footprint)
+{
+    if (index == NULL || footprint == NULL)
+    {
+        return;
+    }
+    memoryFootprintAdd(footprint, CHESS_MEMORY_INDEXES, sizeof(*index), 1);
+    hashTableMemoryUsage(index->heads, footprint);
+    hashTableMemoryUsage(index->tournaments, footprint);
+    if (index->games != NULL)
+    {
+        memoryFootprintAdd(footprint, CHESS_MEMORY_INDEXES, sizeof(*index->games) * index->games_capacity, 1);
+    }
+}
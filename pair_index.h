@@ -0,0 +1,125 @@
+#ifndef PAIR_INDEX_H
+#define PAIR_INDEX_H
+#include <stdbool.h>
+#include "chessSystem.h"
+
+/*
+* The games of the system, indexed by the unordered pair of their players.
+*
+* An open addressing hash table maps every pair of players to the first of its games, and the
+* games of a pair are chained through one pool of game records, so the record between two
+* players is read in time proportional to the number of games they played against each other.
+* Records of removed games go to a free list and are reused by the next games. The games of a
+* tournament are chained as well, so ending or removing a tournament touches only its games.
+* A removed player's games in tournaments that did not end are reached through his opponents,
+* one pair at a time, so no update of the index reads games it does not change.
+*
+* The following functions are available:
+*   pairIndexCreate            - Creates an empty index
+*   pairIndexDestroy           - Deletes an index
+*   pairIndexAdd               - Adds a game to the index
+*   pairIndexRemoveLast        - Removes the last game added between two players
+*   pairIndexEndTournament     - Marks the games of a tournament as ended
+*   pairIndexRemoveTournament  - Removes the games of a tournament
+*   pairIndexRemovePair        - Removes the games of a pair of players in a tournament
+*   pairIndexHeadToHead        - Returns the record between two players
+*   pairIndexMemoryUsage       - Adds the memory of the index to a footprint
+*/
+
+/** Type for defining the pair index */
+typedef struct pair_index_t *PairIndex;
+
+/**
+* pairIndexCreate: Allocates an empty index.
+*
+* @return
+* 	NULL - if allocations failed.
+* 	A new index in case of success.
+*/
+PairIndex pairIndexCreate();
+
+/**
+* pairIndexDestroy: Deallocates an index.
+*
+* @param index - Target index. If index is NULL nothing will be done.
+*/
+void pairIndexDestroy(PairIndex index);
+
+/**
+* pairIndexAdd: Adds a game to the index.
+*
+* @param index - The index.
+* @param tournament_id - The tournament of the game.
+* @param first_player - The first player.
+* @param second_player - The second player.
+* @param winner - The result of the game.
+* @param play_time - The time the game took.
+* @param ended - Whether the tournament of the game already ended.
+* @return
+* 	false - if the input is NULL or an allocation failed.
+* 	true - otherwise.
+*/
+bool pairIndexAdd(PairIndex index, int tournament_id, int first_player, int second_player, Winner winner,
+                  int play_time, bool ended);
+
+/**
+* pairIndexRemoveLast: Removes the last game added between two players, as when adding the game
+*   to its tournament failed.
+*
+* @param index - The index. If index is NULL nothing will be done.
+* @param first_player - One player of the game.
+* @param second_player - The other player of the game.
+*/
+void pairIndexRemoveLast(PairIndex index, int first_player, int second_player);
+
+/**
+* pairIndexEndTournament: Marks the games of a tournament as ended, so they are kept when a
+*   player is removed.
+*
+* @param index - The index. If index is NULL nothing will be done.
+* @param tournament_id - The tournament.
+*/
+void pairIndexEndTournament(PairIndex index, int tournament_id);
+
+/**
+* pairIndexRemoveTournament: Removes the games of a tournament from the index.
+*
+* @param index - The index. If index is NULL nothing will be done.
+* @param tournament_id - The tournament.
+*/
+void pairIndexRemoveTournament(PairIndex index, int tournament_id);
+
+/**
+* pairIndexRemovePair: Removes the games two players played against each other in a tournament,
+*   as when one of them is removed from a tournament that did not end.
+*
+* @param index - The index. If index is NULL nothing will be done.
+* @param tournament_id - The tournament.
+* @param first_player - One player of the pair.
+* @param second_player - The other player of the pair.
+*/
+void pairIndexRemovePair(PairIndex index, int tournament_id, int first_player, int second_player);
+
+/**
+* pairIndexHeadToHead: Sums the games two players played against each other.
+*
+* @param index - The index.
+* @param first_player - The player the record is counted for.
+* @param second_player - The opponent.
+* @param wins - Where to store the games first_player won.
+* @param losses - Where to store the games first_player lost.
+* @param draws - Where to store the games that ended in a draw.
+* @param total_time - Where to store the total time of the games.
+*/
+void pairIndexHeadToHead(PairIndex index, int first_player, int second_player, int *wins, int *losses,
+                         int *draws, int *total_time);
+
+/**
+* pairIndexMemoryUsage: Adds the memory of the index to a footprint.
+*
+* @param index - The index. If index is NULL nothing will be added.
+* @param footprint - The footprint to add to.
+*/
+void pairIndexMemoryUsage(PairIndex index, ChessMemoryFootprint *footprint);
+
+#endif
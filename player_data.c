@@ -1,5 +1,7 @@
 #include <stdlib.h>
 #include "player_data.h"
+#include "chess_alloc.h"
+#include "chess_rating.h"
 
 
 #define P_NULL -1
@@ -11,12 +13,17 @@ struct player_data{
     int draws;
 };
 
+struct player_total{
+    struct player_data stats;
+    double rating;
+};
+
 static PlayerData playerDataCopyInternal(PlayerData source);
 static void playerDataDestroyInternal(PlayerData p_data);
 
 PlayerData playerDataCreate()
 {
-    PlayerData p_data = malloc(sizeof(*p_data));
+    PlayerData p_data = accountedMalloc(sizeof(*p_data), CHESS_MEMORY_PLAYERS);
     if (p_data == NULL)
     {
         return NULL;
@@ -39,7 +46,12 @@ static void playerDataDestroyInternal(PlayerData p_data)
     {
         return;
     }
-    free(p_data);
+    accountedFree(p_data, sizeof(*p_data), CHESS_MEMORY_PLAYERS);
+}
+
+size_t playerDataAllocationSize()
+{
+    return sizeof(struct player_data);
 }
 
 MapDataElement playerDataCopy(MapDataElement player)
@@ -147,4 +159,143 @@ void playerSetDraws(PlayerData player_data, int add_draws)
     }
 
     player_data->draws += add_draws;
+}
+
+PlayerTotal playerTotalCreate()
+{
+    PlayerTotal total = accountedMalloc(sizeof(*total), CHESS_MEMORY_PLAYERS);
+    if (total == NULL)
+    {
+        return NULL;
+    }
+    total->stats.points = 0;
+    total->stats.wins = 0;
+    total->stats.losses = 0;
+    total->stats.draws = 0;
+    total->rating = RATING_INITIAL;
+    return total;
+}
+
+void playerTotalDestroy(MapDataElement total)
+{
+    if (total == NULL)
+    {
+        return;
+    }
+    accountedFree(total, sizeof(struct player_total), CHESS_MEMORY_PLAYERS);
+}
+
+MapDataElement playerTotalCopy(MapDataElement total)
+{
+    PlayerTotal source = total;
+    if (source == NULL)
+    {
+        return NULL;
+    }
+
+    PlayerTotal copy = playerTotalCreate();
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+
+    copy->stats = source->stats;
+    copy->rating = source->rating;
+    return copy;
+}
+
+PlayerData playerTotalStats(PlayerTotal total)
+{
+    if (total == NULL)
+    {
+        return NULL;
+    }
+
+    return &total->stats;
+}
+
+size_t playerTotalAllocationSize()
+{
+    return sizeof(struct player_total);
+}
+
+double playerGetRating(PlayerTotal total)
+{
+    if (total == NULL)
+    {
+        return P_NULL;
+    }
+
+    return total->rating;
+}
+
+void playerSetRating(PlayerTotal total, double rating)
+{
+    if (total == NULL)
+    {
+        return;
+    }
+
+    total->rating = rating;
+}
+
+void playerDataAdd(PlayerData target, PlayerData source, int sign)
+{
+    if (target == NULL || source == NULL)
+    {
+        return;
+    }
+
+    target->points += sign * source->points;
+    target->wins += sign * source->wins;
+    target->losses += sign * source->losses;
+    target->draws += sign * source->draws;
+}
+
+void playerDataClear(PlayerData player_data)
+{
+    if (player_data == NULL)
+    {
+        return;
+    }
+
+    player_data->points = 0;
+    player_data->wins = 0;
+    player_data->losses = 0;
+    player_data->draws = 0;
+}
+
+bool playerHasGames(PlayerData player_data)
+{
+    if (player_data == NULL)
+    {
+        return false;
+    }
+
+    return player_data->wins != 0 || player_data->losses != 0 || player_data->draws != 0;
+}
+
+bool playerDataSnapshotWrite(PlayerData player_data, SnapshotWriter writer)
+{
+    if (player_data == NULL || writer == NULL)
+    {
+        return false;
+    }
+    return snapshotWriteInt(writer, player_data->points) &&
+           snapshotWriteInt(writer, player_data->wins) &&
+           snapshotWriteInt(writer, player_data->losses) &&
+           snapshotWriteInt(writer, player_data->draws);
+}
+
+bool playerDataSnapshotRead(PlayerData player_data, SnapshotReader reader)
+{
+    if (player_data == NULL || reader == NULL)
+    {
+        return false;
+    }
+    player_data->points = snapshotReadInt(reader);
+    player_data->wins = snapshotReadInt(reader);
+    player_data->losses = snapshotReadInt(reader);
+    player_data->draws = snapshotReadInt(reader);
+    return snapshotReaderFailed(reader) == false;
 }
\ No newline at end of file
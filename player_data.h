@@ -2,6 +2,7 @@
 #define PLAYER_MAP_H
 #include "chessSystem.h"
 #include "./mtm_map/map.h"
+#include "chess_snapshot.h"
 /*
 * The following functions are available:
 *   PlayerDataCreate		- Creates a new player
@@ -15,11 +16,30 @@
 *   setLosses	            - Adds losses to a certain player.
 *   getDraws		        - Returns the amount of draws a certain player has.
 *	setDraws		        - Adds draws to a certain player.
+*   playerTotalCreate       - Creates a new system total of a player.
+*   playerTotalDestroy      - Deletes an existing system total.
+*   playerTotalCopy         - Copies an existing system total.
+*   playerTotalStats        - Returns the stats of a system total.
+*   playerGetRating         - Returns the Elo rating of a certain player.
+*   playerSetRating         - Sets the Elo rating of a certain player.
+*   playerDataAdd           - Adds or subtracts the stats of one player to another.
+*   playerDataClear         - Sets the stats of a player to zero.
+*   playerHasGames          - Returns if a player has any win, loss or draw.
+*   playerDataSnapshotWrite - Appends the player's stats to a binary snapshot.
+*   playerDataSnapshotRead  - Overwrites a player with the next stats of a binary snapshot.
+*   playerDataAllocationSize - Returns the number of bytes allocated for one player.
+*   playerTotalAllocationSize - Returns the number of bytes allocated for one system total.
 */
 
 /** Type for defining the player_data */
 typedef struct player_data *PlayerData;
 
+/**
+* Type for defining the system total of a player: his stats over all the tournaments, which start
+* the allocation so a total can be used as a PlayerData, and his Elo rating, kept only here.
+*/
+typedef struct player_total *PlayerTotal;
+
 /**
 * playerDataCreate: Allocates a new player.
 *
@@ -37,6 +57,14 @@ PlayerData playerDataCreate();
 */
 void playerDataDestroy(MapDataElement p_data);
 
+/**
+* playerDataAllocationSize: Returns the number of bytes allocated for one player.
+*
+* @return
+* 	The size of a player.
+*/
+size_t playerDataAllocationSize();
+
 /**
 * gameCopy: Creates a copy of target player.
 *
@@ -119,5 +147,114 @@ int playerGetDraws(PlayerData player_data);
 */
 void playerSetDraws(PlayerData player_data, int add_draws);
 
-#endif
+/**
+* playerTotalCreate: Allocates a new system total with no games and the rating RATING_INITIAL.
+*
+* @return
+* 	NULL - if allocations failed.
+* 	A new total in case of success.
+*/
+PlayerTotal playerTotalCreate();
+
+/**
+* playerTotalDestroy: Deallocates an existing system total.
+*
+* @param total - Target total to be deallocated. If total is NULL nothing will be done.
+*/
+void playerTotalDestroy(MapDataElement total);
 
+/**
+* playerTotalCopy: Creates a copy of a system total, with its rating.
+*
+* @param total - Target total.
+* @return
+* 	NULL if a NULL was sent or a memory allocation failed.
+* 	A new total containing the same elements as total otherwise.
+*/
+MapDataElement playerTotalCopy(MapDataElement total);
+
+/**
+* playerTotalStats: Returns the points, wins, losses and draws of a system total.
+*
+* @param total - The total.
+* @return
+* 	NULL - if a NULL was sent as input.
+*   The stats of the total otherwise, valid as long as the total.
+*/
+PlayerData playerTotalStats(PlayerTotal total);
+
+/**
+* playerTotalAllocationSize: Returns the number of bytes allocated for one system total.
+*
+* @return
+* 	The size of a total.
+*/
+size_t playerTotalAllocationSize();
+
+/**
+* playerGetRating: Returns the player's Elo rating, RATING_INITIAL for a new player.
+*
+* @param total - The system total of the player we want his rating.
+* @return
+* 	-1 - if a NULL was sent as input.
+*   The player actual rating otherwise.
+*/
+double playerGetRating(PlayerTotal total);
+
+/**
+* playerSetRating: Sets the player's Elo rating.
+*
+* @param total - The system total of the player we want to update.
+* @param rating - The new rating.
+*/
+void playerSetRating(PlayerTotal total, double rating);
+
+/**
+* playerDataAdd: Adds the points, wins, losses and draws of one player to another, or subtracts them.
+*
+* @param target - The player to update. If target is NULL nothing will be done.
+* @param source - The player whose stats are added. If source is NULL nothing will be done.
+* @param sign - 1 to add the stats, -1 to subtract them.
+*/
+void playerDataAdd(PlayerData target, PlayerData source, int sign);
+
+/**
+* playerDataClear: Sets the points, wins, losses and draws of a player to zero.
+*
+* @param player_data - The player to clear. If player_data is NULL nothing will be done.
+*/
+void playerDataClear(PlayerData player_data);
+
+/**
+* playerHasGames: Checks if a player has any win, loss or draw.
+*
+* @param player_data - The player.
+* @return
+* 	false - if the input is NULL or the player has no wins, losses and draws.
+* 	true - otherwise.
+*/
+bool playerHasGames(PlayerData player_data);
+
+/**
+* playerDataSnapshotWrite: Appends the player's points, wins, losses and draws to a binary snapshot.
+*
+* @param player_data - The player to write.
+* @param writer - The snapshot writer.
+* @return
+* 	false - if the input is NULL or the snapshot could not grow.
+* 	true - otherwise.
+*/
+bool playerDataSnapshotWrite(PlayerData player_data, SnapshotWriter writer);
+
+/**
+* playerDataSnapshotRead: Overwrites an existing player with the next stats of a binary snapshot.
+*
+* @param player_data - The player to overwrite.
+* @param reader - The snapshot reader.
+* @return
+* 	false - if the input is NULL or the snapshot is truncated.
+* 	true - otherwise.
+*/
+bool playerDataSnapshotRead(PlayerData player_data, SnapshotReader reader);
+
+#endif
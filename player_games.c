@@ -0,0 +1,266 @@
+#include <stdlib.h>
+#include <string.h>
+#include "player_games.h"
+#include "game_data.h"
+#include "chess_alloc.h"
+#include "chess_utilities.h"
+
+#define MINIMUM_CAPACITY 4
+#define EXPAND 2
+#define ID_BITS 32
+
+/** A game in the list of one of its players */
+typedef struct
+{
+    int tournament_id;
+    int game_key;
+    int opponent_id;
+    int play_time;
+    ChessGameResult result;
+} PlayerGame;
+
+/** The games of one player, in increasing (tournament, game key) order */
+typedef struct
+{
+    int size;
+    int capacity;
+    PlayerGame *games;
+} PlayerGameList;
+
+/** The game lists of the players, by player. A player whose games were all removed is removed */
+struct player_games_t
+{
+    HashTable lists;
+};
+
+/**
+ * gamePosition: Returns the position of a game in the order of the lists, which is also the cursor
+ * of the game.
+ */
+static long long gamePosition(int tournament_id, int game_key)
+{
+    return ((long long)tournament_id << ID_BITS) | (unsigned int)game_key;
+}
+
+/**
+ * findList: Returns the games of a player, NULL if the player has none.
+ */
+static PlayerGameList *findList(PlayerGames index, int player_id)
+{
+    return hashTableGet(index->lists, (unsigned int)player_id);
+}
+
+PlayerGames playerGamesCreate()
+{
+    PlayerGames index = accountedMalloc(sizeof(*index), CHESS_MEMORY_INDEXES);
+    if (index == NULL)
+    {
+        return NULL;
+    }
+    index->lists = hashTableCreate(sizeof(PlayerGameList), CHESS_MEMORY_INDEXES);
+    if (index->lists == NULL)
+    {
+        accountedFree(index, sizeof(*index), CHESS_MEMORY_INDEXES);
+        return NULL;
+    }
+    return index;
+}
+
+void playerGamesDestroy(PlayerGames index)
+{
+    if (index == NULL)
+    {
+        return;
+    }
+    int position = 0;
+    for (PlayerGameList *list = hashTableNext(index->lists, &position, NULL); list != NULL;
+         list = hashTableNext(index->lists, &position, NULL))
+    {
+        accountedFree(list->games, sizeof(*list->games) * list->capacity, CHESS_MEMORY_INDEXES);
+    }
+    hashTableDestroy(index->lists);
+    accountedFree(index, sizeof(*index), CHESS_MEMORY_INDEXES);
+}
+
+/**
+ * firstAfter: Binary searches the first game of a list whose position is greater than a position.
+ *
+ * @param list - The games of a player.
+ * @param position - The position.
+ * @return
+ *     The index of the game, list->size if there is none.
+ */
+static int firstAfter(const PlayerGameList *list, long long position)
+{
+    int low = 0, high = list->size;
+    while (low < high)
+    {
+        int middle = low + (high - low) / 2;
+        if (gamePosition(list->games[middle].tournament_id, list->games[middle].game_key) <= position)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+bool playerGamesAdd(PlayerGames index, int player_id, int tournament_id, int game_key, int opponent_id,
+                    ChessGameResult result, int play_time)
+{
+    if (index == NULL)
+    {
+        return false;
+    }
+    PlayerGameList *list = hashTablePut(index->lists, (unsigned int)player_id);
+    if (list == NULL)
+    {
+        return false;
+    }
+    if (list->size == list->capacity)
+    {
+        int capacity = list->capacity == 0 ? MINIMUM_CAPACITY : list->capacity * EXPAND;
+        PlayerGame *games = accountedRealloc(list->games, sizeof(*games) * list->capacity, sizeof(*games) * capacity,
+                                             CHESS_MEMORY_INDEXES);
+        if (games == NULL)
+        {
+            if (list->size == 0)
+            {
+                hashTableRemove(index->lists, (unsigned int)player_id);
+            }
+            return false;
+        }
+        list->games = games;
+        list->capacity = capacity;
+    }
+    // New games of a tournament have the highest key in it, so they go after its other games
+    int position = firstAfter(list, gamePosition(tournament_id, game_key));
+    memmove(list->games + position + 1, list->games + position, sizeof(*list->games) * (list->size - position));
+    list->games[position].tournament_id = tournament_id;
+    list->games[position].game_key = game_key;
+    list->games[position].opponent_id = opponent_id;
+    list->games[position].play_time = play_time;
+    list->games[position].result = result;
+    list->size++;
+    return true;
+}
+
+/**
+ * removeGames: Removes the games at [first, last) from the list of a player, and frees the list
+ * and removes the player once it is empty.
+ */
+static void removeGames(PlayerGames index, int player_id, PlayerGameList *list, int first, int last)
+{
+    memmove(list->games + first, list->games + last, sizeof(*list->games) * (list->size - last));
+    list->size -= last - first;
+    if (list->size == 0)
+    {
+        accountedFree(list->games, sizeof(*list->games) * list->capacity, CHESS_MEMORY_INDEXES);
+        hashTableRemove(index->lists, (unsigned int)player_id);
+    }
+}
+
+void playerGamesRemoveGame(PlayerGames index, int player_id, int tournament_id, int game_key)
+{
+    PlayerGameList *list = index == NULL ? NULL : findList(index, player_id);
+    if (list == NULL)
+    {
+        return;
+    }
+    int game = firstAfter(list, gamePosition(tournament_id, game_key)) - 1;
+    if (game >= 0 && list->games[game].tournament_id == tournament_id && list->games[game].game_key == game_key)
+    {
+        removeGames(index, player_id, list, game, game + 1);
+    }
+}
+
+void playerGamesRemoveTournament(PlayerGames index, int player_id, int tournament_id)
+{
+    PlayerGameList *list = index == NULL ? NULL : findList(index, player_id);
+    if (list == NULL)
+    {
+        return;
+    }
+    removeGames(index, player_id, list, firstAfter(list, gamePosition(tournament_id, 0)),
+                firstAfter(list, gamePosition(tournament_id, -1)));
+}
+
+void playerGamesRemovePlayer(PlayerGames index, int player_id, int tournament_id, PlayerOpponentVisitor visit,
+                             void *context)
+{
+    PlayerGameList *list = index == NULL ? NULL : findList(index, player_id);
+    if (list == NULL)
+    {
+        return;
+    }
+    int first = firstAfter(list, gamePosition(tournament_id, 0));
+    int last = firstAfter(list, gamePosition(tournament_id, -1));
+    for (int i = first; i < last; i++)
+    {
+        PlayerGameList *opponent = list->games[i].opponent_id == DELETE_PLAYER ? NULL :
+                                   findList(index, list->games[i].opponent_id);
+        if (opponent == NULL)
+        {
+            continue;
+        }
+        if (visit != NULL)
+        {
+            visit(context, list->games[i].opponent_id);
+        }
+        // The game of the opponent is the last one at or before the position of this game
+        int game = firstAfter(opponent, gamePosition(tournament_id, list->games[i].game_key)) - 1;
+        opponent->games[game].opponent_id = DELETE_PLAYER;
+        opponent->games[game].result = CHESS_GAME_WIN;
+    }
+    removeGames(index, player_id, list, first, last);
+}
+
+void playerGamesPage(PlayerGames index, int player_id, long long *cursor, ChessPlayerGame *out_games,
+                     int capacity, int *out_count)
+{
+    *out_count = 0;
+    PlayerGameList *list = findList(index, player_id);
+    int first = list == NULL || *cursor == CHESS_GAMES_END ? 0 : firstAfter(list, *cursor);
+    if (list == NULL || *cursor == CHESS_GAMES_END || first == list->size)
+    {
+        *cursor = CHESS_GAMES_END;
+        return;
+    }
+    int count = list->size - first < capacity ? list->size - first : capacity;
+    for (int i = 0; i < count; i++)
+    {
+        const PlayerGame *game = &list->games[first + i];
+        out_games[i].tournament_id = game->tournament_id;
+        out_games[i].opponent_id = game->opponent_id;
+        out_games[i].result = game->result;
+        out_games[i].play_time = game->play_time;
+    }
+    *out_count = count;
+    if (first + count == list->size)
+    {
+        *cursor = CHESS_GAMES_END;
+    }
+    else if (count > 0)
+    {
+        *cursor = gamePosition(list->games[first + count - 1].tournament_id, list->games[first + count - 1].game_key);
+    }
+}
+
+void playerGamesMemoryUsage(PlayerGames index, ChessMemoryFootprint *footprint)
+{
+    if (index == NULL || footprint == NULL)
+    {
+        return;
+    }
+    memoryFootprintAdd(footprint, CHESS_MEMORY_INDEXES, sizeof(*index), 1);
+    hashTableMemoryUsage(index->lists, footprint);
+    int position = 0;
+    for (PlayerGameList *list = hashTableNext(index->lists, &position, NULL); list != NULL;
+         list = hashTableNext(index->lists, &position, NULL))
+    {
+        memoryFootprintAdd(footprint, CHESS_MEMORY_INDEXES, sizeof(*list->games) * list->capacity, 1);
+    }
+}
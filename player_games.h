@@ -0,0 +1,124 @@
+#ifndef PLAYER_GAMES_H
+#define PLAYER_GAMES_H
+#include <stdbool.h>
+#include "chessSystem.h"
+
+/*
+* The games of every player, an adjacency list of the game graph.
+*
+* An open addressing hash table maps every player to an array of the player's games, sorted by
+* tournament id and by the key of the game in its tournament, which is the order games are
+* added to a tournament. A page of games is found by a binary search for the cursor, so reading
+* it takes O(log G + page size) for a player with G games, whatever the size of the system.
+* Games of a removed tournament leave the lists of its players. Games a removed player had in
+* tournaments that did not end leave that player's list, and stay in the lists of the opponents
+* as wins against a removed player.
+*
+* The following functions are available:
+*   playerGamesCreate            - Creates an empty index
+*   playerGamesDestroy           - Deletes an index
+*   playerGamesAdd               - Adds a game to the list of one of its players
+*   playerGamesRemoveGame        - Removes a game from the list of one of its players
+*   playerGamesRemoveTournament  - Removes the games of a tournament from the list of a player
+*   playerGamesRemovePlayer      - Removes a player from the games of a tournament
+*   playerGamesPage              - Copies the games of a player after a cursor
+*   playerGamesMemoryUsage       - Adds the memory of the index to a footprint
+*/
+
+/** Type for defining the games of every player */
+typedef struct player_games_t *PlayerGames;
+
+/** Type of a function called with the opponents of a removed player */
+typedef void (*PlayerOpponentVisitor)(void *context, int opponent_id);
+
+/**
+* playerGamesCreate: Allocates an empty index.
+*
+* @return
+* 	NULL - if allocations failed.
+* 	A new index in case of success.
+*/
+PlayerGames playerGamesCreate();
+
+/**
+* playerGamesDestroy: Deallocates an index.
+*
+* @param index - Target index. If index is NULL nothing will be done.
+*/
+void playerGamesDestroy(PlayerGames index);
+
+/**
+* playerGamesAdd: Adds a game to the list of one of its players. A game is added once for each
+*   of its players.
+*
+* @param index - The index.
+* @param player_id - The player whose list the game is added to.
+* @param tournament_id - The tournament of the game.
+* @param game_key - The key of the game in the tournament.
+* @param opponent_id - The other player, DELETE_PLAYER if that player was removed.
+* @param result - The result of the game for player_id.
+* @param play_time - The time the game took.
+* @return
+* 	false - if the input is NULL or an allocation failed.
+* 	true - otherwise.
+*/
+bool playerGamesAdd(PlayerGames index, int player_id, int tournament_id, int game_key, int opponent_id,
+                    ChessGameResult result, int play_time);
+
+/**
+* playerGamesRemoveGame: Removes a game from the list of one of its players, as when adding the
+*   game to its tournament failed.
+*
+* @param index - The index. If index is NULL nothing will be done.
+* @param player_id - The player whose list the game is removed from.
+* @param tournament_id - The tournament of the game.
+* @param game_key - The key of the game in the tournament.
+*/
+void playerGamesRemoveGame(PlayerGames index, int player_id, int tournament_id, int game_key);
+
+/**
+* playerGamesRemoveTournament: Removes the games of a tournament from the list of a player.
+*
+* @param index - The index. If index is NULL nothing will be done.
+* @param player_id - The player.
+* @param tournament_id - The tournament.
+*/
+void playerGamesRemoveTournament(PlayerGames index, int player_id, int tournament_id);
+
+/**
+* playerGamesRemovePlayer: Removes the games of a tournament from the list of a player, and
+*   turns them into wins against a removed player in the lists of the opponents.
+*
+* @param index - The index. If index is NULL nothing will be done.
+* @param player_id - The removed player.
+* @param tournament_id - A tournament the player is removed from, that did not end.
+* @param visit - Called with the opponent of every such game, unless that opponent was removed
+*                before. May be NULL.
+* @param context - Passed to visit.
+*/
+void playerGamesRemovePlayer(PlayerGames index, int player_id, int tournament_id, PlayerOpponentVisitor visit,
+                             void *context);
+
+/**
+* playerGamesPage: Copies the games of a player that come after a cursor.
+*
+* @param index - The index.
+* @param player_id - The player.
+* @param cursor - The position to read from, 0 for the first game. Set to the position of the
+*                 last copied game, or to CHESS_GAMES_END if no games are left after it.
+* @param out_games - Where to copy the games.
+* @param capacity - The number of games out_games holds.
+* @param out_count - Where to store the number of copied games.
+*/
+void playerGamesPage(PlayerGames index, int player_id, long long *cursor, ChessPlayerGame *out_games,
+                     int capacity, int *out_count);
+
+/**
+* playerGamesMemoryUsage: Adds the memory of the index to a footprint.
+*
+* @param index - The index. If index is NULL nothing will be added.
+* @param footprint - The footprint to add to.
+*/
+void playerGamesMemoryUsage(PlayerGames index, ChessMemoryFootprint *footprint);
+
+#endif
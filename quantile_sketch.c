@@ -0,0 +1,347 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "quantile_sketch.h"
+#include "chess_utilities.h"
+
+/**
+ * The positive values are counted in buckets[i - first_index] for the buckets i from first_index,
+ * and zero in zero_count.
+ */
+struct quantile_sketch_t
+{
+    int count;
+    int zero_count;
+    int first_index;
+    int number_of_buckets;
+    int *buckets;
+};
+
+/** The sketches of the keys, by key. A key whose sketch lost its values is removed */
+struct quantile_sketch_table_t
+{
+    HashTable sketches;
+};
+
+/**
+ * bucketIndex: Returns the bucket of a positive value.
+ */
+static int bucketIndex(int value)
+{
+    return (int)ceil(log((double)value) / log(SKETCH_GAMMA));
+}
+
+/**
+ * bucketValue: Returns the estimate of the values of a bucket, the middle of the bucket relative to
+ * the values in it.
+ */
+static double bucketValue(int index)
+{
+    return 2 * pow(SKETCH_GAMMA, index) / (SKETCH_GAMMA + 1);
+}
+
+/**
+ * resizeBuckets: Moves the buckets of a sketch to an array of the buckets first to last, which
+ * includes the buckets the sketch has.
+ *
+ * @param sketch - The sketch.
+ * @param first - The first bucket of the new array.
+ * @param last - The last bucket of the new array.
+ * @return
+ *     false if the allocation failed, in which case the sketch is not changed, true otherwise.
+ */
+static bool resizeBuckets(QuantileSketch sketch, int first, int last)
+{
+    int number_of_buckets = last - first + 1;
+    if (sketch->buckets != NULL && first == sketch->first_index && number_of_buckets == sketch->number_of_buckets)
+    {
+        return true;
+    }
+    int *buckets = accountedMalloc(sizeof(*buckets) * number_of_buckets, CHESS_MEMORY_SKETCHES);
+    if (buckets == NULL)
+    {
+        return false;
+    }
+    memset(buckets, 0, sizeof(*buckets) * number_of_buckets);
+    if (sketch->buckets != NULL)
+    {
+        memcpy(buckets + (sketch->first_index - first), sketch->buckets,
+               sizeof(*buckets) * sketch->number_of_buckets);
+        accountedFree(sketch->buckets, sizeof(*sketch->buckets) * sketch->number_of_buckets, CHESS_MEMORY_SKETCHES);
+    }
+    sketch->buckets = buckets;
+    sketch->first_index = first;
+    sketch->number_of_buckets = number_of_buckets;
+    return true;
+}
+
+QuantileSketch quantileSketchCreate()
+{
+    QuantileSketch sketch = accountedMalloc(sizeof(*sketch), CHESS_MEMORY_SKETCHES);
+    if (sketch == NULL)
+    {
+        return NULL;
+    }
+    sketch->count = 0;
+    sketch->zero_count = 0;
+    sketch->first_index = 0;
+    sketch->number_of_buckets = 0;
+    sketch->buckets = NULL;
+    return sketch;
+}
+
+void quantileSketchDestroy(QuantileSketch sketch)
+{
+    if (sketch == NULL)
+    {
+        return;
+    }
+    accountedFree(sketch->buckets, sizeof(*sketch->buckets) * sketch->number_of_buckets, CHESS_MEMORY_SKETCHES);
+    accountedFree(sketch, sizeof(*sketch), CHESS_MEMORY_SKETCHES);
+}
+
+QuantileSketch quantileSketchCopy(QuantileSketch sketch)
+{
+    if (sketch == NULL)
+    {
+        return NULL;
+    }
+    QuantileSketch copy = quantileSketchCreate();
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+    if (quantileSketchMerge(copy, sketch) == false)
+    {
+        quantileSketchDestroy(copy);
+        return NULL;
+    }
+    return copy;
+}
+
+bool quantileSketchAdd(QuantileSketch sketch, int value)
+{
+    if (sketch == NULL)
+    {
+        return false;
+    }
+    if (value <= 0)
+    {
+        sketch->zero_count++;
+        sketch->count++;
+        return true;
+    }
+    int index = bucketIndex(value);
+    int first = sketch->buckets == NULL || index < sketch->first_index ? index : sketch->first_index;
+    int last = sketch->first_index + sketch->number_of_buckets - 1;
+    last = sketch->buckets == NULL || index > last ? index : last;
+    if (resizeBuckets(sketch, first, last) == false)
+    {
+        return false;
+    }
+    sketch->buckets[index - sketch->first_index]++;
+    sketch->count++;
+    return true;
+}
+
+void quantileSketchRemove(QuantileSketch sketch, int value)
+{
+    if (sketch == NULL)
+    {
+        return;
+    }
+    if (value <= 0)
+    {
+        if (sketch->zero_count > 0)
+        {
+            sketch->zero_count--;
+            sketch->count--;
+        }
+        return;
+    }
+    int bucket = bucketIndex(value) - sketch->first_index;
+    if (bucket >= 0 && bucket < sketch->number_of_buckets && sketch->buckets[bucket] > 0)
+    {
+        sketch->buckets[bucket]--;
+        sketch->count--;
+    }
+}
+
+bool quantileSketchMerge(QuantileSketch sketch, QuantileSketch other)
+{
+    if (sketch == NULL || other == NULL)
+    {
+        return false;
+    }
+    if (other->buckets != NULL)
+    {
+        int first = other->first_index, last = other->first_index + other->number_of_buckets - 1;
+        if (sketch->buckets != NULL)
+        {
+            int sketch_last = sketch->first_index + sketch->number_of_buckets - 1;
+            first = sketch->first_index < first ? sketch->first_index : first;
+            last = sketch_last > last ? sketch_last : last;
+        }
+        if (resizeBuckets(sketch, first, last) == false)
+        {
+            return false;
+        }
+        int offset = other->first_index - sketch->first_index;
+        for (int i = 0; i < other->number_of_buckets; i++)
+        {
+            sketch->buckets[offset + i] += other->buckets[i];
+        }
+    }
+    sketch->zero_count += other->zero_count;
+    sketch->count += other->count;
+    return true;
+}
+
+int quantileSketchCount(QuantileSketch sketch)
+{
+    return sketch == NULL ? 0 : sketch->count;
+}
+
+double quantileSketchQuantile(QuantileSketch sketch, double quantile)
+{
+    if (sketch == NULL || sketch->count == 0)
+    {
+        return 0;
+    }
+    quantile = quantile < 0 ? 0 : (quantile > 1 ? 1 : quantile);
+    double rank = quantile * (sketch->count - 1);
+    long long counted = sketch->zero_count;
+    if (rank < counted)
+    {
+        return 0;
+    }
+    int last = 0;
+    for (int i = 0; i < sketch->number_of_buckets; i++)
+    {
+        if (sketch->buckets[i] == 0)
+        {
+            continue;
+        }
+        last = i;
+        counted += sketch->buckets[i];
+        if (rank < counted)
+        {
+            break;
+        }
+    }
+    return bucketValue(sketch->first_index + last);
+}
+
+void quantileSketchMemoryUsage(QuantileSketch sketch, ChessMemoryFootprint *footprint)
+{
+    if (sketch == NULL || footprint == NULL)
+    {
+        return;
+    }
+    memoryFootprintAdd(footprint, CHESS_MEMORY_SKETCHES, sizeof(*sketch), 1);
+    if (sketch->buckets != NULL)
+    {
+        memoryFootprintAdd(footprint, CHESS_MEMORY_SKETCHES, sizeof(*sketch->buckets) * sketch->number_of_buckets, 1);
+    }
+}
+
+QuantileSketchTable quantileSketchTableCreate()
+{
+    QuantileSketchTable table = accountedMalloc(sizeof(*table), CHESS_MEMORY_SKETCHES);
+    if (table == NULL)
+    {
+        return NULL;
+    }
+    table->sketches = hashTableCreate(sizeof(QuantileSketch), CHESS_MEMORY_SKETCHES);
+    if (table->sketches == NULL)
+    {
+        accountedFree(table, sizeof(*table), CHESS_MEMORY_SKETCHES);
+        return NULL;
+    }
+    return table;
+}
+
+void quantileSketchTableDestroy(QuantileSketchTable table)
+{
+    if (table == NULL)
+    {
+        return;
+    }
+    int position = 0;
+    for (QuantileSketch *sketch = hashTableNext(table->sketches, &position, NULL); sketch != NULL;
+         sketch = hashTableNext(table->sketches, &position, NULL))
+    {
+        quantileSketchDestroy(*sketch);
+    }
+    hashTableDestroy(table->sketches);
+    accountedFree(table, sizeof(*table), CHESS_MEMORY_SKETCHES);
+}
+
+QuantileSketch quantileSketchTableGet(QuantileSketchTable table, int key)
+{
+    if (table == NULL)
+    {
+        return NULL;
+    }
+    QuantileSketch *sketch = hashTableGet(table->sketches, (unsigned int)key);
+    return sketch == NULL ? NULL : *sketch;
+}
+
+bool quantileSketchTableAdd(QuantileSketchTable table, int key, int value)
+{
+    if (table == NULL)
+    {
+        return false;
+    }
+    QuantileSketch *sketch = hashTablePut(table->sketches, (unsigned int)key);
+    if (sketch == NULL)
+    {
+        return false;
+    }
+    if (*sketch == NULL && (*sketch = quantileSketchCreate()) == NULL)
+    {
+        hashTableRemove(table->sketches, (unsigned int)key);
+        return false;
+    }
+    if (quantileSketchAdd(*sketch, value) == false)
+    {
+        if ((*sketch)->count == 0)
+        {
+            quantileSketchDestroy(*sketch);
+            hashTableRemove(table->sketches, (unsigned int)key);
+        }
+        return false;
+    }
+    return true;
+}
+
+void quantileSketchTableRemove(QuantileSketchTable table, int key, int value)
+{
+    QuantileSketch *sketch = table == NULL ? NULL : hashTableGet(table->sketches, (unsigned int)key);
+    if (sketch == NULL)
+    {
+        return;
+    }
+    quantileSketchRemove(*sketch, value);
+    if ((*sketch)->count == 0)
+    {
+        quantileSketchDestroy(*sketch);
+        hashTableRemove(table->sketches, (unsigned int)key);
+    }
+}
+
+void quantileSketchTableMemoryUsage(QuantileSketchTable table, ChessMemoryFootprint *footprint)
+{
+    if (table == NULL || footprint == NULL)
+    {
+        return;
+    }
+    memoryFootprintAdd(footprint, CHESS_MEMORY_SKETCHES, sizeof(*table), 1);
+    hashTableMemoryUsage(table->sketches, footprint);
+    int position = 0;
+    for (QuantileSketch *sketch = hashTableNext(table->sketches, &position, NULL); sketch != NULL;
+         sketch = hashTableNext(table->sketches, &position, NULL))
+    {
+        quantileSketchMemoryUsage(*sketch, footprint);
+    }
+}
@@ -0,0 +1,188 @@
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+#include <stdbool.h>
+#include "chess_alloc.h"
+
+/*
+* Streaming quantile sketches of non-negative durations, in the layout of DDSketch.
+*
+* A positive value v is counted in the bucket i with SKETCH_GAMMA^(i-1) < v <= SKETCH_GAMMA^i, and
+* zero in a separate counter. The quantiles are answered with the middle of their bucket, which is
+* within SKETCH_ACCURACY of the exact value relative to it. The buckets between the lowest and the
+* highest one used are kept in one array, and since every int fits in about 1100 buckets a sketch
+* never takes more than a few KB, no matter how many values it counted. Sketches are merged by
+* adding their buckets, and a value is removed by taking it out of its bucket.
+*
+* A table of sketches maps an id (such as a player) to a sketch of the durations of that id.
+*
+* The following functions are available:
+*   quantileSketchCreate         - Creates an empty sketch
+*   quantileSketchDestroy        - Deletes a sketch
+*   quantileSketchCopy           - Copies a sketch
+*   quantileSketchAdd            - Counts a value
+*   quantileSketchRemove         - Removes a counted value
+*   quantileSketchMerge          - Counts the values of another sketch
+*   quantileSketchCount          - Returns the number of values
+*   quantileSketchQuantile       - Returns an estimate of a quantile
+*   quantileSketchMemoryUsage    - Adds the memory of a sketch to a footprint
+*   quantileSketchTableCreate    - Creates an empty table of sketches
+*   quantileSketchTableDestroy   - Deletes a table of sketches and its sketches
+*   quantileSketchTableGet       - Returns the sketch of a key
+*   quantileSketchTableAdd       - Counts a value in the sketch of a key
+*   quantileSketchTableRemove    - Removes a value from the sketch of a key
+*   quantileSketchTableMemoryUsage - Adds the memory of a table and its sketches to a footprint
+*/
+
+#define SKETCH_ACCURACY 0.01
+#define SKETCH_GAMMA ((1 + SKETCH_ACCURACY) / (1 - SKETCH_ACCURACY))
+
+/** Type for defining a quantile sketch */
+typedef struct quantile_sketch_t *QuantileSketch;
+
+/** Type for defining a table of quantile sketches, by key */
+typedef struct quantile_sketch_table_t *QuantileSketchTable;
+
+/**
+* quantileSketchCreate: Allocates an empty sketch.
+*
+* @return
+* 	NULL - if allocations failed.
+* 	A new sketch in case of success.
+*/
+QuantileSketch quantileSketchCreate();
+
+/**
+* quantileSketchDestroy: Deallocates a sketch.
+*
+* @param sketch - Target sketch. If sketch is NULL nothing will be done.
+*/
+void quantileSketchDestroy(QuantileSketch sketch);
+
+/**
+* quantileSketchCopy: Creates a copy of a sketch.
+*
+* @param sketch - Target sketch.
+* @return
+* 	NULL if a NULL was sent or a memory allocation failed.
+* 	A new sketch with the same counts otherwise.
+*/
+QuantileSketch quantileSketchCopy(QuantileSketch sketch);
+
+/**
+* quantileSketchAdd: Counts a value in a sketch.
+*
+* @param sketch - The sketch.
+* @param value - The value. Must be non-negative.
+* @return
+* 	false - if the input is NULL or an allocation failed.
+* 	true - otherwise.
+*/
+bool quantileSketchAdd(QuantileSketch sketch, int value);
+
+/**
+* quantileSketchRemove: Removes a value that was counted in a sketch.
+*
+* @param sketch - The sketch. If sketch is NULL nothing will be done.
+* @param value - The value. Removing a value that was not counted does nothing.
+*/
+void quantileSketchRemove(QuantileSketch sketch, int value);
+
+/**
+* quantileSketchMerge: Counts the values of a sketch in another sketch.
+*
+* @param sketch - The sketch to count in.
+* @param other - The sketch whose values are counted. It is not changed.
+* @return
+* 	false - if the input is NULL or an allocation failed, in which case sketch is not changed.
+* 	true - otherwise.
+*/
+bool quantileSketchMerge(QuantileSketch sketch, QuantileSketch other);
+
+/**
+* quantileSketchCount: Returns the number of values counted in a sketch.
+*
+* @param sketch - The sketch.
+* @return
+* 	0 - if sketch is NULL.
+* 	The number of values otherwise.
+*/
+int quantileSketchCount(QuantileSketch sketch);
+
+/**
+* quantileSketchQuantile: Returns an estimate of a quantile of the values counted in a sketch, the
+*   value of rank quantile * (count - 1) in increasing order.
+*
+* @param sketch - The sketch. Must have values.
+* @param quantile - The quantile, between 0 and 1. Values outside are taken as 0 or 1.
+* @return
+* 	0 - if sketch is NULL or empty.
+* 	The estimate otherwise, within SKETCH_ACCURACY of the value relative to it.
+*/
+double quantileSketchQuantile(QuantileSketch sketch, double quantile);
+
+/**
+* quantileSketchMemoryUsage: Adds the memory of a sketch to a footprint.
+*
+* @param sketch - The sketch. If sketch is NULL nothing will be added.
+* @param footprint - The footprint to add to.
+*/
+void quantileSketchMemoryUsage(QuantileSketch sketch, ChessMemoryFootprint *footprint);
+
+/**
+* quantileSketchTableCreate: Allocates an empty table of sketches.
+*
+* @return
+* 	NULL - if allocations failed.
+* 	A new table in case of success.
+*/
+QuantileSketchTable quantileSketchTableCreate();
+
+/**
+* quantileSketchTableDestroy: Deallocates a table and its sketches.
+*
+* @param table - Target table. If table is NULL nothing will be done.
+*/
+void quantileSketchTableDestroy(QuantileSketchTable table);
+
+/**
+* quantileSketchTableGet: Returns the sketch of a key.
+*
+* @param table - The table.
+* @param key - The key.
+* @return
+* 	NULL - if the input is NULL or the key has no values.
+* 	The sketch otherwise.
+*/
+QuantileSketch quantileSketchTableGet(QuantileSketchTable table, int key);
+
+/**
+* quantileSketchTableAdd: Counts a value in the sketch of a key, creating the sketch if needed.
+*
+* @param table - The table.
+* @param key - The key. Must be positive.
+* @param value - The value. Must be non-negative.
+* @return
+* 	false - if the input is NULL or an allocation failed.
+* 	true - otherwise.
+*/
+bool quantileSketchTableAdd(QuantileSketchTable table, int key, int value);
+
+/**
+* quantileSketchTableRemove: Removes a value from the sketch of a key, and frees the sketch once it
+*   has no values.
+*
+* @param table - The table. If table is NULL nothing will be done.
+* @param key - The key.
+* @param value - The value.
+*/
+void quantileSketchTableRemove(QuantileSketchTable table, int key, int value);
+
+/**
+* quantileSketchTableMemoryUsage: Adds the memory of a table and its sketches to a footprint.
+*
+* @param table - The table. If table is NULL nothing will be added.
+* @param footprint - The footprint to add to.
+*/
+void quantileSketchTableMemoryUsage(QuantileSketchTable table, ChessMemoryFootprint *footprint);
+
+#endif
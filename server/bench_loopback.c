@@ -0,0 +1,239 @@
+/*
+ * bench_loopback: measures the throughput of the generated workload sent to a chess_server over a
+ * Unix socket on the same machine.
+ *
+ * Each mode starts its own server on a temporary socket and runs the workload of the same seed for
+ * a fixed duration:
+ *   round_trip - every operation is a call of the client library, waiting for its response.
+ *   pipelined  - the operations are sent with chessPipeline, depth requests before their responses.
+ * One JSON line is printed per mode with its count, throughput and non-success results, as
+ * load_driver prints for the chess system in the same process. Exports write to /dev/null.
+ *
+ * Usage: bench_loopback [seconds] [seed] [server]
+ *   server is the path of the chess_server executable, ./chess_server by default.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "../benchmarks/workload.h"
+#include "chess_client.h"
+
+#define NANOSECONDS 1000000000.0
+#define DEFAULT_SECONDS 2.0
+#define DEFAULT_SERVER "./chess_server"
+#define SINK_PATH "/dev/null"
+#define SOCKET_PATH_SIZE 64
+#define CONNECT_ATTEMPTS 500
+#define CONNECT_WAIT_NS 10000000L
+#define SHALLOW_DEPTH 16
+#define DEEP_DEPTH CLIENT_PIPELINE_WINDOW
+
+static const int bench_depths[] = {1, SHALLOW_DEPTH, DEEP_DEPTH};
+
+static unsigned long long nanosecondsNow()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+ * startServer: Starts a chess_server on a socket path and connects to it.
+ *
+ * @param server_path - The path of the chess_server executable.
+ * @param socket_path - The socket path.
+ * @param server - Where to store the process id of the server.
+ * @return
+ *     The connection, or NULL if the server could not be started or connected to.
+ */
+static ChessSystem startServer(const char *server_path, const char *socket_path, pid_t *server)
+{
+    *server = fork();
+    if (*server < 0)
+    {
+        return NULL;
+    }
+    if (*server == 0)
+    {
+        execl(server_path, server_path, socket_path, (char *)NULL);
+        _exit(127);
+    }
+    struct timespec wait = {0, CONNECT_WAIT_NS};
+    for (int attempt = 0; attempt < CONNECT_ATTEMPTS; attempt++)
+    {
+        ChessSystem chess = chessConnect(socket_path);
+        if (chess != NULL)
+        {
+            return chess;
+        }
+        if (waitpid(*server, NULL, WNOHANG) == *server)
+        {
+            return NULL;
+        }
+        nanosleep(&wait, NULL);
+    }
+    kill(*server, SIGTERM);
+    waitpid(*server, NULL, 0);
+    return NULL;
+}
+
+static void stopServer(ChessSystem chess, pid_t server)
+{
+    chessDestroy(chess);
+    kill(server, SIGTERM);
+    waitpid(server, NULL, 0);
+}
+
+/**
+ * toRequest: Returns the protocol request of a generated operation.
+ */
+static ProtocolRequest toRequest(const WorkloadOperation *operation)
+{
+    ProtocolRequest request = {PROTOCOL_ADD_TOURNAMENT, {0}, NULL};
+    switch (operation->type)
+    {
+    case WORKLOAD_ADD_TOURNAMENT:
+        request.arguments[0] = operation->tournament_id;
+        request.arguments[1] = operation->max_games_per_player;
+        request.text = operation->location;
+        break;
+    case WORKLOAD_ADD_GAME:
+        request.operation = PROTOCOL_ADD_GAME;
+        request.arguments[0] = operation->tournament_id;
+        request.arguments[1] = operation->first_player;
+        request.arguments[2] = operation->second_player;
+        request.arguments[3] = operation->winner;
+        request.arguments[4] = operation->play_time;
+        break;
+    case WORKLOAD_END_TOURNAMENT:
+        request.operation = PROTOCOL_END_TOURNAMENT;
+        request.arguments[0] = operation->tournament_id;
+        break;
+    case WORKLOAD_REMOVE_TOURNAMENT:
+        request.operation = PROTOCOL_REMOVE_TOURNAMENT;
+        request.arguments[0] = operation->tournament_id;
+        break;
+    case WORKLOAD_REMOVE_PLAYER:
+        request.operation = PROTOCOL_REMOVE_PLAYER;
+        request.arguments[0] = operation->first_player;
+        break;
+    case WORKLOAD_AVERAGE_PLAY_TIME:
+        request.operation = PROTOCOL_AVERAGE_PLAY_TIME;
+        request.arguments[0] = operation->first_player;
+        break;
+    case WORKLOAD_SAVE_LEVELS:
+        request.operation = PROTOCOL_SAVE_LEVELS;
+        break;
+    default:
+        request.operation = PROTOCOL_SAVE_STATISTICS;
+        request.text = SINK_PATH;
+        break;
+    }
+    return request;
+}
+
+/**
+ * runMode: Runs the workload against a fresh server for a duration, depth requests at a time, and
+ * prints the JSON line of the mode.
+ *
+ * @return
+ *     false if the server could not be started or the connection failed, true otherwise.
+ */
+static bool runMode(const char *server_path, const WorkloadConfig *config, double seconds, int depth)
+{
+    char socket_path[SOCKET_PATH_SIZE];
+    snprintf(socket_path, sizeof(socket_path), "/tmp/chess_bench_%ld_%d.sock", (long)getpid(), depth);
+    pid_t server;
+    ChessSystem chess = startServer(server_path, socket_path, &server);
+    Workload workload = workloadCreate(config);
+    FILE *sink = fopen(SINK_PATH, "w");
+    if (chess == NULL || workload == NULL || sink == NULL)
+    {
+        fprintf(stderr, "bench_loopback: could not set up the run\n");
+        if (chess != NULL)
+        {
+            stopServer(chess, server);
+        }
+        workloadDestroy(workload);
+        if (sink != NULL)
+        {
+            fclose(sink);
+        }
+        return false;
+    }
+
+    ProtocolRequest requests[DEEP_DEPTH];
+    ProtocolResponse responses[DEEP_DEPTH];
+    unsigned long long count = 0, failures = 0;
+    bool connected = true;
+    unsigned long long start = nanosecondsNow(), deadline = start + (unsigned long long)(seconds * NANOSECONDS);
+    unsigned long long now = start;
+    WorkloadOperation operation;
+    while (connected && now < deadline)
+    {
+        if (depth == 1)
+        {
+            workloadNext(workload, &operation);
+            ChessResult result = workloadRun(chess, &operation, sink, SINK_PATH);
+            connected = result != CHESS_CONNECTION_FAILURE;
+            failures += result != CHESS_SUCCESS;
+        }
+        else
+        {
+            for (int i = 0; i < depth; i++)
+            {
+                workloadNext(workload, &operation);
+                requests[i] = toRequest(&operation);
+            }
+            connected = chessPipeline(chess, requests, depth, responses) == CHESS_SUCCESS;
+            for (int i = 0; connected && i < depth; i++)
+            {
+                failures += responses[i].result != CHESS_SUCCESS;
+            }
+        }
+        count += depth;
+        now = nanosecondsNow();
+    }
+    double elapsed = (now - start) / NANOSECONDS;
+    if (connected)
+    {
+        printf("{\"mode\":\"%s\",\"depth\":%d,\"count\":%llu,\"ops_per_sec\":%.1f,\"failures\":%llu,"
+               "\"seconds\":%.3f,\"seed\":%llu}\n",
+               depth == 1 ? "round_trip" : "pipelined", depth, count, count / elapsed, failures, elapsed,
+               config->seed);
+    }
+    else
+    {
+        fprintf(stderr, "bench_loopback: the connection to the server failed\n");
+    }
+
+    fclose(sink);
+    workloadDestroy(workload);
+    stopServer(chess, server);
+    return connected;
+}
+
+int main(int argc, char **argv)
+{
+    WorkloadConfig config;
+    workloadDefaultConfig(&config);
+    double seconds = argc > 1 ? atof(argv[1]) : DEFAULT_SECONDS;
+    if (argc > 2)
+    {
+        config.seed = strtoull(argv[2], NULL, 0);
+    }
+    const char *server_path = argc > 3 ? argv[3] : DEFAULT_SERVER;
+
+    for (size_t i = 0; i < sizeof(bench_depths) / sizeof(bench_depths[0]); i++)
+    {
+        if (runMode(server_path, &config, seconds, bench_depths[i]) == false)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
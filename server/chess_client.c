@@ -0,0 +1,390 @@
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "chess_client.h"
+
+#define CLIENT_READ_SIZE 65536
+
+struct chess_system_t
+{
+    int socket;
+    bool failed;
+    ProtocolBuffer output;
+    ProtocolBuffer input;
+    /** the length of the last response read, dropped from input before the next one */
+    size_t consumed;
+};
+
+/**
+ * receiveInput: Reads what the server sent into the input of a connection.
+ *
+ * @param chess - The chess system.
+ * @param flags - The flags of recv.
+ * @return
+ *     false if the server closed the connection or it failed, true otherwise.
+ */
+static bool receiveInput(ChessSystem chess, int flags)
+{
+    if (protocolBufferReserve(&chess->input, CLIENT_READ_SIZE) == false)
+    {
+        return false;
+    }
+    ssize_t length;
+    do
+    {
+        length = recv(chess->socket, chess->input.data + chess->input.size,
+                      chess->input.capacity - chess->input.size, flags);
+    } while (length < 0 && errno == EINTR);
+    if (length > 0)
+    {
+        chess->input.size += length;
+        return true;
+    }
+    return length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+/**
+ * sendOutput: Sends the requests in the output of a connection. Responses that arrive meanwhile are
+ * read into its input, so the server never waits for room to write them while the client waits for
+ * room to send.
+ *
+ * @return
+ *     false if the connection failed, true otherwise.
+ */
+static bool sendOutput(ChessSystem chess)
+{
+    size_t written = 0;
+    while (written < chess->output.size)
+    {
+        struct pollfd descriptor = {chess->socket, POLLIN | POLLOUT, 0};
+        if (poll(&descriptor, 1, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        if ((descriptor.revents & POLLIN) && receiveInput(chess, MSG_DONTWAIT) == false)
+        {
+            return false;
+        }
+        if (descriptor.revents & (POLLOUT | POLLERR | POLLHUP))
+        {
+            ssize_t length = send(chess->socket, chess->output.data + written, chess->output.size - written,
+                                  MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (length < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                return false;
+            }
+            written += length > 0 ? length : 0;
+        }
+    }
+    chess->output.size = 0;
+    return true;
+}
+
+/**
+ * receiveResponse: Waits for the next response of a connection. Its text points into the input of
+ * the connection until the next response is received.
+ *
+ * @param chess - The chess system.
+ * @param operation - The operation of the request the response answers.
+ * @param response - Where to store the response.
+ * @return
+ *     false if the connection failed or the response is not valid, true otherwise.
+ */
+static bool receiveResponse(ChessSystem chess, ProtocolOperation operation, ProtocolResponse *response)
+{
+    protocolBufferConsume(&chess->input, chess->consumed);
+    chess->consumed = 0;
+    while (true)
+    {
+        ProtocolStatus status = protocolReadResponse(chess->input.data, chess->input.size, response,
+                                                     &chess->consumed);
+        if (status == PROTOCOL_COMPLETE)
+        {
+            return response->operation == operation;
+        }
+        if (status == PROTOCOL_INVALID || receiveInput(chess, 0) == false)
+        {
+            chess->consumed = 0;
+            return false;
+        }
+    }
+}
+
+/**
+ * call: Sends one request and waits for its response.
+ *
+ * @param chess - The chess system.
+ * @param request - The request.
+ * @param response - Where to store the response.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_CONNECTION_FAILURE - if the connection failed now or before.
+ *     The result of the request otherwise.
+ */
+static ChessResult call(ChessSystem chess, const ProtocolRequest *request, ProtocolResponse *response)
+{
+    if (chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (chess->failed)
+    {
+        return CHESS_CONNECTION_FAILURE;
+    }
+    if (protocolWriteRequest(&chess->output, request) == false)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    if (sendOutput(chess) == false || receiveResponse(chess, request->operation, response) == false)
+    {
+        chess->failed = true;
+        return CHESS_CONNECTION_FAILURE;
+    }
+    return response->result;
+}
+
+ChessSystem chessConnect(const char *socket_path)
+{
+    struct sockaddr_un address;
+    if (socket_path == NULL || strlen(socket_path) >= sizeof(address.sun_path))
+    {
+        return NULL;
+    }
+    ChessSystem chess = malloc(sizeof(*chess));
+    if (chess == NULL)
+    {
+        return NULL;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+    chess->socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (chess->socket < 0 || connect(chess->socket, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        if (chess->socket >= 0)
+        {
+            close(chess->socket);
+        }
+        free(chess);
+        return NULL;
+    }
+    chess->failed = false;
+    protocolBufferInit(&chess->output);
+    protocolBufferInit(&chess->input);
+    chess->consumed = 0;
+    return chess;
+}
+
+ChessSystem chessCreate()
+{
+    const char *socket_path = getenv(CHESS_SOCKET_ENVIRONMENT);
+    return chessConnect(socket_path != NULL ? socket_path : CHESS_DEFAULT_SOCKET);
+}
+
+void chessDestroy(ChessSystem chess)
+{
+    if (chess == NULL)
+    {
+        return;
+    }
+    close(chess->socket);
+    protocolBufferFree(&chess->output);
+    protocolBufferFree(&chess->input);
+    free(chess);
+}
+
+ChessResult chessAddTournament(ChessSystem chess, int tournament_id, int max_games_per_player,
+                               const char *tournament_location)
+{
+    ProtocolRequest request = {PROTOCOL_ADD_TOURNAMENT, {tournament_id, max_games_per_player}, tournament_location};
+    ProtocolResponse response;
+    return call(chess, &request, &response);
+}
+
+ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player, int second_player, Winner winner,
+                         int play_time)
+{
+    ProtocolRequest request = {PROTOCOL_ADD_GAME, {tournament_id, first_player, second_player, winner, play_time},
+                               NULL};
+    ProtocolResponse response;
+    return call(chess, &request, &response);
+}
+
+ChessResult chessRemoveTournament(ChessSystem chess, int tournament_id)
+{
+    ProtocolRequest request = {PROTOCOL_REMOVE_TOURNAMENT, {tournament_id}, NULL};
+    ProtocolResponse response;
+    return call(chess, &request, &response);
+}
+
+ChessResult chessRemovePlayer(ChessSystem chess, int player_id)
+{
+    ProtocolRequest request = {PROTOCOL_REMOVE_PLAYER, {player_id}, NULL};
+    ProtocolResponse response;
+    return call(chess, &request, &response);
+}
+
+ChessResult chessEndTournament(ChessSystem chess, int tournament_id)
+{
+    ProtocolRequest request = {PROTOCOL_END_TOURNAMENT, {tournament_id}, NULL};
+    ProtocolResponse response;
+    return call(chess, &request, &response);
+}
+
+ChessResult chessRecalculateRatings(ChessSystem chess)
+{
+    ProtocolRequest request = {PROTOCOL_RECALCULATE_RATINGS, {0}, NULL};
+    ProtocolResponse response;
+    return call(chess, &request, &response);
+}
+
+/**
+ * callForValue: Sends a request that returns a double and waits for its response.
+ *
+ * @return
+ *     The returned double in case of success, and 0 otherwise. chess_result will contain the result of call.
+ */
+static double callForValue(ChessSystem chess, ProtocolOperation operation, int player_id, ChessResult *chess_result)
+{
+    ProtocolRequest request = {operation, {player_id}, NULL};
+    ProtocolResponse response;
+    ChessResult result = call(chess, &request, &response);
+    if (chess_result != NULL)
+    {
+        *chess_result = result;
+    }
+    return result == CHESS_SUCCESS ? response.value : 0;
+}
+
+double chessCalculateAveragePlayTime(ChessSystem chess, int player_id, ChessResult *chess_result)
+{
+    return callForValue(chess, PROTOCOL_AVERAGE_PLAY_TIME, player_id, chess_result);
+}
+
+double chessGetPlayerRating(ChessSystem chess, int player_id, ChessResult *chess_result)
+{
+    return callForValue(chess, PROTOCOL_PLAYER_RATING, player_id, chess_result);
+}
+
+/**
+ * callForText: Sends an export request and writes the exported text to a file.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or file are NULL.
+ *     CHESS_SAVE_FAILURE - if the text could not be written.
+ *     The result of call otherwise.
+ */
+static ChessResult callForText(ChessSystem chess, ProtocolOperation operation, FILE *file)
+{
+    if (file == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    ProtocolRequest request = {operation, {0}, NULL};
+    ProtocolResponse response;
+    ChessResult result = call(chess, &request, &response);
+    if (result == CHESS_SUCCESS && response.text_length > 0 &&
+        fwrite(response.text, 1, response.text_length, file) != response.text_length)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    return result;
+}
+
+ChessResult chessSavePlayersLevels(ChessSystem chess, FILE *file)
+{
+    return callForText(chess, PROTOCOL_SAVE_LEVELS, file);
+}
+
+ChessResult chessSavePlayersRatings(ChessSystem chess, FILE *file)
+{
+    return callForText(chess, PROTOCOL_SAVE_RATINGS, file);
+}
+
+ChessResult chessSaveTournamentStatistics(ChessSystem chess, char *path_file)
+{
+    ProtocolRequest request = {PROTOCOL_SAVE_STATISTICS, {0}, path_file};
+    ProtocolResponse response;
+    if (path_file == NULL || path_file[0] == '/')
+    {
+        return call(chess, &request, &response);
+    }
+    // The server has its own working directory, so a relative path is sent from the client's
+    char *directory = getcwd(NULL, 0);
+    char *path = directory == NULL ? NULL : malloc(strlen(directory) + strlen(path_file) + 2);
+    if (path == NULL)
+    {
+        free(directory);
+        return CHESS_OUT_OF_MEMORY;
+    }
+    strcpy(path, directory);
+    strcat(path, "/");
+    strcat(path, path_file);
+    request.text = path;
+    ChessResult result = call(chess, &request, &response);
+    free(path);
+    free(directory);
+    return result;
+}
+
+ChessResult chessPipeline(ChessSystem chess, const ProtocolRequest *requests, int count, ProtocolResponse *responses)
+{
+    if (chess == NULL || requests == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (requests[i].operation < PROTOCOL_ADD_TOURNAMENT || requests[i].operation > PROTOCOL_SAVE_STATISTICS)
+        {
+            return CHESS_INVALID_QUERY;
+        }
+    }
+    if (chess->failed)
+    {
+        return CHESS_CONNECTION_FAILURE;
+    }
+    for (int start = 0; start < count; start += CLIENT_PIPELINE_WINDOW)
+    {
+        int end = count - start < CLIENT_PIPELINE_WINDOW ? count : start + CLIENT_PIPELINE_WINDOW;
+        for (int i = start; i < end; i++)
+        {
+            if (protocolWriteRequest(&chess->output, &requests[i]) == false)
+            {
+                chess->output.size = 0;
+                return CHESS_OUT_OF_MEMORY;
+            }
+        }
+        if (sendOutput(chess) == false)
+        {
+            chess->failed = true;
+            return CHESS_CONNECTION_FAILURE;
+        }
+        for (int i = start; i < end; i++)
+        {
+            ProtocolResponse response;
+            if (receiveResponse(chess, requests[i].operation, &response) == false)
+            {
+                chess->failed = true;
+                return CHESS_CONNECTION_FAILURE;
+            }
+            if (responses != NULL)
+            {
+                response.text = NULL;
+                response.text_length = 0;
+                responses[i] = response;
+            }
+        }
+    }
+    return CHESS_SUCCESS;
+}
@@ -0,0 +1,61 @@
+#ifndef CHESS_CLIENT_H
+#define CHESS_CLIENT_H
+#include "chess_protocol.h"
+
+#define CLIENT_PIPELINE_WINDOW 256
+
+/*
+* The client library of chess_server: a ChessSystem whose operations run on the system of a server.
+*
+* A program built against chessSystem.h links this library in place of the chess system sources and
+* keeps calling the same functions; chessCreate connects to the server at $CHESS_SOCKET, or at
+* CHESS_DEFAULT_SOCKET, and chessDestroy disconnects, leaving the server's system as it is. All the
+* clients of one server share its system.
+*
+* Only these chessSystem.h functions are available, each sending one request and waiting for its
+* response. A failure of the connection returns CHESS_CONNECTION_FAILURE, after which every call
+* does.
+*   chessCreate, chessDestroy, chessAddTournament, chessAddGame, chessRemoveTournament,
+*   chessRemovePlayer, chessEndTournament, chessRecalculateRatings, chessCalculateAveragePlayTime,
+*   chessGetPlayerRating, chessSavePlayersLevels, chessSavePlayersRatings,
+*   chessSaveTournamentStatistics - the statistics file is written by the server, a relative path
+*                                   is taken from the client's working directory.
+* Only the user the server runs as can connect to its socket. A levels or ratings export longer than
+* PROTOCOL_MAX_TEXT returns CHESS_SAVE_FAILURE.
+*
+* The following functions are available:
+*   chessConnect    - Connects to the server at a socket path
+*   chessPipeline   - Sends many requests before reading their responses
+*/
+
+/**
+* chessConnect: Connects to the chess server listening at a Unix socket path.
+*
+* @param socket_path - The path of the server's socket.
+* @return
+* 	NULL - if socket_path is NULL, the connection failed or allocations failed.
+* 	A chess system running on the server otherwise, to delete with chessDestroy.
+*/
+ChessSystem chessConnect(const char *socket_path);
+
+/**
+* chessPipeline: Runs many requests, sending them in windows of up to CLIENT_PIPELINE_WINDOW requests
+*   before reading the responses of each window, so a round trip is paid per window rather than per
+*   request. The requests run in order, exactly as the same calls one by one. The text of the levels
+*   and ratings exports is not returned, and the paths of statistics requests are used by the server
+*   as they are.
+*
+* @param chess - The chess system.
+* @param requests - The requests.
+* @param count - The number of requests.
+* @param responses - Where to store the response of each request. May be NULL to only run them.
+* @return
+*     CHESS_NULL_ARGUMENT - if chess or requests are NULL.
+*     CHESS_INVALID_QUERY - if one of the requests has an invalid operation. None of them ran.
+*     CHESS_OUT_OF_MEMORY - if an allocation failed. The windows before it ran.
+*     CHESS_CONNECTION_FAILURE - if the connection failed. Some of the requests may have run.
+*     CHESS_SUCCESS - otherwise, whatever the results of the requests.
+*/
+ChessResult chessPipeline(ChessSystem chess, const ProtocolRequest *requests, int count, ProtocolResponse *responses);
+
+#endif
@@ -0,0 +1,386 @@
+#include <stdlib.h>
+#include <string.h>
+#include "chess_protocol.h"
+
+#define INITIAL_CAPACITY 4096
+#define EXPAND 2
+#define MAX_VARINT_SIZE 5
+#define VARINT_BITS 7
+#define VARINT_MASK 0x7F
+#define VARINT_MORE 0x80
+#define BYTE_BITS 8
+#define BYTE_MASK 0xFF
+#define DOUBLE_SIZE 8
+#define NO_TEXT 0
+
+/**
+ * operationArguments: Returns the number of int arguments of an operation.
+ *
+ * @param operation - The protocol operation.
+ * @return
+ *     -1 if the operation is unknown, the number of arguments otherwise.
+ */
+static int operationArguments(ProtocolOperation operation)
+{
+    switch (operation)
+    {
+    case PROTOCOL_ADD_TOURNAMENT:
+        return 2;
+    case PROTOCOL_ADD_GAME:
+        return 5;
+    case PROTOCOL_REMOVE_TOURNAMENT:
+    case PROTOCOL_REMOVE_PLAYER:
+    case PROTOCOL_END_TOURNAMENT:
+    case PROTOCOL_AVERAGE_PLAY_TIME:
+    case PROTOCOL_PLAYER_RATING:
+        return 1;
+    case PROTOCOL_RECALCULATE_RATINGS:
+    case PROTOCOL_SAVE_LEVELS:
+    case PROTOCOL_SAVE_RATINGS:
+    case PROTOCOL_SAVE_STATISTICS:
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+/**
+ * requestHasText: Returns if the requests of an operation carry a text.
+ */
+static bool requestHasText(ProtocolOperation operation)
+{
+    return operation == PROTOCOL_ADD_TOURNAMENT || operation == PROTOCOL_SAVE_STATISTICS;
+}
+
+/**
+ * responseHasValue: Returns if the responses of an operation carry a double.
+ */
+static bool responseHasValue(ProtocolOperation operation)
+{
+    return operation == PROTOCOL_AVERAGE_PLAY_TIME || operation == PROTOCOL_PLAYER_RATING;
+}
+
+/**
+ * responseHasText: Returns if the responses of an operation carry an exported text.
+ */
+static bool responseHasText(ProtocolOperation operation)
+{
+    return operation == PROTOCOL_SAVE_LEVELS || operation == PROTOCOL_SAVE_RATINGS;
+}
+
+/**
+ * putVarint: Stores an unsigned value using 7 bits per byte, low bits first.
+ *
+ * @param destination - Where to store the bytes. Must have room for MAX_VARINT_SIZE bytes.
+ * @param value - The value.
+ * @return
+ *     The number of bytes stored.
+ */
+static size_t putVarint(unsigned char *destination, unsigned int value)
+{
+    size_t length = 0;
+    while (value > VARINT_MASK)
+    {
+        destination[length++] = (unsigned char)((value & VARINT_MASK) | VARINT_MORE);
+        value >>= VARINT_BITS;
+    }
+    destination[length++] = (unsigned char)value;
+    return length;
+}
+
+/**
+ * getVarint: Loads a value stored by putVarint.
+ *
+ * @param source - The bytes.
+ * @param size - The number of bytes.
+ * @param offset - The offset of the value, advanced past it.
+ * @param value - Where to store the value.
+ * @return
+ *     false if the bytes end before the value or it is longer than MAX_VARINT_SIZE bytes,
+ *     true otherwise.
+ */
+static bool getVarint(const unsigned char *source, size_t size, size_t *offset, unsigned int *value)
+{
+    *value = 0;
+    for (int i = 0; i < MAX_VARINT_SIZE && *offset < size; i++)
+    {
+        unsigned char byte = source[(*offset)++];
+        *value |= (unsigned int)(byte & VARINT_MASK) << (i * VARINT_BITS);
+        if ((byte & VARINT_MORE) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * zigzag: Maps signed values to unsigned values so that small negative values stay short as varints.
+ */
+static unsigned int zigzag(int value)
+{
+    return ((unsigned int)value << 1) ^ (unsigned int)-(value < 0);
+}
+
+/**
+ * unzigzag: Reverses zigzag.
+ */
+static int unzigzag(unsigned int value)
+{
+    return (int)((value >> 1) ^ -(value & 1));
+}
+
+void protocolBufferInit(ProtocolBuffer *buffer)
+{
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+}
+
+void protocolBufferFree(ProtocolBuffer *buffer)
+{
+    free(buffer->data);
+    protocolBufferInit(buffer);
+}
+
+bool protocolBufferReserve(ProtocolBuffer *buffer, size_t length)
+{
+    if (buffer->size + length <= buffer->capacity)
+    {
+        return true;
+    }
+    size_t capacity = buffer->capacity == 0 ? INITIAL_CAPACITY : buffer->capacity;
+    while (capacity < buffer->size + length)
+    {
+        capacity *= EXPAND;
+    }
+    unsigned char *data = realloc(buffer->data, capacity);
+    if (data == NULL)
+    {
+        return false;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return true;
+}
+
+void protocolBufferConsume(ProtocolBuffer *buffer, size_t length)
+{
+    if (length == 0)
+    {
+        return;
+    }
+    memmove(buffer->data, buffer->data + length, buffer->size - length);
+    buffer->size -= length;
+}
+
+/**
+ * finishFrame: Puts the length of the body at the end of a buffer before it, making it a frame.
+ *
+ * @param buffer - The buffer. Must have room for MAX_VARINT_SIZE more bytes.
+ * @param start - Where the body starts in the buffer.
+ */
+static void finishFrame(ProtocolBuffer *buffer, size_t start)
+{
+    unsigned char header[MAX_VARINT_SIZE];
+    size_t body_length = buffer->size - start;
+    size_t header_length = putVarint(header, (unsigned int)body_length);
+    memmove(buffer->data + start + header_length, buffer->data + start, body_length);
+    memcpy(buffer->data + start, header, header_length);
+    buffer->size += header_length;
+}
+
+/**
+ * readFrame: Finds the body of the frame at the start of some bytes.
+ *
+ * @param data - The bytes.
+ * @param size - The number of bytes.
+ * @param body - Where to store the offset of the body.
+ * @param length - Where to store the length of the frame.
+ * @return
+ *     The status of the frame.
+ */
+static ProtocolStatus readFrame(const unsigned char *data, size_t size, size_t *body, size_t *length)
+{
+    size_t offset = 0;
+    unsigned int body_length;
+    if (getVarint(data, size, &offset, &body_length) == false)
+    {
+        return offset < MAX_VARINT_SIZE ? PROTOCOL_INCOMPLETE : PROTOCOL_INVALID;
+    }
+    if (body_length == 0 || body_length > PROTOCOL_MAX_FRAME)
+    {
+        return PROTOCOL_INVALID;
+    }
+    if (size - offset < body_length)
+    {
+        return PROTOCOL_INCOMPLETE;
+    }
+    *body = offset;
+    *length = offset + body_length;
+    return PROTOCOL_COMPLETE;
+}
+
+bool protocolWriteRequest(ProtocolBuffer *buffer, const ProtocolRequest *request)
+{
+    int number_of_arguments = operationArguments(request->operation);
+    if (number_of_arguments < 0)
+    {
+        return false;
+    }
+    size_t text_length = requestHasText(request->operation) && request->text != NULL ? strlen(request->text) + 1 : 0;
+    if (text_length > PROTOCOL_MAX_TEXT ||
+        protocolBufferReserve(buffer, 2 * MAX_VARINT_SIZE * (number_of_arguments + 2) + text_length) == false)
+    {
+        return false;
+    }
+    size_t start = buffer->size;
+    unsigned char *body = buffer->data;
+    body[buffer->size++] = (unsigned char)request->operation;
+    for (int i = 0; i < number_of_arguments; i++)
+    {
+        buffer->size += putVarint(body + buffer->size, zigzag(request->arguments[i]));
+    }
+    if (requestHasText(request->operation))
+    {
+        buffer->size += putVarint(body + buffer->size, (unsigned int)text_length);
+        if (text_length > 0)
+        {
+            memcpy(body + buffer->size, request->text, text_length);
+            buffer->size += text_length;
+        }
+    }
+    finishFrame(buffer, start);
+    return true;
+}
+
+ProtocolStatus protocolReadRequest(const unsigned char *data, size_t size, ProtocolRequest *request, size_t *length)
+{
+    size_t offset;
+    ProtocolStatus status = readFrame(data, size, &offset, length);
+    if (status != PROTOCOL_COMPLETE)
+    {
+        return status;
+    }
+    request->operation = data[offset++];
+    int number_of_arguments = operationArguments(request->operation);
+    if (number_of_arguments < 0)
+    {
+        return PROTOCOL_INVALID;
+    }
+    unsigned int value;
+    for (int i = 0; i < PROTOCOL_MAX_ARGUMENTS; i++)
+    {
+        request->arguments[i] = 0;
+        if (i < number_of_arguments)
+        {
+            if (getVarint(data, *length, &offset, &value) == false)
+            {
+                return PROTOCOL_INVALID;
+            }
+            request->arguments[i] = unzigzag(value);
+        }
+    }
+    request->text = NULL;
+    if (requestHasText(request->operation))
+    {
+        if (getVarint(data, *length, &offset, &value) == false || value > *length - offset)
+        {
+            return PROTOCOL_INVALID;
+        }
+        if (value != NO_TEXT)
+        {
+            // The text is sent with its NUL, so it is used where it is
+            if (data[offset + value - 1] != '\0')
+            {
+                return PROTOCOL_INVALID;
+            }
+            request->text = (const char *)data + offset;
+        }
+        offset += value;
+    }
+    return offset == *length ? PROTOCOL_COMPLETE : PROTOCOL_INVALID;
+}
+
+bool protocolWriteResponse(ProtocolBuffer *buffer, const ProtocolResponse *response)
+{
+    size_t text_length = responseHasText(response->operation) ? response->text_length : 0;
+    if (text_length > PROTOCOL_MAX_TEXT ||
+        protocolBufferReserve(buffer, 2 + DOUBLE_SIZE + 2 * MAX_VARINT_SIZE + text_length) == false)
+    {
+        return false;
+    }
+    size_t start = buffer->size;
+    unsigned char *body = buffer->data;
+    body[buffer->size++] = (unsigned char)response->operation;
+    body[buffer->size++] = (unsigned char)response->result;
+    if (responseHasValue(response->operation))
+    {
+        unsigned long long bits;
+        memcpy(&bits, &response->value, DOUBLE_SIZE);
+        for (int i = 0; i < DOUBLE_SIZE; i++)
+        {
+            body[buffer->size++] = (unsigned char)((bits >> (i * BYTE_BITS)) & BYTE_MASK);
+        }
+    }
+    if (responseHasText(response->operation))
+    {
+        buffer->size += putVarint(body + buffer->size, (unsigned int)text_length);
+        if (text_length > 0)
+        {
+            memcpy(body + buffer->size, response->text, text_length);
+            buffer->size += text_length;
+        }
+    }
+    finishFrame(buffer, start);
+    return true;
+}
+
+ProtocolStatus protocolReadResponse(const unsigned char *data, size_t size, ProtocolResponse *response,
+                                    size_t *length)
+{
+    size_t offset;
+    ProtocolStatus status = readFrame(data, size, &offset, length);
+    if (status != PROTOCOL_COMPLETE)
+    {
+        return status;
+    }
+    if (*length - offset < 2)
+    {
+        return PROTOCOL_INVALID;
+    }
+    response->operation = data[offset++];
+    response->result = data[offset++];
+    response->value = 0;
+    response->text = NULL;
+    response->text_length = 0;
+    if (operationArguments(response->operation) < 0)
+    {
+        return PROTOCOL_INVALID;
+    }
+    if (responseHasValue(response->operation))
+    {
+        if (*length - offset < DOUBLE_SIZE)
+        {
+            return PROTOCOL_INVALID;
+        }
+        unsigned long long bits = 0;
+        for (int i = 0; i < DOUBLE_SIZE; i++)
+        {
+            bits |= (unsigned long long)data[offset++] << (i * BYTE_BITS);
+        }
+        memcpy(&response->value, &bits, DOUBLE_SIZE);
+    }
+    if (responseHasText(response->operation))
+    {
+        unsigned int text_length;
+        if (getVarint(data, *length, &offset, &text_length) == false || text_length > *length - offset)
+        {
+            return PROTOCOL_INVALID;
+        }
+        response->text = (const char *)data + offset;
+        response->text_length = text_length;
+        offset += text_length;
+    }
+    return offset == *length ? PROTOCOL_COMPLETE : PROTOCOL_INVALID;
+}
@@ -0,0 +1,180 @@
+#ifndef CHESS_PROTOCOL_H
+#define CHESS_PROTOCOL_H
+#include <stdbool.h>
+#include <stddef.h>
+#include "../chessSystem.h"
+
+#define PROTOCOL_MAX_ARGUMENTS 5
+#define PROTOCOL_MAX_FRAME (1 << 26)
+#define PROTOCOL_MAX_TEXT (PROTOCOL_MAX_FRAME / 2)
+#define CHESS_SOCKET_ENVIRONMENT "CHESS_SOCKET"
+#define CHESS_DEFAULT_SOCKET "/tmp/chess_server.sock"
+
+/*
+* The binary protocol between chess_server and the client library, over a Unix stream socket.
+*
+* Every message is a frame: a varint length followed by that many bytes of body.
+*   request body  - operation byte, the zigzag varint int arguments of the operation, and for the
+*                   operations with a text (a location or a file path) a varint of its length plus
+*                   one followed by its bytes and a NUL, or a 0 varint for a NULL text.
+*   response body - operation byte, result byte (a ChessResult), and the returned value as 8
+*                   bytes of a little endian IEEE double for the operations that return a double,
+*                   or the varint length and bytes of the exported text for the level and rating
+*                   exports.
+*
+* The server answers the requests of a connection in the order they were sent, so a client may
+* send many requests before reading their responses (pipelining), and the server handles all
+* the requests of one read and sends all their responses with one write (batching).
+*
+* The following functions are available:
+*   protocolBufferInit      - Initializes an empty buffer
+*   protocolBufferFree      - Frees the bytes of a buffer
+*   protocolBufferReserve   - Makes room for more bytes at the end of a buffer
+*   protocolBufferConsume   - Removes bytes from the start of a buffer
+*   protocolWriteRequest    - Appends a request frame to a buffer
+*   protocolReadRequest     - Decodes the request frame at the start of some bytes
+*   protocolWriteResponse   - Appends a response frame to a buffer
+*   protocolReadResponse    - Decodes the response frame at the start of some bytes
+*/
+
+/** Type for defining the operations of the protocol, each a chessSystem.h function */
+typedef enum {
+    PROTOCOL_ADD_TOURNAMENT = 1,
+    PROTOCOL_ADD_GAME,
+    PROTOCOL_REMOVE_TOURNAMENT,
+    PROTOCOL_REMOVE_PLAYER,
+    PROTOCOL_END_TOURNAMENT,
+    PROTOCOL_RECALCULATE_RATINGS,
+    PROTOCOL_AVERAGE_PLAY_TIME,
+    PROTOCOL_PLAYER_RATING,
+    PROTOCOL_SAVE_LEVELS,
+    PROTOCOL_SAVE_RATINGS,
+    PROTOCOL_SAVE_STATISTICS
+} ProtocolOperation;
+
+/**
+* Type for defining one request. The arguments are the int arguments of the operation in the order
+* of the chessSystem.h function, text is the location of PROTOCOL_ADD_TOURNAMENT or the file path
+* of PROTOCOL_SAVE_STATISTICS.
+*/
+typedef struct {
+    ProtocolOperation operation;
+    int arguments[PROTOCOL_MAX_ARGUMENTS];
+    const char *text;
+} ProtocolRequest;
+
+/**
+* Type for defining one response. value is the double returned by PROTOCOL_AVERAGE_PLAY_TIME and
+* PROTOCOL_PLAYER_RATING, text and text_length the output of PROTOCOL_SAVE_LEVELS and
+* PROTOCOL_SAVE_RATINGS, not NUL terminated.
+*/
+typedef struct {
+    ProtocolOperation operation;
+    ChessResult result;
+    double value;
+    const char *text;
+    size_t text_length;
+} ProtocolResponse;
+
+/** Type for defining a growable byte buffer */
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+} ProtocolBuffer;
+
+/** Type for defining the outcome of decoding a frame */
+typedef enum {
+    PROTOCOL_COMPLETE,
+    PROTOCOL_INCOMPLETE,
+    PROTOCOL_INVALID
+} ProtocolStatus;
+
+/**
+* protocolBufferInit: Initializes an empty buffer.
+*
+* @param buffer - The buffer.
+*/
+void protocolBufferInit(ProtocolBuffer *buffer);
+
+/**
+* protocolBufferFree: Frees the bytes of a buffer, leaving it empty.
+*
+* @param buffer - The buffer.
+*/
+void protocolBufferFree(ProtocolBuffer *buffer);
+
+/**
+* protocolBufferReserve: Makes room for at least length more bytes after the end of a buffer.
+*
+* @param buffer - The buffer.
+* @param length - The number of bytes.
+* @return
+* 	false - if the allocation failed.
+* 	true - otherwise.
+*/
+bool protocolBufferReserve(ProtocolBuffer *buffer, size_t length);
+
+/**
+* protocolBufferConsume: Removes bytes from the start of a buffer, moving the rest to the start.
+*
+* @param buffer - The buffer.
+* @param length - The number of bytes. Must not be more than the size of the buffer.
+*/
+void protocolBufferConsume(ProtocolBuffer *buffer, size_t length);
+
+/**
+* protocolWriteRequest: Appends the frame of a request to a buffer.
+*
+* @param buffer - The buffer.
+* @param request - The request.
+* @return
+* 	false - if the operation is not valid, the text is longer than PROTOCOL_MAX_TEXT or an
+* 	        allocation failed.
+* 	true - otherwise.
+*/
+bool protocolWriteRequest(ProtocolBuffer *buffer, const ProtocolRequest *request);
+
+/**
+* protocolReadRequest: Decodes the request frame at the start of some bytes. The text of the request
+*   points into the bytes.
+*
+* @param data - The bytes.
+* @param size - The number of bytes.
+* @param request - Where to store the request.
+* @param length - Where to store the length of the frame.
+* @return
+* 	PROTOCOL_INCOMPLETE - if the bytes end before the frame.
+* 	PROTOCOL_INVALID - if the frame is not a valid request.
+* 	PROTOCOL_COMPLETE - otherwise.
+*/
+ProtocolStatus protocolReadRequest(const unsigned char *data, size_t size, ProtocolRequest *request, size_t *length);
+
+/**
+* protocolWriteResponse: Appends the frame of a response to a buffer.
+*
+* @param buffer - The buffer.
+* @param response - The response.
+* @return
+* 	false - if the text is longer than PROTOCOL_MAX_TEXT or an allocation failed.
+* 	true - otherwise.
+*/
+bool protocolWriteResponse(ProtocolBuffer *buffer, const ProtocolResponse *response);
+
+/**
+* protocolReadResponse: Decodes the response frame at the start of some bytes. The text of the
+*   response points into the bytes.
+*
+* @param data - The bytes.
+* @param size - The number of bytes.
+* @param response - Where to store the response.
+* @param length - Where to store the length of the frame.
+* @return
+* 	PROTOCOL_INCOMPLETE - if the bytes end before the frame.
+* 	PROTOCOL_INVALID - if the frame is not a valid response.
+* 	PROTOCOL_COMPLETE - otherwise.
+*/
+ProtocolStatus protocolReadResponse(const unsigned char *data, size_t size, ProtocolResponse *response,
+                                    size_t *length);
+
+#endif
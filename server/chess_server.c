@@ -0,0 +1,446 @@
+/*
+ * chess_server: owns one ChessSystem and serves the chessSystem.h operations of chess_protocol.h to
+ * the clients of a Unix domain socket.
+ *
+ * One thread runs an epoll loop over the listening socket and the connections, all non-blocking.
+ * A readable connection is read until it has nothing more, then every complete request in its
+ * input is served in order and the responses are appended to its output, which is written when
+ * the socket takes it. While the output of a connection holds more than SERVER_OUTPUT_LIMIT
+ * bytes its requests wait and it is not read, so a client that does not read its responses grows
+ * neither its output nor its input forever. A client that closes or shuts down its side has the
+ * requests it sent served and their responses written before the connection is closed.
+ * A connection that sends a frame that is not a valid request is closed.
+ *
+ * The levels and ratings exports are returned in the response, and an export longer than
+ * PROTOCOL_MAX_TEXT returns CHESS_SAVE_FAILURE instead. The statistics export writes the file at
+ * the path of the request, on the server's side and with the server's permissions, so the socket
+ * is created for the server's user only.
+ *
+ * Usage: chess_server [socket_path]
+ *   The default path is $CHESS_SOCKET, or CHESS_DEFAULT_SOCKET. SIGINT and SIGTERM stop the server.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "chess_protocol.h"
+
+#define SERVER_BACKLOG 64
+#define SERVER_EVENTS 64
+#define SERVER_READ_SIZE 65536
+#define SERVER_OUTPUT_LIMIT (1 << 20)
+#define SERVER_SOCKET_MASK 0177
+
+typedef struct connection_t
+{
+    int socket;
+    ProtocolBuffer input;
+    ProtocolBuffer output;
+    unsigned int interest;
+    bool read_closed;
+    struct connection_t *next;
+    struct connection_t *previous;
+} *Connection;
+
+typedef struct
+{
+    ChessSystem chess;
+    int listener;
+    int epoll;
+    Connection connections;
+} Server;
+
+static volatile sig_atomic_t stopping = 0;
+
+static void stopServer(int signal_number)
+{
+    (void)signal_number;
+    stopping = 1;
+}
+
+/**
+ * captureExport: Runs the levels or ratings export of a request into memory.
+ *
+ * @param chess - The chess system.
+ * @param operation - PROTOCOL_SAVE_LEVELS or PROTOCOL_SAVE_RATINGS.
+ * @param response - Where to store the result and text. The text is allocated with malloc.
+ * @param text - Where to store the text to free, or NULL.
+ */
+static void captureExport(ChessSystem chess, ProtocolOperation operation, ProtocolResponse *response, char **text)
+{
+    size_t length = 0;
+    *text = NULL;
+    FILE *stream = open_memstream(text, &length);
+    if (stream == NULL)
+    {
+        response->result = CHESS_OUT_OF_MEMORY;
+        return;
+    }
+    response->result = operation == PROTOCOL_SAVE_LEVELS ? chessSavePlayersLevels(chess, stream)
+                                                         : chessSavePlayersRatings(chess, stream);
+    if (fclose(stream) != 0 && response->result == CHESS_SUCCESS)
+    {
+        response->result = CHESS_SAVE_FAILURE;
+    }
+    // A longer text does not fit in a response frame
+    if (response->result == CHESS_SUCCESS && length > PROTOCOL_MAX_TEXT)
+    {
+        response->result = CHESS_SAVE_FAILURE;
+    }
+    response->text = *text;
+    response->text_length = response->result == CHESS_SUCCESS ? length : 0;
+}
+
+/**
+ * serveRequest: Runs one request against the chess system and appends its response to an output.
+ *
+ * @param chess - The chess system.
+ * @param request - The request.
+ * @param output - The buffer to append the response to.
+ * @return
+ *     false if an allocation failed, true otherwise.
+ */
+static bool serveRequest(ChessSystem chess, const ProtocolRequest *request, ProtocolBuffer *output)
+{
+    const int *arguments = request->arguments;
+    ProtocolResponse response = {request->operation, CHESS_SUCCESS, 0, NULL, 0};
+    char *text = NULL;
+    switch (request->operation)
+    {
+    case PROTOCOL_ADD_TOURNAMENT:
+        response.result = chessAddTournament(chess, arguments[0], arguments[1], (char *)request->text);
+        break;
+    case PROTOCOL_ADD_GAME:
+        response.result = chessAddGame(chess, arguments[0], arguments[1], arguments[2], (Winner)arguments[3],
+                                       arguments[4]);
+        break;
+    case PROTOCOL_REMOVE_TOURNAMENT:
+        response.result = chessRemoveTournament(chess, arguments[0]);
+        break;
+    case PROTOCOL_REMOVE_PLAYER:
+        response.result = chessRemovePlayer(chess, arguments[0]);
+        break;
+    case PROTOCOL_END_TOURNAMENT:
+        response.result = chessEndTournament(chess, arguments[0]);
+        break;
+    case PROTOCOL_RECALCULATE_RATINGS:
+        response.result = chessRecalculateRatings(chess);
+        break;
+    case PROTOCOL_AVERAGE_PLAY_TIME:
+        response.value = chessCalculateAveragePlayTime(chess, arguments[0], &response.result);
+        break;
+    case PROTOCOL_PLAYER_RATING:
+        response.value = chessGetPlayerRating(chess, arguments[0], &response.result);
+        break;
+    case PROTOCOL_SAVE_LEVELS:
+    case PROTOCOL_SAVE_RATINGS:
+        captureExport(chess, request->operation, &response, &text);
+        break;
+    case PROTOCOL_SAVE_STATISTICS:
+        response.result = chessSaveTournamentStatistics(chess, (char *)request->text);
+        break;
+    }
+    bool written = protocolWriteResponse(output, &response);
+    free(text);
+    return written;
+}
+
+/**
+ * updateInterest: Watches a connection for input while its output has room and the client did not
+ * close its side, and for output while it has any.
+ *
+ * @return
+ *     false if epoll failed, true otherwise.
+ */
+static bool updateInterest(Server *server, Connection connection)
+{
+    bool readable = connection->read_closed == false && connection->output.size < SERVER_OUTPUT_LIMIT;
+    unsigned int interest = (readable ? EPOLLIN : 0) |
+                            (connection->output.size > 0 ? EPOLLOUT : 0);
+    if (interest == connection->interest)
+    {
+        return true;
+    }
+    struct epoll_event event = {.events = interest, .data.ptr = connection};
+    if (epoll_ctl(server->epoll, EPOLL_CTL_MOD, connection->socket, &event) != 0)
+    {
+        return false;
+    }
+    connection->interest = interest;
+    return true;
+}
+
+static void closeConnection(Server *server, Connection connection)
+{
+    epoll_ctl(server->epoll, EPOLL_CTL_DEL, connection->socket, NULL);
+    close(connection->socket);
+    if (connection->previous != NULL)
+    {
+        connection->previous->next = connection->next;
+    }
+    else
+    {
+        server->connections = connection->next;
+    }
+    if (connection->next != NULL)
+    {
+        connection->next->previous = connection->previous;
+    }
+    protocolBufferFree(&connection->input);
+    protocolBufferFree(&connection->output);
+    free(connection);
+}
+
+/**
+ * acceptConnections: Accepts every pending connection of the listening socket.
+ */
+static void acceptConnections(Server *server)
+{
+    while (true)
+    {
+        int socket = accept(server->listener, NULL, NULL);
+        if (socket < 0)
+        {
+            return;
+        }
+        Connection connection = malloc(sizeof(*connection));
+        int flags = fcntl(socket, F_GETFL);
+        struct epoll_event event = {.events = EPOLLIN, .data.ptr = connection};
+        if (connection == NULL || flags < 0 || fcntl(socket, F_SETFL, flags | O_NONBLOCK) != 0 ||
+            epoll_ctl(server->epoll, EPOLL_CTL_ADD, socket, &event) != 0)
+        {
+            free(connection);
+            close(socket);
+            continue;
+        }
+        connection->socket = socket;
+        protocolBufferInit(&connection->input);
+        protocolBufferInit(&connection->output);
+        connection->interest = EPOLLIN;
+        connection->read_closed = false;
+        connection->previous = NULL;
+        connection->next = server->connections;
+        if (server->connections != NULL)
+        {
+            server->connections->previous = connection;
+        }
+        server->connections = connection;
+    }
+}
+
+/**
+ * readInput: Reads everything a connection has sent so far into its input, unless its output is
+ * full. The end of the input is recorded in read_closed.
+ *
+ * @return
+ *     false if the connection failed, true otherwise.
+ */
+static bool readInput(Connection connection)
+{
+    while (connection->read_closed == false && connection->output.size < SERVER_OUTPUT_LIMIT)
+    {
+        if (protocolBufferReserve(&connection->input, SERVER_READ_SIZE) == false)
+        {
+            return false;
+        }
+        ssize_t length = read(connection->socket, connection->input.data + connection->input.size,
+                              connection->input.capacity - connection->input.size);
+        if (length > 0)
+        {
+            connection->input.size += length;
+        }
+        else if (length == 0)
+        {
+            connection->read_closed = true;
+        }
+        else if (errno != EINTR)
+        {
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+    }
+    return true;
+}
+
+/**
+ * serveInput: Serves the complete requests in the input of a connection, in order, until its output
+ * is full.
+ *
+ * @return
+ *     false if a request is not valid or an allocation failed, true otherwise.
+ */
+static bool serveInput(Server *server, Connection connection)
+{
+    size_t consumed = 0;
+    bool valid = true;
+    while (connection->output.size < SERVER_OUTPUT_LIMIT)
+    {
+        ProtocolRequest request;
+        size_t length;
+        ProtocolStatus status = protocolReadRequest(connection->input.data + consumed,
+                                                    connection->input.size - consumed, &request, &length);
+        if (status != PROTOCOL_COMPLETE)
+        {
+            valid = status == PROTOCOL_INCOMPLETE;
+            break;
+        }
+        if (serveRequest(server->chess, &request, &connection->output) == false)
+        {
+            valid = false;
+            break;
+        }
+        consumed += length;
+    }
+    protocolBufferConsume(&connection->input, consumed);
+    return valid;
+}
+
+/**
+ * writeOutput: Writes as much of the output of a connection as the socket takes.
+ *
+ * @return
+ *     false if the connection failed, true otherwise.
+ */
+static bool writeOutput(Connection connection)
+{
+    size_t written = 0;
+    while (written < connection->output.size)
+    {
+        ssize_t length = send(connection->socket, connection->output.data + written,
+                              connection->output.size - written, MSG_NOSIGNAL);
+        if (length > 0)
+        {
+            written += length;
+        }
+        else if (length < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else
+        {
+            protocolBufferConsume(&connection->output, written);
+            return length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+    protocolBufferConsume(&connection->output, written);
+    return true;
+}
+
+/**
+ * handleConnection: Reads, serves and writes a connection after an epoll event, closing it when it
+ * failed, or when the client closed its side and every response was written. Serving and writing
+ * alternate while the output drains, so the requests left waiting for room in the output are
+ * served without waiting for more input.
+ */
+static void handleConnection(Server *server, Connection connection, unsigned int events)
+{
+    bool open = (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) == 0 || readInput(connection);
+    while (open)
+    {
+        size_t waiting = connection->input.size;
+        open = serveInput(server, connection) && writeOutput(connection);
+        if (connection->input.size == waiting || connection->output.size >= SERVER_OUTPUT_LIMIT)
+        {
+            break;
+        }
+    }
+    // The output is only empty here once the complete requests were served
+    bool finished = connection->read_closed && connection->output.size == 0;
+    if (open == false || finished || updateInterest(server, connection) == false)
+    {
+        closeConnection(server, connection);
+    }
+}
+
+/**
+ * openListener: Creates the non-blocking listening socket at a path, replacing a stale socket file.
+ * The socket file is created without permissions for other users, who could otherwise write files
+ * as the server's user through the statistics export.
+ *
+ * @return
+ *     The socket, or -1 if it could not be created.
+ */
+static int openListener(const char *path)
+{
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener < 0)
+    {
+        return -1;
+    }
+    unlink(path);
+    mode_t previous_mask = umask(SERVER_SOCKET_MASK);
+    bool bound = bind(listener, (struct sockaddr *)&address, sizeof(address)) == 0;
+    umask(previous_mask);
+    if (bound == false || listen(listener, SERVER_BACKLOG) != 0)
+    {
+        close(listener);
+        return -1;
+    }
+    return listener;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : getenv(CHESS_SOCKET_ENVIRONMENT);
+    if (path == NULL)
+    {
+        path = CHESS_DEFAULT_SOCKET;
+    }
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stopServer;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    Server server = {chessCreate(), openListener(path), epoll_create1(EPOLL_CLOEXEC), NULL};
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = NULL};
+    if (server.chess == NULL || server.listener < 0 || server.epoll < 0 ||
+        epoll_ctl(server.epoll, EPOLL_CTL_ADD, server.listener, &event) != 0)
+    {
+        fprintf(stderr, "chess_server: could not listen on %s\n", path);
+        return 1;
+    }
+
+    struct epoll_event events[SERVER_EVENTS];
+    while (stopping == 0)
+    {
+        int count = epoll_wait(server.epoll, events, SERVER_EVENTS, -1);
+        for (int i = 0; i < count; i++)
+        {
+            if (events[i].data.ptr == NULL)
+            {
+                acceptConnections(&server);
+            }
+            else
+            {
+                handleConnection(&server, events[i].data.ptr, events[i].events);
+            }
+        }
+    }
+
+    while (server.connections != NULL)
+    {
+        closeConnection(&server, server.connections);
+    }
+    close(server.epoll);
+    close(server.listener);
+    unlink(path);
+    chessDestroy(server.chess);
+    return 0;
+}
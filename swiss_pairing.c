@@ -0,0 +1,205 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include "swiss_pairing.h"
+#include "chess_utilities.h"
+
+#define UNPAIRED -1
+#define LIST_END -1
+
+/**
+ * playedCreate: Creates the set of the pairs of players of the games played so far.
+ *
+ * @param played_first - The first players of the games.
+ * @param played_second - The second players of the games.
+ * @param number_of_played - The number of games.
+ * @return
+ *     NULL if an allocation failed, the set of the pairKey of every game otherwise.
+ */
+static HashTable playedCreate(const int *played_first, const int *played_second, int number_of_played)
+{
+    HashTable played = hashTableCreate(0, HASH_TABLE_UNCOUNTED);
+    for (int i = 0; i < number_of_played && played != NULL; i++)
+    {
+        if (hashTablePut(played, pairKey(played_first[i], played_second[i])) == NULL)
+        {
+            hashTableDestroy(played);
+            played = NULL;
+        }
+    }
+    return played;
+}
+
+/**
+ * havePlayed: Checks if two players already played each other.
+ */
+static bool havePlayed(HashTable played, int player1, int player2)
+{
+    return hashTableGet(played, pairKey(player1, player2)) != NULL;
+}
+
+/**
+ * compareStandings: qsort comparison of the standings, by points from the highest and by id.
+ */
+static int compareStandings(const void *first, const void *second)
+{
+    const SwissPlayer *player1 = first, *player2 = second;
+    if (player1->points != player2->points)
+    {
+        return player1->points > player2->points ? -1 : 1;
+    }
+    return (player1->player_id > player2->player_id) - (player1->player_id < player2->player_id);
+}
+
+/**
+ * unlinkPlayer: Removes a player from the list of unpaired players.
+ */
+static void unlinkPlayer(int *next, int *previous, int *first, int player)
+{
+    if (previous[player] == LIST_END)
+    {
+        *first = next[player];
+    }
+    else
+    {
+        next[previous[player]] = next[player];
+    }
+    if (next[player] != LIST_END)
+    {
+        previous[next[player]] = previous[player];
+    }
+}
+
+/**
+ * setPartners: Pairs two players.
+ */
+static void setPartners(int *partner, int player1, int player2)
+{
+    partner[player1] = player2;
+    partner[player2] = player1;
+}
+
+/**
+ * exchangePartners: Pairs two players left without a partner by taking the partners of an existing
+ * pair, searching from the bottom of the standings.
+ *
+ * @param players - The players in the standings.
+ * @param number_of_players - The number of players.
+ * @param partner - The partner of every player, UNPAIRED for none.
+ * @param played - The games played so far.
+ * @param left1 - A player without a partner.
+ * @param left2 - Another player without a partner, who played left1.
+ * @return
+ *     true if the four players were paired again, false otherwise.
+ */
+static bool exchangePartners(const SwissPlayer *players, int number_of_players, int *partner,
+                             HashTable played, int left1, int left2)
+{
+    for (int a = number_of_players - 1; a >= 0; a--)
+    {
+        int b = partner[a];
+        if (b == UNPAIRED || b < a)
+        {
+            continue;
+        }
+        int id1 = players[left1].player_id, id2 = players[left2].player_id;
+        int id_a = players[a].player_id, id_b = players[b].player_id;
+        if (havePlayed(played, id1, id_a) == false && havePlayed(played, id2, id_b) == false)
+        {
+            setPartners(partner, left1, a);
+            setPartners(partner, left2, b);
+            return true;
+        }
+        if (havePlayed(played, id1, id_b) == false && havePlayed(played, id2, id_a) == false)
+        {
+            setPartners(partner, left1, b);
+            setPartners(partner, left2, a);
+            return true;
+        }
+    }
+    return false;
+}
+
+ChessResult swissGeneratePairings(SwissPlayer *players, int number_of_players, const int *played_first,
+                                  const int *played_second, int number_of_played, int *out_pairs, int capacity,
+                                  int *out_count)
+{
+    *out_count = 0;
+    if (number_of_players < 2)
+    {
+        return CHESS_SUCCESS;
+    }
+    HashTable played = playedCreate(played_first, played_second, number_of_played);
+    int *partner = malloc(sizeof(int) * number_of_players);
+    int *next = malloc(sizeof(int) * number_of_players);
+    int *previous = malloc(sizeof(int) * number_of_players);
+    if (played == NULL || partner == NULL || next == NULL || previous == NULL)
+    {
+        hashTableDestroy(played);
+        free(partner);
+        free(next);
+        free(previous);
+        return CHESS_OUT_OF_MEMORY;
+    }
+
+    qsort(players, number_of_players, sizeof(*players), compareStandings);
+    for (int i = 0; i < number_of_players; i++)
+    {
+        partner[i] = UNPAIRED;
+        next[i] = i + 1 < number_of_players ? i + 1 : LIST_END;
+        previous[i] = i - 1;
+    }
+
+    // Every candidate passed over already played the player, so the scans are bounded by the games
+    int first = 0;
+    while (first != LIST_END)
+    {
+        int player = first;
+        unlinkPlayer(next, previous, &first, player);
+        int candidate = first;
+        while (candidate != LIST_END && havePlayed(played, players[player].player_id, players[candidate].player_id))
+        {
+            candidate = next[candidate];
+        }
+        if (candidate != LIST_END)
+        {
+            unlinkPlayer(next, previous, &first, candidate);
+            setPartners(partner, player, candidate);
+        }
+    }
+
+    // The players left without a partner all played each other
+    int left = UNPAIRED;
+    for (int i = 0; i < number_of_players; i++)
+    {
+        if (partner[i] != UNPAIRED)
+        {
+            continue;
+        }
+        if (left == UNPAIRED)
+        {
+            left = i;
+        }
+        else if (exchangePartners(players, number_of_players, partner, played, left, i))
+        {
+            left = UNPAIRED;
+        }
+    }
+
+    for (int i = 0; i < number_of_players; i++)
+    {
+        if (partner[i] > i)
+        {
+            if (*out_count < capacity)
+            {
+                out_pairs[2 * *out_count] = players[i].player_id;
+                out_pairs[2 * *out_count + 1] = players[partner[i]].player_id;
+            }
+            (*out_count)++;
+        }
+    }
+    hashTableDestroy(played);
+    free(partner);
+    free(next);
+    free(previous);
+    return CHESS_SUCCESS;
+}
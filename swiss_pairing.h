@@ -0,0 +1,46 @@
+#ifndef SWISS_PAIRING_H
+#define SWISS_PAIRING_H
+#include "chessSystem.h"
+
+/*
+* Swiss-system pairing of the next round of a tournament.
+*
+* The players are ranked by points, from the highest, and by id between players with the same
+* points. Going down the standings, every unpaired player is paired with the next unpaired player it
+* has not played yet (the Monrad system). The unpaired players are kept in a linked list and
+* the played pairs in a hash set, so a round takes O(P log P + G) for P players and G games
+* played. Players left without a partner because they already played every player that was
+* still free are then paired by exchanging partners with an existing pair, from the bottom of the
+* standings. With an odd number of players, one player is left without a game.
+*
+* The following functions are available:
+*   swissGeneratePairings  - Pairs the players of the next round
+*/
+
+/** Type for defining a player that can play in the next round */
+typedef struct {
+    int player_id;
+    int points;
+} SwissPlayer;
+
+/**
+* swissGeneratePairings: Pairs the players of the next round, with no pair that already played.
+*
+* @param players - The players that can play in the round. The array is sorted into the standings.
+* @param number_of_players - The number of players.
+* @param played_first - The first players of the games played so far.
+* @param played_second - The second players of the games played so far.
+* @param number_of_played - The number of games played so far.
+* @param out_pairs - Where to store the pairs, the higher placed player of each pair first, in the
+*                    order of the standings. Holds 2 * capacity ids.
+* @param capacity - The number of pairs out_pairs holds. Pairs after it are counted but not stored.
+* @param out_count - Where to store the number of pairs of the round.
+* @return
+* 	CHESS_OUT_OF_MEMORY - if an allocation failed.
+* 	CHESS_SUCCESS - otherwise.
+*/
+ChessResult swissGeneratePairings(SwissPlayer *players, int number_of_players, const int *played_first,
+                                  const int *played_second, int number_of_played, int *out_pairs, int capacity,
+                                  int *out_count);
+
+#endif
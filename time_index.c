@@ -0,0 +1,274 @@
+#include <stdlib.h>
+#include <string.h>
+#include "time_index.h"
+#include "chess_alloc.h"
+
+#define MINIMUM_CAPACITY 4
+#define EXPAND 2
+
+/** A game in the index */
+typedef struct
+{
+    int play_time;
+    int game_key;
+    int first_player;
+    int second_player;
+    Winner winner;
+} TimedGame;
+
+struct time_index_t
+{
+    TimedGame *games;
+    int size;
+    int capacity;
+};
+
+TimeIndex timeIndexCreate()
+{
+    TimeIndex index = accountedMalloc(sizeof(*index), CHESS_MEMORY_INDEXES);
+    if (index == NULL)
+    {
+        return NULL;
+    }
+    index->games = NULL;
+    index->size = 0;
+    index->capacity = 0;
+    return index;
+}
+
+void timeIndexDestroy(TimeIndex index)
+{
+    if (index == NULL)
+    {
+        return;
+    }
+    accountedFree(index->games, sizeof(*index->games) * index->capacity, CHESS_MEMORY_INDEXES);
+    accountedFree(index, sizeof(*index), CHESS_MEMORY_INDEXES);
+}
+
+TimeIndex timeIndexCopy(TimeIndex index)
+{
+    if (index == NULL)
+    {
+        return NULL;
+    }
+    TimeIndex copy = timeIndexCreate();
+    if (copy == NULL || index->size == 0)
+    {
+        return copy;
+    }
+    copy->games = accountedMalloc(sizeof(*copy->games) * index->size, CHESS_MEMORY_INDEXES);
+    if (copy->games == NULL)
+    {
+        timeIndexDestroy(copy);
+        return NULL;
+    }
+    memcpy(copy->games, index->games, sizeof(*copy->games) * index->size);
+    copy->size = index->size;
+    copy->capacity = index->size;
+    return copy;
+}
+
+/**
+ * firstAfter: Binary searches the first game of an index whose play time is greater than a time.
+ *
+ * @param index - The index.
+ * @param play_time - The time.
+ * @return
+ *     The position of the game, index->size if there is none.
+ */
+static int firstAfter(TimeIndex index, long long play_time)
+{
+    int low = 0, high = index->size;
+    while (low < high)
+    {
+        int middle = low + (high - low) / 2;
+        if (index->games[middle].play_time <= play_time)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+bool timeIndexAdd(TimeIndex index, int game_key, int first_player, int second_player, Winner winner,
+                  int play_time)
+{
+    if (index == NULL)
+    {
+        return false;
+    }
+    if (index->size == index->capacity)
+    {
+        int capacity = index->capacity == 0 ? MINIMUM_CAPACITY : index->capacity * EXPAND;
+        TimedGame *games = accountedRealloc(index->games, sizeof(*games) * index->capacity, sizeof(*games) * capacity,
+                                            CHESS_MEMORY_INDEXES);
+        if (games == NULL)
+        {
+            return false;
+        }
+        index->games = games;
+        index->capacity = capacity;
+    }
+    int position = firstAfter(index, play_time);
+    memmove(index->games + position + 1, index->games + position, sizeof(*index->games) * (index->size - position));
+    index->games[position].play_time = play_time;
+    index->games[position].game_key = game_key;
+    index->games[position].first_player = first_player;
+    index->games[position].second_player = second_player;
+    index->games[position].winner = winner;
+    index->size++;
+    return true;
+}
+
+/**
+ * findGame: Binary searches a game of an index by its play time and key.
+ *
+ * @param index - The index.
+ * @param game_key - The key of the game.
+ * @param play_time - The play time of the game.
+ * @return
+ *     The position of the game, -1 if it is not in the index.
+ */
+static int findGame(TimeIndex index, int game_key, int play_time)
+{
+    // The games with the time are at [firstAfter(play_time - 1), firstAfter(play_time)), by key
+    int low = firstAfter(index, (long long)play_time - 1), high = firstAfter(index, play_time);
+    while (low < high)
+    {
+        int middle = low + (high - low) / 2;
+        if (index->games[middle].game_key < game_key)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    if (low < index->size && index->games[low].play_time == play_time && index->games[low].game_key == game_key)
+    {
+        return low;
+    }
+    return -1;
+}
+
+void timeIndexUpdate(TimeIndex index, int game_key, int play_time, int first_player, int second_player,
+                     Winner winner)
+{
+    if (index == NULL)
+    {
+        return;
+    }
+    int position = findGame(index, game_key, play_time);
+    if (position >= 0)
+    {
+        index->games[position].first_player = first_player;
+        index->games[position].second_player = second_player;
+        index->games[position].winner = winner;
+    }
+}
+
+void timeIndexRemove(TimeIndex index, int game_key, int play_time)
+{
+    if (index == NULL)
+    {
+        return;
+    }
+    int position = findGame(index, game_key, play_time);
+    if (position >= 0)
+    {
+        memmove(index->games + position, index->games + position + 1,
+                sizeof(*index->games) * (index->size - position - 1));
+        index->size--;
+    }
+}
+
+void timeIndexCompact(TimeIndex index)
+{
+    if (index == NULL || index->size == index->capacity)
+    {
+        return;
+    }
+    if (index->size == 0)
+    {
+        accountedFree(index->games, sizeof(*index->games) * index->capacity, CHESS_MEMORY_INDEXES);
+        index->games = NULL;
+        index->capacity = 0;
+        return;
+    }
+    TimedGame *games = accountedRealloc(index->games, sizeof(*games) * index->capacity, sizeof(*games) * index->size,
+                                        CHESS_MEMORY_INDEXES);
+    if (games != NULL)
+    {
+        index->games = games;
+        index->capacity = index->size;
+    }
+}
+
+int timeIndexCount(TimeIndex index, int min_time, int max_time)
+{
+    int first;
+    return timeIndexRange(index, min_time, max_time, &first);
+}
+
+int timeIndexCopyRange(TimeIndex index, int tournament_id, int min_time, int max_time, ChessTimedGame *out_games,
+                       int capacity)
+{
+    if (index == NULL || min_time > max_time)
+    {
+        return 0;
+    }
+    int first = firstAfter(index, (long long)min_time - 1), last = firstAfter(index, max_time);
+    for (int i = first; i < last && i - first < capacity; i++)
+    {
+        ChessTimedGame *game = &out_games[i - first];
+        game->tournament_id = tournament_id;
+        game->first_player = index->games[i].first_player;
+        game->second_player = index->games[i].second_player;
+        game->winner = index->games[i].winner;
+        game->play_time = index->games[i].play_time;
+    }
+    return last - first;
+}
+
+int timeIndexRange(TimeIndex index, int min_time, int max_time, int *first)
+{
+    *first = 0;
+    if (index == NULL || min_time > max_time)
+    {
+        return 0;
+    }
+    *first = firstAfter(index, (long long)min_time - 1);
+    return firstAfter(index, max_time) - *first;
+}
+
+void timeIndexColumns(TimeIndex index, int first, int count, int *first_players, int *second_players,
+                      Winner *winners, int *play_times)
+{
+    const TimedGame *games = index->games + first;
+    for (int i = 0; i < count; i++)
+    {
+        first_players[i] = games[i].first_player;
+        second_players[i] = games[i].second_player;
+        winners[i] = games[i].winner;
+        play_times[i] = games[i].play_time;
+    }
+}
+
+void timeIndexMemoryUsage(TimeIndex index, ChessMemoryFootprint *footprint)
+{
+    if (index == NULL || footprint == NULL)
+    {
+        return;
+    }
+    memoryFootprintAdd(footprint, CHESS_MEMORY_INDEXES, sizeof(*index), 1);
+    if (index->games != NULL)
+    {
+        memoryFootprintAdd(footprint, CHESS_MEMORY_INDEXES, sizeof(*index->games) * index->capacity, 1);
+    }
+}
@@ -0,0 +1,169 @@
+#ifndef TIME_INDEX_H
+#define TIME_INDEX_H
+#include <stdbool.h>
+#include "chessSystem.h"
+
+/*
+* An index of the games of a tournament ordered by their play time, for counting and listing the
+* games with a play time in a range without going over the other games.
+*
+* The games are kept in one array sorted by play time, and by game key between games with the same
+* time, with their players and winner so a range is listed from the array alone. A new game has the
+* highest key of its tournament, so it goes after the games with its time. Once the tournament ends
+* and no more games are added, the array is compacted to its exact size.
+*
+* The following functions are available:
+*   timeIndexCreate       - Creates an empty index
+*   timeIndexDestroy      - Deletes an index
+*   timeIndexCopy         - Copies an index
+*   timeIndexAdd          - Adds a game
+*   timeIndexUpdate       - Updates the players and the winner of a game
+*   timeIndexRemove       - Removes a game
+*   timeIndexCompact      - Frees the room kept for more games
+*   timeIndexCount        - Returns the number of games in a time range
+*   timeIndexCopyRange    - Copies the games in a time range
+*   timeIndexRange        - Returns the position and the number of the games in a time range
+*   timeIndexColumns      - Copies the columns of consecutive games
+*   timeIndexMemoryUsage  - Adds the memory of an index to a footprint
+*/
+
+/** Type for defining a time index */
+typedef struct time_index_t *TimeIndex;
+
+/**
+* timeIndexCreate: Allocates an empty index.
+*
+* @return
+* 	NULL - if allocations failed.
+* 	A new index in case of success.
+*/
+TimeIndex timeIndexCreate();
+
+/**
+* timeIndexDestroy: Deallocates an index.
+*
+* @param index - Target index. If index is NULL nothing will be done.
+*/
+void timeIndexDestroy(TimeIndex index);
+
+/**
+* timeIndexCopy: Creates a copy of an index.
+*
+* @param index - Target index.
+* @return
+* 	NULL if a NULL was sent or a memory allocation failed.
+* 	A new index with the same games otherwise.
+*/
+TimeIndex timeIndexCopy(TimeIndex index);
+
+/**
+* timeIndexAdd: Adds a game to an index.
+*
+* @param index - The index.
+* @param game_key - The key of the game. Must be higher than the keys of the games in the index.
+* @param first_player - The first player.
+* @param second_player - The second player.
+* @param winner - The winner of the game.
+* @param play_time - The play time of the game.
+* @return
+* 	false - if the input is NULL or an allocation failed.
+* 	true - otherwise.
+*/
+bool timeIndexAdd(TimeIndex index, int game_key, int first_player, int second_player, Winner winner,
+                  int play_time);
+
+/**
+* timeIndexUpdate: Updates the players and the winner of a game, after a player was removed from it.
+*
+* @param index - The index. If index is NULL nothing will be done.
+* @param game_key - The key of the game.
+* @param play_time - The play time of the game.
+* @param first_player - The first player, DELETE_PLAYER if that player was removed.
+* @param second_player - The second player, DELETE_PLAYER if that player was removed.
+* @param winner - The winner of the game.
+*/
+void timeIndexUpdate(TimeIndex index, int game_key, int play_time, int first_player, int second_player,
+                     Winner winner);
+
+/**
+* timeIndexRemove: Removes a game from an index, as when adding the game to its tournament failed.
+*   The room of the game is kept for the next game added.
+*
+* @param index - The index. If index is NULL nothing will be done.
+* @param game_key - The key of the game.
+* @param play_time - The play time of the game.
+*/
+void timeIndexRemove(TimeIndex index, int game_key, int play_time);
+
+/**
+* timeIndexCompact: Shrinks the array of an index to its games. Adding games after it is allowed
+*   but grows the array again.
+*
+* @param index - The index. If index is NULL nothing will be done.
+*/
+void timeIndexCompact(TimeIndex index);
+
+/**
+* timeIndexCount: Returns the number of games with a play time in a range.
+*
+* @param index - The index.
+* @param min_time - The lowest play time of the range.
+* @param max_time - The highest play time of the range.
+* @return
+* 	0 - if index is NULL or the range is empty.
+* 	The number of games otherwise.
+*/
+int timeIndexCount(TimeIndex index, int min_time, int max_time);
+
+/**
+* timeIndexCopyRange: Copies the games with a play time in a range, in increasing play time order.
+*
+* @param index - The index.
+* @param tournament_id - The tournament of the games, stored in the copies.
+* @param min_time - The lowest play time of the range.
+* @param max_time - The highest play time of the range.
+* @param out_games - Where to copy the games.
+* @param capacity - The number of games out_games holds. Games after it are counted but not copied.
+* @return
+* 	The number of games in the range.
+*/
+int timeIndexCopyRange(TimeIndex index, int tournament_id, int min_time, int max_time, ChessTimedGame *out_games,
+                       int capacity);
+
+/**
+* timeIndexRange: Returns where the games with a play time in a range are, for reading them with
+*   timeIndexColumns.
+*
+* @param index - The index.
+* @param min_time - The lowest play time of the range.
+* @param max_time - The highest play time of the range.
+* @param first - Where to store the position of the first game in the range.
+* @return
+* 	The number of games in the range, 0 if index is NULL.
+*/
+int timeIndexRange(TimeIndex index, int min_time, int max_time, int *first);
+
+/**
+* timeIndexColumns: Copies the players, the winners and the play times of consecutive games, each to
+*   its own array.
+*
+* @param index - The index.
+* @param first - The position of the first game.
+* @param count - The number of games. The games must be in the index.
+* @param first_players - Where to copy the first players.
+* @param second_players - Where to copy the second players.
+* @param winners - Where to copy the winners.
+* @param play_times - Where to copy the play times.
+*/
+void timeIndexColumns(TimeIndex index, int first, int count, int *first_players, int *second_players,
+                      Winner *winners, int *play_times);
+
+/**
+* timeIndexMemoryUsage: Adds the memory of an index to a footprint.
+*
+* @param index - The index. If index is NULL nothing will be added.
+* @param footprint - The footprint to add to.
+*/
+void timeIndexMemoryUsage(TimeIndex index, ChessMemoryFootprint *footprint);
+
+#endif
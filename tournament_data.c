@@ -1,24 +1,34 @@
 
 #include <stdio.h>
 #include "tournament_data.h"
+#include "chess_alloc.h"
+#include "swiss_pairing.h"
+#include "chess_metrics_hooks.h"
+
+#define MINIMUM_LOADED_GAMES 16
+#define EXPAND_LOADED_GAMES 2
 
 struct tournament_t
 {
     Map games;
     Map player_list;
     WinnerId winner;
-    Location location;
+    SharedLocation location;
+    IdSet players;
+    QuantileSketch durations;
+    TimeIndex times;
     int max_games_per_player;
     TournamentStatus status;
     int number_of_players;
+    FrozenTournament frozen;
 };
 
 void tournamentDestroyInternal(Tournament tournament);
 Tournament tournamentCopyInternal(Tournament tournament);
 
-Tournament tournamentCreate(const char *location, int max_games_per_player)
+Tournament tournamentCreate(SharedLocation location, int max_games_per_player)
 {
-    Tournament tournament = malloc(sizeof(*tournament));
+    Tournament tournament = accountedMalloc(sizeof(*tournament), CHESS_MEMORY_TOURNAMENTS);
     if (tournament == NULL)
     {
         return NULL;
@@ -26,12 +36,18 @@ Tournament tournamentCreate(const char *location, int max_games_per_player)
     tournament->games = mapCreate(gameCopy, keyCopy, gameDestroy, keyFree, keyCompare);
     tournament->player_list = mapCreate(playerDataCopy, keyCopy, playerDataDestroy, keyFree, keyCompare);
     tournament->winner = NO_WINNER;
-    tournament->location = malloc(strlen(location) + 1);
-    if (tournament->location == NULL)
+    tournament->frozen = NULL;
+    tournament->players = idSetCreate();
+    tournament->durations = quantileSketchCreate();
+    tournament->times = timeIndexCreate();
+    tournament->location = location;
+    locationRetain(location);
+    if (tournament->games == NULL || tournament->player_list == NULL || tournament->players == NULL ||
+        tournament->durations == NULL || tournament->times == NULL || tournament->location == NULL)
     {
         tournamentDestroyInternal(tournament);
+        return NULL;
     }
-    strcpy(tournament->location, location); 
     tournament->status = true;
     tournament->max_games_per_player = max_games_per_player;
     tournament->number_of_players = 0;
@@ -54,8 +70,12 @@ void tournamentDestroyInternal(Tournament tournament)
 
     mapDestroy(tournament->games);
     mapDestroy(tournament->player_list);
-    free(tournament->location);
-    free(tournament);
+    frozenDestroy(tournament->frozen);
+    idSetDestroy(tournament->players);
+    quantileSketchDestroy(tournament->durations);
+    timeIndexDestroy(tournament->times);
+    locationRelease(tournament->location);
+    accountedFree(tournament, sizeof(*tournament), CHESS_MEMORY_TOURNAMENTS);
 }
 
 MapDataElement tournamentCopy(MapDataElement source)
@@ -75,6 +95,34 @@ Tournament tournamentCopyInternal(Tournament tournament)
     {
         return NULL;
     }
+    idSetDestroy(tournament_copy->players);
+    tournament_copy->players = idSetCopy(tournament->players);
+    quantileSketchDestroy(tournament_copy->durations);
+    tournament_copy->durations = quantileSketchCopy(tournament->durations);
+    timeIndexDestroy(tournament_copy->times);
+    tournament_copy->times = timeIndexCopy(tournament->times);
+    if (tournament_copy->players == NULL || tournament_copy->durations == NULL || tournament_copy->times == NULL)
+    {
+        tournamentDestroyInternal(tournament_copy);
+        return NULL;
+    }
+    if (tournament->frozen != NULL)
+    {
+        mapDestroy(tournament_copy->games);
+        mapDestroy(tournament_copy->player_list);
+        tournament_copy->games = NULL;
+        tournament_copy->player_list = NULL;
+        tournament_copy->frozen = frozenCopy(tournament->frozen);
+        if (tournament_copy->frozen == NULL)
+        {
+            tournamentDestroyInternal(tournament_copy);
+            return NULL;
+        }
+        tournament_copy->winner = tournament->winner;
+        tournament_copy->status = tournament->status;
+        tournament_copy->number_of_players = tournament->number_of_players;
+        return tournament_copy;
+    }
     mapDestroy(tournament_copy->games);
     tournament_copy->games = mapCopy(tournament->games);
     if (tournament_copy->games == NULL)
@@ -90,7 +138,6 @@ Tournament tournamentCopyInternal(Tournament tournament)
         tournamentDestroyInternal(tournament_copy);
         return NULL;
     }
-    strcpy(tournament_copy->location, tournament->location);
     tournament_copy->winner = tournament->winner;
     tournament_copy->status = tournament->status;
     tournament_copy->max_games_per_player = tournament->max_games_per_player;
@@ -192,8 +239,34 @@ static ChessResult addPlayerToTournament(Tournament tournament, Player_Id player
     return CHESS_SUCCESS;
 }
 
+/**
+ * removeNewPlayer: Removes a player whose only game in the tournament failed to be added or was
+ * removed, from its players map and its player set.
+ *
+ * @param tournament - The tournament.
+ * @param player_id - The player's Id.
+ * @param new_player - Whether the player was not in the tournament before the game.
+ */
+static void removeNewPlayer(Tournament tournament, Player_Id player_id, bool new_player)
+{
+    if (new_player == false)
+    {
+        return;
+    }
+    if (mapContains(tournament->player_list, &player_id))
+    {
+        mapRemove(tournament->player_list, &player_id);
+        tournament->number_of_players--;
+    }
+    idSetRemove(tournament->players, player_id);
+}
+
 ChessResult tournamentAddGame(Tournament tournament, Winner winner, Player_Id player1, Player_Id player2, Time time, int* key_game)
 {
+    if (tournament->frozen != NULL)
+    {
+        return CHESS_TOURNAMENT_ENDED;
+    }
     if (playsTogether(tournament, player1, player2)) 
     {
         return CHESS_GAME_ALREADY_EXISTS;
@@ -208,26 +281,28 @@ ChessResult tournamentAddGame(Tournament tournament, Winner winner, Player_Id pl
         return CHESS_EXCEEDED_GAMES; 
     }
 
+    bool new_player1 = mapContains(tournament->player_list, &player1) == false;
+    bool new_player2 = mapContains(tournament->player_list, &player2) == false;
     Game_Data new_game_data = gameCreate(winner, player1, player2, time);
     if (new_game_data == NULL)
     {
         return CHESS_OUT_OF_MEMORY;
     }
-    if (addPlayerToTournament(tournament, player1) == CHESS_OUT_OF_MEMORY)
-    {
-        gameDestroy(new_game_data);
-        return CHESS_OUT_OF_MEMORY;
-    }
-    if (addPlayerToTournament(tournament, player2) == CHESS_OUT_OF_MEMORY)
-    {
-        gameDestroy(new_game_data);
-        return CHESS_OUT_OF_MEMORY;
-    }
     int new_game_key = mapGetSize(tournament->games) + 1;
     *key_game = new_game_key;
-    if (mapPut(tournament->games, (MapKeyElement)&new_game_key, (MapDataElement)new_game_data) == MAP_OUT_OF_MEMORY)
+    bool added = addPlayerToTournament(tournament, player1) == CHESS_SUCCESS &&
+                 addPlayerToTournament(tournament, player2) == CHESS_SUCCESS &&
+                 mapPut(tournament->games, (MapKeyElement)&new_game_key, (MapDataElement)new_game_data) == MAP_SUCCESS;
+    gameDestroy(new_game_data);
+    if (added == false || idSetAdd(tournament->players, player1) == false ||
+        idSetAdd(tournament->players, player2) == false ||
+        timeIndexAdd(tournament->times, new_game_key, player1, player2, winner, time) == false ||
+        quantileSketchAdd(tournament->durations, time) == false)
     {
-        gameDestroy(new_game_data);
+        timeIndexRemove(tournament->times, new_game_key, time);
+        mapRemove(tournament->games, (MapKeyElement)&new_game_key);
+        removeNewPlayer(tournament, player1, new_player1);
+        removeNewPlayer(tournament, player2, new_player2);
         return CHESS_OUT_OF_MEMORY;
     }
 
@@ -252,37 +327,89 @@ ChessResult tournamentAddGame(Tournament tournament, Winner winner, Player_Id pl
         playerSetDraws(mapGet(tournament->player_list, (MapKeyElement)&player2), ONE_POINT);
         break;
     default:
-        gameDestroy(new_game_data);
         return CHESS_NULL_ARGUMENT;
     }
-    gameDestroy(new_game_data); 
     return CHESS_SUCCESS;
 }
 
-ChessResult tournamentRemovePlayer(Tournament tournament, Player_Id player) //remove the player from all the games in the tournament
+void tournamentRemoveLastGame(Tournament tournament)
+{
+    int game_key = mapGetSize(tournament->games);
+    Game_Data game = mapGet(tournament->games, (MapKeyElement)&game_key);
+    if (game == NULL)
+    {
+        return;
+    }
+    Player_Id player1 = gameGetFirstPlayer(game), player2 = gameGetSecondPlayer(game);
+    Time time = gameGetTime(game);
+    PlayerData first_data = mapGet(tournament->player_list, (MapKeyElement)&player1);
+    PlayerData second_data = mapGet(tournament->player_list, (MapKeyElement)&player2);
+    switch ((Winner)gameGetWinner(game))
+    {
+    case FIRST_PLAYER:
+        playerSetPoints(first_data, -TOW_POINTS);
+        playerSetWins(first_data, -ONE_POINT);
+        playerSetLosses(second_data, -ONE_POINT);
+        break;
+    case SECOND_PLAYER:
+        playerSetPoints(second_data, -TOW_POINTS);
+        playerSetWins(second_data, -ONE_POINT);
+        playerSetLosses(first_data, -ONE_POINT);
+        break;
+    default:
+        playerSetPoints(first_data, -ONE_POINT);
+        playerSetDraws(first_data, -ONE_POINT);
+        playerSetPoints(second_data, -ONE_POINT);
+        playerSetDraws(second_data, -ONE_POINT);
+        break;
+    }
+    quantileSketchRemove(tournament->durations, time);
+    timeIndexRemove(tournament->times, game_key, time);
+    mapRemove(tournament->games, (MapKeyElement)&game_key);
+    removeNewPlayer(tournament, player1, playerHasGames(first_data) == false);
+    removeNewPlayer(tournament, player2, playerHasGames(second_data) == false);
+}
+
+ChessResult tournamentRemovePlayer(Tournament tournament, Player_Id player, Map total_player_list) //remove the player from all the games in the tournament
 {
     if (tournament == NULL)
     {
         return CHESS_NULL_ARGUMENT;
     }
-    if (tournament->games == NULL)
+    if (tournament->games == NULL || tournament->frozen != NULL)
     {
         return CHESS_SUCCESS;
     }
 
+    if (total_player_list != NULL)
+    {
+        playerDataAdd(mapGet(total_player_list, &player), mapGet(tournament->player_list, &player), NEGATIVE);
+    }
     MAP_FOREACH(MapKeyElement, game_key, tournament->games)
     {
-        gameRemovePlayer(mapGet(tournament->games, game_key), player, tournament->player_list);
+        Game_Data game = mapGet(tournament->games, game_key);
+        bool plays = gameContains(game, player);
+        gameRemovePlayer(game, player, tournament->player_list, total_player_list);
+        if (plays)
+        {
+            timeIndexUpdate(tournament->times, *(int *)game_key, gameGetTime(game), gameGetFirstPlayer(game),
+                            gameGetSecondPlayer(game), (Winner)gameGetWinner(game));
+        }
         keyFree(game_key);
     }
 
     mapRemove(tournament->player_list, &player);
+    idSetRemove(tournament->players, player);
     return CHESS_SUCCESS;
 }
 
 int tournamentPlayerWins(Tournament tournament, Player_Id player)
 {
     int wins = 0;
+    if (tournament->frozen != NULL)
+    {
+        return wins;
+    }
     MAP_FOREACH(MapKeyElement, game_key, tournament->games)
     {
         if (gameGetWinner(mapGet(tournament->games, (MapKeyElement)game_key)) == player)
@@ -387,7 +514,12 @@ const char *tournamentGetLocation(Tournament tournament)
         return NULL;
     }
 
-    return tournament->location;
+    return locationName(tournament->location);
+}
+
+SharedLocation tournamentGetSharedLocation(Tournament tournament)
+{
+    return tournament == NULL ? NULL : tournament->location;
 }
 
 int tournamentNumberOfGames(Tournament tournament)
@@ -396,6 +528,10 @@ int tournamentNumberOfGames(Tournament tournament)
     {
         return -1;
     }
+    if (tournament->frozen != NULL)
+    {
+        return frozenNumberOfGames(tournament->frozen);
+    }
 
     return mapGetSize(tournament->games);
 }
@@ -407,22 +543,22 @@ TournamentStatus tournamentGetStatus(Tournament tournament)
 
 bool tournamentIsPlayerExist(Tournament tournament, Player_Id player_id)
 {
-    if (tournament == NULL || tournament->games == NULL)
-    {
-        return false;
-    }
+    return tournament != NULL && idSetContains(tournament->players, player_id);
+}
 
-    MAP_FOREACH(MapKeyElement, game_key, tournament->games)
-    {
-        if (gameContains(mapGet(tournament->games, game_key), player_id))
-        {
-            keyFree(game_key);
-            return true;
-        }
-        keyFree(game_key);
-    }
+IdSet tournamentGetPlayerSet(Tournament tournament)
+{
+    return tournament == NULL ? NULL : tournament->players;
+}
 
-    return false;
+QuantileSketch tournamentGetDurations(Tournament tournament)
+{
+    return tournament == NULL ? NULL : tournament->durations;
+}
+
+TimeIndex tournamentGetTimeIndex(Tournament tournament)
+{
+    return tournament == NULL ? NULL : tournament->times;
 }
 
 int tournamentPlayerTotalTime(Tournament tournament, Player_Id player_id, int *number_of_games_per_player)
@@ -435,6 +571,10 @@ int tournamentPlayerTotalTime(Tournament tournament, Player_Id player_id, int *n
     {
         return NEGATIVE;
     }
+    if (tournament->frozen != NULL)
+    {
+        return frozenPlayerTotalTime(tournament->frozen, player_id, number_of_games_per_player);
+    }
     int total_time = 0;
     MAP_FOREACH(MapKeyElement, game_key, tournament->games)
     {
@@ -460,6 +600,10 @@ int tournamentGetWinner(Tournament tournament)
 
 ChessResult tournamentCopyPlayersToMap(Tournament tournament, Map total_player_map)
 {
+    if (tournament != NULL && tournament->frozen != NULL)
+    {
+        return frozenCopyPlayersToMap(tournament->frozen, total_player_map);
+    }
     if (tournament == NULL || total_player_map == NULL || tournament->player_list == NULL)
     {
         return CHESS_NULL_ARGUMENT;
@@ -500,6 +644,11 @@ int tournamentLongestGameTime(Tournament tournament, double *total_time)
     {
         return NEGATIVE;
     }
+    if (tournament->frozen != NULL)
+    {
+        *total_time += frozenTotalGameTime(tournament->frozen);
+        return frozenLongestGameTime(tournament->frozen);
+    }
     int game_time, longestGameTime = 0;
     MAP_FOREACH(MapKeyElement, game_key, tournament->games)
     {
@@ -524,4 +673,539 @@ Map tournamentGetGamesMap(Tournament tournament){
     }
 
     return tournament->games;
-}
\ No newline at end of file
+}
+
+/**
+ * frozenSnapshotWrite: Appends the games and players of a frozen tournament to a snapshot, in the
+ * same layout gameSnapshotWrite and playerDataSnapshotWrite use for a tournament that is not frozen.
+ *
+ * @param frozen - The frozen games and players.
+ * @param writer - The snapshot writer.
+ * @return
+ *     false - if the snapshot could not grow or an allocation failed.
+ *     true - otherwise.
+ */
+static bool frozenSnapshotWrite(FrozenTournament frozen, SnapshotWriter writer)
+{
+    if (!snapshotWriteInt(writer, frozenNumberOfGames(frozen)))
+    {
+        return false;
+    }
+    Player_Id player1, player2;
+    Winner winner;
+    Time time;
+    int game_key = 1;
+    for (int offset = frozenGetGame(frozen, 0, &player1, &player2, &winner, &time); offset != FROZEN_GAMES_END;
+         offset = frozenGetGame(frozen, offset, &player1, &player2, &winner, &time))
+    {
+        if (!snapshotWriteInt(writer, game_key++) || !snapshotWriteInt(writer, player1) ||
+            !snapshotWriteInt(writer, player2) || !snapshotWriteInt(writer, winner) ||
+            !snapshotWriteInt(writer, time))
+        {
+            return false;
+        }
+    }
+
+    int number_of_players = frozenNumberOfPlayers(frozen);
+    if (!snapshotWriteInt(writer, number_of_players))
+    {
+        return false;
+    }
+    for (int i = 0; i < number_of_players; i++)
+    {
+        PlayerData player_data = playerDataCreate();
+        if (player_data == NULL)
+        {
+            return false;
+        }
+        Player_Id player_id = frozenGetPlayer(frozen, i, player_data);
+        bool success = snapshotWriteInt(writer, player_id) && playerDataSnapshotWrite(player_data, writer);
+        playerDataDestroy(player_data);
+        if (success == false)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool tournamentSnapshotWrite(Tournament tournament, SnapshotWriter writer)
+{
+    if (tournament == NULL || writer == NULL)
+    {
+        return false;
+    }
+    const char *location = locationName(tournament->location);
+    int location_length = strlen(location) + 1;
+    if (!snapshotWriteInt(writer, tournament->max_games_per_player) ||
+        !snapshotWriteInt(writer, tournament->status) ||
+        !snapshotWriteInt(writer, tournament->winner) ||
+        !snapshotWriteInt(writer, tournament->number_of_players) ||
+        !snapshotWriteInt(writer, location_length) ||
+        !snapshotWriteBytes(writer, location, location_length))
+    {
+        return false;
+    }
+
+    if (tournament->frozen != NULL)
+    {
+        return frozenSnapshotWrite(tournament->frozen, writer);
+    }
+
+    if (!snapshotWriteInt(writer, mapGetSize(tournament->games)))
+    {
+        return false;
+    }
+    MAP_FOREACH(MapKeyElement, game_key, tournament->games)
+    {
+        if (!snapshotWriteInt(writer, *(int *)game_key) ||
+            !gameSnapshotWrite(mapGet(tournament->games, game_key), writer))
+        {
+            keyFree(game_key);
+            return false;
+        }
+        keyFree(game_key);
+    }
+
+    if (!snapshotWriteInt(writer, mapGetSize(tournament->player_list)))
+    {
+        return false;
+    }
+    MAP_FOREACH(MapKeyElement, player_id, tournament->player_list)
+    {
+        if (!snapshotWriteInt(writer, *(int *)player_id) ||
+            !playerDataSnapshotWrite(mapGet(tournament->player_list, player_id), writer))
+        {
+            keyFree(player_id);
+            return false;
+        }
+        keyFree(player_id);
+    }
+    return true;
+}
+
+Tournament tournamentSnapshotReadHeader(SnapshotReader reader, LocationTable locations)
+{
+    if (reader == NULL || locations == NULL)
+    {
+        return NULL;
+    }
+    int max_games_per_player = snapshotReadInt(reader);
+    TournamentStatus status = snapshotReadInt(reader);
+    WinnerId winner = snapshotReadInt(reader);
+    int number_of_players = snapshotReadInt(reader);
+    int location_length = snapshotReadInt(reader);
+    const char *location = snapshotReadBytes(reader, location_length);
+    if (snapshotReaderFailed(reader) || location_length <= 0 || location[location_length - 1] != '\0')
+    {
+        return NULL;
+    }
+
+    SharedLocation shared_location = locationIntern(locations, location);
+    Tournament tournament = tournamentCreate(shared_location, max_games_per_player);
+    locationRelease(shared_location);
+    if (tournament == NULL)
+    {
+        return NULL;
+    }
+    tournament->status = status;
+    tournament->winner = winner;
+    tournament->number_of_players = number_of_players;
+    return tournament;
+}
+
+/**
+ * addGamePlayers: Adds the players of a game that were not removed from it to a set.
+ *
+ * @param players - The set.
+ * @param game_data - The game.
+ * @return
+ *     false if an allocation failed, true otherwise.
+ */
+static bool addGamePlayers(IdSet players, Game_Data game_data)
+{
+    Player_Id first = gameGetFirstPlayer(game_data), second = gameGetSecondPlayer(game_data);
+    return (first == DELETE_PLAYER || idSetAdd(players, first)) &&
+           (second == DELETE_PLAYER || idSetAdd(players, second));
+}
+
+/**
+ * indexLoadedGame: Adds a game read from a snapshot to the players, durations and time index of
+ * its tournament.
+ *
+ * @param tournament - The tournament.
+ * @param game_key - The key of the game.
+ * @param game_data - The game.
+ * @return
+ *     false if an allocation failed, true otherwise.
+ */
+static bool indexLoadedGame(Tournament tournament, int game_key, Game_Data game_data)
+{
+    return addGamePlayers(tournament->players, game_data) &&
+           quantileSketchAdd(tournament->durations, gameGetTime(game_data)) &&
+           timeIndexAdd(tournament->times, game_key, gameGetFirstPlayer(game_data), gameGetSecondPlayer(game_data),
+                        (Winner)gameGetWinner(game_data), gameGetTime(game_data));
+}
+
+/**
+ * readFrozenContents: Reads the games and players of an ended tournament straight into its
+ * frozen form, without building the maps tournamentFreeze would pack.
+ *
+ * @param tournament - The tournament to fill.
+ * @param reader - The snapshot reader.
+ * @param game_data - A game to read into.
+ * @param player_data - A player to read into.
+ * @return
+ *     CHESS_LOAD_FAILURE - if the snapshot is truncated or corrupted.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS otherwise.
+ */
+static ChessResult readFrozenContents(Tournament tournament, SnapshotReader reader, Game_Data game_data,
+                                      PlayerData player_data)
+{
+    FrozenTournament frozen = frozenBegin();
+    if (frozen == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    ChessResult result = CHESS_SUCCESS;
+    int number_of_games = snapshotReadInt(reader);
+    for (int i = 0; i < number_of_games && result == CHESS_SUCCESS; i++)
+    {
+        int game_key = snapshotReadInt(reader);
+        if (gameSnapshotRead(game_data, reader) == false)
+        {
+            result = CHESS_LOAD_FAILURE;
+        }
+        else if (frozenAddGame(frozen, gameGetFirstPlayer(game_data), gameGetSecondPlayer(game_data),
+                               (Winner)gameGetWinner(game_data), gameGetTime(game_data)) == false ||
+                 indexLoadedGame(tournament, game_key, game_data) == false)
+        {
+            result = CHESS_OUT_OF_MEMORY;
+        }
+    }
+    int number_of_players = result == CHESS_SUCCESS ? snapshotReadInt(reader) : 0;
+    for (int i = 0; i < number_of_players && result == CHESS_SUCCESS; i++)
+    {
+        int player_id = snapshotReadInt(reader);
+        if (playerDataSnapshotRead(player_data, reader) == false)
+        {
+            result = CHESS_LOAD_FAILURE;
+        }
+        else if (frozenAddPlayer(frozen, player_id, player_data) == false)
+        {
+            result = CHESS_OUT_OF_MEMORY;
+        }
+    }
+    if (snapshotReaderFailed(reader) || number_of_games < 0 || number_of_players < 0 ||
+        (result == CHESS_SUCCESS && frozenFinish(frozen) == false))
+    {
+        result = CHESS_LOAD_FAILURE;
+    }
+    if (result != CHESS_SUCCESS)
+    {
+        frozenDestroy(frozen);
+        return result;
+    }
+    timeIndexCompact(tournament->times);
+    mapDestroy(tournament->games);
+    mapDestroy(tournament->player_list);
+    tournament->games = NULL;
+    tournament->player_list = NULL;
+    tournament->frozen = frozen;
+    return CHESS_SUCCESS;
+}
+
+/** A game of a snapshot record, kept until the games of its tournament are put in the map */
+typedef struct
+{
+    int game_key;
+    Player_Id first_player;
+    Player_Id second_player;
+    Winner winner;
+    Time play_time;
+} LoadedGame;
+
+/**
+ * putLoadedGames: Puts games read from a snapshot in the games map of a tournament. The map keeps
+ * its keys in a sorted list, so the games are put from the highest key down, and each one goes to
+ * the front of the list instead of after all the games put before it.
+ *
+ * @param tournament - The tournament.
+ * @param games - The games, in increasing key order.
+ * @param number_of_games - The number of games.
+ * @return
+ *     false if an allocation failed, true otherwise.
+ */
+static bool putLoadedGames(Tournament tournament, const LoadedGame *games, int number_of_games)
+{
+    for (int i = number_of_games - 1; i >= 0; i--)
+    {
+        Game_Data game_data = gameCreate(games[i].winner, games[i].first_player, games[i].second_player,
+                                         games[i].play_time);
+        MapResult result = game_data == NULL ? MAP_OUT_OF_MEMORY :
+                           mapPut(tournament->games, (MapKeyElement)&games[i].game_key, game_data);
+        gameDestroy(game_data);
+        if (result != MAP_SUCCESS)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+ChessResult tournamentSnapshotReadContents(Tournament tournament, SnapshotReader reader)
+{
+    if (tournament == NULL || reader == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    Game_Data game_data = gameCreate(DRAW, 0, 0, 0);
+    PlayerData player_data = playerDataCreate();
+    if (game_data == NULL || player_data == NULL)
+    {
+        gameDestroy(game_data);
+        playerDataDestroy(player_data);
+        return CHESS_OUT_OF_MEMORY;
+    }
+    if (tournament->status == false)
+    {
+        ChessResult result = readFrozenContents(tournament, reader, game_data, player_data);
+        gameDestroy(game_data);
+        playerDataDestroy(player_data);
+        return result;
+    }
+
+    ChessResult result = CHESS_SUCCESS;
+    LoadedGame *games = NULL;
+    int games_capacity = 0;
+    int number_of_games = snapshotReadInt(reader);
+    for (int i = 0; i < number_of_games && result == CHESS_SUCCESS; i++)
+    {
+        int game_key = snapshotReadInt(reader);
+        if (gameSnapshotRead(game_data, reader) == false)
+        {
+            result = CHESS_LOAD_FAILURE;
+            continue;
+        }
+        // The array grows with the games read, as the count of a corrupted record can be anything
+        if (i == games_capacity)
+        {
+            games_capacity = games_capacity == 0 ? MINIMUM_LOADED_GAMES : games_capacity * EXPAND_LOADED_GAMES;
+            LoadedGame *grown = realloc(games, sizeof(*games) * games_capacity);
+            if (grown == NULL)
+            {
+                result = CHESS_OUT_OF_MEMORY;
+                continue;
+            }
+            games = grown;
+        }
+        games[i].game_key = game_key;
+        games[i].first_player = gameGetFirstPlayer(game_data);
+        games[i].second_player = gameGetSecondPlayer(game_data);
+        games[i].winner = (Winner)gameGetWinner(game_data);
+        games[i].play_time = gameGetTime(game_data);
+        if (indexLoadedGame(tournament, game_key, game_data) == false)
+        {
+            result = CHESS_OUT_OF_MEMORY;
+        }
+    }
+    if (result == CHESS_SUCCESS && number_of_games > 0 && putLoadedGames(tournament, games, number_of_games) == false)
+    {
+        result = CHESS_OUT_OF_MEMORY;
+    }
+    free(games);
+    int number_of_players = result == CHESS_SUCCESS ? snapshotReadInt(reader) : 0;
+    for (int i = 0; i < number_of_players && result == CHESS_SUCCESS; i++)
+    {
+        int player_id = snapshotReadInt(reader);
+        if (playerDataSnapshotRead(player_data, reader) == false)
+        {
+            result = CHESS_LOAD_FAILURE;
+        }
+        else if (mapPut(tournament->player_list, &player_id, player_data) != MAP_SUCCESS)
+        {
+            result = CHESS_OUT_OF_MEMORY;
+        }
+    }
+    if (snapshotReaderFailed(reader) || number_of_games < 0 || number_of_players < 0)
+    {
+        result = CHESS_LOAD_FAILURE;
+    }
+    gameDestroy(game_data);
+    playerDataDestroy(player_data);
+    return result;
+}
+
+ChessResult tournamentFreeze(Tournament tournament)
+{
+    if (tournament == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (tournament->status == true)
+    {
+        return CHESS_SUCCESS;
+    }
+    if (tournament->frozen != NULL)
+    {
+        return CHESS_SUCCESS;
+    }
+    tournament->frozen = frozenCreate(tournament->games, tournament->player_list);
+    if (tournament->frozen == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    timeIndexCompact(tournament->times);
+    mapDestroy(tournament->games);
+    mapDestroy(tournament->player_list);
+    tournament->games = NULL;
+    tournament->player_list = NULL;
+    return CHESS_SUCCESS;
+}
+
+bool tournamentIsFrozen(Tournament tournament)
+{
+    return tournament != NULL && tournament->frozen != NULL;
+}
+
+void tournamentMemoryUsage(Tournament tournament, ChessMemoryFootprint *footprint)
+{
+    if (tournament == NULL || footprint == NULL)
+    {
+        return;
+    }
+    memoryFootprintAdd(footprint, CHESS_MEMORY_TOURNAMENTS, sizeof(*tournament), 1);
+    idSetMemoryUsage(tournament->players, footprint);
+    quantileSketchMemoryUsage(tournament->durations, footprint);
+    timeIndexMemoryUsage(tournament->times, footprint);
+    if (tournament->frozen != NULL)
+    {
+        frozenMemoryUsage(tournament->frozen, footprint);
+        return;
+    }
+    size_t number_of_games = mapGetSize(tournament->games), number_of_players = mapGetSize(tournament->player_list);
+    memoryFootprintAdd(footprint, CHESS_MEMORY_GAMES, number_of_games * gameAllocationSize(), number_of_games);
+    memoryFootprintAdd(footprint, CHESS_MEMORY_PLAYERS, number_of_players * playerDataAllocationSize(), number_of_players);
+    memoryFootprintAdd(footprint, CHESS_MEMORY_KEYS, (number_of_games + number_of_players) * sizeof(int),
+                       number_of_games + number_of_players);
+}
+
+/**
+ * findPairingPlayer: Binary searches players sorted by id.
+ *
+ * @param players - The players, in increasing id order.
+ * @param number_of_players - The number of players.
+ * @param player_id - The id to find.
+ * @return
+ *     The index of the player, -1 if he is not in the array.
+ */
+static int findPairingPlayer(const SwissPlayer *players, int number_of_players, Player_Id player_id)
+{
+    int low = 0, high = number_of_players - 1;
+    while (low <= high)
+    {
+        int middle = low + (high - low) / 2;
+        if (players[middle].player_id == player_id)
+        {
+            return middle;
+        }
+        if (players[middle].player_id < player_id)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+    return -1;
+}
+
+ChessResult tournamentGeneratePairings(Tournament tournament, int *out_pairs, int capacity, int *out_count)
+{
+    if (tournament->frozen != NULL || tournament->status == false)
+    {
+        return CHESS_TOURNAMENT_ENDED;
+    }
+    int number_of_players = mapGetSize(tournament->player_list);
+    int number_of_games = mapGetSize(tournament->games);
+    SwissPlayer *players = malloc(sizeof(*players) * number_of_players + 1);
+    int *games = calloc(number_of_players + 1, sizeof(int));
+    int *played_first = malloc(sizeof(int) * number_of_games + 1);
+    int *played_second = malloc(sizeof(int) * number_of_games + 1);
+    ChessResult result = CHESS_OUT_OF_MEMORY;
+    if (players != NULL && games != NULL && played_first != NULL && played_second != NULL)
+    {
+        int index = 0;
+        MAP_FOREACH(MapKeyElement, player_id, tournament->player_list)
+        {
+            players[index].player_id = *(int *)player_id;
+            players[index++].points = playerGetPoints(mapGet(tournament->player_list, player_id));
+            keyFree(player_id);
+        }
+        // games[i + 1] counts the games of the player at i, and games[0] those of removed players
+        int number_of_played = 0;
+        MAP_FOREACH(MapKeyElement, game_key, tournament->games)
+        {
+            Game_Data game = mapGet(tournament->games, game_key);
+            int first = findPairingPlayer(players, number_of_players, gameGetFirstPlayer(game));
+            int second = findPairingPlayer(players, number_of_players, gameGetSecondPlayer(game));
+            games[first + 1]++;
+            games[second + 1]++;
+            if (first >= 0 && second >= 0)
+            {
+                played_first[number_of_played] = players[first].player_id;
+                played_second[number_of_played++] = players[second].player_id;
+            }
+            keyFree(game_key);
+        }
+        int eligible = 0;
+        for (int i = 0; i < number_of_players; i++)
+        {
+            if (games[i + 1] < tournament->max_games_per_player)
+            {
+                players[eligible++] = players[i];
+            }
+        }
+        result = swissGeneratePairings(players, eligible, played_first, played_second, number_of_played,
+                                       out_pairs, capacity, out_count);
+    }
+    free(players);
+    free(games);
+    free(played_first);
+    free(played_second);
+    return result;
+}
+
+bool tournamentForEachGame(Tournament tournament, TournamentGameVisitor visit, void *context)
+{
+    TournamentGame visited;
+    if (tournament->frozen != NULL)
+    {
+        for (int offset = frozenGetGame(tournament->frozen, 0, &visited.first_player, &visited.second_player,
+                                        &visited.winner, &visited.play_time);
+             offset != FROZEN_GAMES_END;
+             offset = frozenGetGame(tournament->frozen, offset, &visited.first_player, &visited.second_player,
+                                    &visited.winner, &visited.play_time))
+        {
+            if (visit(context, &visited) == false)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    bool visiting = true;
+    MAP_FOREACH(MapKeyElement, game_key, tournament->games)
+    {
+        Game_Data game = mapGet(tournament->games, game_key);
+        visited.first_player = gameGetFirstPlayer(game);
+        visited.second_player = gameGetSecondPlayer(game);
+        visited.winner = (Winner)gameGetWinner(game);
+        visited.play_time = gameGetTime(game);
+        visiting = visiting && visit(context, &visited);
+        keyFree(game_key);
+    }
+    return visiting;
+}
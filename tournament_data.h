@@ -5,6 +5,11 @@
 #include <string.h>
 #include "game_data.h"
 #include "chess_utilities.h"
+#include "frozen_tournament.h"
+#include "location_table.h"
+#include "id_set.h"
+#include "quantile_sketch.h"
+#include "time_index.h"
 #define POSITIVE 1
 #define NEGATIVE -1
 #define NO_WINNER -1
@@ -15,16 +20,29 @@
 *   tournamentDestroy		 - Deletes an existing tournament
 *   tournamentCopy	     	 - Copies an existing tournament
 *   tournamentAddGame    	 - Adding a new game to the tournament
+*   tournamentRemoveLastGame - Removes the last game added to the tournament
 *   tournamentRemovePlayer   - Remove one player from the tournament
 *   tournamentEnd            - End the tournament and decide the winner
 *   tournamentGetLocation    - Return the location of the tournament
+*   tournamentGetSharedLocation - Return the shared location of the tournament
 *   isValidLocationName      - Check if the location name is valid
 *   tournamentGetStatus      - Return the status(if the tournament ended or is it still going) of the tournament
 *   tournamentIsPlayerExist  - Check if the player parcipited in one (at least) of the tournament games
+*   tournamentGetPlayerSet   - Return the set of the players of the tournament games
+*   tournamentGetDurations   - Return the sketch of the times of the tournament games
+*   tournamentGetTimeIndex   - Return the index of the tournament games by time
 *   tournamentGetWinner      - Return the winner of the tournament if the tournament ended
 *   copyPlayersToMap         - Copy all the players data to an outside map of players
 *   tournamentLongestGameTime- Find and return the time of the longest game
 *   tournamentNumberOfGames  - Return the number of games in the tournament
+*   tournamentSnapshotWrite  - Append the tournament to a binary snapshot
+*   tournamentSnapshotReadHeader   - Create an empty tournament from the next snapshot record
+*   tournamentSnapshotReadContents - Fill a tournament with the games and players of the snapshot record
+*   tournamentFreeze         - Pack the games and players of an ended tournament into read-only arrays
+*   tournamentIsFrozen       - Return if the tournament was frozen
+*   tournamentMemoryUsage    - Adds the memory of the tournament to a footprint
+*   tournamentGeneratePairings - Pair the players of the next round by the Swiss system
+*   tournamentForEachGame    - Call a function on every game of the tournament
 */
 /** Type for defining the tournament */
 typedef struct tournament_t *Tournament;
@@ -38,10 +56,22 @@ typedef int WinnerId;
 /** Type for defining the tournament status - is the tournament ended or is it still going */
 typedef bool TournamentStatus;
 
+/** Type for defining a game passed to a TournamentGameVisitor */
+typedef struct
+{
+    Player_Id first_player;
+    Player_Id second_player;
+    Winner winner;
+    Time play_time;
+} TournamentGame;
+
+/** Type for defining a function called on a game, that returns false to stop the iteration */
+typedef bool (*TournamentGameVisitor)(void *context, const TournamentGame *game);
+
 /**
 * tournamentCreate: Allocates a new tournament.
 *
-* @param location - The location of the tournament.
+* @param location - The location of the tournament. The tournament holds a reference to it.
 * @param max_games_per_player - Maximum number of games a player can participate in that tournamen.
 
 *
@@ -49,7 +79,7 @@ typedef bool TournamentStatus;
 * 	NULL - if allocations failed.
 * 	A new tournament in case of success.
 */
-Tournament tournamentCreate(const char *location, int max_games_per_player);
+Tournament tournamentCreate(SharedLocation location, int max_games_per_player);
 
 /**
 * tournamentDestroy: Deallocates an existing tournament.
@@ -86,19 +116,32 @@ MapDataElement tournamentCopy(MapDataElement source);
  */
 ChessResult tournamentAddGame(Tournament tournament, Winner winner, Player_Id player1, Player_Id player2, Time time, int* key_game);
 
+/**
+ * tournamentRemoveLastGame: Removes the last game added to the tournament, as when adding it to the
+ *                      system failed after tournamentAddGame. The stats of the game are subtracted
+ *                      from its players, and a player that had no other game leaves the tournament.
+ *
+ * @param tournament - tournament to remove the game from. Must be non-NULL and not ended.
+ */
+void tournamentRemoveLastGame(Tournament tournament);
+
 /**
  * tournamentRemovePlayer: Removes a specific player from the tournament.
  *                      In games where the player has participated and not yet ended,
  *                      the opponent is the winner automatically after removal.
+ *                      The system totals are updated by the same changes: the stats the
+ *                      player had in the tournament are subtracted from his total, and the
+ *                      opponents get the wins of the removal.
  *
  * @param tournament - tournament that contains the player. Must be non-NULL.
  * @param player_id - the player's id. Must be non-negative.
+ * @param total_player_list - the system totals of the players. May be NULL.
  *
  * @return
  *     CHESS_NULL_ARGUMENT - if the turnament is NULL.
  *     CHESS_SUCCESS - if there are no games in the tournament or player was removed successfully.
  */
-ChessResult tournamentRemovePlayer(Tournament tournament, Player_Id player);
+ChessResult tournamentRemovePlayer(Tournament tournament, Player_Id player, Map total_player_list);
 
 /**
  * turnamentEnd: The function will end the tournament and calculate the id of the winner.
@@ -125,6 +168,17 @@ ChessResult tournamentEnd(Tournament tournament);
 */
 const char *tournamentGetLocation(Tournament touranament);
 
+/**
+* tournamentGetSharedLocation: Returns the location of the tournament, as it is shared with the
+*   other tournaments held in it.
+*
+* @param tournament - The tournament.
+* @return
+* 	NULL - if a NULL was sent as input.
+*   The location otherwise.
+*/
+SharedLocation tournamentGetSharedLocation(Tournament tournament);
+
 /**
 * tournamentGetStatus: Returns the status of the tournament - false if the tournament ended, true if the tournament still going.
 *
@@ -146,6 +200,39 @@ TournamentStatus tournamentGetStatus(Tournament tournament);
 */
 bool tournamentIsPlayerExist(Tournament tournament, Player_Id player_id);
 
+/**
+* tournamentGetPlayerSet: Returns the set of the players that parcipitate in at least one of the
+*   tournament's games, kept as games are added and players removed, and after the tournament ends.
+*
+* @param tournament - A tournament.
+* @return
+* 	NULL - if a NULL was sent as input.
+*   The set otherwise. It belongs to the tournament.
+*/
+IdSet tournamentGetPlayerSet(Tournament tournament);
+
+/**
+* tournamentGetDurations: Returns the quantile sketch of the times of the tournament's games, kept as
+*   games are added, and after the tournament ends.
+*
+* @param tournament - A tournament.
+* @return
+* 	NULL - if a NULL was sent as input.
+*   The sketch otherwise. It belongs to the tournament.
+*/
+QuantileSketch tournamentGetDurations(Tournament tournament);
+
+/**
+* tournamentGetTimeIndex: Returns the index of the tournament's games ordered by time, kept as games
+*   are added and players removed, and compacted when the tournament is frozen.
+*
+* @param tournament - A tournament.
+* @return
+* 	NULL - if a NULL was sent as input.
+*   The index otherwise. It belongs to the tournament.
+*/
+TimeIndex tournamentGetTimeIndex(Tournament tournament);
+
 /**
 * tournamentPlayerTotalTime: calcolate the sum of all the games time and the number of games that the player participate in.
 *
@@ -228,4 +315,107 @@ int tournamentLongestGameTime(Tournament tournament, double *total_time);
 */
 Map tournamentGetGamesMap(Tournament tournament);
 
-#endif
\ No newline at end of file
+/**
+* tournamentSnapshotWrite: Appends the tournament, its location, games and players to a binary snapshot.
+*
+* @param tournament - The tournament to write.
+* @param writer - The snapshot writer.
+* @return
+* 	false - if the input is NULL or the snapshot could not grow.
+* 	true - otherwise.
+*/
+bool tournamentSnapshotWrite(Tournament tournament, SnapshotWriter writer);
+
+/**
+* tournamentSnapshotReadHeader: Creates a tournament without games from the next snapshot record.
+*   The games and players are read by tournamentSnapshotReadContents, after the tournament was put
+*   in its map, so the loaded games are not copied a second time by mapPut.
+*
+* @param reader - The snapshot reader.
+* @param locations - The table the location of the tournament is interned in.
+* @return
+* 	NULL - if the snapshot is truncated or an allocation failed.
+* 	A new tournament otherwise.
+*/
+Tournament tournamentSnapshotReadHeader(SnapshotReader reader, LocationTable locations);
+
+/**
+* tournamentSnapshotReadContents: Fills a tournament with the games and players of the snapshot record
+*   whose header was read by tournamentSnapshotReadHeader. An ended tournament is read straight into
+*   its frozen form.
+*
+* @param tournament - The tournament to fill.
+* @param reader - The snapshot reader.
+* @return
+*     CHESS_NULL_ARGUMENT - if the input is NULL.
+*     CHESS_LOAD_FAILURE - if the snapshot is truncated or corrupted.
+*     CHESS_OUT_OF_MEMORY - if there was a problem allocating the games or players.
+*     CHESS_SUCCESS - if the tournament was filled successfully.
+*/
+ChessResult tournamentSnapshotReadContents(Tournament tournament, SnapshotReader reader);
+
+/**
+* tournamentFreeze: Packs the games and players maps of an ended tournament into a read-only frozen
+*   form (see frozen_tournament.h) and frees the maps. Ended tournaments never change, and the frozen
+*   form takes a fraction of the memory. All the query functions keep working on a frozen tournament,
+*   tournamentGetGamesMap returns NULL for it.
+*
+* @param tournament - The tournament to freeze.
+* @return
+*     CHESS_NULL_ARGUMENT - if tournament is NULL.
+*     CHESS_OUT_OF_MEMORY - if an allocation failed. The tournament is left as it was.
+*     CHESS_SUCCESS - if the tournament was frozen, was already frozen, or has not ended yet.
+*/
+ChessResult tournamentFreeze(Tournament tournament);
+
+/**
+* tournamentIsFrozen: Returns if the tournament was frozen by tournamentFreeze.
+*
+* @param tournament - The tournament.
+* @return
+* 	false - if tournament is NULL or is not frozen.
+* 	true - otherwise.
+*/
+bool tournamentIsFrozen(Tournament tournament);
+
+/**
+* tournamentMemoryUsage: Adds the memory allocated for the tournament to a footprint - the tournament
+*   itself, and its games, players and their keys, or its frozen form. Its location is shared, and
+*   counted by locationTableMemoryUsage.
+*
+* @param tournament - The tournament. If it is NULL nothing will be added.
+* @param footprint - The footprint to add to.
+*/
+void tournamentMemoryUsage(Tournament tournament, ChessMemoryFootprint *footprint);
+
+
+/**
+* tournamentGeneratePairings: Pairs the players of the next round of the tournament by the Swiss
+*   system, see swiss_pairing.h. Only players that played less than max_games_per_player games
+*   are paired, and no pair already played in the tournament.
+*
+* @param tournament - The tournament. Must be non-NULL and not ended.
+* @param out_pairs - Where to store the pairs, two ids each. Holds 2 * capacity ids.
+* @param capacity - The number of pairs out_pairs holds.
+* @param out_count - Where to store the number of pairs of the round.
+* @return
+*     CHESS_TOURNAMENT_ENDED - if the tournament ended.
+*     CHESS_OUT_OF_MEMORY - if an allocation failed.
+*     CHESS_SUCCESS - otherwise.
+*/
+ChessResult tournamentGeneratePairings(Tournament tournament, int *out_pairs, int capacity, int *out_count);
+
+/**
+* tournamentForEachGame: Calls a function on every game of the tournament, in game key order, frozen
+*   or not. A player removed from a game is passed as DELETE_PLAYER.
+*
+* @param tournament - The tournament. Must be non-NULL.
+* @param visit - The function to call.
+* @param context - Passed to visit as is.
+* @return
+*     false - if visit returned false, in which case the games after it are not visited.
+*     true - otherwise.
+*/
+bool tournamentForEachGame(Tournament tournament, TournamentGameVisitor visit, void *context);
+
+#endif